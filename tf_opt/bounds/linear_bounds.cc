@@ -0,0 +1,156 @@
+// Copyright 2026 The tf.opt Authors.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "tf_opt/bounds/linear_bounds.h"
+
+#include <algorithm>
+#include <cstdint>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "ortools/base/logging.h"
+#include "absl/strings/str_cat.h"
+#include "absl/strings/str_join.h"
+#include "absl/types/span.h"
+#include "tf_opt/bounds/bounds.h"
+
+namespace tf_opt {
+namespace {
+
+// target += scale * coefficients, with missing coefficients being zero.
+void AddScaled(const std::vector<double>& coefficients, const double scale,
+               std::vector<double>* target) {
+  if (coefficients.size() > target->size()) {
+    target->resize(coefficients.size(), 0.0);
+  }
+  for (int64_t i = 0; i < coefficients.size(); ++i) {
+    (*target)[i] += scale * coefficients[i];
+  }
+}
+
+// The minimum (or maximum if "maximize") of coefficients . x + offset over
+// the box input_bounds.
+double Optimize(const std::vector<double>& coefficients, const double offset,
+                absl::Span<const Bounds> input_bounds, const bool maximize) {
+  CHECK_LE(coefficients.size(), input_bounds.size());
+  double result = offset;
+  for (int64_t i = 0; i < coefficients.size(); ++i) {
+    const double coefficient = coefficients[i];
+    // Skips zeros, which could otherwise multiply infinite bounds.
+    if (coefficient == 0.0) continue;
+    const bool use_ub = (coefficient > 0.0) == maximize;
+    result += coefficient *
+              (use_ub ? input_bounds[i].ub() : input_bounds[i].lb());
+  }
+  return result;
+}
+
+}  // namespace
+
+LinearBounds LinearBounds::Input(const int64_t index) {
+  CHECK_GE(index, 0);
+  LinearBounds result;
+  result.lower_coefficients_.resize(index + 1, 0.0);
+  result.lower_coefficients_[index] = 1.0;
+  result.upper_coefficients_ = result.lower_coefficients_;
+  return result;
+}
+
+LinearBounds LinearBounds::FromLowerAndUpper(const LinearBounds& lower,
+                                             const LinearBounds& upper) {
+  LinearBounds result;
+  result.lower_coefficients_ = lower.lower_coefficients_;
+  result.lower_offset_ = lower.lower_offset_;
+  result.upper_coefficients_ = upper.upper_coefficients_;
+  result.upper_offset_ = upper.upper_offset_;
+  return result;
+}
+
+Bounds LinearBounds::Concretize(absl::Span<const Bounds> input_bounds) const {
+  return Bounds(
+      Optimize(lower_coefficients_, lower_offset_, input_bounds, false),
+      Optimize(upper_coefficients_, upper_offset_, input_bounds, true));
+}
+
+LinearBounds LinearBounds::Relax(const double lower_slope,
+                                 const double lower_intercept,
+                                 const double upper_slope,
+                                 const double upper_intercept) const {
+  CHECK_GE(lower_slope, 0.0);
+  CHECK_GE(upper_slope, 0.0);
+  LinearBounds result(Bounds(lower_intercept, upper_intercept));
+  // A zero slope gives a constant, even if the offset is infinite.
+  if (lower_slope > 0.0) {
+    AddScaled(lower_coefficients_, lower_slope, &result.lower_coefficients_);
+    result.lower_offset_ += lower_slope * lower_offset_;
+  }
+  if (upper_slope > 0.0) {
+    AddScaled(upper_coefficients_, upper_slope, &result.upper_coefficients_);
+    result.upper_offset_ += upper_slope * upper_offset_;
+  }
+  return result;
+}
+
+LinearBounds& LinearBounds::operator+=(const LinearBounds& rhs) {
+  AddScaled(rhs.lower_coefficients_, 1.0, &lower_coefficients_);
+  AddScaled(rhs.upper_coefficients_, 1.0, &upper_coefficients_);
+  lower_offset_ += rhs.lower_offset_;
+  upper_offset_ += rhs.upper_offset_;
+  return *this;
+}
+
+LinearBounds& LinearBounds::operator-=(const LinearBounds& rhs) {
+  AddScaled(rhs.upper_coefficients_, -1.0, &lower_coefficients_);
+  AddScaled(rhs.lower_coefficients_, -1.0, &upper_coefficients_);
+  lower_offset_ -= rhs.upper_offset_;
+  upper_offset_ -= rhs.lower_offset_;
+  return *this;
+}
+
+LinearBounds& LinearBounds::operator*=(const double rhs) {
+  if (rhs == 0.0) {
+    *this = LinearBounds(0.0);
+    return *this;
+  }
+  if (rhs < 0.0) {
+    std::swap(lower_coefficients_, upper_coefficients_);
+    std::swap(lower_offset_, upper_offset_);
+  }
+  for (double& coefficient : lower_coefficients_) coefficient *= rhs;
+  for (double& coefficient : upper_coefficients_) coefficient *= rhs;
+  lower_offset_ *= rhs;
+  upper_offset_ *= rhs;
+  return *this;
+}
+
+LinearBounds& LinearBounds::operator/=(const double rhs) {
+  CHECK_NE(rhs, 0.0) << "Division of LinearBounds by zero";
+  return *this *= 1.0 / rhs;
+}
+
+LinearBounds LinearBounds::operator-() const {
+  LinearBounds result = *this;
+  result *= -1.0;
+  return result;
+}
+
+std::string LinearBounds::ToString() const {
+  return absl::StrCat("[", absl::StrJoin(lower_coefficients_, ","), "] x + ",
+                      lower_offset_, " <= value <= [",
+                      absl::StrJoin(upper_coefficients_, ","), "] x + ",
+                      upper_offset_);
+}
+
+}  // namespace tf_opt
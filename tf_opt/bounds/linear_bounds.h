@@ -0,0 +1,141 @@
+// Copyright 2026 The tf.opt Authors.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef TF_OPT_BOUNDS_LINEAR_BOUNDS_H_
+#define TF_OPT_BOUNDS_LINEAR_BOUNDS_H_
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+#include "absl/types/span.h"
+#include "tf_opt/bounds/bounds.h"
+
+namespace tf_opt {
+
+// Lower and upper bounds on a value that are affine functions of some inputs
+// x (e.g. the elements of the input variables of a neural network):
+//   lower_coefficients . x + lower_offset
+//       <= value <= upper_coefficients . x + upper_offset.
+//
+// Coefficient vectors may be shorter than the number of inputs, the missing
+// coefficients being zero. In particular, LinearBounds with no coefficients
+// are a constant interval, which keeps tensors of constants small.
+//
+// The operators are those of interval arithmetic, on functions instead of
+// numbers, e.g. (L1, U1) - (L2, U2) = (L1 - U2, U1 - L2). Multiplication is
+// only defined by a double, as the product of two affine functions is not
+// affine.
+class LinearBounds {
+ public:
+  // The constant zero.
+  LinearBounds() : LinearBounds(0.0) {}
+
+  explicit LinearBounds(const double value)
+      : lower_offset_(value), upper_offset_(value) {}
+
+  explicit LinearBounds(const Bounds bounds)
+      : lower_offset_(bounds.lb()), upper_offset_(bounds.ub()) {}
+
+  // The input x[index].
+  static LinearBounds Input(int64_t index);
+
+  // The lower bound of "lower" and the upper bound of "upper".
+  static LinearBounds FromLowerAndUpper(const LinearBounds& lower,
+                                        const LinearBounds& upper);
+
+  const std::vector<double>& lower_coefficients() const {
+    return lower_coefficients_;
+  }
+  const std::vector<double>& upper_coefficients() const {
+    return upper_coefficients_;
+  }
+  double lower_offset() const { return lower_offset_; }
+  double upper_offset() const { return upper_offset_; }
+
+  // True if the bounds do not depend on the inputs.
+  bool is_constant() const {
+    return lower_coefficients_.empty() && upper_coefficients_.empty();
+  }
+
+  // The tightest Bounds implied on the value when each input x[i] is within
+  // input_bounds[i]. Inputs beyond input_bounds.size() must have zero
+  // coefficients.
+  Bounds Concretize(absl::Span<const Bounds> input_bounds) const;
+
+  // Bounds on f(value) for a nondecreasing function f, given affine bounds
+  //   lower_slope * y + lower_intercept <= f(y)
+  //       <= upper_slope * y + upper_intercept
+  // that hold for all y in the range of the value. The slopes must be
+  // nonnegative.
+  LinearBounds Relax(double lower_slope, double lower_intercept,
+                     double upper_slope, double upper_intercept) const;
+
+  LinearBounds& operator+=(const LinearBounds& rhs);
+  LinearBounds& operator-=(const LinearBounds& rhs);
+  // Multiplying by zero gives the constant zero.
+  LinearBounds& operator*=(double rhs);
+  LinearBounds& operator/=(double rhs);
+
+  LinearBounds& operator+=(const double rhs) {
+    lower_offset_ += rhs;
+    upper_offset_ += rhs;
+    return *this;
+  }
+
+  // Turns (L, U) into (-U, -L).
+  LinearBounds operator-() const;
+
+  std::string ToString() const;
+
+ private:
+  std::vector<double> lower_coefficients_;
+  std::vector<double> upper_coefficients_;
+  double lower_offset_;
+  double upper_offset_;
+};
+
+inline LinearBounds operator+(LinearBounds lhs, const LinearBounds& rhs) {
+  lhs += rhs;
+  return lhs;
+}
+
+inline LinearBounds operator+(LinearBounds lhs, const double rhs) {
+  lhs += rhs;
+  return lhs;
+}
+
+inline LinearBounds operator-(LinearBounds lhs, const LinearBounds& rhs) {
+  lhs -= rhs;
+  return lhs;
+}
+
+inline LinearBounds operator*(LinearBounds lhs, const double rhs) {
+  lhs *= rhs;
+  return lhs;
+}
+
+inline LinearBounds operator*(const double lhs, LinearBounds rhs) {
+  rhs *= lhs;
+  return rhs;
+}
+
+inline LinearBounds operator/(LinearBounds lhs, const double rhs) {
+  lhs /= rhs;
+  return lhs;
+}
+
+}  // namespace tf_opt
+
+#endif  // TF_OPT_BOUNDS_LINEAR_BOUNDS_H_
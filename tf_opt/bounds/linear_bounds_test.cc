@@ -0,0 +1,106 @@
+// Copyright 2026 The tf.opt Authors.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "tf_opt/bounds/linear_bounds.h"
+
+#include <limits>
+#include <vector>
+
+#include "gmock/gmock.h"
+#include "gtest/gtest.h"
+#include "tf_opt/bounds/bounds.h"
+
+namespace tf_opt {
+namespace {
+
+using ::testing::ElementsAre;
+using ::testing::IsEmpty;
+
+constexpr double kInf = std::numeric_limits<double>::infinity();
+
+TEST(LinearBoundsTest, Constant) {
+  const LinearBounds bounds(Bounds(-1.0, 2.0));
+  EXPECT_TRUE(bounds.is_constant());
+  EXPECT_EQ(bounds.Concretize({}), Bounds(-1.0, 2.0));
+}
+
+TEST(LinearBoundsTest, Input) {
+  const LinearBounds x1 = LinearBounds::Input(1);
+  EXPECT_FALSE(x1.is_constant());
+  EXPECT_THAT(x1.lower_coefficients(), ElementsAre(0.0, 1.0));
+  EXPECT_THAT(x1.upper_coefficients(), ElementsAre(0.0, 1.0));
+  EXPECT_EQ(x1.Concretize({Bounds(0.0, 1.0), Bounds(3.0, 4.0)}),
+            Bounds(3.0, 4.0));
+}
+
+TEST(LinearBoundsTest, SubtractionKeepsCorrelation) {
+  // x0 - x0 is exactly zero, whereas [0, 1] - [0, 1] = [-1, 1].
+  const LinearBounds x0 = LinearBounds::Input(0);
+  const LinearBounds difference = x0 - x0;
+  EXPECT_EQ(difference.Concretize({Bounds(0.0, 1.0)}), Bounds(0.0, 0.0));
+}
+
+TEST(LinearBoundsTest, AdditionOfDifferentLengths) {
+  const LinearBounds sum =
+      LinearBounds::Input(0) + 2.0 * LinearBounds::Input(2) + LinearBounds(1.0);
+  EXPECT_THAT(sum.lower_coefficients(), ElementsAre(1.0, 0.0, 2.0));
+  EXPECT_EQ(sum.lower_offset(), 1.0);
+  EXPECT_EQ(
+      sum.Concretize({Bounds(-1.0, 1.0), Bounds(-kInf, kInf), Bounds(0, 3)}),
+      Bounds(0.0, 8.0));
+}
+
+TEST(LinearBoundsTest, MultiplyByNegativeSwapsBounds) {
+  const LinearBounds bounds =
+      LinearBounds::FromLowerAndUpper(LinearBounds::Input(0),
+                                      LinearBounds::Input(0) + 1.0) *
+      -2.0;
+  EXPECT_THAT(bounds.lower_coefficients(), ElementsAre(-2.0));
+  EXPECT_EQ(bounds.lower_offset(), -2.0);
+  EXPECT_THAT(bounds.upper_coefficients(), ElementsAre(-2.0));
+  EXPECT_EQ(bounds.upper_offset(), 0.0);
+  EXPECT_EQ((-LinearBounds::Input(0)).Concretize({Bounds(1.0, 2.0)}),
+            Bounds(-2.0, -1.0));
+}
+
+TEST(LinearBoundsTest, MultiplyByZero) {
+  const LinearBounds bounds = LinearBounds::Input(0) * 0.0;
+  EXPECT_TRUE(bounds.is_constant());
+  EXPECT_EQ(bounds.Concretize({Bounds(-kInf, kInf)}), Bounds(0.0));
+}
+
+TEST(LinearBoundsTest, Divide) {
+  const LinearBounds bounds = LinearBounds::Input(0) / -4.0;
+  EXPECT_EQ(bounds.Concretize({Bounds(-4.0, 8.0)}), Bounds(-2.0, 1.0));
+}
+
+TEST(LinearBoundsTest, Relax) {
+  // The triangle relaxation of ReLU on [-1, 3]:
+  //   0 <= relu(y) <= 0.75 * y + 0.75.
+  const LinearBounds y = 2.0 * LinearBounds::Input(0) + 1.0;
+  const LinearBounds relu = y.Relax(0.0, 0.0, 0.75, 0.75);
+  EXPECT_THAT(relu.lower_coefficients(), IsEmpty());
+  EXPECT_EQ(relu.lower_offset(), 0.0);
+  EXPECT_THAT(relu.upper_coefficients(), ElementsAre(1.5));
+  EXPECT_EQ(relu.upper_offset(), 1.5);
+  EXPECT_EQ(relu.Concretize({Bounds(-1.0, 1.0)}), Bounds(0.0, 3.0));
+}
+
+TEST(LinearBoundsTest, ToString) {
+  EXPECT_EQ(LinearBounds::Input(1).ToString(),
+            "[0,1] x + 0 <= value <= [0,1] x + 0");
+}
+
+}  // namespace
+}  // namespace tf_opt
@@ -0,0 +1,469 @@
+// Copyright 2026 The tf.opt Authors.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "tf_opt/neural_net/affine_folding.h"
+
+#include <cstdint>
+#include <memory>
+#include <optional>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "ortools/base/logging.h"
+#include "absl/algorithm/container.h"
+#include "absl/status/status.h"
+#include "absl/status/statusor.h"
+#include "absl/strings/str_cat.h"
+#include "tf_opt/neural_net/neural_net_graph.h"
+#include "tf_opt/neural_net/op_registry.h"
+#include "tf_opt/neural_net/operation.h"
+#include "tf_opt/neural_net/ops/all_operations.h"
+#include "tf_opt/open_source/status_macros.h"
+#include "tf_opt/tensor/math.h"
+#include "tf_opt/tensor/shape.h"
+#include "tf_opt/tensor/tensor.h"
+
+namespace tf_opt {
+
+namespace {
+
+// The value of a chain of affine operations:
+//   head(source, weights) * scale + bias,
+// or source * scale + bias without a head, with broadcasting.
+struct AffineChain {
+  // The id of the non-constant input of the chain.
+  int source = -1;
+
+  // A MatmulOperation, Conv1dOperation or Conv2dOperation, or nullptr.
+  const Operation* head = nullptr;
+
+  // The constant operand of head, with the scale folded in. Then the scale
+  // is one.
+  DoubleTensor weights;
+
+  DoubleTensor scale = DoubleTensor(1.0);
+  DoubleTensor bias = DoubleTensor(0.0);
+
+  // The output shape of the chain.
+  Shape shape;
+
+  // The operations of the graph in the chain, and the name of the first.
+  int num_operations = 0;
+  std::string first_name;
+};
+
+const DoubleTensor* ConstantValue(const NeuralNetGraph& graph, const int id) {
+  const auto* constant =
+      dynamic_cast<const ConstantOperation*>(&graph.operation(id));
+  return constant == nullptr ? nullptr : &constant->value();
+}
+
+bool AllEqual(const DoubleTensor& tensor, const double value) {
+  return absl::c_all_of(tensor.flat_values(),
+                        [value](const double v) { return v == value; });
+}
+
+// tensor as a vector of the given size if it only varies along its last axis,
+// which is of that size or one.
+std::optional<DoubleTensor> AsLastAxisVector(const DoubleTensor& tensor,
+                                             const int64_t size) {
+  const std::vector<int64_t>& dims = tensor.dimension().dimension_sizes();
+  for (int i = 0; i + 1 < dims.size(); ++i) {
+    if (dims[i] != 1) return std::nullopt;
+  }
+  if (tensor.size() == size) return tensor.Reshape(Shape({size}));
+  if (tensor.size() == 1) {
+    return DoubleTensor(Shape({size}), tensor.flat_value(0));
+  }
+  return std::nullopt;
+}
+
+// tensor broadcast to a matrix with "columns" columns, if it has at most two
+// dimensions.
+std::optional<DoubleTensor> AsMatrix(const DoubleTensor& tensor,
+                                     const int64_t columns) {
+  if (tensor.dimension().num_dimensions() > 2) return std::nullopt;
+  const absl::StatusOr<Shape> shape =
+      BinaryOpOutputShape(tensor.dimension(), Shape({1, columns}));
+  if (!shape.ok() || shape->dimension_sizes().back() != columns) {
+    return std::nullopt;
+  }
+  return Add(tensor, DoubleTensor(Shape({1, columns}), 0.0));
+}
+
+// Folds the scale of chain into its weights, if possible.
+bool FoldScaleIntoWeights(AffineChain* chain) {
+  const int64_t channels = chain->shape.dimension_sizes().back();
+  const std::optional<DoubleTensor> scale =
+      AsLastAxisVector(chain->scale, channels);
+  if (!scale.has_value()) return false;
+  // The last axis of the weights of a MatMul or convolution is the output
+  // channel.
+  chain->weights = Multiply(chain->weights, *scale);
+  chain->scale = DoubleTensor(1.0);
+  return true;
+}
+
+// Applies the Add, Subtract, Multiply or Divide operation "op", with the
+// other operand "constant", to chain. Returns false if chain has a head and
+// the result would not fold into its weights.
+bool ApplyElementwise(const Operation& op, const bool constant_is_right,
+                      const DoubleTensor& constant, AffineChain* chain) {
+  if (chain->head != nullptr && !(op.output_shape() == chain->shape)) {
+    return false;
+  }
+  if (dynamic_cast<const AddOperation*>(&op) != nullptr) {
+    chain->bias = Add(chain->bias, constant);
+  } else if (dynamic_cast<const SubtractOperation*>(&op) != nullptr) {
+    if (constant_is_right) {
+      chain->bias = Subtract(chain->bias, constant);
+    } else {
+      chain->scale = ElementwiseNegate(chain->scale);
+      chain->bias = Subtract(constant, chain->bias);
+    }
+  } else if (dynamic_cast<const MultiplyOperation*>(&op) != nullptr) {
+    chain->scale = Multiply(chain->scale, constant);
+    chain->bias = Multiply(chain->bias, constant);
+  } else {
+    CHECK(dynamic_cast<const DivideOperation*>(&op) != nullptr);
+    CHECK(constant_is_right);
+    chain->scale = Divide(chain->scale, constant);
+    chain->bias = Divide(chain->bias, constant);
+  }
+  chain->shape = op.output_shape();
+  return chain->head == nullptr || FoldScaleIntoWeights(chain);
+}
+
+bool IsElementwiseAffine(const Operation& op, const bool constant_is_right) {
+  return dynamic_cast<const AddOperation*>(&op) != nullptr ||
+         dynamic_cast<const SubtractOperation*>(&op) != nullptr ||
+         dynamic_cast<const MultiplyOperation*>(&op) != nullptr ||
+         // c / x is not affine.
+         (dynamic_cast<const DivideOperation*>(&op) != nullptr &&
+          constant_is_right);
+}
+
+class AffineFolder {
+ public:
+  explicit AffineFolder(const NeuralNetGraph& graph)
+      : graph_(graph),
+        chains_(graph.num_operations()),
+        absorbed_(graph.num_operations(), false),
+        new_ids_(graph.num_operations(), -1) {}
+
+  absl::StatusOr<NeuralNetGraph> Fold(AffineFoldingStats* stats);
+
+ private:
+  // The chain ending with operation "id", or std::nullopt if it is not
+  // affine in one non-constant input. Sets absorbed_[input] if it extends the
+  // chain of its input.
+  std::optional<AffineChain> MakeChain(int id);
+
+  // The empty chain of the output of operation "id".
+  AffineChain Identity(int id) const;
+
+  // The chain of input, if operation "id" is its only consumer, or the empty
+  // chain of input.
+  AffineChain Start(int id, int input) const;
+
+  // The chain followed by a MatMul with the constant weights, or
+  // std::nullopt if it cannot be merged into it.
+  std::optional<AffineChain> ApplyMatmul(const MatmulOperation& op,
+                                         AffineChain chain,
+                                         const DoubleTensor& weights) const;
+
+  // The head of the chain, or its Multiply if it has no head, named "name".
+  // nullptr if the chain is only an Add.
+  absl::StatusOr<std::unique_ptr<Operation>> MakeLinear(
+      const AffineChain& chain, const std::string& name) const;
+
+  // Adds the operations computing the chain of operation "id" to result_.
+  absl::Status EmitChain(int id);
+
+  // Adds a copy of operation "id" to result_.
+  absl::Status EmitCopy(int id);
+
+  // The id in result_ of operation "id" of graph_, adding it if it is a
+  // ConstantOperation that is not there yet.
+  absl::StatusOr<int> NewId(int id);
+
+  absl::StatusOr<int> Emit(std::unique_ptr<Operation> op,
+                           std::vector<int> inputs);
+  absl::StatusOr<int> EmitConstant(const std::string& name,
+                                   DoubleTensor value);
+
+  // "base", or "base" with a suffix, so that it is not the name of an
+  // operation of result_, nor of one of graph_ that may be copied to it.
+  std::string UniqueName(const std::string& base) const;
+
+  const NeuralNetGraph& graph_;
+  std::vector<std::optional<AffineChain>> chains_;
+  std::vector<bool> absorbed_;
+  std::vector<int> new_ids_;
+  NeuralNetGraph result_;
+};
+
+AffineChain AffineFolder::Identity(const int id) const {
+  AffineChain result;
+  result.source = id;
+  result.shape = graph_.operation(id).output_shape();
+  return result;
+}
+
+AffineChain AffineFolder::Start(const int id, const int input) const {
+  if (chains_[input].has_value() && graph_.consumers(input).size() == 1) {
+    CHECK_EQ(graph_.consumers(input)[0], id);
+    return *chains_[input];
+  }
+  return Identity(input);
+}
+
+std::optional<AffineChain> AffineFolder::ApplyMatmul(
+    const MatmulOperation& op, AffineChain chain,
+    const DoubleTensor& weights) const {
+  const int64_t rows = weights.dimension().dimension_sizes()[0];
+  const int64_t columns = weights.dimension().dimension_sizes()[1];
+  if (chain.head == nullptr) {
+    // (x * scale + bias) W = x (diag(scale) W) + bias W, when the scale only
+    // depends on the column of x.
+    if (!(chain.shape == graph_.operation(chain.source).output_shape())) {
+      return std::nullopt;
+    }
+    const std::optional<DoubleTensor> scale =
+        AsLastAxisVector(chain.scale, rows);
+    const std::optional<DoubleTensor> bias = AsMatrix(chain.bias, rows);
+    if (!scale.has_value() || !bias.has_value()) return std::nullopt;
+    chain.weights = Multiply(weights, scale->Reshape(Shape({rows, 1})));
+    chain.scale = DoubleTensor(1.0);
+    chain.bias = MatMul(*bias, weights);
+  } else {
+    // (x W1 + bias) W = x (W1 W) + bias W, unless W1 W is larger than W1
+    // and W.
+    if (dynamic_cast<const MatmulOperation*>(chain.head) == nullptr) {
+      return std::nullopt;
+    }
+    const int64_t inner = chain.weights.dimension().dimension_sizes()[0];
+    if (inner * columns > chain.weights.size() + weights.size()) {
+      return std::nullopt;
+    }
+    const std::optional<DoubleTensor> bias = AsMatrix(chain.bias, rows);
+    if (!bias.has_value()) return std::nullopt;
+    chain.weights = MatMul(chain.weights, weights);
+    chain.bias = MatMul(*bias, weights);
+  }
+  chain.head = &op;
+  chain.shape = op.output_shape();
+  return chain;
+}
+
+std::optional<AffineChain> AffineFolder::MakeChain(const int id) {
+  const Operation& op = graph_.operation(id);
+  const std::vector<int>& inputs = graph_.inputs(id);
+  if (inputs.size() != 2) return std::nullopt;
+  const DoubleTensor* left = ConstantValue(graph_, inputs[0]);
+  const DoubleTensor* right = ConstantValue(graph_, inputs[1]);
+  if ((left == nullptr) == (right == nullptr)) return std::nullopt;
+  const bool constant_is_right = right != nullptr;
+  const int input = constant_is_right ? inputs[0] : inputs[1];
+  const DoubleTensor& constant = constant_is_right ? *right : *left;
+
+  std::optional<AffineChain> result;
+  const AffineChain start = Start(id, input);
+  if (const auto* matmul = dynamic_cast<const MatmulOperation*>(&op)) {
+    if (!constant_is_right || constant.dimension().num_dimensions() != 2) {
+      return std::nullopt;
+    }
+    if (start.num_operations > 0) {
+      result = ApplyMatmul(*matmul, start, constant);
+    }
+    if (!result.has_value()) {
+      result = Identity(input);
+      result->head = matmul;
+      result->weights = constant;
+      result->shape = op.output_shape();
+    }
+  } else if (dynamic_cast<const Conv1dOperation*>(&op) != nullptr ||
+             dynamic_cast<const Conv2dOperation*>(&op) != nullptr) {
+    if (!constant_is_right) return std::nullopt;
+    result = Identity(input);
+    result->head = &op;
+    result->weights = constant;
+    result->shape = op.output_shape();
+  } else if (IsElementwiseAffine(op, constant_is_right)) {
+    result = start;
+    if (!ApplyElementwise(op, constant_is_right, constant, &*result)) {
+      // Keep the chain of the input, and start a new one.
+      result = Identity(input);
+      CHECK(ApplyElementwise(op, constant_is_right, constant, &*result));
+    }
+  } else {
+    return std::nullopt;
+  }
+  if (result->num_operations == 0) {
+    result->first_name = op.name();
+  } else {
+    absorbed_[input] = true;
+  }
+  ++result->num_operations;
+  return result;
+}
+
+std::string AffineFolder::UniqueName(const std::string& base) const {
+  std::string result = base;
+  for (int suffix = 1;; ++suffix) {
+    const absl::StatusOr<int> id = graph_.OperationId(result);
+    if (!result_.OperationId(result).ok() && (!id.ok() || absorbed_[*id])) {
+      return result;
+    }
+    result = absl::StrCat(base, "_", suffix);
+  }
+}
+
+absl::StatusOr<int> AffineFolder::Emit(std::unique_ptr<Operation> op,
+                                       std::vector<int> inputs) {
+  return result_.AddOperation(std::move(op), std::move(inputs));
+}
+
+absl::StatusOr<int> AffineFolder::EmitConstant(const std::string& name,
+                                               DoubleTensor value) {
+  return Emit(std::make_unique<ConstantOperation>(UniqueName(name),
+                                                  std::move(value)),
+              {});
+}
+
+absl::StatusOr<int> AffineFolder::NewId(const int id) {
+  if (new_ids_[id] < 0) {
+    CHECK(ConstantValue(graph_, id) != nullptr);
+    TFOPT_RETURN_IF_ERROR(EmitCopy(id));
+  }
+  return new_ids_[id];
+}
+
+absl::Status AffineFolder::EmitCopy(const int id) {
+  const Operation& op = graph_.operation(id);
+  std::vector<int> inputs;
+  for (const int input : graph_.inputs(id)) {
+    TFOPT_ASSIGN_OR_RETURN(const int new_id, NewId(input));
+    inputs.push_back(new_id);
+  }
+  TFOPT_ASSIGN_OR_RETURN(std::unique_ptr<Operation> copy,
+                         op_registry::CloneOperation(op, op.name()));
+  TFOPT_ASSIGN_OR_RETURN(new_ids_[id], Emit(std::move(copy), inputs));
+  return absl::OkStatus();
+}
+
+absl::StatusOr<std::unique_ptr<Operation>> AffineFolder::MakeLinear(
+    const AffineChain& chain, const std::string& name) const {
+  const Shape& source_shape = graph_.operation(chain.source).output_shape();
+  if (chain.head == nullptr) {
+    if (AllEqual(chain.scale, 1.0)) {
+      return std::unique_ptr<Operation>();
+    }
+    TFOPT_ASSIGN_OR_RETURN(
+        MultiplyOperation multiply,
+        MultiplyOperation::Create(name, source_shape,
+                                  chain.scale.dimension()));
+    return std::make_unique<MultiplyOperation>(std::move(multiply));
+  }
+  if (dynamic_cast<const MatmulOperation*>(chain.head) != nullptr) {
+    TFOPT_ASSIGN_OR_RETURN(
+        MatmulOperation matmul,
+        MatmulOperation::Create(name, source_shape,
+                                chain.weights.dimension()));
+    return std::make_unique<MatmulOperation>(std::move(matmul));
+  }
+  return op_registry::CloneOperation(*chain.head, name);
+}
+
+absl::Status AffineFolder::EmitChain(const int id) {
+  const AffineChain& chain = *chains_[id];
+  const Shape& output_shape = graph_.operation(id).output_shape();
+  const std::string& name = graph_.operation(id).name();
+  TFOPT_ASSIGN_OR_RETURN(std::unique_ptr<Operation> linear_op,
+                         MakeLinear(chain, name));
+  // The Add is needed for a nonzero bias, and for a zero bias that
+  // broadcasts the linear operation to the output shape. Without a linear
+  // operation, the chain is one Add, even if the bias is zero, so that it
+  // keeps its name.
+  const bool emit_add = !AllEqual(chain.bias, 0.0) || linear_op == nullptr ||
+                        linear_op->output_shape() != output_shape;
+  if (emit_add && linear_op != nullptr) {
+    TFOPT_ASSIGN_OR_RETURN(linear_op,
+                           MakeLinear(chain, UniqueName(chain.first_name)));
+  }
+  TFOPT_ASSIGN_OR_RETURN(int linear, NewId(chain.source));
+  Shape linear_shape = graph_.operation(chain.source).output_shape();
+  if (linear_op != nullptr) {
+    linear_shape = linear_op->output_shape();
+    const bool is_head = chain.head != nullptr;
+    TFOPT_ASSIGN_OR_RETURN(
+        const int constant,
+        EmitConstant(absl::StrCat(linear_op->name(),
+                                  is_head ? "_weights" : "_scale"),
+                     is_head ? chain.weights : chain.scale));
+    TFOPT_ASSIGN_OR_RETURN(linear,
+                           Emit(std::move(linear_op), {linear, constant}));
+  }
+  if (emit_add) {
+    TFOPT_ASSIGN_OR_RETURN(
+        AddOperation add,
+        AddOperation::Create(name, linear_shape, chain.bias.dimension()));
+    TFOPT_ASSIGN_OR_RETURN(
+        const int bias,
+        EmitConstant(absl::StrCat(name, "_bias"), chain.bias));
+    TFOPT_ASSIGN_OR_RETURN(
+        linear, Emit(std::make_unique<AddOperation>(std::move(add)),
+                     {linear, bias}));
+  }
+  if (result_.operation(linear).output_shape() != output_shape) {
+    return absl::InternalError(absl::StrCat(
+        "Folded ", name, " has shape ",
+        result_.operation(linear).output_shape().ToString(), ", expected ",
+        output_shape.ToString()));
+  }
+  new_ids_[id] = linear;
+  return absl::OkStatus();
+}
+
+absl::StatusOr<NeuralNetGraph> AffineFolder::Fold(AffineFoldingStats* stats) {
+  for (int id = 0; id < graph_.num_operations(); ++id) {
+    chains_[id] = MakeChain(id);
+  }
+  int num_folded_operations = 0;
+  for (int id = 0; id < graph_.num_operations(); ++id) {
+    if (absorbed_[id]) continue;
+    if (chains_[id].has_value() && chains_[id]->num_operations > 1) {
+      TFOPT_RETURN_IF_ERROR(EmitChain(id));
+      num_folded_operations += chains_[id]->num_operations - 1;
+    } else if (ConstantValue(graph_, id) == nullptr ||
+               graph_.consumers(id).empty()) {
+      // The other constants are added when they are used.
+      TFOPT_RETURN_IF_ERROR(EmitCopy(id));
+    }
+  }
+  if (stats != nullptr) {
+    stats->num_folded_operations = num_folded_operations;
+  }
+  return std::move(result_);
+}
+
+}  // namespace
+
+absl::StatusOr<NeuralNetGraph> FoldAffineOperations(
+    const NeuralNetGraph& graph, AffineFoldingStats* stats) {
+  return AffineFolder(graph).Fold(stats);
+}
+
+}  // namespace tf_opt
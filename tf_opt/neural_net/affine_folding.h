@@ -0,0 +1,54 @@
+// Copyright 2026 The tf.opt Authors.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef TF_OPT_NEURAL_NET_AFFINE_FOLDING_H_
+#define TF_OPT_NEURAL_NET_AFFINE_FOLDING_H_
+
+#include "absl/status/statusor.h"
+#include "tf_opt/neural_net/neural_net_graph.h"
+
+namespace tf_opt {
+
+struct AffineFoldingStats {
+  // The operations of the graph that were merged into another one.
+  int num_folded_operations = 0;
+};
+
+// Presolve that merges the chains of affine operations with constant operands
+// into as few operations as possible, with recomputed constants:
+//  - Add, Subtract, Multiply and Divide (by a constant) become one Multiply
+//    and one Add, y = x * scale + bias;
+//  - after a MatMul with constant weights, or a Conv1d or Conv2d with a
+//    constant filter, the scale is folded into the weights or filter when it
+//    only depends on the last axis (the output channel), e.g. for a batch
+//    normalization, and the chain becomes the MatMul or convolution and one
+//    Add;
+//  - consecutive MatMuls with constant weights become one MatMul, unless the
+//    product of the weights is larger than the two of them.
+// Only operations with a single consumer are merged into the next one, so
+// the operations whose result is used elsewhere are kept. The last operation
+// of each chain keeps its name, so the outputs of the graph can still be
+// looked up by name; the other names of a chain may disappear or name the new
+// operations.
+//
+// The result evaluates to the same values as graph, up to rounding, with
+// fewer operations to evaluate and fewer auxiliary variables in a MIP model
+// (see MipEncoder). Run it before evaluating or encoding the graph:
+//   TFOPT_ASSIGN_OR_RETURN(NeuralNetGraph folded, FoldAffineOperations(graph));
+absl::StatusOr<NeuralNetGraph> FoldAffineOperations(
+    const NeuralNetGraph& graph, AffineFoldingStats* stats = nullptr);
+
+}  // namespace tf_opt
+
+#endif  // TF_OPT_NEURAL_NET_AFFINE_FOLDING_H_
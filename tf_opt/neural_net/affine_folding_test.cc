@@ -0,0 +1,290 @@
+// Copyright 2026 The tf.opt Authors.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "tf_opt/neural_net/affine_folding.h"
+
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "gtest/gtest.h"
+#include "absl/status/statusor.h"
+#include "tf_opt/neural_net/double_evaluator.h"
+#include "tf_opt/neural_net/neural_net_graph.h"
+#include "tf_opt/neural_net/operation_testing.h"
+#include "tf_opt/neural_net/ops/all_operations.h"
+#include "tf_opt/open_source/status_matchers.h"
+#include "tf_opt/tensor/shape.h"
+#include "tf_opt/tensor/tensor.h"
+#include "tf_opt/tensor/tensor_testing.h"
+
+namespace tf_opt {
+namespace {
+
+constexpr double kTolerance = 1e-9;
+
+// Checks that the sinks of graph have the same values in folded, at x.
+void ExpectSameOutputs(const NeuralNetGraph& graph,
+                       const NeuralNetGraph& folded, const DoubleTensor& x) {
+  DoubleEvaluator evaluator;
+  evaluator.set_variable_value("x", x);
+  const std::vector<DoubleTensor> values = graph.Evaluate(&evaluator);
+  const std::vector<DoubleTensor> folded_values = folded.Evaluate(&evaluator);
+  for (const int id : graph.Sinks()) {
+    const std::string& name = graph.operation(id).name();
+    TFOPT_ASSERT_OK_AND_ASSIGN(const int folded_id, folded.OperationId(name));
+    const DoubleTensor& expected = values[id];
+    const DoubleTensor& actual = folded_values[folded_id];
+    ASSERT_EQ(actual.dimension(), expected.dimension()) << name;
+    for (int64_t i = 0; i < expected.size(); ++i) {
+      EXPECT_NEAR(actual.flat_value(i), expected.flat_value(i), kTolerance)
+          << name << " at " << i;
+    }
+  }
+}
+
+TEST(FoldAffineOperationsTest, DenseLayerWithBatchNorm) {
+  NeuralNetGraph graph;
+  const int x = AddToGraph(VariableOperation::Create("x", Shape({2, 3})), {},
+                           &graph);
+  const int w = AddConstant("w", MakeWeights(Shape({3, 4}), 1), &graph);
+  const int matmul = AddToGraph(
+      MatmulOperation::Create("matmul", Shape({2, 3}), Shape({3, 4})),
+      {x, w}, &graph);
+  const int b = AddConstant("b", MakeWeights(Shape({4}), 2), &graph);
+  const int add = AddToGraph(
+      AddOperation::Create("add", Shape({2, 4}), Shape({4})), {matmul, b},
+      &graph);
+  const int gamma = AddConstant("gamma", MakeWeights(Shape({1, 4}), 3),
+                                &graph);
+  const int scaled = AddToGraph(
+      MultiplyOperation::Create("scaled", Shape({2, 4}), Shape({1, 4})),
+      {add, gamma}, &graph);
+  const int beta = AddConstant("beta", MakeWeights(Shape({4}), 4), &graph);
+  const int shifted = AddToGraph(
+      AddOperation::Create("shifted", Shape({2, 4}), Shape({4})),
+      {scaled, beta}, &graph);
+  AddToGraph(ReluOperation::Create("relu", Shape({2, 4})), {shifted}, &graph);
+
+  AffineFoldingStats stats;
+  TFOPT_ASSERT_OK_AND_ASSIGN(const NeuralNetGraph folded,
+                             FoldAffineOperations(graph, &stats));
+  EXPECT_EQ(stats.num_folded_operations, 3);
+  // x, the weights, MatMul, the bias, Add and Relu.
+  EXPECT_EQ(folded.num_operations(), 6);
+  TFOPT_ASSERT_OK_AND_ASSIGN(const int folded_shifted,
+                             folded.OperationId("shifted"));
+  EXPECT_NE(dynamic_cast<const AddOperation*>(
+                &folded.operation(folded_shifted)),
+            nullptr);
+  ExpectSameOutputs(graph, folded, MakeWeights(Shape({2, 3}), 5));
+}
+
+TEST(FoldAffineOperationsTest, ConvolutionWithBatchNorm) {
+  NeuralNetGraph graph;
+  const int x = AddToGraph(VariableOperation::Create("x", Shape({1, 3, 3, 2})),
+                           {}, &graph);
+  const int filter =
+      AddConstant("filter", MakeWeights(Shape({2, 2, 2, 3}), 1), &graph);
+  const int conv = AddToGraph(
+      Conv2dOperation::Create("conv", Shape({1, 3, 3, 2}),
+                              Shape({2, 2, 2, 3}), Position2D(1, 1),
+                              PaddingType::SAME),
+      {x, filter}, &graph);
+  const Shape conv_shape = graph.operation(conv).output_shape();
+  const int gamma = AddConstant("gamma", MakeWeights(Shape({3}), 2), &graph);
+  const int scaled = AddToGraph(
+      MultiplyOperation::Create("scaled", conv_shape, Shape({3})),
+      {conv, gamma}, &graph);
+  const int beta = AddConstant("beta", MakeWeights(Shape({3}), 3), &graph);
+  AddToGraph(AddOperation::Create("shifted", conv_shape, Shape({3})),
+             {scaled, beta}, &graph);
+
+  AffineFoldingStats stats;
+  TFOPT_ASSERT_OK_AND_ASSIGN(const NeuralNetGraph folded,
+                             FoldAffineOperations(graph, &stats));
+  EXPECT_EQ(stats.num_folded_operations, 2);
+  EXPECT_EQ(folded.num_operations(), 5);
+  ExpectSameOutputs(graph, folded, MakeWeights(Shape({1, 3, 3, 2}), 4));
+}
+
+TEST(FoldAffineOperationsTest, ElementwiseChain) {
+  NeuralNetGraph graph;
+  const int x = AddToGraph(VariableOperation::Create("x", Shape({2, 3})), {},
+                           &graph);
+  const int two = AddConstant("two", DoubleTensor(Shape({1}), 2.0), &graph);
+  const int doubled = AddToGraph(
+      MultiplyOperation::Create("doubled", Shape({2, 3}), Shape({1})),
+      {x, two}, &graph);
+  const int c = AddConstant("c", MakeWeights(Shape({2, 3}), 1), &graph);
+  const int negated = AddToGraph(
+      SubtractOperation::Create("negated", Shape({2, 3}), Shape({2, 3})),
+      {c, doubled}, &graph);
+  const int four = AddConstant("four", DoubleTensor(Shape({3}), 4.0), &graph);
+  AddToGraph(DivideOperation::Create("divided", Shape({2, 3}), Shape({3})),
+             {negated, four}, &graph);
+
+  AffineFoldingStats stats;
+  TFOPT_ASSERT_OK_AND_ASSIGN(const NeuralNetGraph folded,
+                             FoldAffineOperations(graph, &stats));
+  EXPECT_EQ(stats.num_folded_operations, 2);
+  // x, the scale, Multiply, the bias and Add.
+  EXPECT_EQ(folded.num_operations(), 5);
+  ExpectSameOutputs(graph, folded, MakeWeights(Shape({2, 3}), 2));
+}
+
+TEST(FoldAffineOperationsTest, ZeroBiasThatBroadcastsIsKept) {
+  NeuralNetGraph graph;
+  const int x =
+      AddToGraph(VariableOperation::Create("x", Shape({3})), {}, &graph);
+  const int two = AddConstant("two", DoubleTensor(Shape({1}), 2.0), &graph);
+  const int doubled =
+      AddToGraph(MultiplyOperation::Create("doubled", Shape({3}), Shape({1})),
+                 {x, two}, &graph);
+  const int zeros = AddConstant("zeros", DoubleTensor(Shape({2, 3})), &graph);
+  AddToGraph(AddOperation::Create("add", Shape({3}), Shape({2, 3})),
+             {doubled, zeros}, &graph);
+
+  AffineFoldingStats stats;
+  TFOPT_ASSERT_OK_AND_ASSIGN(const NeuralNetGraph folded,
+                             FoldAffineOperations(graph, &stats));
+  EXPECT_EQ(stats.num_folded_operations, 1);
+  TFOPT_ASSERT_OK_AND_ASSIGN(const int add, folded.OperationId("add"));
+  EXPECT_EQ(folded.operation(add).output_shape(), Shape({2, 3}));
+  ExpectSameOutputs(graph, folded, MakeWeights(Shape({3}), 2));
+}
+
+// The scale before the MatMul is folded into its weights only once.
+TEST(FoldAffineOperationsTest, ScaleBeforeMatmulThenAddAndMultiply) {
+  NeuralNetGraph graph;
+  const int x = AddToGraph(VariableOperation::Create("x", Shape({2, 3})), {},
+                           &graph);
+  const int two = AddConstant("two", DoubleTensor(Shape({1}), 2.0), &graph);
+  const int doubled = AddToGraph(
+      MultiplyOperation::Create("doubled", Shape({2, 3}), Shape({1})),
+      {x, two}, &graph);
+  const int w = AddConstant("w", DoubleTensor(Shape({3, 4}), 1.0), &graph);
+  const int matmul = AddToGraph(
+      MatmulOperation::Create("matmul", Shape({2, 3}), Shape({3, 4})),
+      {doubled, w}, &graph);
+  const int half = AddConstant("half", DoubleTensor(Shape({1}), 0.5), &graph);
+  const int add = AddToGraph(
+      AddOperation::Create("add", Shape({2, 4}), Shape({1})), {matmul, half},
+      &graph);
+  const int three =
+      AddConstant("three", DoubleTensor(Shape({4}), 3.0), &graph);
+  AddToGraph(MultiplyOperation::Create("tripled", Shape({2, 4}), Shape({4})),
+             {add, three}, &graph);
+
+  AffineFoldingStats stats;
+  TFOPT_ASSERT_OK_AND_ASSIGN(const NeuralNetGraph folded,
+                             FoldAffineOperations(graph, &stats));
+  EXPECT_EQ(stats.num_folded_operations, 3);
+  ExpectSameOutputs(graph, folded, DoubleTensor(Shape({2, 3}), 1.0));
+  ExpectSameOutputs(graph, folded, MakeWeights(Shape({2, 3}), 2));
+}
+
+TEST(FoldAffineOperationsTest, ConsecutiveMatmuls) {
+  NeuralNetGraph graph;
+  const int x = AddToGraph(VariableOperation::Create("x", Shape({1, 4})), {},
+                           &graph);
+  const int w1 = AddConstant("w1", MakeWeights(Shape({4, 2}), 1), &graph);
+  const int matmul1 = AddToGraph(
+      MatmulOperation::Create("matmul1", Shape({1, 4}), Shape({4, 2})),
+      {x, w1}, &graph);
+  const int b1 = AddConstant("b1", MakeWeights(Shape({2}), 2), &graph);
+  const int add1 = AddToGraph(
+      AddOperation::Create("add1", Shape({1, 2}), Shape({2})), {matmul1, b1},
+      &graph);
+  const int w2 = AddConstant("w2", MakeWeights(Shape({2, 3}), 3), &graph);
+  const int matmul2 = AddToGraph(
+      MatmulOperation::Create("matmul2", Shape({1, 2}), Shape({2, 3})),
+      {add1, w2}, &graph);
+  // The product of w3 and w4 would be larger than both.
+  const int w3 = AddConstant("w3", MakeWeights(Shape({3, 1}), 4), &graph);
+  const int matmul3 = AddToGraph(
+      MatmulOperation::Create("matmul3", Shape({1, 3}), Shape({3, 1})),
+      {matmul2, w3}, &graph);
+  const int w4 = AddConstant("w4", MakeWeights(Shape({1, 5}), 5), &graph);
+  AddToGraph(MatmulOperation::Create("matmul4", Shape({1, 1}), Shape({1, 5})),
+             {matmul3, w4}, &graph);
+
+  AffineFoldingStats stats;
+  TFOPT_ASSERT_OK_AND_ASSIGN(const NeuralNetGraph folded,
+                             FoldAffineOperations(graph, &stats));
+  // add1, matmul2 and matmul3 are folded, matmul4 is not.
+  EXPECT_EQ(stats.num_folded_operations, 3);
+  EXPECT_TRUE(folded.OperationId("matmul3").ok());
+  EXPECT_TRUE(folded.OperationId("matmul4").ok());
+  ExpectSameOutputs(graph, folded,
+                    DoubleTensor(std::vector<std::vector<double>>{
+                        {0.5, -1.0, 0.25, 2.0}}));
+}
+
+TEST(FoldAffineOperationsTest, KeepsSharedOperations) {
+  NeuralNetGraph graph;
+  const int x = AddToGraph(VariableOperation::Create("x", Shape({1, 3})), {},
+                           &graph);
+  const int w = AddConstant("w", MakeWeights(Shape({3, 3}), 1), &graph);
+  const int matmul = AddToGraph(
+      MatmulOperation::Create("matmul", Shape({1, 3}), Shape({3, 3})),
+      {x, w}, &graph);
+  const int b = AddConstant("b", MakeWeights(Shape({3}), 2), &graph);
+  const int add = AddToGraph(
+      AddOperation::Create("add", Shape({1, 3}), Shape({3})), {matmul, b},
+      &graph);
+  AddToGraph(ReluOperation::Create("relu", Shape({1, 3})), {add}, &graph);
+  const int scale = AddConstant("scale", MakeWeights(Shape({3}), 3), &graph);
+  AddToGraph(MultiplyOperation::Create("scaled", Shape({1, 3}), Shape({3})),
+             {add, scale}, &graph);
+
+  AffineFoldingStats stats;
+  TFOPT_ASSERT_OK_AND_ASSIGN(const NeuralNetGraph folded,
+                             FoldAffineOperations(graph, &stats));
+  // add is used twice, so only matmul is folded into it.
+  EXPECT_EQ(stats.num_folded_operations, 1);
+  EXPECT_EQ(folded.num_operations(), graph.num_operations());
+  ExpectSameOutputs(graph, folded, MakeWeights(Shape({1, 3}), 4));
+}
+
+TEST(FoldAffineOperationsTest, ScaleAcrossRowsIsNotFoldedIntoWeights) {
+  NeuralNetGraph graph;
+  const int x = AddToGraph(VariableOperation::Create("x", Shape({2, 3})), {},
+                           &graph);
+  const int w = AddConstant("w", MakeWeights(Shape({3, 2}), 1), &graph);
+  const int matmul = AddToGraph(
+      MatmulOperation::Create("matmul", Shape({2, 3}), Shape({3, 2})),
+      {x, w}, &graph);
+  const int scale = AddConstant("scale", MakeWeights(Shape({2, 1}), 2),
+                                &graph);
+  const int scaled = AddToGraph(
+      MultiplyOperation::Create("scaled", Shape({2, 2}), Shape({2, 1})),
+      {matmul, scale}, &graph);
+  const int b = AddConstant("b", MakeWeights(Shape({2}), 3), &graph);
+  AddToGraph(AddOperation::Create("add", Shape({2, 2}), Shape({2})),
+             {scaled, b}, &graph);
+
+  AffineFoldingStats stats;
+  TFOPT_ASSERT_OK_AND_ASSIGN(const NeuralNetGraph folded,
+                             FoldAffineOperations(graph, &stats));
+  // Only the Add is folded into the Multiply.
+  EXPECT_EQ(stats.num_folded_operations, 1);
+  EXPECT_TRUE(folded.OperationId("matmul").ok());
+  ExpectSameOutputs(graph, folded, MakeWeights(Shape({2, 3}), 4));
+}
+
+}  // namespace
+}  // namespace tf_opt
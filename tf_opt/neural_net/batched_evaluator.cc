@@ -0,0 +1,434 @@
+// Copyright 2026 The tf.opt Authors.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "tf_opt/neural_net/batched_evaluator.h"
+
+#include <algorithm>
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "ortools/base/logging.h"
+#include "absl/container/flat_hash_map.h"
+#include "absl/status/status.h"
+#include "absl/status/statusor.h"
+#include "absl/strings/str_cat.h"
+#include "tf_opt/neural_net/double_evaluator.h"
+#include "tf_opt/neural_net/neural_net.pb.h"
+#include "tf_opt/neural_net/neural_net_graph.h"
+#include "tf_opt/neural_net/op_registry.h"
+#include "tf_opt/neural_net/operation.h"
+#include "tf_opt/neural_net/ops/all_operations.h"
+#include "tf_opt/open_source/status_macros.h"
+#include "tf_opt/tensor/shape.h"
+#include "tf_opt/tensor/tensor.h"
+
+namespace tf_opt {
+namespace {
+
+// The shape [batch_size, shape].
+Shape BatchedShape(const int64_t batch_size, const Shape& shape) {
+  std::vector<int64_t> sizes = {batch_size};
+  sizes.insert(sizes.end(), shape.dimension_sizes().begin(),
+               shape.dimension_sizes().end());
+  return Shape(std::move(sizes));
+}
+
+// The shape [batch_size * d_0 * ... * d_{n-1}, d_n, ...] of a tensor of shape
+// [batch_size, shape] whose first n + 1 dimensions are merged.
+Shape MergedShape(const int64_t batch_size, const Shape& shape,
+                  const int num_merged) {
+  const std::vector<int64_t>& sizes = shape.dimension_sizes();
+  int64_t merged_size = batch_size;
+  for (int i = 0; i < num_merged; ++i) {
+    merged_size *= sizes[i];
+  }
+  std::vector<int64_t> result = {merged_size};
+  result.insert(result.end(), sizes.begin() + num_merged, sizes.end());
+  return Shape(std::move(result));
+}
+
+// Shifts the non-negative axes in values by one, past the batch dimension.
+void ShiftAxes(std::vector<int64_t>* values) {
+  for (int64_t& axis : *values) {
+    if (axis >= 0) {
+      ++axis;
+    }
+  }
+}
+
+// Rewrites the operations of a graph one at a time, in the order of their
+// ids, into the batched graph.
+class GraphBatcher {
+ public:
+  GraphBatcher(const NeuralNetGraph& graph, const int64_t batch_size)
+      : graph_(graph),
+        batch_size_(batch_size),
+        new_ids_(graph.num_operations(), -1),
+        is_batched_(graph.num_operations(), false) {}
+
+  absl::StatusOr<NeuralNetGraph> Run() && {
+    for (int id = 0; id < graph_.num_operations(); ++id) {
+      const Operation& op = graph_.operation(id);
+      if (dynamic_cast<const VariableOperation*>(&op) != nullptr) {
+        is_batched_[id] = true;
+        TFOPT_ASSIGN_OR_RETURN(
+            new_ids_[id],
+            AddToResult(VariableOperation::Create(
+                            op.name(),
+                            BatchedShape(batch_size_, op.output_shape())),
+                        {}));
+        continue;
+      }
+      for (const int input : graph_.inputs(id)) {
+        is_batched_[id] = is_batched_[id] || is_batched_[input];
+      }
+      if (is_batched_[id]) {
+        TFOPT_ASSIGN_OR_RETURN(new_ids_[id], AddBatched(id),
+                               _ << "while batching operation: "
+                                 << op.name());
+      } else {
+        TFOPT_ASSIGN_OR_RETURN(std::unique_ptr<Operation> copy,
+                               op_registry::CloneOperation(op, op.name()));
+        TFOPT_ASSIGN_OR_RETURN(new_ids_[id],
+                               result_.AddOperation(std::move(copy),
+                                                    NewIds(graph_.inputs(id))));
+      }
+    }
+    return std::move(result_);
+  }
+
+ private:
+  template <typename OperationType>
+  absl::StatusOr<int> AddToResult(absl::StatusOr<OperationType> operation,
+                                  std::vector<int> input_ids) {
+    TFOPT_ASSIGN_OR_RETURN(OperationType op, std::move(operation));
+    return result_.AddOperation(std::make_unique<OperationType>(std::move(op)),
+                                std::move(input_ids));
+  }
+
+  // Adds an operation of type op_type to the result, on the inputs of ids
+  // input_ids of the result.
+  absl::StatusOr<int> AddToResult(const proto::OpType op_type,
+                                  std::string name, std::vector<int> input_ids,
+                                  Shape output_shape,
+                                  const Operation::Options& options) {
+    std::vector<Shape> input_shapes;
+    for (const int input_id : input_ids) {
+      input_shapes.push_back(result_.operation(input_id).output_shape());
+    }
+    TFOPT_ASSIGN_OR_RETURN(
+        std::unique_ptr<Operation> op,
+        op_registry::MakeOperation(op_type, std::move(name),
+                                   std::move(input_shapes),
+                                   std::move(output_shape), options));
+    return result_.AddOperation(std::move(op), std::move(input_ids));
+  }
+
+  // Reshapes operation "id" of the result to shape, if needed.
+  absl::StatusOr<int> AddReshape(std::string name, const int id,
+                                 Shape shape) {
+    const Shape& input_shape = result_.operation(id).output_shape();
+    if (input_shape == shape) {
+      return id;
+    }
+    return AddToResult(ReshapeOperation::Create(std::move(name), input_shape,
+                                                std::move(shape)),
+                       {id});
+  }
+
+  std::vector<int> NewIds(const std::vector<int>& ids) const {
+    std::vector<int> result;
+    for (const int id : ids) {
+      result.push_back(new_ids_[id]);
+    }
+    return result;
+  }
+
+  proto::TensorNode ToProto(const int id) const {
+    std::vector<std::string> input_names;
+    for (const int input : graph_.inputs(id)) {
+      input_names.push_back(graph_.operation(input).name());
+    }
+    return graph_.operation(id).ToProto(input_names);
+  }
+
+  absl::Status ExpectUnbatched(const int id, const int input_index) const {
+    if (is_batched_[graph_.inputs(id)[input_index]]) {
+      return absl::UnimplementedError(
+          absl::StrCat("Input ", input_index, " of ",
+                       graph_.operation(id).name(),
+                       " cannot depend on a variable in a batched graph."));
+    }
+    return absl::OkStatus();
+  }
+
+  // The batched operation "id", whose value has the leading dimension
+  // batch_size_, with some input batched.
+  absl::StatusOr<int> AddBatched(const int id) {
+    const Operation& op = graph_.operation(id);
+    const proto::TensorNode node = ToProto(id);
+    Operation::Options options(node.options());
+    const Shape output_shape = BatchedShape(batch_size_, op.output_shape());
+    switch (node.op_type()) {
+      case proto::ADD:
+      case proto::SUBTRACT:
+      case proto::MULTIPLY:
+      case proto::DIVIDE:
+        return AddBroadcasting(id, options);
+      case proto::MAT_MUL:
+        if (!is_batched_[graph_.inputs(id)[1]] &&
+            op.input_shape(1).num_dimensions() == 2) {
+          return AddMerged(id, op.input_shape(0).num_dimensions() - 1,
+                           options);
+        }
+        return AddBroadcasting(id, options);
+      case proto::FUSED_LINEAR:
+        TFOPT_RETURN_IF_ERROR(ExpectUnbatched(id, 1));
+        TFOPT_RETURN_IF_ERROR(ExpectUnbatched(id, 2));
+        if (dynamic_cast<const FusedLinearOperation&>(op).conv2d() !=
+            nullptr) {
+          return AddMerged(id, 1, options);
+        }
+        if (op.input_shape(1).num_dimensions() == 2) {
+          return AddMerged(id, op.input_shape(0).num_dimensions() - 1,
+                           options);
+        }
+        return AddBroadcasting(id, options);
+      case proto::CONV1D:
+      case proto::CONV2D:
+        TFOPT_RETURN_IF_ERROR(ExpectUnbatched(id, 1));
+        return AddMerged(id, 1, options);
+      case proto::MAX_POOL:
+        return AddMerged(id, 1, options);
+      case proto::EMBEDDING_LOOKUP:
+        TFOPT_RETURN_IF_ERROR(ExpectUnbatched(id, 0));
+        break;
+      case proto::CONCAT:
+        for (int i = 0; i < graph_.inputs(id).size(); ++i) {
+          if (!is_batched_[graph_.inputs(id)[i]]) {
+            return absl::UnimplementedError(absl::StrCat(
+                "Concat ", op.name(), " of batched and unbatched inputs."));
+          }
+        }
+        if (options.integer_options[ConcatOperation::kOptionsAxisKey] >= 0) {
+          ++options.integer_options[ConcatOperation::kOptionsAxisKey];
+        }
+        break;
+      case proto::EXPAND_DIMS:
+        if (options.integer_options[ExpandDimsOperation::kOptionsAxisKey] >=
+            0) {
+          ++options.integer_options[ExpandDimsOperation::kOptionsAxisKey];
+        }
+        break;
+      case proto::SQUEEZE: {
+        std::vector<int64_t>& axes =
+            options.integer_list_options[SqueezeOperation::kOptionsAxesKey];
+        // No axes squeezes every dimension of size 1, which would include a
+        // batch of size 1: lists them explicitly.
+        if (axes.empty()) {
+          const std::vector<int64_t>& sizes =
+              op.input_shape(0).dimension_sizes();
+          for (int axis = 0; axis < sizes.size(); ++axis) {
+            if (sizes[axis] == 1) {
+              axes.push_back(axis);
+            }
+          }
+        }
+        // Without any dimension to remove, the squeeze is the identity.
+        if (axes.empty()) {
+          return AddToResult(
+              ReshapeOperation::Create(op.name(), output_shape, output_shape),
+              NewIds(graph_.inputs(id)));
+        }
+        ShiftAxes(&axes);
+        break;
+      }
+      case proto::REDUCE_MAX:
+      case proto::REDUCE_MIN:
+      case proto::REDUCE_MEAN:
+      case proto::REDUCE_SUM:
+        ShiftAxes(&options.integer_list_options[std::string(
+            reduce::kOptionsAxesKey)]);
+        break;
+      case proto::SLICE: {
+        std::vector<int64_t>& begin =
+            options.integer_list_options[SliceOperation::kOptionsBeginKey];
+        std::vector<int64_t>& size =
+            options.integer_list_options[SliceOperation::kOptionsSizeKey];
+        begin.insert(begin.begin(), 0);
+        size.insert(size.begin(), batch_size_);
+        break;
+      }
+      case proto::RELU:
+      case proto::CLIPPED_RELU:
+      case proto::RESHAPE:
+        break;
+      default:
+        return absl::UnimplementedError(
+            absl::StrCat("Cannot batch operation: ", op.name()));
+    }
+    return AddToResult(node.op_type(), op.name(), NewIds(graph_.inputs(id)),
+                       output_shape, options);
+  }
+
+  // Operation "id" on its inputs, where the batched ones are padded with
+  // dimensions of size 1 after the batch dimension to the rank of the
+  // largest input, so that the operation broadcasts over the batch.
+  absl::StatusOr<int> AddBroadcasting(const int id,
+                                      const Operation::Options& options) {
+    const Operation& op = graph_.operation(id);
+    const std::vector<int>& inputs = graph_.inputs(id);
+    int max_rank = 0;
+    for (const Shape& shape : op.input_shapes()) {
+      max_rank = std::max<int>(max_rank, shape.num_dimensions());
+    }
+    std::vector<int> input_ids;
+    for (int i = 0; i < inputs.size(); ++i) {
+      if (!is_batched_[inputs[i]]) {
+        input_ids.push_back(new_ids_[inputs[i]]);
+        continue;
+      }
+      std::vector<int64_t> sizes(max_rank + 1, 1);
+      sizes[0] = batch_size_;
+      const std::vector<int64_t>& input_sizes =
+          op.input_shape(i).dimension_sizes();
+      std::copy(input_sizes.begin(), input_sizes.end(),
+                sizes.end() - input_sizes.size());
+      TFOPT_ASSIGN_OR_RETURN(
+          const int input_id,
+          AddReshape(absl::StrCat(op.name(), "/batch_input", i),
+                     new_ids_[inputs[i]], Shape(std::move(sizes))));
+      input_ids.push_back(input_id);
+    }
+    return AddToResult(ToProto(id).op_type(), op.name(),
+                       std::move(input_ids),
+                       BatchedShape(batch_size_, op.output_shape()), options);
+  }
+
+  // Operation "id" with the batch dimension merged with the first num_merged
+  // dimensions of its first input and output, which is the only batched
+  // input. This is valid for the operations that treat these dimensions as
+  // independent rows, e.g. a MatMul with a rank 2 right operand.
+  absl::StatusOr<int> AddMerged(const int id, const int num_merged,
+                                const Operation::Options& options) {
+    const Operation& op = graph_.operation(id);
+    std::vector<int> input_ids = NewIds(graph_.inputs(id));
+    TFOPT_ASSIGN_OR_RETURN(
+        input_ids[0],
+        AddReshape(absl::StrCat(op.name(), "/batch_input0"), input_ids[0],
+                   MergedShape(batch_size_, op.input_shape(0), num_merged)));
+    TFOPT_ASSIGN_OR_RETURN(
+        const int merged,
+        AddToResult(ToProto(id).op_type(),
+                    absl::StrCat(op.name(), "/merged_batch"),
+                    std::move(input_ids),
+                    MergedShape(batch_size_, op.output_shape(), num_merged),
+                    options));
+    return AddToResult(ReshapeOperation::Create(
+                           op.name(), result_.operation(merged).output_shape(),
+                           BatchedShape(batch_size_, op.output_shape())),
+                       {merged});
+  }
+
+  const NeuralNetGraph& graph_;
+  const int64_t batch_size_;
+  NeuralNetGraph result_;
+  std::vector<int> new_ids_;
+  std::vector<bool> is_batched_;
+};
+
+}  // namespace
+
+absl::StatusOr<NeuralNetGraph> BatchGraph(const NeuralNetGraph& graph,
+                                          const int64_t batch_size) {
+  if (batch_size < 1) {
+    return absl::InvalidArgumentError(
+        absl::StrCat("Batch size must be positive, found: ", batch_size));
+  }
+  return GraphBatcher(graph, batch_size).Run();
+}
+
+BatchedEvaluator::BatchedEvaluator(const NeuralNetGraph* graph,
+                                   const int64_t batch_size,
+                                   NeuralNetGraph batched_graph)
+    : graph_(graph),
+      batch_size_(batch_size),
+      batched_graph_(std::move(batched_graph)) {
+  for (int id = 0; id < graph_->num_operations(); ++id) {
+    const Operation& op = graph_->operation(id);
+    const int batched_id = batched_graph_.OperationIdOrDie(op.name());
+    batched_ids_.push_back(batched_id);
+    is_batched_.push_back(
+        batched_graph_.operation(batched_id).output_shape().num_dimensions() >
+        op.output_shape().num_dimensions());
+  }
+}
+
+absl::StatusOr<BatchedEvaluator> BatchedEvaluator::Create(
+    const NeuralNetGraph* graph, const int64_t batch_size) {
+  CHECK(graph != nullptr);
+  TFOPT_ASSIGN_OR_RETURN(NeuralNetGraph batched_graph,
+                         BatchGraph(*graph, batch_size));
+  return BatchedEvaluator(graph, batch_size, std::move(batched_graph));
+}
+
+std::vector<std::vector<DoubleTensor>> BatchedEvaluator::Evaluate(
+    const std::vector<absl::flat_hash_map<std::string, DoubleTensor>>& points,
+    const std::vector<int>& output_ids) const {
+  std::vector<std::vector<DoubleTensor>> result(points.size());
+  for (int64_t chunk_begin = 0; chunk_begin < points.size();
+       chunk_begin += batch_size_) {
+    const int64_t chunk_size =
+        std::min<int64_t>(batch_size_, points.size() - chunk_begin);
+    DoubleEvaluator evaluator;
+    for (const int id : graph_->variables()) {
+      const Operation& variable = graph_->operation(id);
+      const int64_t variable_size = variable.output_shape().size();
+      DoubleTensor stacked(BatchedShape(batch_size_, variable.output_shape()));
+      std::vector<double>& stacked_values = *stacked.mutable_flat_values();
+      for (int64_t i = 0; i < batch_size_; ++i) {
+        const DoubleTensor& value =
+            points[chunk_begin + std::min(i, chunk_size - 1)].at(
+                variable.name());
+        CHECK(value.dimension() == variable.output_shape())
+            << "Wrong shape for variable: " << variable.name();
+        std::copy(value.flat_values().begin(), value.flat_values().end(),
+                  stacked_values.begin() + i * variable_size);
+      }
+      evaluator.set_variable_value(variable.name(), std::move(stacked));
+    }
+    const std::vector<DoubleTensor> values =
+        batched_graph_.Evaluate(&evaluator);
+    for (int64_t i = 0; i < chunk_size; ++i) {
+      std::vector<DoubleTensor>& point_result = result[chunk_begin + i];
+      for (const int id : output_ids) {
+        const DoubleTensor& value = values[batched_ids_[id]];
+        if (!is_batched_[id]) {
+          point_result.push_back(value);
+          continue;
+        }
+        const Shape& shape = graph_->operation(id).output_shape();
+        const auto begin = value.flat_values().begin() + i * shape.size();
+        point_result.push_back(DoubleTensor::FromFlatData(
+            shape, std::vector<double>(begin, begin + shape.size())));
+      }
+    }
+  }
+  return result;
+}
+
+}  // namespace tf_opt
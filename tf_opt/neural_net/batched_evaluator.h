@@ -0,0 +1,99 @@
+// Copyright 2026 The tf.opt Authors.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef TF_OPT_NEURAL_NET_BATCHED_EVALUATOR_H_
+#define TF_OPT_NEURAL_NET_BATCHED_EVALUATOR_H_
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+#include "absl/container/flat_hash_map.h"
+#include "absl/status/statusor.h"
+#include "tf_opt/neural_net/neural_net_graph.h"
+#include "tf_opt/tensor/tensor.h"
+
+namespace tf_opt {
+
+// Returns a graph evaluating graph at batch_size points at once, stacked
+// along a new leading (batch) dimension.
+//
+// Each VariableOperation of shape S becomes one of shape [batch_size, S], and
+// so does every operation that depends on a variable: its value at point i
+// is the slice i of its batched value. The other operations, e.g. the
+// weights, are copied unchanged. Every operation keeps its name, with a
+// batched shape if it depends on a variable.
+//
+// The operations are rewritten so that the kernels see large tensors:
+//   * The leading dimensions of the left operand of a MatMul (or fused
+//     MatMul) with a rank 2 right operand are merged with the batch
+//     dimension, for a single large matrix product.
+//   * The batch dimension of convolutions and max pools is merged with their
+//     own leading (batch) dimension.
+//   * The other operations broadcast over the batch dimension, or have their
+//     axes shifted by one.
+// Returns an Unimplemented error for the operations whose batched form is
+// not supported: a Concat of batched and unbatched inputs, and an
+// EmbeddingLookup, convolution or fused operation whose weights depend on a
+// variable.
+absl::StatusOr<NeuralNetGraph> BatchGraph(const NeuralNetGraph& graph,
+                                          int64_t batch_size);
+
+// Evaluates a NeuralNetGraph on DoubleTensors at many points, by chunks of
+// batch_size points, with the batched graph of BatchGraph(). This amortizes
+// the per-operation overhead of evaluation over the points of a chunk, and
+// runs the matrix products on large matrices.
+//
+// Example use:
+//   TFOPT_ASSIGN_OR_RETURN(BatchedEvaluator evaluator,
+//                          BatchedEvaluator::Create(&graph, 256));
+//   std::vector<std::vector<DoubleTensor>> outputs =
+//       evaluator.Evaluate(points, {output_id});
+//   // outputs[i][0] is the value of output_id at points[i].
+class BatchedEvaluator {
+ public:
+  // The graph must outlive this. batch_size must be positive.
+  static absl::StatusOr<BatchedEvaluator> Create(const NeuralNetGraph* graph,
+                                                 int64_t batch_size);
+
+  int64_t batch_size() const { return batch_size_; }
+
+  const NeuralNetGraph& batched_graph() const { return batched_graph_; }
+
+  // Returns the values of the operations "output_ids" of graph at each point,
+  // where result[i][j] is the value of output_ids[j] at points[i]. Each point
+  // must give a value to every variable of graph, with its shape. The last
+  // chunk is padded with copies of the last point.
+  std::vector<std::vector<DoubleTensor>> Evaluate(
+      const std::vector<absl::flat_hash_map<std::string, DoubleTensor>>&
+          points,
+      const std::vector<int>& output_ids) const;
+
+ private:
+  BatchedEvaluator(const NeuralNetGraph* graph, int64_t batch_size,
+                   NeuralNetGraph batched_graph);
+
+  const NeuralNetGraph* graph_;
+  int64_t batch_size_;
+  NeuralNetGraph batched_graph_;
+
+  // The id in batched_graph_ of each operation of graph_, and whether its
+  // value has a batch dimension.
+  std::vector<int> batched_ids_;
+  std::vector<bool> is_batched_;
+};
+
+}  // namespace tf_opt
+
+#endif  // TF_OPT_NEURAL_NET_BATCHED_EVALUATOR_H_
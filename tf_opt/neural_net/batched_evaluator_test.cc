@@ -0,0 +1,262 @@
+// Copyright 2026 The tf.opt Authors.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "tf_opt/neural_net/batched_evaluator.h"
+
+#include <cstdint>
+#include <memory>
+#include <numeric>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "gtest/gtest.h"
+#include "absl/container/flat_hash_map.h"
+#include "absl/status/status.h"
+#include "absl/status/statusor.h"
+#include "tf_opt/neural_net/double_evaluator.h"
+#include "tf_opt/neural_net/neural_net_graph.h"
+#include "tf_opt/neural_net/operation_testing.h"
+#include "tf_opt/neural_net/ops/all_operations.h"
+#include "tf_opt/open_source/status_matchers.h"
+#include "tf_opt/tensor/element_operations.h"
+#include "tf_opt/tensor/shape.h"
+#include "tf_opt/tensor/tensor.h"
+#include "tf_opt/tensor/tensor_testing.h"
+#include "tf_opt/tensor/window.h"
+
+namespace tf_opt {
+namespace {
+
+using VariableValues = absl::flat_hash_map<std::string, DoubleTensor>;
+
+// num_points values of the variable x of the given shape.
+std::vector<VariableValues> MakePoints(const Shape& shape,
+                                       const int num_points) {
+  std::vector<VariableValues> result;
+  for (int i = 0; i < num_points; ++i) {
+    result.push_back({{"x", MakeWeights(shape, 10 + i)}});
+  }
+  return result;
+}
+
+// Checks that evaluator gives the values of every operation of graph at each
+// point, as evaluated one point at a time.
+void ExpectSameAsPointwise(const NeuralNetGraph& graph,
+                           const BatchedEvaluator& evaluator,
+                           const std::vector<VariableValues>& points) {
+  std::vector<int> all_ids(graph.num_operations());
+  std::iota(all_ids.begin(), all_ids.end(), 0);
+  const std::vector<std::vector<DoubleTensor>> batched_values =
+      evaluator.Evaluate(points, all_ids);
+  ASSERT_EQ(batched_values.size(), points.size());
+  for (int i = 0; i < points.size(); ++i) {
+    DoubleEvaluator point_evaluator(points[i]);
+    const std::vector<DoubleTensor> expected = graph.Evaluate(&point_evaluator);
+    ASSERT_EQ(batched_values[i].size(), expected.size());
+    for (int id = 0; id < graph.num_operations(); ++id) {
+      const DoubleTensor& value = batched_values[i][id];
+      ASSERT_EQ(value.dimension(), expected[id].dimension())
+          << graph.operation(id).name();
+      for (int64_t j = 0; j < value.size(); ++j) {
+        EXPECT_NEAR(value.flat_value(j), expected[id].flat_value(j), 1e-9)
+            << graph.operation(id).name() << " at point " << i;
+      }
+    }
+  }
+}
+
+Shape BatchedShapeOf(const BatchedEvaluator& evaluator,
+                     const std::string& name) {
+  const NeuralNetGraph& batched = evaluator.batched_graph();
+  return batched.operation(batched.OperationIdOrDie(name)).output_shape();
+}
+
+TEST(BatchGraphTest, BatchesDenseNetwork) {
+  NeuralNetGraph graph;
+  const int x = AddToGraph(VariableOperation::Create("x", Shape({2, 4})), {},
+                           &graph);
+  const int w1 = AddConstant("w1", MakeWeights(Shape({4, 5}), 1), &graph);
+  const int b1 = AddConstant("b1", MakeWeights(Shape({5}), 2), &graph);
+  const int w2 = AddConstant("w2", MakeWeights(Shape({5, 3}), 3), &graph);
+  const int matmul1 = AddToGraph(
+      MatmulOperation::Create("matmul1", Shape({2, 4}), Shape({4, 5})),
+      {x, w1}, &graph);
+  const int add1 = AddToGraph(
+      AddOperation::Create("add1", Shape({2, 5}), Shape({5})), {matmul1, b1},
+      &graph);
+  const int relu1 =
+      AddToGraph(ReluOperation::Create("relu1", Shape({2, 5})), {add1},
+                 &graph);
+  const int matmul2 = AddToGraph(
+      MatmulOperation::Create("matmul2", Shape({2, 5}), Shape({5, 3})),
+      {relu1, w2}, &graph);
+  // The variable on the right of a MatMul broadcasts instead.
+  AddToGraph(MatmulOperation::Create("gram", Shape({3, 2}), Shape({2, 3})),
+             {AddToGraph(ReshapeOperation::Create("flipped", Shape({2, 3}),
+                                                  Shape({3, 2})),
+                         {matmul2}, &graph),
+              matmul2},
+             &graph);
+
+  TFOPT_ASSERT_OK_AND_ASSIGN(const BatchedEvaluator evaluator,
+                             BatchedEvaluator::Create(&graph, 2));
+  EXPECT_EQ(evaluator.batch_size(), 2);
+  EXPECT_EQ(BatchedShapeOf(evaluator, "x"), Shape({2, 2, 4}));
+  EXPECT_EQ(BatchedShapeOf(evaluator, "w1"), Shape({4, 5}));
+  // A single product of a [4, 4] and a [4, 5] matrix.
+  EXPECT_EQ(BatchedShapeOf(evaluator, "matmul1/merged_batch"),
+            Shape({4, 5}));
+  EXPECT_EQ(BatchedShapeOf(evaluator, "matmul1"), Shape({2, 2, 5}));
+  EXPECT_EQ(BatchedShapeOf(evaluator, "gram"), Shape({2, 3, 3}));
+  // Two full chunks and one padded chunk.
+  ExpectSameAsPointwise(graph, evaluator, MakePoints(Shape({2, 4}), 5));
+}
+
+TEST(BatchGraphTest, BatchesConvolutionAndAxisOperations) {
+  NeuralNetGraph graph;
+  const int x = AddToGraph(
+      VariableOperation::Create("x", Shape({1, 4, 4, 2})), {}, &graph);
+  const int filter =
+      AddConstant("filter", MakeWeights(Shape({2, 2, 2, 3}), 1), &graph);
+  const int conv = AddToGraph(
+      Conv2dOperation::Create("conv", Shape({1, 4, 4, 2}),
+                              Shape({2, 2, 2, 3}), Position2D(1, 1),
+                              PaddingType::SAME),
+      {x, filter}, &graph);
+  const int relu = AddToGraph(
+      ReluOperation::Create("relu", Shape({1, 4, 4, 3})), {conv}, &graph);
+  const int pool = AddToGraph(
+      MaxpoolOperation::Create("pool", Shape({1, 4, 4, 3}), Position2D(2, 2),
+                               Position2D(2, 2), PaddingType::VALID),
+      {relu}, &graph);
+  const int flat = AddToGraph(
+      ReshapeOperation::Create("flat", Shape({1, 2, 2, 3}), Shape({1, 12})),
+      {pool}, &graph);
+  const int slice = AddToGraph(
+      SliceOperation::Create("slice", Shape({1, 12}), {0, 2}, {1, 6}), {flat},
+      &graph);
+  const int squeeze = AddToGraph(
+      SqueezeOperation::Create("squeeze", Shape({1, 6}), {0}), {slice},
+      &graph);
+  const int expand = AddToGraph(
+      ExpandDimsOperation::Create("expand", Shape({6}), 0), {squeeze},
+      &graph);
+  const int concat = AddToGraph(
+      ConcatOperation::Create("concat", {Shape({1, 6}), Shape({1, 12})}, 1),
+      {expand, flat}, &graph);
+  const int sum = AddToGraph(
+      ReduceSumOperation::Create("sum", Shape({1, 18}), {1}), {concat},
+      &graph);
+  const int max = AddToGraph(
+      ReduceMaxOperation::Create("max", Shape({1, 18}), {1}), {concat},
+      &graph);
+  AddToGraph(SubtractOperation::Create("spread", Shape({1}), Shape({1})),
+             {max, sum}, &graph);
+
+  TFOPT_ASSERT_OK_AND_ASSIGN(const BatchedEvaluator evaluator,
+                             BatchedEvaluator::Create(&graph, 3));
+  EXPECT_EQ(BatchedShapeOf(evaluator, "conv/merged_batch"),
+            Shape({3, 4, 4, 3}));
+  EXPECT_EQ(BatchedShapeOf(evaluator, "squeeze"), Shape({3, 6}));
+  EXPECT_EQ(BatchedShapeOf(evaluator, "concat"), Shape({3, 1, 18}));
+  EXPECT_EQ(BatchedShapeOf(evaluator, "sum"), Shape({3, 1}));
+  ExpectSameAsPointwise(graph, evaluator, MakePoints(Shape({1, 4, 4, 2}), 3));
+}
+
+TEST(BatchGraphTest, SqueezeWithoutAxesKeepsBatchOfOne) {
+  NeuralNetGraph graph;
+  const int x =
+      AddToGraph(VariableOperation::Create("x", Shape({1, 3})), {}, &graph);
+  const int squeeze = AddToGraph(
+      SqueezeOperation::Create("squeeze", Shape({1, 3}), {}), {x}, &graph);
+  const int relu =
+      AddToGraph(ReluOperation::Create("relu", Shape({3})), {squeeze}, &graph);
+  // Has no dimension of size 1 to remove.
+  AddToGraph(SqueezeOperation::Create("identity", Shape({3}), {}), {relu},
+             &graph);
+
+  for (const int batch_size : {1, 3}) {
+    TFOPT_ASSERT_OK_AND_ASSIGN(const BatchedEvaluator evaluator,
+                               BatchedEvaluator::Create(&graph, batch_size));
+    EXPECT_EQ(BatchedShapeOf(evaluator, "squeeze"), Shape({batch_size, 3}));
+    EXPECT_EQ(BatchedShapeOf(evaluator, "identity"), Shape({batch_size, 3}));
+    ExpectSameAsPointwise(graph, evaluator, MakePoints(Shape({1, 3}), 4));
+  }
+}
+
+TEST(BatchGraphTest, BatchesFusedOperations) {
+  NeuralNetGraph graph;
+  const int x = AddToGraph(
+      VariableOperation::Create("x", Shape({1, 3, 3, 2})), {}, &graph);
+  const int filter =
+      AddConstant("filter", MakeWeights(Shape({2, 2, 2, 4}), 1), &graph);
+  const int conv_bias = AddConstant("conv_bias", MakeWeights(Shape({4}), 2),
+                                    &graph);
+  const int conv = AddToGraph(
+      FusedLinearOperation::CreateConv2d(
+          "conv", Shape({1, 3, 3, 2}), Shape({2, 2, 2, 4}), Shape({4}),
+          Position2D(1, 1), PaddingType::VALID, Activation::kRelu),
+      {x, filter, conv_bias}, &graph);
+  const int w = AddConstant("w", MakeWeights(Shape({4, 3}), 3), &graph);
+  const int b = AddConstant("b", MakeWeights(Shape({3}), 4), &graph);
+  AddToGraph(FusedLinearOperation::CreateMatmul(
+                 "dense", Shape({1, 2, 2, 4}), Shape({4, 3}), Shape({3}),
+                 Activation::kClippedRelu, 0.5),
+             {conv, w, b}, &graph);
+
+  TFOPT_ASSERT_OK_AND_ASSIGN(const BatchedEvaluator evaluator,
+                             BatchedEvaluator::Create(&graph, 4));
+  EXPECT_EQ(BatchedShapeOf(evaluator, "dense/merged_batch"), Shape({16, 3}));
+  EXPECT_EQ(BatchedShapeOf(evaluator, "dense"), Shape({4, 1, 2, 2, 3}));
+  ExpectSameAsPointwise(graph, evaluator, MakePoints(Shape({1, 3, 3, 2}), 6));
+}
+
+TEST(BatchGraphTest, KeepsOperationsIndependentOfVariables) {
+  NeuralNetGraph graph;
+  const int x =
+      AddToGraph(VariableOperation::Create("x", Shape({3})), {}, &graph);
+  const int c = AddConstant("c", MakeWeights(Shape({2, 3}), 1), &graph);
+  const int relu_c =
+      AddToGraph(ReluOperation::Create("relu_c", Shape({2, 3})), {c}, &graph);
+  AddToGraph(MultiplyOperation::Create("product", Shape({3}), Shape({2, 3})),
+             {x, relu_c}, &graph);
+
+  TFOPT_ASSERT_OK_AND_ASSIGN(const BatchedEvaluator evaluator,
+                             BatchedEvaluator::Create(&graph, 2));
+  EXPECT_EQ(BatchedShapeOf(evaluator, "relu_c"), Shape({2, 3}));
+  // x is padded to [2, 1, 3] to broadcast against relu_c.
+  EXPECT_EQ(BatchedShapeOf(evaluator, "product/batch_input0"),
+            Shape({2, 1, 3}));
+  EXPECT_EQ(BatchedShapeOf(evaluator, "product"), Shape({2, 2, 3}));
+  ExpectSameAsPointwise(graph, evaluator, MakePoints(Shape({3}), 3));
+}
+
+TEST(BatchGraphTest, RejectsUnsupportedOperations) {
+  NeuralNetGraph graph;
+  const int x = AddToGraph(VariableOperation::Create("x", Shape({4, 3})), {},
+                           &graph);
+  const int ids = AddConstant("ids", MakeWeights(Shape({1, 2, 4}), 1),
+                              &graph);
+  AddToGraph(EmbeddingLookupOperation::Create("lookup", Shape({4, 3}),
+                                              Shape({1, 2, 4})),
+             {x, ids}, &graph);
+  EXPECT_EQ(BatchGraph(graph, 2).status().code(),
+            absl::StatusCode::kUnimplemented);
+  EXPECT_EQ(BatchGraph(NeuralNetGraph(), 0).status().code(),
+            absl::StatusCode::kInvalidArgument);
+}
+
+}  // namespace
+}  // namespace tf_opt
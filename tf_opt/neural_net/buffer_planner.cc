@@ -0,0 +1,106 @@
+// Copyright 2026 The tf.opt Authors.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "tf_opt/neural_net/buffer_planner.h"
+
+#include <algorithm>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+#include "ortools/base/logging.h"
+#include "absl/container/flat_hash_map.h"
+#include "absl/strings/str_cat.h"
+
+namespace tf_opt {
+namespace {
+
+// The smallest power of two >= size, for size >= 1.
+int64_t SizeBucket(const int64_t size) {
+  int64_t bucket = 1;
+  while (bucket < size) {
+    bucket *= 2;
+  }
+  return bucket;
+}
+
+}  // namespace
+
+std::string BufferPlan::Report(const int64_t bytes_per_element) const {
+  return absl::StrCat(
+      "Buffer plan for ", buffer.size(), " operations and ", outputs.size(),
+      " outputs: ", num_buffers(), " buffers, planned peak ",
+      planned_size * bytes_per_element, " bytes, live peak ",
+      peak_live_size * bytes_per_element, " bytes, without reuse ",
+      unplanned_size * bytes_per_element, " bytes.");
+}
+
+BufferPlan PlanBuffers(const NeuralNetGraph& graph,
+                       const std::vector<int>& outputs) {
+  const int num_operations = graph.num_operations();
+  BufferPlan plan;
+  plan.outputs = outputs;
+  plan.buffer.assign(num_operations, -1);
+  plan.last_uses.resize(num_operations);
+
+  // The last operation reading each value, or num_operations for outputs.
+  std::vector<int> last_use(num_operations);
+  for (int id = 0; id < num_operations; ++id) {
+    const std::vector<int>& consumers = graph.consumers(id);
+    last_use[id] = consumers.empty() ? id : consumers.back();
+  }
+  for (const int output : outputs) {
+    CHECK_GE(output, 0);
+    CHECK_LT(output, num_operations);
+    last_use[output] = num_operations;
+  }
+  for (int id = 0; id < num_operations; ++id) {
+    if (last_use[id] < num_operations) {
+      plan.last_uses[last_use[id]].push_back(id);
+    }
+  }
+
+  // The free buffers of each size bucket.
+  absl::flat_hash_map<int64_t, std::vector<int>> free_buffers;
+  int64_t live_size = 0;
+  for (int id = 0; id < num_operations; ++id) {
+    const int64_t size = graph.operation(id).output_shape().size();
+    const int64_t bucket = SizeBucket(std::max<int64_t>(size, 1));
+    std::vector<int>& free = free_buffers[bucket];
+    if (free.empty()) {
+      plan.buffer[id] = plan.num_buffers();
+      plan.buffer_capacities.push_back(bucket);
+      plan.planned_size += bucket;
+    } else {
+      plan.buffer[id] = free.back();
+      free.pop_back();
+    }
+    plan.unplanned_size += size;
+    // The inputs are still live while the operation is evaluated.
+    live_size += size;
+    plan.peak_live_size = std::max(plan.peak_live_size, live_size);
+    for (const int dead : plan.last_uses[id]) {
+      live_size -= graph.operation(dead).output_shape().size();
+      free_buffers[plan.buffer_capacities[plan.buffer[dead]]].push_back(
+          plan.buffer[dead]);
+    }
+  }
+  return plan;
+}
+
+BufferPlan PlanBuffers(const NeuralNetGraph& graph) {
+  return PlanBuffers(graph, graph.Sinks());
+}
+
+}  // namespace tf_opt
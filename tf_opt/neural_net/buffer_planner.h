@@ -0,0 +1,122 @@
+// Copyright 2026 The tf.opt Authors.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef TF_OPT_NEURAL_NET_BUFFER_PLANNER_H_
+#define TF_OPT_NEURAL_NET_BUFFER_PLANNER_H_
+
+#include <algorithm>
+#include <cstdint>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "ortools/base/logging.h"
+#include "tf_opt/neural_net/neural_net_graph.h"
+#include "tf_opt/neural_net/operation_evaluator.h"
+
+namespace tf_opt {
+
+// A memory plan for evaluating a NeuralNetGraph in the order of its ids.
+//
+// The output of an operation is live from its evaluation until the
+// evaluation of its last consumer, or until the end for the outputs of the
+// graph. Each output is assigned a buffer whose capacity is its size rounded
+// up to a power of two (its size bucket). A buffer is reused by a later
+// operation of the same bucket once the output it holds is dead. All sizes
+// are numbers of tensor elements.
+struct BufferPlan {
+  // The ids of the operations whose values are kept until the end.
+  std::vector<int> outputs;
+
+  // The buffer of each operation, indexed by operation id.
+  std::vector<int> buffer;
+
+  // The capacity of each buffer.
+  std::vector<int64_t> buffer_capacities;
+
+  // For each operation id, the inputs whose last use is this operation, in
+  // increasing order. They can be freed once the operation is evaluated.
+  std::vector<std::vector<int>> last_uses;
+
+  // The largest total size of the values live at the same time.
+  int64_t peak_live_size = 0;
+
+  // The sum of the buffer capacities: the peak footprint of the plan.
+  int64_t planned_size = 0;
+
+  // The sum of the sizes of all values, i.e. the footprint without reuse.
+  int64_t unplanned_size = 0;
+
+  int num_buffers() const { return buffer_capacities.size(); }
+
+  // A human readable summary of the plan, with sizes in bytes.
+  std::string Report(int64_t bytes_per_element) const;
+};
+
+// Plans the buffers to evaluate graph, keeping the values of the operations
+// "outputs". Requires the ids of outputs to be valid.
+BufferPlan PlanBuffers(const NeuralNetGraph& graph,
+                       const std::vector<int>& outputs);
+
+// Like above, with the sinks of graph as outputs.
+BufferPlan PlanBuffers(const NeuralNetGraph& graph);
+
+// Evaluates graph like NeuralNetGraph::Evaluate(), but frees each
+// intermediate value after its last use according to plan, so that at most
+// plan.peak_live_size elements are live at once. Returns the values of
+// plan.outputs, in order.
+template <typename T>
+std::vector<T> EvaluateWithPlan(const NeuralNetGraph& graph,
+                                const BufferPlan& plan,
+                                OperationEvaluator<T>* evaluator);
+
+// ///////////////////////////// Implementation ////////////////////////////////
+
+template <typename T>
+std::vector<T> EvaluateWithPlan(const NeuralNetGraph& graph,
+                                const BufferPlan& plan,
+                                OperationEvaluator<T>* evaluator) {
+  CHECK(evaluator != nullptr);
+  CHECK_EQ(plan.last_uses.size(), graph.num_operations());
+  std::vector<T> values(graph.num_operations());
+  std::vector<const T*> inputs;
+  for (int id = 0; id < graph.num_operations(); ++id) {
+    inputs.clear();
+    for (const int input : graph.inputs(id)) {
+      inputs.push_back(&values[input]);
+    }
+    values[id] = evaluator->Evaluate(&graph.operation(id), inputs);
+    for (const int dead : plan.last_uses[id]) {
+      values[dead] = T();
+    }
+  }
+  // Each value is moved into the last of its positions in plan.outputs and
+  // copied into the others.
+  const std::vector<int>& outputs = plan.outputs;
+  std::vector<T> result(outputs.size());
+  for (int i = static_cast<int>(outputs.size()) - 1; i >= 0; --i) {
+    const auto later =
+        std::find(outputs.begin() + i + 1, outputs.end(), outputs[i]);
+    if (later == outputs.end()) {
+      result[i] = std::move(values[outputs[i]]);
+    } else {
+      result[i] = result[later - outputs.begin()];
+    }
+  }
+  return result;
+}
+
+}  // namespace tf_opt
+
+#endif  // TF_OPT_NEURAL_NET_BUFFER_PLANNER_H_
@@ -0,0 +1,151 @@
+// Copyright 2026 The tf.opt Authors.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "tf_opt/neural_net/buffer_planner.h"
+
+#include <memory>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "gmock/gmock.h"
+#include "gtest/gtest.h"
+#include "absl/strings/str_cat.h"
+#include "tf_opt/neural_net/double_evaluator.h"
+#include "tf_opt/neural_net/neural_net_graph.h"
+#include "tf_opt/neural_net/operation_testing.h"
+#include "tf_opt/neural_net/ops/all_operations.h"
+#include "tf_opt/tensor/shape.h"
+#include "tf_opt/tensor/tensor.h"
+#include "tf_opt/tensor/tensor_testing.h"
+
+namespace tf_opt {
+namespace {
+
+using ::testing::ElementsAre;
+using ::testing::HasSubstr;
+using ::testing::IsEmpty;
+
+using Matrix = std::vector<std::vector<double>>;
+
+// x -> relu0 -> relu1 -> ... -> relu{length-1}, all of shape [1, 4].
+NeuralNetGraph MakeReluChain(const int length) {
+  NeuralNetGraph graph;
+  const Shape shape({1, 4});
+  int previous = AddToGraph(VariableOperation::Create("x", shape), {}, &graph);
+  for (int i = 0; i < length; ++i) {
+    previous = AddToGraph(ReluOperation::Create(absl::StrCat("relu", i), shape),
+                          {previous}, &graph);
+  }
+  return graph;
+}
+
+TEST(BufferPlannerTest, ChainAlternatesBetweenTwoBuffers) {
+  const NeuralNetGraph graph = MakeReluChain(4);
+  const BufferPlan plan = PlanBuffers(graph);
+  EXPECT_THAT(plan.outputs, ElementsAre(4));
+  EXPECT_THAT(plan.buffer, ElementsAre(0, 1, 0, 1, 0));
+  EXPECT_THAT(plan.buffer_capacities, ElementsAre(4, 4));
+  EXPECT_THAT(plan.last_uses[0], IsEmpty());
+  EXPECT_THAT(plan.last_uses[1], ElementsAre(0));
+  EXPECT_THAT(plan.last_uses[4], ElementsAre(3));
+  EXPECT_EQ(plan.peak_live_size, 8);
+  EXPECT_EQ(plan.planned_size, 8);
+  EXPECT_EQ(plan.unplanned_size, 20);
+  EXPECT_THAT(plan.Report(8),
+              HasSubstr("2 buffers, planned peak 64 bytes, live peak 64 "
+                        "bytes, without reuse 160 bytes"));
+}
+
+TEST(BufferPlannerTest, OutputsAreNeverReused) {
+  const NeuralNetGraph graph = MakeReluChain(3);
+  const BufferPlan plan = PlanBuffers(graph, {1, 3});
+  // relu0 is never freed, so relu2 needs a third buffer.
+  EXPECT_THAT(plan.buffer, ElementsAre(0, 1, 0, 2));
+  EXPECT_THAT(plan.last_uses[1], ElementsAre(0));
+  EXPECT_THAT(plan.last_uses[2], IsEmpty());
+  EXPECT_THAT(plan.last_uses[3], ElementsAre(2));
+  EXPECT_EQ(plan.planned_size, 12);
+}
+
+TEST(BufferPlannerTest, BuffersAreBucketedBySize) {
+  NeuralNetGraph graph;
+  const int x = AddToGraph(VariableOperation::Create("x", Shape({1, 3})), {},
+                           &graph);
+  const int w = AddConstant("w", DoubleTensor(Shape({3, 5}), 1.0), &graph);
+  const int matmul = AddToGraph(
+      MatmulOperation::Create("matmul", Shape({1, 3}), Shape({3, 5})), {x, w},
+      &graph);
+  const int relu = AddToGraph(ReluOperation::Create("relu", Shape({1, 5})),
+                              {matmul}, &graph);
+  AddToGraph(ReluOperation::Create("relu2", Shape({1, 5})), {relu}, &graph);
+  const BufferPlan plan = PlanBuffers(graph);
+  // Sizes 3, 15, 5, 5, 5 go to buckets 4, 16, 8, 8, 8.
+  EXPECT_THAT(plan.buffer, ElementsAre(0, 1, 2, 3, 2));
+  EXPECT_THAT(plan.buffer_capacities, ElementsAre(4, 16, 8, 8));
+  EXPECT_EQ(plan.peak_live_size, 23);
+  EXPECT_EQ(plan.planned_size, 36);
+  EXPECT_EQ(plan.unplanned_size, 33);
+}
+
+TEST(BufferPlannerTest, UnusedSinkIsFreedRightAway) {
+  const NeuralNetGraph graph = MakeReluChain(2);
+  const BufferPlan plan = PlanBuffers(graph, {1});
+  EXPECT_THAT(plan.last_uses[2], ElementsAre(2));
+}
+
+TEST(BufferPlannerTest, EvaluateWithPlanMatchesEvaluate) {
+  NeuralNetGraph graph;
+  const int x = AddToGraph(VariableOperation::Create("x", Shape({1, 3})), {},
+                           &graph);
+  const int w = AddConstant(
+      "w", DoubleTensor(Matrix{{1.0, 2.0}, {3.0, 4.0}, {5.0, 6.0}}), &graph);
+  const int b = AddConstant("b", DoubleTensor({1.0, -30.0}), &graph);
+  const int matmul = AddToGraph(
+      MatmulOperation::Create("matmul", Shape({1, 3}), Shape({3, 2})), {x, w},
+      &graph);
+  const int add = AddToGraph(
+      AddOperation::Create("add", Shape({1, 2}), Shape({2})), {matmul, b},
+      &graph);
+  const int relu = AddToGraph(ReluOperation::Create("relu", Shape({1, 2})),
+                              {add}, &graph);
+
+  DoubleEvaluator evaluator({{"x", DoubleTensor(Matrix{{1.0, 2.0, 3.0}})}});
+  const std::vector<DoubleTensor> expected = graph.Evaluate(&evaluator);
+  const BufferPlan plan = PlanBuffers(graph, {matmul, relu});
+  EXPECT_THAT(EvaluateWithPlan(graph, plan, &evaluator),
+              ElementsAre(DoubleTensorEquals(expected[matmul]),
+                          DoubleTensorEquals(expected[relu])));
+  EXPECT_THAT(expected[relu],
+              DoubleTensorEquals(DoubleTensor(Matrix{{23.0, 0.0}})));
+}
+
+TEST(BufferPlannerTest, EvaluateWithPlanRepeatedOutputs) {
+  NeuralNetGraph graph;
+  const int x =
+      AddToGraph(VariableOperation::Create("x", Shape({2})), {}, &graph);
+  const int relu =
+      AddToGraph(ReluOperation::Create("relu", Shape({2})), {x}, &graph);
+
+  DoubleEvaluator evaluator({{"x", DoubleTensor({-1.0, 2.0})}});
+  const BufferPlan plan = PlanBuffers(graph, {relu, x, relu});
+  const DoubleTensor expected_relu({0.0, 2.0});
+  EXPECT_THAT(EvaluateWithPlan(graph, plan, &evaluator),
+              ElementsAre(DoubleTensorEquals(expected_relu),
+                          DoubleTensorEquals(DoubleTensor({-1.0, 2.0})),
+                          DoubleTensorEquals(expected_relu)));
+}
+
+}  // namespace
+}  // namespace tf_opt
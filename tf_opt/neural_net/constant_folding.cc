@@ -0,0 +1,101 @@
+// Copyright 2026 The tf.opt Authors.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "tf_opt/neural_net/constant_folding.h"
+
+#include <memory>
+#include <optional>
+#include <utility>
+#include <vector>
+
+#include "absl/status/status.h"
+#include "absl/status/statusor.h"
+#include "tf_opt/neural_net/double_evaluator.h"
+#include "tf_opt/neural_net/neural_net_graph.h"
+#include "tf_opt/neural_net/op_registry.h"
+#include "tf_opt/neural_net/operation.h"
+#include "tf_opt/neural_net/ops/all_operations.h"
+#include "tf_opt/open_source/status_macros.h"
+#include "tf_opt/tensor/tensor.h"
+
+namespace tf_opt {
+
+namespace {
+
+bool IsConstantOperation(const Operation& op) {
+  return dynamic_cast<const ConstantOperation*>(&op) != nullptr;
+}
+
+}  // namespace
+
+absl::StatusOr<NeuralNetGraph> FoldConstants(const NeuralNetGraph& graph,
+                                             ConstantFoldingStats* stats) {
+  const int num_operations = graph.num_operations();
+  // The value of each operation that only depends on constants.
+  std::vector<std::optional<DoubleTensor>> values(num_operations);
+  DoubleEvaluator evaluator;
+  int num_folded_operations = 0;
+  for (int id = 0; id < num_operations; ++id) {
+    const Operation& op = graph.operation(id);
+    if (dynamic_cast<const VariableOperation*>(&op) != nullptr) continue;
+    std::vector<const DoubleTensor*> inputs;
+    for (const int input : graph.inputs(id)) {
+      if (!values[input].has_value()) break;
+      inputs.push_back(&*values[input]);
+    }
+    if (inputs.size() < graph.inputs(id).size()) continue;
+    values[id] = evaluator.Evaluate(&op, inputs);
+    if (!IsConstantOperation(op)) ++num_folded_operations;
+  }
+
+  // A constant is kept if it is a sink or if a non-constant operation uses
+  // it; all the non-constant operations are kept.
+  std::vector<bool> kept(num_operations, true);
+  for (int id = 0; id < num_operations; ++id) {
+    if (!values[id].has_value() || graph.consumers(id).empty()) continue;
+    kept[id] = false;
+    for (const int consumer : graph.consumers(id)) {
+      if (!values[consumer].has_value()) kept[id] = true;
+    }
+  }
+
+  NeuralNetGraph result;
+  std::vector<int> new_ids(num_operations, -1);
+  for (int id = 0; id < num_operations; ++id) {
+    if (!kept[id]) continue;
+    const Operation& op = graph.operation(id);
+    std::unique_ptr<Operation> new_op;
+    std::vector<int> new_inputs;
+    if (values[id].has_value()) {
+      new_op = std::make_unique<ConstantOperation>(op.name(),
+                                                   *std::move(values[id]));
+    } else {
+      TFOPT_ASSIGN_OR_RETURN(new_op,
+                             op_registry::CloneOperation(op, op.name()));
+      for (const int input : graph.inputs(id)) {
+        new_inputs.push_back(new_ids[input]);
+      }
+    }
+    TFOPT_ASSIGN_OR_RETURN(
+        new_ids[id], result.AddOperation(std::move(new_op), new_inputs));
+  }
+  if (stats != nullptr) {
+    stats->num_folded_operations = num_folded_operations;
+    stats->num_removed_operations =
+        num_operations - result.num_operations();
+  }
+  return result;
+}
+
+}  // namespace tf_opt
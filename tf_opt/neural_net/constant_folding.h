@@ -0,0 +1,48 @@
+// Copyright 2026 The tf.opt Authors.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef TF_OPT_NEURAL_NET_CONSTANT_FOLDING_H_
+#define TF_OPT_NEURAL_NET_CONSTANT_FOLDING_H_
+
+#include "absl/status/statusor.h"
+#include "tf_opt/neural_net/neural_net_graph.h"
+
+namespace tf_opt {
+
+struct ConstantFoldingStats {
+  // The operations, other than ConstantOperations, whose inputs are all
+  // constant, and that were evaluated.
+  int num_folded_operations = 0;
+
+  // The operations of the graph that are not in the result: the folded
+  // operations and the constants that are only used by them.
+  int num_removed_operations = 0;
+};
+
+// Presolve that evaluates once, with DoubleEvaluator, the operations that
+// only depend on ConstantOperations, e.g. reshaped or sliced weights, or
+// products of scales. Each one that is used by a non-constant operation, or
+// that is a sink of the graph, becomes a ConstantOperation with the same name
+// and its value; the others, and the constants that only they use, are
+// dropped. The result evaluates to the same values as graph for every
+// operation it keeps, in particular for its sinks.
+//
+// Run it before FoldAffineOperations(), which then sees the folded values as
+// constant operands.
+absl::StatusOr<NeuralNetGraph> FoldConstants(
+    const NeuralNetGraph& graph, ConstantFoldingStats* stats = nullptr);
+
+}  // namespace tf_opt
+
+#endif  // TF_OPT_NEURAL_NET_CONSTANT_FOLDING_H_
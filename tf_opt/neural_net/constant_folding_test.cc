@@ -0,0 +1,139 @@
+// Copyright 2026 The tf.opt Authors.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "tf_opt/neural_net/constant_folding.h"
+
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "gtest/gtest.h"
+#include "absl/status/statusor.h"
+#include "tf_opt/neural_net/double_evaluator.h"
+#include "tf_opt/neural_net/neural_net_graph.h"
+#include "tf_opt/neural_net/operation_testing.h"
+#include "tf_opt/neural_net/ops/all_operations.h"
+#include "tf_opt/open_source/status_matchers.h"
+#include "tf_opt/tensor/shape.h"
+#include "tf_opt/tensor/tensor.h"
+
+namespace tf_opt {
+namespace {
+
+bool IsConstant(const NeuralNetGraph& graph, const std::string& name) {
+  return dynamic_cast<const ConstantOperation*>(
+             &graph.operation(graph.OperationIdOrDie(name))) != nullptr;
+}
+
+// Checks that every operation of folded has the same value as in graph, at x.
+void ExpectSameValues(const NeuralNetGraph& graph,
+                      const NeuralNetGraph& folded, const DoubleTensor& x) {
+  DoubleEvaluator evaluator({{"x", x}});
+  const std::vector<DoubleTensor> values = graph.Evaluate(&evaluator);
+  const std::vector<DoubleTensor> folded_values = folded.Evaluate(&evaluator);
+  for (int id = 0; id < folded.num_operations(); ++id) {
+    const std::string& name = folded.operation(id).name();
+    const DoubleTensor& expected = values[graph.OperationIdOrDie(name)];
+    ASSERT_EQ(folded_values[id].dimension(), expected.dimension()) << name;
+    EXPECT_EQ(folded_values[id].flat_values(), expected.flat_values())
+        << name;
+  }
+}
+
+TEST(FoldConstantsTest, FoldsWeightTransformations) {
+  NeuralNetGraph graph;
+  const int x = AddToGraph(VariableOperation::Create("x", Shape({1, 3})), {},
+                           &graph);
+  const int flat_w = AddConstant(
+      "flat_w", DoubleTensor(std::vector<double>{1, 2, 3, 4, 5, 6, 7, 8}),
+      &graph);
+  const int sliced = AddToGraph(
+      SliceOperation::Create("sliced", Shape({8}), {1}, {6}), {flat_w},
+      &graph);
+  const int w = AddToGraph(
+      ReshapeOperation::Create("w", Shape({6}), Shape({3, 2})), {sliced},
+      &graph);
+  const int matmul = AddToGraph(
+      MatmulOperation::Create("matmul", Shape({1, 3}), Shape({3, 2})),
+      {x, w}, &graph);
+  const int gamma = AddConstant(
+      "gamma", DoubleTensor(std::vector<double>{2, 3}), &graph);
+  const int inv_std = AddConstant(
+      "inv_std", DoubleTensor(std::vector<double>{0.5, 0.25}), &graph);
+  const int scale = AddToGraph(
+      MultiplyOperation::Create("scale", Shape({2}), Shape({2})),
+      {gamma, inv_std}, &graph);
+  AddToGraph(MultiplyOperation::Create("output", Shape({1, 2}), Shape({2})),
+             {matmul, scale}, &graph);
+
+  ConstantFoldingStats stats;
+  TFOPT_ASSERT_OK_AND_ASSIGN(const NeuralNetGraph folded,
+                             FoldConstants(graph, &stats));
+  EXPECT_EQ(stats.num_folded_operations, 3);
+  // sliced, flat_w, gamma and inv_std.
+  EXPECT_EQ(stats.num_removed_operations, 4);
+  EXPECT_EQ(folded.num_operations(), graph.num_operations() - 4);
+  EXPECT_TRUE(IsConstant(folded, "w"));
+  EXPECT_TRUE(IsConstant(folded, "scale"));
+  EXPECT_FALSE(folded.OperationId("sliced").ok());
+  EXPECT_FALSE(folded.OperationId("flat_w").ok());
+  EXPECT_EQ(folded.Sinks().size(), 1);
+  ExpectSameValues(graph, folded,
+                   DoubleTensor(std::vector<std::vector<double>>{
+                       {1.0, -2.0, 0.5}}));
+}
+
+TEST(FoldConstantsTest, KeepsConstantSinks) {
+  NeuralNetGraph graph;
+  const int c = AddConstant(
+      "c", DoubleTensor(std::vector<double>{1, -2, 3}), &graph);
+  const int relu = AddToGraph(ReluOperation::Create("relu", Shape({3})), {c},
+                              &graph);
+  AddToGraph(ReduceSumOperation::Create("sum", Shape({3}), {0}), {relu},
+             &graph);
+  AddToGraph(VariableOperation::Create("x", Shape({3})), {}, &graph);
+
+  ConstantFoldingStats stats;
+  TFOPT_ASSERT_OK_AND_ASSIGN(const NeuralNetGraph folded,
+                             FoldConstants(graph, &stats));
+  EXPECT_EQ(stats.num_folded_operations, 2);
+  EXPECT_EQ(folded.num_operations(), 2);
+  ASSERT_TRUE(IsConstant(folded, "sum"));
+  ExpectSameValues(graph, folded, DoubleTensor(Shape({3}), 0.0));
+}
+
+TEST(FoldConstantsTest, NothingToFold) {
+  NeuralNetGraph graph;
+  const int x = AddToGraph(VariableOperation::Create("x", Shape({1, 2})), {},
+                           &graph);
+  const int w = AddConstant(
+      "w", DoubleTensor(std::vector<std::vector<double>>{{1, 2}, {3, 4}}),
+      &graph);
+  AddToGraph(MatmulOperation::Create("matmul", Shape({1, 2}), Shape({2, 2})),
+             {x, w}, &graph);
+
+  ConstantFoldingStats stats;
+  TFOPT_ASSERT_OK_AND_ASSIGN(const NeuralNetGraph folded,
+                             FoldConstants(graph, &stats));
+  EXPECT_EQ(stats.num_folded_operations, 0);
+  EXPECT_EQ(stats.num_removed_operations, 0);
+  EXPECT_EQ(folded.num_operations(), graph.num_operations());
+  ExpectSameValues(graph, folded,
+                   DoubleTensor(std::vector<std::vector<double>>{{1, 2}}));
+}
+
+}  // namespace
+}  // namespace tf_opt
@@ -0,0 +1,168 @@
+// Copyright 2026 The tf.opt Authors.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "tf_opt/neural_net/double_evaluator.h"
+
+#include <vector>
+
+#include "ortools/base/logging.h"
+#include "tf_opt/tensor/concat.h"
+#include "tf_opt/tensor/convolve.h"
+#include "tf_opt/tensor/embedding_lookup.h"
+#include "tf_opt/tensor/math.h"
+#include "tf_opt/tensor/pooling.h"
+#include "tf_opt/tensor/reduce.h"
+#include "tf_opt/tensor/tensor_view.h"
+
+namespace tf_opt {
+
+DoubleTensor DoubleEvaluator::EvaluateAdd(const AddOperation& op,
+                                          const DoubleTensor& left,
+                                          const DoubleTensor& right) {
+  return Add(left, right);
+}
+
+DoubleTensor DoubleEvaluator::EvaluateClippedRelu(
+    const ClippedReluOperation& op, const DoubleTensor& input) {
+  return ElementwiseClippedRelu(input, op.cap());
+}
+
+DoubleTensor DoubleEvaluator::EvaluateConcat(
+    const ConcatOperation& op, const std::vector<const DoubleTensor*>& inputs) {
+  return Concat(inputs, op.axis());
+}
+
+DoubleTensor DoubleEvaluator::EvaluateConstant(const ConstantOperation& op) {
+  return op.value();
+}
+
+DoubleTensor DoubleEvaluator::EvaluateConv1d(const Conv1dOperation& op,
+                                             const DoubleTensor& value,
+                                             const DoubleTensor& filters) {
+  return Conv1d<double>(value, filters, op.stride(), op.padding()).value();
+}
+
+DoubleTensor DoubleEvaluator::EvaluateConv2d(const Conv2dOperation& op,
+                                             const DoubleTensor& value,
+                                             const DoubleTensor& filters) {
+  return Conv2d<double>(value, filters, op.stride(), op.padding()).value();
+}
+
+DoubleTensor DoubleEvaluator::EvaluateDivide(const DivideOperation& op,
+                                             const DoubleTensor& left,
+                                             const DoubleTensor& right) {
+  return Divide(left, right);
+}
+
+DoubleTensor DoubleEvaluator::EvaluateEmbeddingLookup(
+    const EmbeddingLookupOperation& op, const DoubleTensor& params,
+    const DoubleTensor& ids) {
+  return EmbeddingLookup<double>(params, ids);
+}
+
+DoubleTensor DoubleEvaluator::EvaluateExpandDims(const ExpandDimsOperation& op,
+                                                 const DoubleTensor& input) {
+  return TensorView<double>(input).ExpandDims(op.axis()).ToTensor();
+}
+
+DoubleTensor DoubleEvaluator::EvaluateFusedLinear(
+    const FusedLinearOperation& op, const DoubleTensor& value,
+    const DoubleTensor& weights, const DoubleTensor& bias) {
+  DoubleTensor result =
+      op.matmul() != nullptr
+          ? MatMul(value, weights)
+          : Conv2d<double>(value, weights, op.conv2d()->stride(),
+                           op.conv2d()->padding())
+                .value();
+  BiasActivationInPlace(bias, op.activation(), op.cap(), &result);
+  return result;
+}
+
+DoubleTensor DoubleEvaluator::EvaluateMatmul(const MatmulOperation& op,
+                                             const DoubleTensor& left,
+                                             const DoubleTensor& right) {
+  return MatMul(left, right);
+}
+
+DoubleTensor DoubleEvaluator::EvaluateMaxpool(const MaxpoolOperation& op,
+                                              const DoubleTensor& input) {
+  return MaxPool(input, op.ksize(), op.stride(), op.padding());
+}
+
+DoubleTensor DoubleEvaluator::EvaluateMultiply(const MultiplyOperation& op,
+                                               const DoubleTensor& left,
+                                               const DoubleTensor& right) {
+  return Multiply(left, right);
+}
+
+DoubleTensor DoubleEvaluator::EvaluateReduceMax(const ReduceMaxOperation& op,
+                                                const DoubleTensor& input) {
+  return ReduceMax(input, op.axes());
+}
+
+DoubleTensor DoubleEvaluator::EvaluateReduceMean(const ReduceMeanOperation& op,
+                                                 const DoubleTensor& input) {
+  return ReduceMean(input, op.axes());
+}
+
+DoubleTensor DoubleEvaluator::EvaluateReduceMin(const ReduceMinOperation& op,
+                                                const DoubleTensor& input) {
+  return ReduceMin(input, op.axes());
+}
+
+DoubleTensor DoubleEvaluator::EvaluateReduceSum(const ReduceSumOperation& op,
+                                                const DoubleTensor& input) {
+  return ReduceSum(input, op.axes());
+}
+
+DoubleTensor DoubleEvaluator::EvaluateRelu(const ReluOperation& op,
+                                           const DoubleTensor& input) {
+  return ElementwiseRelu(input);
+}
+
+DoubleTensor DoubleEvaluator::EvaluateReshape(const ReshapeOperation& op,
+                                              const DoubleTensor& input) {
+  return TensorView<double>(input).Reshape(op.output_shape()).ToTensor();
+}
+
+DoubleTensor DoubleEvaluator::EvaluateSlice(const SliceOperation& op,
+                                            const DoubleTensor& input) {
+  return TensorView<double>(input).Slice(op.begin(), op.sizes()).ToTensor();
+}
+
+DoubleTensor DoubleEvaluator::EvaluateSqueeze(const SqueezeOperation& op,
+                                              const DoubleTensor& input) {
+  const TensorView<double> view(input);
+  return (op.axes().empty() ? view.Squeeze() : view.Squeeze(op.axes()))
+      .ToTensor();
+}
+
+DoubleTensor DoubleEvaluator::EvaluateSubtract(const SubtractOperation& op,
+                                               const DoubleTensor& left,
+                                               const DoubleTensor& right) {
+  return Subtract(left, right);
+}
+
+DoubleTensor DoubleEvaluator::EvaluateVariable(const VariableOperation& op) {
+  const auto it = variable_values_.find(op.name());
+  CHECK(it != variable_values_.end())
+      << "No value for variable: " << op.name();
+  CHECK(it->second.dimension() == op.output_shape())
+      << "Value for variable: " << op.name() << " has shape "
+      << it->second.dimension().ToString() << ", expected "
+      << op.output_shape().ToString();
+  return it->second;
+}
+
+}  // namespace tf_opt
@@ -0,0 +1,124 @@
+// Copyright 2026 The tf.opt Authors.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef TF_OPT_NEURAL_NET_DOUBLE_EVALUATOR_H_
+#define TF_OPT_NEURAL_NET_DOUBLE_EVALUATOR_H_
+
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "absl/container/flat_hash_map.h"
+#include "absl/strings/string_view.h"
+#include "tf_opt/neural_net/operation_evaluator.h"
+#include "tf_opt/neural_net/ops/all_operations.h"
+#include "tf_opt/tensor/shape.h"
+#include "tf_opt/tensor/tensor.h"
+
+namespace tf_opt {
+
+// Evaluates operations on DoubleTensors, with the functions of tf_opt/tensor.
+//
+// Each VariableOperation evaluates to the value set for its name, which must
+// have the shape of the variable. Evaluating a variable without a value CHECK
+// fails.
+//
+// Example use:
+//   DoubleEvaluator evaluator({{"x", DoubleTensor({{1.0, 2.0, 3.0}})}});
+//   std::vector<DoubleTensor> values = graph.Evaluate(&evaluator);
+class DoubleEvaluator : public OperationEvaluator<DoubleTensor> {
+ public:
+  DoubleEvaluator() = default;
+  explicit DoubleEvaluator(
+      absl::flat_hash_map<std::string, DoubleTensor> variable_values)
+      : variable_values_(std::move(variable_values)) {}
+
+  void set_variable_value(absl::string_view name, DoubleTensor value) {
+    variable_values_[std::string(name)] = std::move(value);
+  }
+
+  const absl::flat_hash_map<std::string, DoubleTensor>& variable_values()
+      const {
+    return variable_values_;
+  }
+
+ protected:
+  Shape GetShape(const DoubleTensor& tensor) const override {
+    return tensor.dimension();
+  }
+
+  DoubleTensor EvaluateAdd(const AddOperation& op, const DoubleTensor& left,
+                           const DoubleTensor& right) override;
+  DoubleTensor EvaluateClippedRelu(const ClippedReluOperation& op,
+                                   const DoubleTensor& input) override;
+  DoubleTensor EvaluateConcat(
+      const ConcatOperation& op,
+      const std::vector<const DoubleTensor*>& inputs) override;
+  DoubleTensor EvaluateConstant(const ConstantOperation& op) override;
+  DoubleTensor EvaluateConv1d(const Conv1dOperation& op,
+                              const DoubleTensor& value,
+                              const DoubleTensor& filters) override;
+  DoubleTensor EvaluateConv2d(const Conv2dOperation& op,
+                              const DoubleTensor& value,
+                              const DoubleTensor& filters) override;
+  DoubleTensor EvaluateDivide(const DivideOperation& op,
+                              const DoubleTensor& left,
+                              const DoubleTensor& right) override;
+  DoubleTensor EvaluateEmbeddingLookup(const EmbeddingLookupOperation& op,
+                                       const DoubleTensor& params,
+                                       const DoubleTensor& ids) override;
+  DoubleTensor EvaluateExpandDims(const ExpandDimsOperation& op,
+                                  const DoubleTensor& input) override;
+  // Applies the bias and the activation in place on the result of the
+  // linear operation, see BiasActivationInPlace() in math.h.
+  DoubleTensor EvaluateFusedLinear(const FusedLinearOperation& op,
+                                   const DoubleTensor& value,
+                                   const DoubleTensor& weights,
+                                   const DoubleTensor& bias) override;
+  DoubleTensor EvaluateMatmul(const MatmulOperation& op,
+                              const DoubleTensor& left,
+                              const DoubleTensor& right) override;
+  DoubleTensor EvaluateMaxpool(const MaxpoolOperation& op,
+                               const DoubleTensor& input) override;
+  DoubleTensor EvaluateMultiply(const MultiplyOperation& op,
+                                const DoubleTensor& left,
+                                const DoubleTensor& right) override;
+  DoubleTensor EvaluateReduceMax(const ReduceMaxOperation& op,
+                                 const DoubleTensor& input) override;
+  DoubleTensor EvaluateReduceMean(const ReduceMeanOperation& op,
+                                  const DoubleTensor& input) override;
+  DoubleTensor EvaluateReduceMin(const ReduceMinOperation& op,
+                                 const DoubleTensor& input) override;
+  DoubleTensor EvaluateReduceSum(const ReduceSumOperation& op,
+                                 const DoubleTensor& input) override;
+  DoubleTensor EvaluateRelu(const ReluOperation& op,
+                            const DoubleTensor& input) override;
+  DoubleTensor EvaluateReshape(const ReshapeOperation& op,
+                               const DoubleTensor& input) override;
+  DoubleTensor EvaluateSlice(const SliceOperation& op,
+                             const DoubleTensor& input) override;
+  DoubleTensor EvaluateSqueeze(const SqueezeOperation& op,
+                               const DoubleTensor& input) override;
+  DoubleTensor EvaluateSubtract(const SubtractOperation& op,
+                                const DoubleTensor& left,
+                                const DoubleTensor& right) override;
+  DoubleTensor EvaluateVariable(const VariableOperation& op) override;
+
+ private:
+  absl::flat_hash_map<std::string, DoubleTensor> variable_values_;
+};
+
+}  // namespace tf_opt
+
+#endif  // TF_OPT_NEURAL_NET_DOUBLE_EVALUATOR_H_
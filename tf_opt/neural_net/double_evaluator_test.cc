@@ -0,0 +1,254 @@
+// Copyright 2026 The tf.opt Authors.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "tf_opt/neural_net/double_evaluator.h"
+
+#include <cstdint>
+#include <vector>
+
+#include "gmock/gmock.h"
+#include "gtest/gtest.h"
+#include "tf_opt/neural_net/ops/all_operations.h"
+#include "tf_opt/open_source/status_matchers.h"
+#include "tf_opt/tensor/element_operations.h"
+#include "tf_opt/tensor/shape.h"
+#include "tf_opt/tensor/tensor.h"
+#include "tf_opt/tensor/tensor_testing.h"
+#include "tf_opt/tensor/window.h"
+
+namespace tf_opt {
+namespace {
+
+using Matrix = std::vector<std::vector<double>>;
+
+TEST(DoubleEvaluatorTest, Arithmetic) {
+  const DoubleTensor left(Matrix{{1.0, 2.0}, {3.0, 4.0}});
+  const DoubleTensor right({2.0, -1.0});
+  DoubleEvaluator evaluator;
+  TFOPT_ASSERT_OK_AND_ASSIGN(
+      const AddOperation add,
+      AddOperation::Create("add", left.dimension(), right.dimension()));
+  EXPECT_THAT(evaluator.Evaluate(&add, {&left, &right}),
+              DoubleTensorEquals(DoubleTensor(Matrix{{3.0, 1.0}, {5.0, 3.0}})));
+  TFOPT_ASSERT_OK_AND_ASSIGN(
+      const SubtractOperation subtract,
+      SubtractOperation::Create("sub", left.dimension(), right.dimension()));
+  EXPECT_THAT(evaluator.Evaluate(&subtract, {&left, &right}),
+              DoubleTensorEquals(
+                  DoubleTensor(Matrix{{-1.0, 3.0}, {1.0, 5.0}})));
+  TFOPT_ASSERT_OK_AND_ASSIGN(
+      const MultiplyOperation multiply,
+      MultiplyOperation::Create("mul", left.dimension(), right.dimension()));
+  EXPECT_THAT(evaluator.Evaluate(&multiply, {&left, &right}),
+              DoubleTensorEquals(
+                  DoubleTensor(Matrix{{2.0, -2.0}, {6.0, -4.0}})));
+  TFOPT_ASSERT_OK_AND_ASSIGN(
+      const DivideOperation divide,
+      DivideOperation::Create("div", left.dimension(), right.dimension()));
+  EXPECT_THAT(evaluator.Evaluate(&divide, {&left, &right}),
+              DoubleTensorEquals(
+                  DoubleTensor(Matrix{{0.5, -2.0}, {1.5, -4.0}})));
+}
+
+TEST(DoubleEvaluatorTest, MatmulAndActivations) {
+  const DoubleTensor x(Matrix{{1.0, -2.0}});
+  const DoubleTensor w(Matrix{{1.0, 2.0, 0.5}, {3.0, -1.0, 0.5}});
+  DoubleEvaluator evaluator;
+  TFOPT_ASSERT_OK_AND_ASSIGN(
+      const MatmulOperation matmul,
+      MatmulOperation::Create("matmul", x.dimension(), w.dimension()));
+  const DoubleTensor product = evaluator.Evaluate(&matmul, {&x, &w});
+  EXPECT_THAT(product,
+              DoubleTensorEquals(DoubleTensor(Matrix{{-5.0, 4.0, -0.5}})));
+  TFOPT_ASSERT_OK_AND_ASSIGN(
+      const ReluOperation relu,
+      ReluOperation::Create("relu", product.dimension()));
+  EXPECT_THAT(evaluator.Evaluate(&relu, {&product}),
+              DoubleTensorEquals(DoubleTensor(Matrix{{0.0, 4.0, 0.0}})));
+  TFOPT_ASSERT_OK_AND_ASSIGN(
+      const ClippedReluOperation clipped_relu,
+      ClippedReluOperation::Create("clipped_relu", product.dimension(), 3.0));
+  EXPECT_THAT(evaluator.Evaluate(&clipped_relu, {&product}),
+              DoubleTensorEquals(DoubleTensor(Matrix{{0.0, 3.0, 0.0}})));
+}
+
+TEST(DoubleEvaluatorTest, FusedLinear) {
+  const DoubleTensor x(Matrix{{1.0, -2.0}, {0.5, 1.0}});
+  const DoubleTensor w(Matrix{{1.0, 2.0, 0.5}, {3.0, -1.0, 0.5}});
+  const DoubleTensor b({1.0, -1.0, 0.25});
+  DoubleEvaluator evaluator;
+  TFOPT_ASSERT_OK_AND_ASSIGN(
+      const FusedLinearOperation dense,
+      FusedLinearOperation::CreateMatmul("dense", x.dimension(),
+                                         w.dimension(), b.dimension()));
+  EXPECT_THAT(evaluator.Evaluate(&dense, {&x, &w, &b}),
+              DoubleTensorEquals(
+                  DoubleTensor(Matrix{{-4.0, 3.0, -0.25}, {4.5, -1.0, 1.0}})));
+  TFOPT_ASSERT_OK_AND_ASSIGN(
+      const FusedLinearOperation clipped,
+      FusedLinearOperation::CreateMatmul("clipped", x.dimension(),
+                                         w.dimension(), b.dimension(),
+                                         Activation::kClippedRelu, 2.0));
+  EXPECT_THAT(evaluator.Evaluate(&clipped, {&x, &w, &b}),
+              DoubleTensorEquals(
+                  DoubleTensor(Matrix{{0.0, 2.0, 0.0}, {2.0, 0.0, 1.0}})));
+}
+
+TEST(DoubleEvaluatorTest, FusedConv2d) {
+  DoubleTensor image(Shape({1, 3, 3, 1}));
+  for (int64_t i = 0; i < image.size(); ++i) {
+    (*image.mutable_flat_values())[i] = i % 2 == 0 ? i : -i;
+  }
+  DoubleTensor filter(Shape({2, 2, 1, 2}));
+  for (int64_t i = 0; i < filter.size(); ++i) {
+    (*filter.mutable_flat_values())[i] = 0.5 - 0.25 * i;
+  }
+  const DoubleTensor bias({0.5, -0.5});
+  DoubleEvaluator evaluator;
+  TFOPT_ASSERT_OK_AND_ASSIGN(
+      const FusedLinearOperation fused,
+      FusedLinearOperation::CreateConv2d(
+          "fused", image.dimension(), filter.dimension(), bias.dimension(),
+          Position2D(1, 1), PaddingType::SAME, Activation::kRelu));
+  const DoubleTensor conv =
+      evaluator.Evaluate(fused.conv2d(), {&image, &filter});
+  const DoubleTensor biased =
+      evaluator.Evaluate(&fused.bias_add(), {&conv, &bias});
+  EXPECT_THAT(evaluator.Evaluate(&fused, {&image, &filter, &bias}),
+              DoubleTensorEquals(evaluator.Evaluate(fused.relu(), {&biased})));
+}
+
+TEST(DoubleEvaluatorTest, ShapeOperations) {
+  const DoubleTensor input(Matrix{{1.0, 2.0, 3.0}, {4.0, 5.0, 6.0}});
+  DoubleEvaluator evaluator;
+  TFOPT_ASSERT_OK_AND_ASSIGN(
+      const ConcatOperation concat,
+      ConcatOperation::Create("concat",
+                              {input.dimension(), input.dimension()}, 1));
+  EXPECT_EQ(evaluator.Evaluate(&concat, {&input, &input}).dimension(),
+            Shape({2, 6}));
+  TFOPT_ASSERT_OK_AND_ASSIGN(
+      const ReshapeOperation reshape,
+      ReshapeOperation::Create("reshape", input.dimension(), Shape({3, 2})));
+  EXPECT_THAT(evaluator.Evaluate(&reshape, {&input}),
+              DoubleTensorEquals(
+                  DoubleTensor(Matrix{{1.0, 2.0}, {3.0, 4.0}, {5.0, 6.0}})));
+  TFOPT_ASSERT_OK_AND_ASSIGN(
+      const SliceOperation slice,
+      SliceOperation::Create("slice", input.dimension(), {0, 1}, {2, 1}));
+  const DoubleTensor column = evaluator.Evaluate(&slice, {&input});
+  EXPECT_THAT(column, DoubleTensorEquals(DoubleTensor(Matrix{{2.0}, {5.0}})));
+  TFOPT_ASSERT_OK_AND_ASSIGN(
+      const SqueezeOperation squeeze,
+      SqueezeOperation::Create("squeeze", column.dimension(), {1}));
+  const DoubleTensor squeezed = evaluator.Evaluate(&squeeze, {&column});
+  EXPECT_THAT(squeezed, DoubleTensorEquals(DoubleTensor({2.0, 5.0})));
+  // Without axes, every dimension of size 1 is removed.
+  const DoubleTensor single(Shape({1, 2, 1}), 3.0);
+  TFOPT_ASSERT_OK_AND_ASSIGN(
+      const SqueezeOperation squeeze_all,
+      SqueezeOperation::Create("squeeze_all", single.dimension(), {}));
+  EXPECT_THAT(evaluator.Evaluate(&squeeze_all, {&single}),
+              DoubleTensorEquals(DoubleTensor({3.0, 3.0})));
+  TFOPT_ASSERT_OK_AND_ASSIGN(
+      const ExpandDimsOperation expand_dims,
+      ExpandDimsOperation::Create("expand_dims", squeezed.dimension(), 0));
+  EXPECT_THAT(evaluator.Evaluate(&expand_dims, {&squeezed}),
+              DoubleTensorEquals(DoubleTensor(Matrix{{2.0, 5.0}})));
+}
+
+TEST(DoubleEvaluatorTest, Reductions) {
+  const DoubleTensor input(Matrix{{1.0, -2.0, 3.0}, {4.0, 5.0, -6.0}});
+  const std::vector<int64_t> axes = {1};
+  DoubleEvaluator evaluator;
+  TFOPT_ASSERT_OK_AND_ASSIGN(
+      const ReduceMaxOperation reduce_max,
+      ReduceMaxOperation::Create("max", input.dimension(), axes));
+  EXPECT_THAT(evaluator.Evaluate(&reduce_max, {&input}),
+              DoubleTensorEquals(DoubleTensor({3.0, 5.0})));
+  TFOPT_ASSERT_OK_AND_ASSIGN(
+      const ReduceMinOperation reduce_min,
+      ReduceMinOperation::Create("min", input.dimension(), axes));
+  EXPECT_THAT(evaluator.Evaluate(&reduce_min, {&input}),
+              DoubleTensorEquals(DoubleTensor({-2.0, -6.0})));
+  TFOPT_ASSERT_OK_AND_ASSIGN(
+      const ReduceSumOperation reduce_sum,
+      ReduceSumOperation::Create("sum", input.dimension(), axes));
+  EXPECT_THAT(evaluator.Evaluate(&reduce_sum, {&input}),
+              DoubleTensorEquals(DoubleTensor({2.0, 3.0})));
+  TFOPT_ASSERT_OK_AND_ASSIGN(
+      const ReduceMeanOperation reduce_mean,
+      ReduceMeanOperation::Create("mean", input.dimension(), axes));
+  EXPECT_THAT(evaluator.Evaluate(&reduce_mean, {&input}),
+              DoubleTensorNear(DoubleTensor({2.0 / 3.0, 1.0})));
+}
+
+TEST(DoubleEvaluatorTest, EmbeddingLookup) {
+  const DoubleTensor params(Matrix{{1.0, 2.0}, {3.0, 4.0}, {5.0, 6.0}});
+  // A multi-hot encoding of ids 0 and 2, with weights 1 and 2.
+  const DoubleTensor ids(Matrix{{1.0, 0.0, 2.0}});
+  DoubleEvaluator evaluator;
+  TFOPT_ASSERT_OK_AND_ASSIGN(
+      const EmbeddingLookupOperation lookup,
+      EmbeddingLookupOperation::Create("lookup", params.dimension(),
+                                       ids.dimension()));
+  EXPECT_THAT(evaluator.Evaluate(&lookup, {&params, &ids}),
+              DoubleTensorEquals(DoubleTensor(Matrix{{11.0, 14.0}})));
+}
+
+TEST(DoubleEvaluatorTest, Maxpool) {
+  const DoubleTensor input =
+      DoubleTensor::FromFlatData(Shape({1, 2, 2, 1}), {1.0, 4.0, 3.0, 2.0});
+  DoubleEvaluator evaluator;
+  TFOPT_ASSERT_OK_AND_ASSIGN(
+      const MaxpoolOperation maxpool,
+      MaxpoolOperation::Create("maxpool", input.dimension(), Position2D(2, 2),
+                               Position2D(1, 1), PaddingType::VALID));
+  EXPECT_THAT(evaluator.Evaluate(&maxpool, {&input}),
+              DoubleTensorEquals(
+                  DoubleTensor::FromFlatData(Shape({1, 1, 1, 1}), {4.0})));
+}
+
+TEST(DoubleEvaluatorTest, ConstantAndVariable) {
+  DoubleEvaluator evaluator({{"x", DoubleTensor({1.0, 2.0})}});
+  TFOPT_ASSERT_OK_AND_ASSIGN(
+      const ConstantOperation constant,
+      ConstantOperation::Create("c", DoubleTensor({3.0})));
+  EXPECT_THAT(evaluator.Evaluate(&constant, {}),
+              DoubleTensorEquals(DoubleTensor({3.0})));
+  TFOPT_ASSERT_OK_AND_ASSIGN(const VariableOperation x,
+                             VariableOperation::Create("x", Shape({2})));
+  EXPECT_THAT(evaluator.Evaluate(&x, {}),
+              DoubleTensorEquals(DoubleTensor({1.0, 2.0})));
+  evaluator.set_variable_value("x", DoubleTensor({5.0, 6.0}));
+  EXPECT_THAT(evaluator.Evaluate(&x, {}),
+              DoubleTensorEquals(DoubleTensor({5.0, 6.0})));
+}
+
+TEST(DoubleEvaluatorDeathTest, MissingVariable) {
+  DoubleEvaluator evaluator;
+  TFOPT_ASSERT_OK_AND_ASSIGN(const VariableOperation x,
+                             VariableOperation::Create("x", Shape({2})));
+  EXPECT_DEATH(evaluator.Evaluate(&x, {}), "No value for variable: x");
+}
+
+TEST(DoubleEvaluatorDeathTest, VariableWithWrongShape) {
+  DoubleEvaluator evaluator({{"x", DoubleTensor({1.0, 2.0, 3.0})}});
+  TFOPT_ASSERT_OK_AND_ASSIGN(const VariableOperation x,
+                             VariableOperation::Create("x", Shape({2})));
+  EXPECT_DEATH(evaluator.Evaluate(&x, {}), "has shape");
+}
+
+}  // namespace
+}  // namespace tf_opt
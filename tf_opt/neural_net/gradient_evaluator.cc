@@ -0,0 +1,619 @@
+// Copyright 2026 The tf.opt Authors.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "tf_opt/neural_net/gradient_evaluator.h"
+
+#include <cstdint>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "ortools/base/logging.h"
+#include "absl/container/flat_hash_map.h"
+#include "tf_opt/neural_net/neural_net_graph.h"
+#include "tf_opt/neural_net/operation.h"
+#include "tf_opt/neural_net/operation_visitor.h"
+#include "tf_opt/neural_net/ops/all_operations.h"
+#include "tf_opt/open_source/status_macros.h"
+#include "tf_opt/tensor/convolve.h"
+#include "tf_opt/tensor/element_operations.h"
+#include "tf_opt/tensor/shape.h"
+#include "tf_opt/tensor/tensor.h"
+#include "tf_opt/tensor/window.h"
+
+namespace tf_opt {
+namespace {
+
+// For each flat index of a tensor of shape "result", the flat index of the
+// element of a tensor of shape "operand" that is broadcast to it, with the
+// broadcasting rules of BinaryElementwiseOp().
+std::vector<int64_t> BroadcastIndices(const Shape& operand,
+                                      const Shape& result) {
+  const int offset = result.num_dimensions() - operand.num_dimensions();
+  std::vector<int64_t> indices(result.size());
+  for (int64_t i = 0; i < result.size(); ++i) {
+    const std::vector<int64_t> multi_index = result.ExpandIndex(i);
+    int64_t index = 0;
+    for (int d = 0; d < operand.num_dimensions(); ++d) {
+      const int64_t size = operand.dimension_size(d);
+      index = index * size + (size == 1 ? 0 : multi_index[d + offset]);
+    }
+    indices[i] = index;
+  }
+  return indices;
+}
+
+// For each flat index of a tensor of shape "input", the flat index of the
+// element it is reduced into when reducing along "axes".
+std::vector<int64_t> ReducedIndices(const Shape& input,
+                                    const std::vector<int64_t>& axes) {
+  std::vector<bool> reduced(input.num_dimensions(), false);
+  for (const int64_t axis : axes) {
+    reduced[axis] = true;
+  }
+  std::vector<int64_t> indices(input.size());
+  for (int64_t i = 0; i < input.size(); ++i) {
+    const std::vector<int64_t> multi_index = input.ExpandIndex(i);
+    int64_t index = 0;
+    for (int d = 0; d < input.num_dimensions(); ++d) {
+      if (!reduced[d]) {
+        index = index * input.dimension_size(d) + multi_index[d];
+      }
+    }
+    indices[i] = index;
+  }
+  return indices;
+}
+
+Shape MatMulBatchShape(const Shape& shape) {
+  const std::vector<int64_t>& sizes = shape.dimension_sizes();
+  return Shape(std::vector<int64_t>(sizes.begin(), sizes.end() - 2));
+}
+
+// Adds the gradient of MatMul(left, right) to left_adjoint and right_adjoint
+// (if not null), for the adjoint of its result. The leading (batch)
+// dimensions may broadcast.
+void MatMulBackward(const DoubleTensor& left, const DoubleTensor& right,
+                    const DoubleTensor& adjoint,
+                    std::vector<double>* left_adjoint,
+                    std::vector<double>* right_adjoint) {
+  const Shape& left_shape = left.dimension();
+  const Shape& right_shape = right.dimension();
+  const int64_t rows =
+      left_shape.dimension_size(left_shape.num_dimensions() - 2);
+  const int64_t inner =
+      left_shape.dimension_size(left_shape.num_dimensions() - 1);
+  const int64_t cols =
+      right_shape.dimension_size(right_shape.num_dimensions() - 1);
+  const Shape batch_shape = MatMulBatchShape(adjoint.dimension());
+  const std::vector<int64_t> left_batches =
+      BroadcastIndices(MatMulBatchShape(left_shape), batch_shape);
+  const std::vector<int64_t> right_batches =
+      BroadcastIndices(MatMulBatchShape(right_shape), batch_shape);
+  for (int64_t b = 0; b < batch_shape.size(); ++b) {
+    const double* l =
+        left.flat_values().data() + left_batches[b] * rows * inner;
+    const double* r =
+        right.flat_values().data() + right_batches[b] * inner * cols;
+    const double* g = adjoint.flat_values().data() + b * rows * cols;
+    if (left_adjoint != nullptr) {
+      double* dl = left_adjoint->data() + left_batches[b] * rows * inner;
+      for (int64_t i = 0; i < rows; ++i) {
+        for (int64_t k = 0; k < inner; ++k) {
+          double sum = 0.0;
+          for (int64_t j = 0; j < cols; ++j) {
+            sum += g[i * cols + j] * r[k * cols + j];
+          }
+          dl[i * inner + k] += sum;
+        }
+      }
+    }
+    if (right_adjoint != nullptr) {
+      double* dr = right_adjoint->data() + right_batches[b] * inner * cols;
+      for (int64_t i = 0; i < rows; ++i) {
+        for (int64_t k = 0; k < inner; ++k) {
+          const double l_ik = l[i * inner + k];
+          for (int64_t j = 0; j < cols; ++j) {
+            dr[k * cols + j] += l_ik * g[i * cols + j];
+          }
+        }
+      }
+    }
+  }
+}
+
+// Adds the gradient of Conv2d(input, filter, strides, padding) to
+// input_adjoint and filter_adjoint (if not null), for the adjoint of its
+// result. Loops over the windows like Conv2d() in convolve.h.
+void Conv2dBackward(const DoubleTensor& input, const DoubleTensor& filter,
+                    const Position2D strides, const PaddingType padding,
+                    const DoubleTensor& adjoint,
+                    std::vector<double>* input_adjoint,
+                    std::vector<double>* filter_adjoint) {
+  const Conv2dInputShape input_shape(&input.dimension());
+  const Conv2dFilterShape filter_shape(&filter.dimension());
+  WindowExtractor2D window_extractor;
+  TFOPT_CHECK_OK(window_extractor.Initialize(input_shape.RegionSize(),
+                                             filter_shape.RegionSize(),
+                                             strides, padding));
+  const int64_t height = input_shape.height();
+  const int64_t width = input_shape.width();
+  const int64_t in_channels = input_shape.channels();
+  const int64_t out_channels = filter_shape.out_channels();
+  const int64_t output_height = window_extractor.output_size().row;
+  const int64_t output_width = window_extractor.output_size().col;
+  const std::vector<double>& input_values = input.flat_values();
+  const std::vector<double>& filter_values = filter.flat_values();
+  for (int64_t ob = 0; ob < input_shape.batch(); ++ob) {
+    for (int64_t oy = 0; oy < output_height; ++oy) {
+      for (int64_t ox = 0; ox < output_width; ++ox) {
+        const double* g =
+            adjoint.flat_values().data() +
+            ((ob * output_height + oy) * output_width + ox) * out_channels;
+        const Rectangle rectangle =
+            window_extractor.GetWindow(Position2D(oy, ox));
+        for (int64_t iy = rectangle.start.row;
+             iy < rectangle.start.row + rectangle.size.row; ++iy) {
+          for (int64_t ix = rectangle.start.col;
+               ix < rectangle.start.col + rectangle.size.col; ++ix) {
+            if (window_extractor.IsPadding(Position2D(iy, ix))) {
+              continue;
+            }
+            const int64_t input_base = ((ob * height + iy) * width + ix) *
+                                       in_channels;
+            const int64_t filter_base =
+                ((iy - rectangle.start.row) * filter_shape.width() +
+                 (ix - rectangle.start.col)) *
+                in_channels * out_channels;
+            for (int64_t ic = 0; ic < in_channels; ++ic) {
+              for (int64_t oc = 0; oc < out_channels; ++oc) {
+                const int64_t f = filter_base + ic * out_channels + oc;
+                if (input_adjoint != nullptr) {
+                  (*input_adjoint)[input_base + ic] += g[oc] * filter_values[f];
+                }
+                if (filter_adjoint != nullptr) {
+                  (*filter_adjoint)[f] += g[oc] * input_values[input_base + ic];
+                }
+              }
+            }
+          }
+        }
+      }
+    }
+  }
+}
+
+// Applies the backward rule of each operation: given the values of its
+// inputs and output and the adjoint of its output, computes the adjoints of
+// its inputs.
+class BackwardVisitor : public OperationVisitor {
+ public:
+  // Returns the adjoints of the inputs of operation, or empty tensors for the
+  // inputs i without needed[i].
+  std::vector<DoubleTensor> Backward(
+      const Operation& operation, std::vector<const DoubleTensor*> inputs,
+      const DoubleTensor& value, const DoubleTensor& adjoint,
+      std::vector<bool> needed) {
+    inputs_ = std::move(inputs);
+    value_ = &value;
+    adjoint_ = &adjoint;
+    input_adjoints_.clear();
+    for (int i = 0; i < inputs_.size(); ++i) {
+      input_adjoints_.push_back(needed[i]
+                                    ? DoubleTensor(inputs_[i]->dimension())
+                                    : DoubleTensor());
+    }
+    needed_ = std::move(needed);
+    operation.Accept(this);
+    return std::move(input_adjoints_);
+  }
+
+  void Visit(const AddOperation& operation) override {
+    BinaryBackward([](double, double) { return 1.0; },
+                   [](double, double) { return 1.0; });
+  }
+  void Visit(const DivideOperation& operation) override {
+    BinaryBackward([](double, double r) { return 1.0 / r; },
+                   [](double l, double r) { return -l / (r * r); });
+  }
+  void Visit(const MultiplyOperation& operation) override {
+    BinaryBackward([](double, double r) { return r; },
+                   [](double l, double) { return l; });
+  }
+  void Visit(const SubtractOperation& operation) override {
+    BinaryBackward([](double, double) { return 1.0; },
+                   [](double, double) { return -1.0; });
+  }
+
+  void Visit(const ClippedReluOperation& operation) override {
+    const double cap = operation.cap();
+    UnaryBackward([cap](double x) { return x > 0.0 && x < cap; });
+  }
+
+  void Visit(const ConcatOperation& operation) override {
+    const std::vector<int64_t>& sizes = adjoint_->dimension().dimension_sizes();
+    const int axis = operation.axis();
+    int64_t num_outer = 1;
+    for (int d = 0; d < axis; ++d) {
+      num_outer *= sizes[d];
+    }
+    const int64_t output_block = adjoint_->size() / num_outer;
+    int64_t offset = 0;
+    for (int i = 0; i < inputs_.size(); ++i) {
+      const int64_t block = inputs_[i]->size() / num_outer;
+      if (std::vector<double>* dx = InputAdjoint(i)) {
+        for (int64_t o = 0; o < num_outer; ++o) {
+          for (int64_t j = 0; j < block; ++j) {
+            (*dx)[o * block + j] += Adjoint(o * output_block + offset + j);
+          }
+        }
+      }
+      offset += block;
+    }
+  }
+
+  void Visit(const ConstantOperation& operation) override {}
+
+  void Visit(const Conv1dOperation& operation) override {
+    const DoubleTensor input = inputs_[0]->Reshape(
+        Conv1dInputShape(&inputs_[0]->dimension()).shape2d());
+    const DoubleTensor filter = inputs_[1]->Reshape(
+        Conv1dFilterShape(&inputs_[1]->dimension()).shape2d());
+    const Shape& output_shape = adjoint_->dimension();
+    const DoubleTensor adjoint = adjoint_->Reshape(
+        Shape({output_shape.dimension_size(0), 1,
+               output_shape.dimension_size(1),
+               output_shape.dimension_size(2)}));
+    Conv2dBackward(input, filter, Position2D(1, operation.stride()),
+                   operation.padding(), adjoint, InputAdjoint(0),
+                   InputAdjoint(1));
+  }
+
+  void Visit(const Conv2dOperation& operation) override {
+    Conv2dBackward(*inputs_[0], *inputs_[1], operation.stride(),
+                   operation.padding(), *adjoint_, InputAdjoint(0),
+                   InputAdjoint(1));
+  }
+
+  void Visit(const EmbeddingLookupOperation& operation) override {
+    const DoubleTensor& params = *inputs_[0];
+    const DoubleTensor& ids = *inputs_[1];
+    const int64_t num_classes = params.dimension().dimension_size(0);
+    const int64_t row_size = params.size() / num_classes;
+    const int64_t num_lookups = ids.size() / num_classes;
+    std::vector<double>* params_adjoint = InputAdjoint(0);
+    std::vector<double>* ids_adjoint = InputAdjoint(1);
+    for (int64_t r = 0; r < num_lookups; ++r) {
+      for (int64_t k = 0; k < num_classes; ++k) {
+        const double id = ids.flat_value(r * num_classes + k);
+        double sum = 0.0;
+        for (int64_t e = 0; e < row_size; ++e) {
+          const double g = Adjoint(r * row_size + e);
+          if (params_adjoint != nullptr) {
+            (*params_adjoint)[k * row_size + e] += id * g;
+          }
+          sum += g * params.flat_value(k * row_size + e);
+        }
+        if (ids_adjoint != nullptr) {
+          (*ids_adjoint)[r * num_classes + k] += sum;
+        }
+      }
+    }
+  }
+
+  void Visit(const ExpandDimsOperation& operation) override {
+    ReshapeBackward();
+  }
+
+  void Visit(const FusedLinearOperation& operation) override {
+    // The derivative of the activation only depends on the sign of its input,
+    // which is also the sign of its output.
+    DoubleTensor linear_adjoint = *adjoint_;
+    std::vector<double>& g = *linear_adjoint.mutable_flat_values();
+    for (int64_t i = 0; i < g.size(); ++i) {
+      const double y = value_->flat_value(i);
+      switch (operation.activation()) {
+        case Activation::kIdentity:
+          break;
+        case Activation::kRelu:
+          if (!(y > 0.0)) {
+            g[i] = 0.0;
+          }
+          break;
+        case Activation::kClippedRelu:
+          if (!(y > 0.0 && y < operation.cap())) {
+            g[i] = 0.0;
+          }
+          break;
+      }
+    }
+    if (std::vector<double>* bias_adjoint = InputAdjoint(2)) {
+      const std::vector<int64_t> bias_indices =
+          BroadcastIndices(inputs_[2]->dimension(), linear_adjoint.dimension());
+      for (int64_t i = 0; i < g.size(); ++i) {
+        (*bias_adjoint)[bias_indices[i]] += g[i];
+      }
+    }
+    if (const Conv2dOperation* conv2d = operation.conv2d()) {
+      Conv2dBackward(*inputs_[0], *inputs_[1], conv2d->stride(),
+                     conv2d->padding(), linear_adjoint, InputAdjoint(0),
+                     InputAdjoint(1));
+    } else {
+      MatMulBackward(*inputs_[0], *inputs_[1], linear_adjoint, InputAdjoint(0),
+                     InputAdjoint(1));
+    }
+  }
+
+  void Visit(const ReduceMeanOperation& operation) override {
+    LinearReduceBackward(operation.axes(),
+                         static_cast<double>(adjoint_->size()) /
+                             inputs_[0]->size());
+  }
+  void Visit(const ReduceSumOperation& operation) override {
+    LinearReduceBackward(operation.axes(), 1.0);
+  }
+
+  void Visit(const MatmulOperation& operation) override {
+    MatMulBackward(*inputs_[0], *inputs_[1], *adjoint_, InputAdjoint(0),
+                   InputAdjoint(1));
+  }
+
+  void Visit(const MaxpoolOperation& operation) override {
+    const DoubleTensor& input = *inputs_[0];
+    const Shape& input_shape = input.dimension();
+    const int64_t height = input_shape.dimension_size(1);
+    const int64_t width = input_shape.dimension_size(2);
+    const int64_t channels = input_shape.dimension_size(3);
+    WindowExtractor2D window_extractor;
+    TFOPT_CHECK_OK(window_extractor.Initialize(
+        Position2D(height, width), operation.ksize(), operation.stride(),
+        operation.padding()));
+    const int64_t output_height = window_extractor.output_size().row;
+    const int64_t output_width = window_extractor.output_size().col;
+    std::vector<double>& dx = *InputAdjoint(0);
+    for (int64_t ob = 0; ob < input_shape.dimension_size(0); ++ob) {
+      for (int64_t oy = 0; oy < output_height; ++oy) {
+        for (int64_t ox = 0; ox < output_width; ++ox) {
+          const Rectangle rectangle =
+              window_extractor.GetWindow(Position2D(oy, ox));
+          for (int64_t c = 0; c < channels; ++c) {
+            const int64_t o =
+                ((ob * output_height + oy) * output_width + ox) * channels + c;
+            const int64_t argmax =
+                WindowArgmax(input, window_extractor, rectangle, ob, c,
+                             value_->flat_value(o));
+            if (argmax >= 0) {
+              dx[argmax] += Adjoint(o);
+            }
+          }
+        }
+      }
+    }
+  }
+
+  void Visit(const ReduceMaxOperation& operation) override {
+    NonlinearReduceBackward(operation.axes());
+  }
+  void Visit(const ReduceMinOperation& operation) override {
+    NonlinearReduceBackward(operation.axes());
+  }
+
+  void Visit(const ReluOperation& operation) override {
+    UnaryBackward([](double x) { return x > 0.0; });
+  }
+
+  void Visit(const ReshapeOperation& operation) override { ReshapeBackward(); }
+
+  void Visit(const SliceOperation& operation) override {
+    const Shape& input_shape = inputs_[0]->dimension();
+    const Shape& slice_shape = adjoint_->dimension();
+    std::vector<double>& dx = *InputAdjoint(0);
+    for (int64_t j = 0; j < slice_shape.size(); ++j) {
+      std::vector<int64_t> multi_index = slice_shape.ExpandIndex(j);
+      for (int d = 0; d < multi_index.size(); ++d) {
+        multi_index[d] += operation.begin()[d];
+      }
+      dx[input_shape.FlattenIndexSpan(multi_index)] += Adjoint(j);
+    }
+  }
+
+  void Visit(const SqueezeOperation& operation) override { ReshapeBackward(); }
+
+  void Visit(const VariableOperation& operation) override {}
+
+ private:
+  double Adjoint(const int64_t i) const { return adjoint_->flat_value(i); }
+
+  // The adjoint of input i, or null if it is not needed.
+  std::vector<double>* InputAdjoint(const int i) {
+    return needed_[i] ? input_adjoints_[i].mutable_flat_values() : nullptr;
+  }
+
+  template <typename LeftDerivative, typename RightDerivative>
+  void BinaryBackward(const LeftDerivative& left_derivative,
+                      const RightDerivative& right_derivative) {
+    const Shape& result_shape = adjoint_->dimension();
+    const std::vector<int64_t> left_indices =
+        BroadcastIndices(inputs_[0]->dimension(), result_shape);
+    const std::vector<int64_t> right_indices =
+        BroadcastIndices(inputs_[1]->dimension(), result_shape);
+    std::vector<double>* left_adjoint = InputAdjoint(0);
+    std::vector<double>* right_adjoint = InputAdjoint(1);
+    for (int64_t i = 0; i < result_shape.size(); ++i) {
+      const double l = inputs_[0]->flat_value(left_indices[i]);
+      const double r = inputs_[1]->flat_value(right_indices[i]);
+      if (left_adjoint != nullptr) {
+        (*left_adjoint)[left_indices[i]] += Adjoint(i) * left_derivative(l, r);
+      }
+      if (right_adjoint != nullptr) {
+        (*right_adjoint)[right_indices[i]] +=
+            Adjoint(i) * right_derivative(l, r);
+      }
+    }
+  }
+
+  // For the elementwise operations whose derivative is 1 on the inputs x
+  // with is_active(x), and 0 elsewhere.
+  template <typename IsActive>
+  void UnaryBackward(const IsActive& is_active) {
+    std::vector<double>& dx = *InputAdjoint(0);
+    for (int64_t i = 0; i < dx.size(); ++i) {
+      if (is_active(inputs_[0]->flat_value(i))) {
+        dx[i] += Adjoint(i);
+      }
+    }
+  }
+
+  // For the operations that only change the shape.
+  void ReshapeBackward() {
+    std::vector<double>& dx = *InputAdjoint(0);
+    for (int64_t i = 0; i < dx.size(); ++i) {
+      dx[i] += Adjoint(i);
+    }
+  }
+
+  void LinearReduceBackward(const std::vector<int64_t>& axes,
+                            const double scale) {
+    const std::vector<int64_t> reduced_indices =
+        ReducedIndices(inputs_[0]->dimension(), axes);
+    std::vector<double>& dx = *InputAdjoint(0);
+    for (int64_t i = 0; i < dx.size(); ++i) {
+      dx[i] += scale * Adjoint(reduced_indices[i]);
+    }
+  }
+
+  // The adjoint of each output goes to the first input equal to it.
+  void NonlinearReduceBackward(const std::vector<int64_t>& axes) {
+    const std::vector<int64_t> reduced_indices =
+        ReducedIndices(inputs_[0]->dimension(), axes);
+    std::vector<bool> assigned(adjoint_->size(), false);
+    std::vector<double>& dx = *InputAdjoint(0);
+    for (int64_t i = 0; i < dx.size(); ++i) {
+      const int64_t o = reduced_indices[i];
+      if (!assigned[o] && inputs_[0]->flat_value(i) == value_->flat_value(o)) {
+        dx[i] += Adjoint(o);
+        assigned[o] = true;
+      }
+    }
+  }
+
+  // The flat index in input of the first element of the window equal to max,
+  // or -1 if none (e.g. NaNs).
+  static int64_t WindowArgmax(const DoubleTensor& input,
+                              const WindowExtractor2D& window_extractor,
+                              const Rectangle& rectangle, const int64_t batch,
+                              const int64_t channel, const double max) {
+    const Shape& shape = input.dimension();
+    for (int64_t iy = rectangle.start.row;
+         iy < rectangle.start.row + rectangle.size.row; ++iy) {
+      for (int64_t ix = rectangle.start.col;
+           ix < rectangle.start.col + rectangle.size.col; ++ix) {
+        if (window_extractor.IsPadding(Position2D(iy, ix))) {
+          continue;
+        }
+        const int64_t index = shape.FlattenIndexSpan({batch, iy, ix, channel});
+        if (input.flat_value(index) == max) {
+          return index;
+        }
+      }
+    }
+    return -1;
+  }
+
+  std::vector<const DoubleTensor*> inputs_;
+  const DoubleTensor* value_ = nullptr;
+  const DoubleTensor* adjoint_ = nullptr;
+  std::vector<bool> needed_;
+  std::vector<DoubleTensor> input_adjoints_;
+};
+
+}  // namespace
+
+GradientEvaluator::GradientEvaluator(const NeuralNetGraph* graph)
+    : graph_(graph), depends_on_variable_(graph->num_operations(), false) {
+  for (const int id : graph_->variables()) {
+    depends_on_variable_[id] = true;
+  }
+  for (int id = 0; id < graph_->num_operations(); ++id) {
+    for (const int input : graph_->inputs(id)) {
+      if (depends_on_variable_[input]) {
+        depends_on_variable_[id] = true;
+      }
+    }
+  }
+}
+
+std::vector<DoubleTensor> GradientEvaluator::Adjoints(
+    const std::vector<DoubleTensor>& values, const int output_id) const {
+  const int num_operations = graph_->num_operations();
+  CHECK_EQ(values.size(), num_operations);
+  CHECK_EQ(values[output_id].size(), 1)
+      << "Can only differentiate an operation with a single element: "
+      << graph_->operation(output_id).name();
+  std::vector<DoubleTensor> adjoints(num_operations);
+  std::vector<bool> reached(num_operations, false);
+  adjoints[output_id] = DoubleTensor(values[output_id].dimension());
+  (*adjoints[output_id].mutable_flat_values())[0] = 1.0;
+  reached[output_id] = true;
+  BackwardVisitor visitor;
+  for (int id = output_id; id >= 0; --id) {
+    if (!reached[id] || !depends_on_variable_[id]) {
+      continue;
+    }
+    const std::vector<int>& input_ids = graph_->inputs(id);
+    std::vector<const DoubleTensor*> inputs;
+    std::vector<bool> needed;
+    for (const int input : input_ids) {
+      inputs.push_back(&values[input]);
+      needed.push_back(depends_on_variable_[input]);
+    }
+    std::vector<DoubleTensor> input_adjoints =
+        visitor.Backward(graph_->operation(id), std::move(inputs), values[id],
+                         adjoints[id], std::move(needed));
+    for (int i = 0; i < input_ids.size(); ++i) {
+      const int input = input_ids[i];
+      if (!depends_on_variable_[input]) {
+        continue;
+      }
+      if (!reached[input]) {
+        adjoints[input] = std::move(input_adjoints[i]);
+        reached[input] = true;
+        continue;
+      }
+      std::vector<double>& sum = *adjoints[input].mutable_flat_values();
+      for (int64_t j = 0; j < sum.size(); ++j) {
+        sum[j] += input_adjoints[i].flat_value(j);
+      }
+    }
+  }
+  for (int id = 0; id < num_operations; ++id) {
+    if (!reached[id]) {
+      adjoints[id] = DoubleTensor(values[id].dimension());
+    }
+  }
+  return adjoints;
+}
+
+absl::flat_hash_map<std::string, DoubleTensor>
+GradientEvaluator::VariableGradients(const std::vector<DoubleTensor>& values,
+                                     const int output_id) const {
+  std::vector<DoubleTensor> adjoints = Adjoints(values, output_id);
+  absl::flat_hash_map<std::string, DoubleTensor> result;
+  for (const int id : graph_->variables()) {
+    result[graph_->operation(id).name()] = std::move(adjoints[id]);
+  }
+  return result;
+}
+
+}  // namespace tf_opt
@@ -0,0 +1,77 @@
+// Copyright 2026 The tf.opt Authors.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef TF_OPT_NEURAL_NET_GRADIENT_EVALUATOR_H_
+#define TF_OPT_NEURAL_NET_GRADIENT_EVALUATOR_H_
+
+#include <string>
+#include <vector>
+
+#include "absl/container/flat_hash_map.h"
+#include "tf_opt/neural_net/neural_net_graph.h"
+#include "tf_opt/tensor/tensor.h"
+
+namespace tf_opt {
+
+// Reverse-mode differentiation of a NeuralNetGraph on DoubleTensors, e.g. to
+// follow the gradient of an output in a primal heuristic.
+//
+// Given the values of every operation at a point, as computed by
+// NeuralNetGraph::Evaluate() with a DoubleEvaluator, computes the gradient of
+// a scalar operation with respect to the value of the operations it depends
+// on (their adjoints), in a single pass over the ids in decreasing order. The
+// backward rule of each operation reads the values of its inputs and output,
+// so nothing is evaluated again. Only the operations that depend on a
+// variable are differentiated, e.g. there is no gradient for the weights.
+//
+// The piecewise linear operations get a subgradient: ReLUs and clipped ReLUs
+// have derivative 0 at their kinks, and max pools, ReduceMax and ReduceMin
+// pass the adjoint of each output to the first element of its window that
+// attains the maximum (minimum).
+//
+// Example use:
+//   DoubleEvaluator evaluator({{"x", x}});
+//   const std::vector<DoubleTensor> values = graph.Evaluate(&evaluator);
+//   GradientEvaluator gradient_evaluator(&graph);
+//   absl::flat_hash_map<std::string, DoubleTensor> gradients =
+//       gradient_evaluator.VariableGradients(
+//           values, graph.OperationIdOrDie("loss"));
+//   const DoubleTensor& x_gradient = gradients["x"];
+class GradientEvaluator {
+ public:
+  // The graph must outlive this.
+  explicit GradientEvaluator(const NeuralNetGraph* graph);
+
+  // Returns the adjoints of the operations, indexed by id, of the operation
+  // "output_id", which must have a single element. values must hold the
+  // value of every operation. The adjoint of an operation that does not
+  // depend on a variable, or that output_id does not depend on, is zero.
+  std::vector<DoubleTensor> Adjoints(const std::vector<DoubleTensor>& values,
+                                     int output_id) const;
+
+  // Returns the gradient of operation "output_id" with respect to every
+  // variable of the graph, by name. Same requirements as Adjoints().
+  absl::flat_hash_map<std::string, DoubleTensor> VariableGradients(
+      const std::vector<DoubleTensor>& values, int output_id) const;
+
+ private:
+  const NeuralNetGraph* graph_;
+
+  // Whether each operation depends on a variable, indexed by id.
+  std::vector<bool> depends_on_variable_;
+};
+
+}  // namespace tf_opt
+
+#endif  // TF_OPT_NEURAL_NET_GRADIENT_EVALUATOR_H_
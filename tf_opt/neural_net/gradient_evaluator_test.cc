@@ -0,0 +1,305 @@
+// Copyright 2026 The tf.opt Authors.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "tf_opt/neural_net/gradient_evaluator.h"
+
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "gtest/gtest.h"
+#include "absl/container/flat_hash_map.h"
+#include "absl/status/statusor.h"
+#include "tf_opt/neural_net/double_evaluator.h"
+#include "tf_opt/neural_net/neural_net_graph.h"
+#include "tf_opt/neural_net/operation_testing.h"
+#include "tf_opt/neural_net/ops/all_operations.h"
+#include "tf_opt/tensor/element_operations.h"
+#include "tf_opt/tensor/shape.h"
+#include "tf_opt/tensor/tensor.h"
+#include "tf_opt/tensor/window.h"
+
+namespace tf_opt {
+namespace {
+
+using VariableValues = absl::flat_hash_map<std::string, DoubleTensor>;
+
+// A deterministic tensor with values in [-1, 1], none of them 0.
+DoubleTensor MakeNonzeroWeights(const Shape& shape, const int seed) {
+  DoubleTensor result(shape);
+  std::vector<double>& values = *result.mutable_flat_values();
+  for (int i = 0; i < values.size(); ++i) {
+    values[i] = ((seed * 31 + i * 17) % 23) / 11.0 - 0.987;
+  }
+  return result;
+}
+
+double EvaluateAt(const NeuralNetGraph& graph, const VariableValues& point,
+                  const int output_id) {
+  DoubleEvaluator evaluator(point);
+  return graph.Evaluate(&evaluator)[output_id].flat_value(0);
+}
+
+// Checks the gradients of operation "output" at point against central finite
+// differences, away from the kinks of the piecewise linear operations.
+void ExpectGradientsMatchFiniteDifferences(const NeuralNetGraph& graph,
+                                           const VariableValues& point,
+                                           const std::string& output) {
+  constexpr double kStep = 1e-6;
+  const int output_id = graph.OperationIdOrDie(output);
+  DoubleEvaluator evaluator(point);
+  const std::vector<DoubleTensor> values = graph.Evaluate(&evaluator);
+  GradientEvaluator gradient_evaluator(&graph);
+  const VariableValues gradients =
+      gradient_evaluator.VariableGradients(values, output_id);
+  ASSERT_EQ(gradients.size(), point.size());
+  for (const auto& [name, value] : point) {
+    const DoubleTensor& gradient = gradients.at(name);
+    ASSERT_EQ(gradient.dimension(), value.dimension()) << name;
+    for (int64_t i = 0; i < value.size(); ++i) {
+      VariableValues shifted = point;
+      (*shifted[name].mutable_flat_values())[i] += kStep;
+      const double plus = EvaluateAt(graph, shifted, output_id);
+      (*shifted[name].mutable_flat_values())[i] -= 2 * kStep;
+      const double minus = EvaluateAt(graph, shifted, output_id);
+      EXPECT_NEAR(gradient.flat_value(i), (plus - minus) / (2 * kStep), 1e-6)
+          << name << " at " << i;
+    }
+  }
+}
+
+TEST(GradientEvaluatorTest, DenseNetwork) {
+  NeuralNetGraph graph;
+  const int x = AddToGraph(VariableOperation::Create("x", Shape({2, 4})), {},
+                           &graph);
+  const int w1 =
+      AddConstant("w1", MakeNonzeroWeights(Shape({4, 5}), 1), &graph);
+  const int b1 = AddConstant("b1", MakeNonzeroWeights(Shape({5}), 2), &graph);
+  const int w2 =
+      AddConstant("w2", MakeNonzeroWeights(Shape({5, 3}), 3), &graph);
+  const int matmul1 = AddToGraph(
+      MatmulOperation::Create("matmul1", Shape({2, 4}), Shape({4, 5})),
+      {x, w1}, &graph);
+  const int add1 = AddToGraph(
+      AddOperation::Create("add1", Shape({2, 5}), Shape({5})), {matmul1, b1},
+      &graph);
+  const int relu1 =
+      AddToGraph(ReluOperation::Create("relu1", Shape({2, 5})), {add1},
+                 &graph);
+  const int matmul2 = AddToGraph(
+      MatmulOperation::Create("matmul2", Shape({2, 5}), Shape({5, 3})),
+      {relu1, w2}, &graph);
+  AddToGraph(ReduceSumOperation::Create("loss", Shape({2, 3}), {0, 1}),
+             {matmul2}, &graph);
+  ExpectGradientsMatchFiniteDifferences(
+      graph, {{"x", MakeNonzeroWeights(Shape({2, 4}), 4)}}, "loss");
+}
+
+TEST(GradientEvaluatorTest, ElementwiseOperationsAndReductions) {
+  NeuralNetGraph graph;
+  const int x = AddToGraph(VariableOperation::Create("x", Shape({2, 3})), {},
+                           &graph);
+  const int z =
+      AddToGraph(VariableOperation::Create("z", Shape({3})), {}, &graph);
+  const int c = AddConstant(
+      "c", DoubleTensor(std::vector<double>{2.0, 3.0, 4.0}), &graph);
+  const int difference = AddToGraph(
+      SubtractOperation::Create("difference", Shape({2, 3}), Shape({3})),
+      {x, z}, &graph);
+  const int product = AddToGraph(
+      MultiplyOperation::Create("product", Shape({2, 3}), Shape({3})),
+      {difference, z}, &graph);
+  const int denominator = AddToGraph(
+      AddOperation::Create("denominator", Shape({3}), Shape({3})), {z, c},
+      &graph);
+  const int quotient = AddToGraph(
+      DivideOperation::Create("quotient", Shape({2, 3}), Shape({3})),
+      {product, denominator}, &graph);
+  const int square = AddToGraph(
+      MultiplyOperation::Create("square", Shape({2, 3}), Shape({2, 3})),
+      {quotient, quotient}, &graph);
+  const int clipped = AddToGraph(
+      ClippedReluOperation::Create("clipped", Shape({2, 3}), 0.05),
+      {quotient}, &graph);
+  const int mean = AddToGraph(
+      ReduceMeanOperation::Create("mean", Shape({2, 3}), {0, 1}), {square},
+      &graph);
+  const int row_max = AddToGraph(
+      ReduceMaxOperation::Create("row_max", Shape({2, 3}), {1}), {clipped},
+      &graph);
+  const int row_min = AddToGraph(
+      ReduceMinOperation::Create("row_min", Shape({2, 3}), {1}), {quotient},
+      &graph);
+  const int extremes = AddToGraph(
+      AddOperation::Create("extremes", Shape({2}), Shape({2})),
+      {row_max, row_min}, &graph);
+  const int sum = AddToGraph(
+      ReduceSumOperation::Create("sum", Shape({2}), {0}), {extremes}, &graph);
+  AddToGraph(AddOperation::Create("loss", Shape(), Shape()), {mean, sum},
+             &graph);
+  ExpectGradientsMatchFiniteDifferences(
+      graph,
+      {{"x", MakeNonzeroWeights(Shape({2, 3}), 1)},
+       {"z", MakeNonzeroWeights(Shape({3}), 2)}},
+      "loss");
+}
+
+TEST(GradientEvaluatorTest, ConvolutionsAndPooling) {
+  NeuralNetGraph graph;
+  const int x = AddToGraph(
+      VariableOperation::Create("x", Shape({1, 5, 5, 2})), {}, &graph);
+  const int filter = AddToGraph(
+      VariableOperation::Create("filter", Shape({3, 3, 2, 3})), {}, &graph);
+  const int conv = AddToGraph(
+      Conv2dOperation::Create("conv", Shape({1, 5, 5, 2}),
+                              Shape({3, 3, 2, 3}), Position2D(2, 1),
+                              PaddingType::SAME),
+      {x, filter}, &graph);
+  const int pool = AddToGraph(
+      MaxpoolOperation::Create("pool", Shape({1, 3, 5, 3}), Position2D(2, 2),
+                               Position2D(1, 2), PaddingType::SAME),
+      {conv}, &graph);
+  const int pool_sum = AddToGraph(
+      ReduceSumOperation::Create("pool_sum", Shape({1, 3, 3, 3}),
+                                 {0, 1, 2, 3}),
+      {pool}, &graph);
+  const int y = AddToGraph(VariableOperation::Create("y", Shape({2, 6, 2})),
+                           {}, &graph);
+  const int filter1d =
+      AddConstant("filter1d", MakeNonzeroWeights(Shape({3, 2, 2}), 5), &graph);
+  const int conv1d = AddToGraph(
+      Conv1dOperation::Create("conv1d", Shape({2, 6, 2}), Shape({3, 2, 2}), 2,
+                              PaddingType::VALID),
+      {y, filter1d}, &graph);
+  const int conv1d_sum = AddToGraph(
+      ReduceSumOperation::Create("conv1d_sum", Shape({2, 2, 2}), {0, 1, 2}),
+      {conv1d}, &graph);
+  AddToGraph(MultiplyOperation::Create("loss", Shape(), Shape()),
+             {pool_sum, conv1d_sum}, &graph);
+  ExpectGradientsMatchFiniteDifferences(
+      graph,
+      {{"x", MakeNonzeroWeights(Shape({1, 5, 5, 2}), 1)},
+       {"filter", MakeNonzeroWeights(Shape({3, 3, 2, 3}), 2)},
+       {"y", MakeNonzeroWeights(Shape({2, 6, 2}), 3)}},
+      "loss");
+}
+
+TEST(GradientEvaluatorTest, ShapeOperationsAndEmbeddingLookup) {
+  NeuralNetGraph graph;
+  const int params = AddToGraph(
+      VariableOperation::Create("params", Shape({4, 3})), {}, &graph);
+  const int ids = AddToGraph(
+      VariableOperation::Create("ids", Shape({1, 2, 4})), {}, &graph);
+  const int lookup = AddToGraph(
+      EmbeddingLookupOperation::Create("lookup", Shape({4, 3}),
+                                       Shape({1, 2, 4})),
+      {params, ids}, &graph);
+  const int squeeze = AddToGraph(
+      SqueezeOperation::Create("squeeze", Shape({1, 2, 3}), {0}), {lookup},
+      &graph);
+  const int expand = AddToGraph(
+      ExpandDimsOperation::Create("expand", Shape({2, 3}), 0), {squeeze},
+      &graph);
+  const int concat = AddToGraph(
+      ConcatOperation::Create("concat", {Shape({1, 2, 3}), Shape({1, 2, 3})},
+                              1),
+      {expand, lookup}, &graph);
+  const int slice = AddToGraph(
+      SliceOperation::Create("slice", Shape({1, 4, 3}), {0, 1, 0}, {1, 2, 3}),
+      {concat}, &graph);
+  const int w = AddConstant("w", MakeNonzeroWeights(Shape({3, 2}), 1), &graph);
+  const int matmul = AddToGraph(
+      MatmulOperation::Create("matmul", Shape({1, 2, 3}), Shape({3, 2})),
+      {slice, w}, &graph);
+  const int reshape = AddToGraph(
+      ReshapeOperation::Create("reshape", Shape({1, 2, 2}), Shape({4})),
+      {matmul}, &graph);
+  const int square = AddToGraph(
+      MultiplyOperation::Create("square", Shape({4}), Shape({4})),
+      {reshape, reshape}, &graph);
+  AddToGraph(ReduceSumOperation::Create("loss", Shape({4}), {0}), {square},
+             &graph);
+  ExpectGradientsMatchFiniteDifferences(
+      graph,
+      {{"params", MakeNonzeroWeights(Shape({4, 3}), 1)},
+       {"ids", MakeNonzeroWeights(Shape({1, 2, 4}), 2)}},
+      "loss");
+}
+
+TEST(GradientEvaluatorTest, FusedOperations) {
+  NeuralNetGraph graph;
+  const int x = AddToGraph(
+      VariableOperation::Create("x", Shape({1, 4, 4, 2})), {}, &graph);
+  const int filter =
+      AddConstant("filter", MakeNonzeroWeights(Shape({2, 2, 2, 3}), 1), &graph);
+  const int conv_bias = AddToGraph(
+      VariableOperation::Create("conv_bias", Shape({3})), {}, &graph);
+  const int conv = AddToGraph(
+      FusedLinearOperation::CreateConv2d(
+          "conv", Shape({1, 4, 4, 2}), Shape({2, 2, 2, 3}), Shape({3}),
+          Position2D(1, 1), PaddingType::VALID, Activation::kRelu),
+      {x, filter, conv_bias}, &graph);
+  const int w = AddToGraph(VariableOperation::Create("w", Shape({3, 2})), {},
+                           &graph);
+  const int b = AddConstant("b", MakeNonzeroWeights(Shape({2}), 2), &graph);
+  const int dense = AddToGraph(
+      FusedLinearOperation::CreateMatmul("dense", Shape({1, 3, 3, 3}),
+                                         Shape({3, 2}), Shape({2}),
+                                         Activation::kClippedRelu, 1.0),
+      {conv, w, b}, &graph);
+  AddToGraph(ReduceSumOperation::Create("loss", Shape({1, 3, 3, 2}),
+                                        {0, 1, 2, 3}),
+             {dense}, &graph);
+  ExpectGradientsMatchFiniteDifferences(
+      graph,
+      {{"x", MakeNonzeroWeights(Shape({1, 4, 4, 2}), 3)},
+       {"conv_bias", MakeNonzeroWeights(Shape({3}), 4)},
+       {"w", MakeNonzeroWeights(Shape({3, 2}), 5)}},
+      "loss");
+}
+
+TEST(GradientEvaluatorTest, SubgradientsAndUnusedVariables) {
+  NeuralNetGraph graph;
+  const int x = AddToGraph(VariableOperation::Create("x", Shape({1, 4})), {},
+                           &graph);
+  AddToGraph(VariableOperation::Create("unused", Shape({2})), {}, &graph);
+  const int relu =
+      AddToGraph(ReluOperation::Create("relu", Shape({1, 4})), {x}, &graph);
+  const int loss = AddToGraph(
+      ReduceMaxOperation::Create("loss", Shape({1, 4}), {0, 1}), {relu},
+      &graph);
+  const VariableValues point = {
+      {"x", DoubleTensor(std::vector<std::vector<double>>{
+                {-1.0, 0.0, 2.0, 2.0}})},
+      {"unused", DoubleTensor(std::vector<double>{1.0, 2.0})}};
+  DoubleEvaluator evaluator(point);
+  const std::vector<DoubleTensor> values = graph.Evaluate(&evaluator);
+  GradientEvaluator gradient_evaluator(&graph);
+  const std::vector<DoubleTensor> adjoints =
+      gradient_evaluator.Adjoints(values, loss);
+  // The ReLU has derivative 0 at 0, and the maximum goes to the first 2.
+  EXPECT_EQ(adjoints[relu].flat_values(),
+            std::vector<double>({0.0, 0.0, 1.0, 0.0}));
+  EXPECT_EQ(adjoints[x].flat_values(),
+            std::vector<double>({0.0, 0.0, 1.0, 0.0}));
+  const VariableValues gradients =
+      gradient_evaluator.VariableGradients(values, loss);
+  EXPECT_EQ(gradients.at("unused").flat_values(),
+            std::vector<double>({0.0, 0.0}));
+}
+
+}  // namespace
+}  // namespace tf_opt
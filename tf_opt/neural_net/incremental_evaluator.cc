@@ -0,0 +1,281 @@
+// Copyright 2026 The tf.opt Authors.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "tf_opt/neural_net/incremental_evaluator.h"
+
+#include <algorithm>
+#include <cstdint>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "ortools/base/logging.h"
+#include "absl/container/flat_hash_map.h"
+#include "absl/strings/string_view.h"
+#include "tf_opt/neural_net/ops/all_operations.h"
+#include "tf_opt/tensor/tensor.h"
+
+namespace tf_opt {
+namespace {
+
+// For an operation whose changed operand x has rows of size row_size, and
+// whose result row i is sum_k x[i, k] * other[k, :], adds the change of the
+// result. This is MatMul(x, other) and EmbeddingLookup(other, x).
+void AddRowDeltas(const std::vector<int64_t>& indices,
+                  const std::vector<double>& changes, const int64_t row_size,
+                  const DoubleTensor& other, DoubleTensor* value) {
+  const int64_t other_row_size = other.size() / row_size;
+  const std::vector<double>& other_values = other.flat_values();
+  std::vector<double>& result = *value->mutable_flat_values();
+  for (int i = 0; i < indices.size(); ++i) {
+    const int64_t row = indices[i] / row_size;
+    const int64_t k = indices[i] % row_size;
+    const double change = changes[i];
+    for (int64_t j = 0; j < other_row_size; ++j) {
+      result[row * other_row_size + j] +=
+          change * other_values[k * other_row_size + j];
+    }
+  }
+}
+
+// Adds the change of MatMul(other, x) for a change of x, of rows of size
+// row_size.
+void AddColumnDeltas(const std::vector<int64_t>& indices,
+                     const std::vector<double>& changes,
+                     const int64_t row_size, const DoubleTensor& other,
+                     DoubleTensor* value) {
+  const int64_t num_other_columns = other.dimension().dimension_sizes()[1];
+  const int64_t num_rows = other.dimension().dimension_sizes()[0];
+  const std::vector<double>& other_values = other.flat_values();
+  std::vector<double>& result = *value->mutable_flat_values();
+  for (int i = 0; i < indices.size(); ++i) {
+    const int64_t k = indices[i] / row_size;
+    const int64_t column = indices[i] % row_size;
+    const double change = changes[i];
+    for (int64_t row = 0; row < num_rows; ++row) {
+      result[row * row_size + column] +=
+          change * other_values[row * num_other_columns + k];
+    }
+  }
+}
+
+// The flat indices, sorted, of the result elements that AddRowDeltas()
+// changes, for a result with rows of size result_row_size.
+std::vector<int64_t> RowDeltaElements(const std::vector<int64_t>& indices,
+                                      const int64_t row_size,
+                                      const int64_t result_row_size) {
+  std::vector<int64_t> rows;
+  for (const int64_t index : indices) {
+    rows.push_back(index / row_size);
+  }
+  std::sort(rows.begin(), rows.end());
+  rows.erase(std::unique(rows.begin(), rows.end()), rows.end());
+  std::vector<int64_t> result;
+  for (const int64_t row : rows) {
+    for (int64_t j = 0; j < result_row_size; ++j) {
+      result.push_back(row * result_row_size + j);
+    }
+  }
+  return result;
+}
+
+// The flat indices, sorted, of the result elements that AddColumnDeltas()
+// changes, for a result of num_rows rows.
+std::vector<int64_t> ColumnDeltaElements(const std::vector<int64_t>& indices,
+                                         const int64_t row_size,
+                                         const int64_t num_rows) {
+  std::vector<int64_t> columns;
+  for (const int64_t index : indices) {
+    columns.push_back(index % row_size);
+  }
+  std::sort(columns.begin(), columns.end());
+  columns.erase(std::unique(columns.begin(), columns.end()), columns.end());
+  std::vector<int64_t> result;
+  for (int64_t row = 0; row < num_rows; ++row) {
+    for (const int64_t column : columns) {
+      result.push_back(row * row_size + column);
+    }
+  }
+  return result;
+}
+
+bool IsMatrix(const DoubleTensor& tensor) {
+  return tensor.dimension().num_dimensions() == 2;
+}
+
+}  // namespace
+
+IncrementalEvaluator::IncrementalEvaluator(
+    const NeuralNetGraph* graph,
+    absl::flat_hash_map<std::string, DoubleTensor> variable_values)
+    : graph_(graph),
+      evaluator_(std::move(variable_values)),
+      dirty_variables_(graph->num_operations(), false) {
+  for (const int id : graph_->variables()) {
+    const Operation& variable = graph_->operation(id);
+    const auto it = evaluator_.variable_values().find(variable.name());
+    CHECK(it != evaluator_.variable_values().end())
+        << "No value for variable: " << variable.name();
+    CHECK(it->second.dimension() == variable.output_shape())
+        << "Wrong shape for variable: " << variable.name();
+  }
+}
+
+int IncrementalEvaluator::VariableId(const absl::string_view name) const {
+  const int id = graph_->OperationIdOrDie(name);
+  CHECK(std::binary_search(graph_->variables().begin(),
+                           graph_->variables().end(), id))
+      << "Not a variable: " << name;
+  return id;
+}
+
+void IncrementalEvaluator::SetVariableValue(const absl::string_view name,
+                                            DoubleTensor value) {
+  const int id = VariableId(name);
+  CHECK(value.dimension() == graph_->operation(id).output_shape())
+      << "Wrong shape for variable: " << name;
+  evaluator_.set_variable_value(name, std::move(value));
+  dirty_variables_[id] = true;
+}
+
+void IncrementalEvaluator::SetVariableElement(const absl::string_view name,
+                                              const int64_t flat_index,
+                                              const double value) {
+  const int id = VariableId(name);
+  DoubleTensor variable_value = evaluator_.variable_values().at(name);
+  CHECK_GE(flat_index, 0);
+  CHECK_LT(flat_index, variable_value.size());
+  (*variable_value.mutable_flat_values())[flat_index] = value;
+  evaluator_.set_variable_value(name, std::move(variable_value));
+  dirty_variables_[id] = true;
+}
+
+void IncrementalEvaluator::Invalidate() { evaluated_ = false; }
+
+const std::vector<DoubleTensor>& IncrementalEvaluator::Evaluate() {
+  const int num_operations = graph_->num_operations();
+  if (!evaluated_) {
+    values_ = graph_->Evaluate(&evaluator_);
+    stats_.num_evaluated_operations += num_operations;
+    std::fill(dirty_variables_.begin(), dirty_variables_.end(), false);
+    evaluated_ = true;
+    return values_;
+  }
+
+  // An operation is reached if it is downstream of a dirty variable, and
+  // changed if its value differs from the cached one, as given by its delta.
+  std::vector<bool> reached(num_operations, false);
+  std::vector<ValueDelta> deltas(num_operations);
+  for (int id = 0; id < num_operations; ++id) {
+    bool input_reached = dirty_variables_[id];
+    bool input_changed = dirty_variables_[id];
+    for (const int input : graph_->inputs(id)) {
+      input_reached = input_reached || reached[input];
+      input_changed = input_changed || !deltas[input].indices.empty();
+    }
+    reached[id] = input_reached;
+    if (!input_changed) {
+      if (input_reached) {
+        ++stats_.num_skipped_operations;
+      }
+      continue;
+    }
+    if (TryDeltaUpdate(id, &deltas)) {
+      ++stats_.num_delta_updates;
+      continue;
+    }
+    std::vector<const DoubleTensor*> inputs;
+    for (const int input : graph_->inputs(id)) {
+      inputs.push_back(&values_[input]);
+    }
+    const DoubleTensor old_value = std::move(values_[id]);
+    values_[id] = evaluator_.Evaluate(&graph_->operation(id), inputs);
+    ++stats_.num_evaluated_operations;
+    const std::vector<double>& new_values = values_[id].flat_values();
+    const std::vector<double>& old_values = old_value.flat_values();
+    ValueDelta& delta = deltas[id];
+    for (int64_t i = 0; i < new_values.size(); ++i) {
+      if (new_values[i] != old_values[i]) {
+        delta.indices.push_back(i);
+        delta.changes.push_back(new_values[i] - old_values[i]);
+      }
+    }
+  }
+  std::fill(dirty_variables_.begin(), dirty_variables_.end(), false);
+  return values_;
+}
+
+bool IncrementalEvaluator::TryDeltaUpdate(
+    const int id, std::vector<ValueDelta>* deltas) {
+  const std::vector<int>& inputs = graph_->inputs(id);
+  if (inputs.size() != 2 || inputs[0] == inputs[1]) {
+    return false;
+  }
+  const bool left_changed = !(*deltas)[inputs[0]].indices.empty();
+  const bool right_changed = !(*deltas)[inputs[1]].indices.empty();
+  if (left_changed == right_changed) {
+    return false;
+  }
+  const int changed = left_changed ? 0 : 1;
+  const ValueDelta& delta = (*deltas)[inputs[changed]];
+  const DoubleTensor& changed_value = values_[inputs[changed]];
+  const DoubleTensor& other = values_[inputs[1 - changed]];
+  // Past half of the elements, the update costs more than an evaluation.
+  if (2 * delta.indices.size() > changed_value.size()) {
+    return false;
+  }
+  const Operation& op = graph_->operation(id);
+  const int64_t row_size = changed_value.dimension().dimension_sizes().back();
+  const bool is_matmul = dynamic_cast<const MatmulOperation*>(&op) != nullptr;
+  if (is_matmul && (!IsMatrix(changed_value) || !IsMatrix(other))) {
+    return false;
+  }
+  const bool is_row_update =
+      (is_matmul && changed == 0) ||
+      (dynamic_cast<const EmbeddingLookupOperation*>(&op) != nullptr &&
+       changed == 1);
+  if (!is_matmul && !is_row_update) {
+    return false;
+  }
+
+  // Updates the value in place, keeping the old values of the elements that
+  // may change to compute its delta.
+  DoubleTensor* value = &values_[id];
+  const std::vector<int64_t> elements =
+      is_row_update
+          ? RowDeltaElements(delta.indices, row_size, other.size() / row_size)
+          : ColumnDeltaElements(delta.indices, row_size,
+                                other.dimension().dimension_sizes()[0]);
+  std::vector<double> old_values;
+  old_values.reserve(elements.size());
+  for (const int64_t i : elements) {
+    old_values.push_back(value->flat_value(i));
+  }
+  if (is_row_update) {
+    AddRowDeltas(delta.indices, delta.changes, row_size, other, value);
+  } else {
+    AddColumnDeltas(delta.indices, delta.changes, row_size, other, value);
+  }
+  ValueDelta& value_delta = (*deltas)[id];
+  for (int i = 0; i < elements.size(); ++i) {
+    const double new_value = value->flat_value(elements[i]);
+    if (new_value != old_values[i]) {
+      value_delta.indices.push_back(elements[i]);
+      value_delta.changes.push_back(new_value - old_values[i]);
+    }
+  }
+  return true;
+}
+
+}  // namespace tf_opt
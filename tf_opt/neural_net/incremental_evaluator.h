@@ -0,0 +1,129 @@
+// Copyright 2026 The tf.opt Authors.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef TF_OPT_NEURAL_NET_INCREMENTAL_EVALUATOR_H_
+#define TF_OPT_NEURAL_NET_INCREMENTAL_EVALUATOR_H_
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+#include "absl/container/flat_hash_map.h"
+#include "absl/strings/string_view.h"
+#include "tf_opt/neural_net/double_evaluator.h"
+#include "tf_opt/neural_net/neural_net_graph.h"
+#include "tf_opt/tensor/tensor.h"
+
+namespace tf_opt {
+
+// Counters of the work done by an IncrementalEvaluator, summed over all the
+// calls to Evaluate().
+struct IncrementalEvaluationStats {
+  // Operations evaluated from their inputs, with a DoubleEvaluator.
+  int64_t num_evaluated_operations = 0;
+
+  // MatMul and EmbeddingLookup operations updated from the change of one of
+  // their inputs, instead of being evaluated again.
+  int64_t num_delta_updates = 0;
+
+  // Operations that were downstream of a changed variable, but none of whose
+  // inputs had changed by the time they were reached.
+  int64_t num_skipped_operations = 0;
+};
+
+// Evaluates a NeuralNetGraph on DoubleTensors repeatedly, when only some of
+// its variables change between evaluations (e.g. in a local search over the
+// inputs of the network).
+//
+// The values of all operations are cached. Evaluate() only visits the
+// operations downstream of the variables that changed since the previous
+// call, in the order of their ids, and an operation is only evaluated again
+// if the value of one of its inputs actually changed. In particular, a ReLU
+// that stays inactive stops the propagation of a change.
+//
+// A MatMul or EmbeddingLookup operation with rank 2 operands (any rank for
+// the ids of an EmbeddingLookup), where only one operand changed in a few
+// elements, is updated rather than evaluated: changing element k of row i of
+// the left operand of MatMul(x, w) by d adds d * w[k, :] to row i of the
+// result, and similarly for the columns of the right operand and for the rows
+// of ids. This applies to the first layer when few inputs change, and to later
+// layers while the changes stay sparse. The result equals a full evaluation up
+// to rounding errors, which accumulate over updates; Invalidate() forces a
+// full evaluation.
+//
+// Example use:
+//   IncrementalEvaluator evaluator(&graph, {{"x", x}});
+//   const DoubleTensor& y = evaluator.Evaluate()[y_id];
+//   evaluator.SetVariableElement("x", 3, 0.5);
+//   const DoubleTensor& new_y = evaluator.Evaluate()[y_id];
+class IncrementalEvaluator {
+ public:
+  // The graph must outlive this. variable_values must contain a value of the
+  // right shape for every VariableOperation of the graph.
+  IncrementalEvaluator(
+      const NeuralNetGraph* graph,
+      absl::flat_hash_map<std::string, DoubleTensor> variable_values);
+
+  // Sets the value of the variable called "name", which must have its shape.
+  // The values of the graph are only updated by the next Evaluate().
+  void SetVariableValue(absl::string_view name, DoubleTensor value);
+
+  // Like above, but only sets the element of flat index "flat_index".
+  void SetVariableElement(absl::string_view name, int64_t flat_index,
+                          double value);
+
+  // Discards the cached values: the next Evaluate() evaluates every
+  // operation.
+  void Invalidate();
+
+  // Updates the values of the graph for the current variable values, and
+  // returns them indexed by operation id. The first call evaluates every
+  // operation.
+  const std::vector<DoubleTensor>& Evaluate();
+
+  // The values computed by the last call to Evaluate().
+  const std::vector<DoubleTensor>& values() const { return values_; }
+
+  const IncrementalEvaluationStats& stats() const { return stats_; }
+
+ private:
+  // The elements of a value that changed in an Evaluate(), with the amount
+  // they changed by.
+  struct ValueDelta {
+    std::vector<int64_t> indices;
+    std::vector<double> changes;
+  };
+
+  // The id of the variable called "name", which must exist.
+  int VariableId(absl::string_view name) const;
+
+  // If operation "id" can be updated in place from the deltas of its inputs,
+  // updates values_[id], stores its delta in (*deltas)[id] and returns true.
+  // Requires the values of its inputs to be up to date.
+  bool TryDeltaUpdate(int id, std::vector<ValueDelta>* deltas);
+
+  const NeuralNetGraph* graph_;
+  DoubleEvaluator evaluator_;
+  std::vector<DoubleTensor> values_;
+  bool evaluated_ = false;
+
+  // The variables set since the last Evaluate(), indexed by operation id.
+  std::vector<bool> dirty_variables_;
+
+  IncrementalEvaluationStats stats_;
+};
+
+}  // namespace tf_opt
+
+#endif  // TF_OPT_NEURAL_NET_INCREMENTAL_EVALUATOR_H_
@@ -0,0 +1,215 @@
+// Copyright 2026 The tf.opt Authors.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "tf_opt/neural_net/incremental_evaluator.h"
+
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "gtest/gtest.h"
+#include "absl/container/flat_hash_map.h"
+#include "absl/status/statusor.h"
+#include "tf_opt/neural_net/double_evaluator.h"
+#include "tf_opt/neural_net/neural_net_graph.h"
+#include "tf_opt/neural_net/operation_testing.h"
+#include "tf_opt/neural_net/ops/all_operations.h"
+#include "tf_opt/tensor/shape.h"
+#include "tf_opt/tensor/tensor.h"
+#include "tf_opt/tensor/tensor_testing.h"
+
+namespace tf_opt {
+namespace {
+
+// Checks that evaluator has the values of a full evaluation of graph at
+// variable_values, up to rounding errors.
+void ExpectFullEvaluationValues(
+    const NeuralNetGraph& graph,
+    const absl::flat_hash_map<std::string, DoubleTensor>& variable_values,
+    const IncrementalEvaluator& evaluator) {
+  DoubleEvaluator full_evaluator(variable_values);
+  const std::vector<DoubleTensor> expected = graph.Evaluate(&full_evaluator);
+  ASSERT_EQ(evaluator.values().size(), expected.size());
+  for (int id = 0; id < graph.num_operations(); ++id) {
+    const DoubleTensor& value = evaluator.values()[id];
+    ASSERT_EQ(value.dimension(), expected[id].dimension());
+    for (int64_t i = 0; i < value.size(); ++i) {
+      EXPECT_NEAR(value.flat_value(i), expected[id].flat_value(i), 1e-9)
+          << graph.operation(id).name() << " at " << i;
+    }
+  }
+}
+
+// y = relu(x * w1 + b1) * w2, with x of shape [2, 4].
+NeuralNetGraph MakeDenseNet() {
+  NeuralNetGraph graph;
+  const int x = AddToGraph(VariableOperation::Create("x", Shape({2, 4})), {},
+                           &graph);
+  const int w1 = AddConstant("w1", MakeWeights(Shape({4, 5}), 1), &graph);
+  const int b1 = AddConstant("b1", MakeWeights(Shape({5}), 2), &graph);
+  const int w2 = AddConstant("w2", MakeWeights(Shape({5, 3}), 3), &graph);
+  const int matmul1 = AddToGraph(
+      MatmulOperation::Create("matmul1", Shape({2, 4}), Shape({4, 5})),
+      {x, w1}, &graph);
+  const int add1 = AddToGraph(
+      AddOperation::Create("add1", Shape({2, 5}), Shape({5})), {matmul1, b1},
+      &graph);
+  const int relu1 =
+      AddToGraph(ReluOperation::Create("relu1", Shape({2, 5})), {add1},
+                 &graph);
+  AddToGraph(MatmulOperation::Create("y", Shape({2, 5}), Shape({5, 3})),
+             {relu1, w2}, &graph);
+  return graph;
+}
+
+TEST(IncrementalEvaluatorTest, FirstEvaluationEvaluatesEverything) {
+  const NeuralNetGraph graph = MakeDenseNet();
+  const absl::flat_hash_map<std::string, DoubleTensor> variable_values = {
+      {"x", MakeWeights(Shape({2, 4}), 4)}};
+  IncrementalEvaluator evaluator(&graph, variable_values);
+  evaluator.Evaluate();
+  ExpectFullEvaluationValues(graph, variable_values, evaluator);
+  EXPECT_EQ(evaluator.stats().num_evaluated_operations,
+            graph.num_operations());
+  EXPECT_EQ(evaluator.stats().num_delta_updates, 0);
+
+  // Nothing changed.
+  evaluator.Evaluate();
+  EXPECT_EQ(evaluator.stats().num_evaluated_operations,
+            graph.num_operations());
+}
+
+TEST(IncrementalEvaluatorTest, UpdatesFirstLayerWithDeltas) {
+  const NeuralNetGraph graph = MakeDenseNet();
+  absl::flat_hash_map<std::string, DoubleTensor> variable_values = {
+      {"x", MakeWeights(Shape({2, 4}), 4)}};
+  IncrementalEvaluator evaluator(&graph, variable_values);
+  evaluator.Evaluate();
+  const IncrementalEvaluationStats initial_stats = evaluator.stats();
+
+  // A single element of x changes: x, add1 and relu1 are evaluated again.
+  // matmul1 is updated, and so is y, as only row 1 of relu1 changes.
+  (*variable_values["x"].mutable_flat_values())[5] = 0.75;
+  evaluator.SetVariableElement("x", 5, 0.75);
+  evaluator.Evaluate();
+  ExpectFullEvaluationValues(graph, variable_values, evaluator);
+  EXPECT_EQ(evaluator.stats().num_delta_updates,
+            initial_stats.num_delta_updates + 2);
+  EXPECT_EQ(evaluator.stats().num_evaluated_operations,
+            initial_stats.num_evaluated_operations + 3);
+
+  // A change of every element is evaluated in full.
+  variable_values["x"] = MakeWeights(Shape({2, 4}), 7);
+  evaluator.SetVariableValue("x", variable_values["x"]);
+  evaluator.Evaluate();
+  ExpectFullEvaluationValues(graph, variable_values, evaluator);
+  EXPECT_EQ(evaluator.stats().num_delta_updates,
+            initial_stats.num_delta_updates + 2);
+}
+
+TEST(IncrementalEvaluatorTest, MatchesFullEvaluationOverManyChanges) {
+  const NeuralNetGraph graph = MakeDenseNet();
+  absl::flat_hash_map<std::string, DoubleTensor> variable_values = {
+      {"x", MakeWeights(Shape({2, 4}), 4)}};
+  IncrementalEvaluator evaluator(&graph, variable_values);
+  evaluator.Evaluate();
+  for (int step = 0; step < 50; ++step) {
+    const int64_t index = (step * 5) % 8;
+    const double value = ((step * 13) % 17) / 8.0 - 1.0;
+    (*variable_values["x"].mutable_flat_values())[index] = value;
+    evaluator.SetVariableElement("x", index, value);
+    if (step % 3 == 0) {
+      evaluator.Evaluate();
+      ExpectFullEvaluationValues(graph, variable_values, evaluator);
+    }
+  }
+  EXPECT_GT(evaluator.stats().num_delta_updates, 0);
+
+  evaluator.Invalidate();
+  evaluator.Evaluate();
+  ExpectFullEvaluationValues(graph, variable_values, evaluator);
+}
+
+TEST(IncrementalEvaluatorTest, OnlyEvaluatesDownstreamOfChanges) {
+  NeuralNetGraph graph;
+  const int x = AddToGraph(VariableOperation::Create("x", Shape({1, 3})), {},
+                           &graph);
+  const int z = AddToGraph(VariableOperation::Create("z", Shape({1, 3})), {},
+                           &graph);
+  const int relu_x =
+      AddToGraph(ReluOperation::Create("relu_x", Shape({1, 3})), {x}, &graph);
+  const int relu_z =
+      AddToGraph(ReluOperation::Create("relu_z", Shape({1, 3})), {z}, &graph);
+  AddToGraph(AddOperation::Create("sum", Shape({1, 3}), Shape({1, 3})),
+             {relu_x, relu_z}, &graph);
+  absl::flat_hash_map<std::string, DoubleTensor> variable_values = {
+      {"x", DoubleTensor(std::vector<std::vector<double>>{{1.0, -2.0, 3.0}})},
+      {"z", DoubleTensor(std::vector<std::vector<double>>{{-1.0, 2.0, 0.5}})}};
+  IncrementalEvaluator evaluator(&graph, variable_values);
+  evaluator.Evaluate();
+
+  // z, relu_z and sum.
+  variable_values["z"] =
+      DoubleTensor(std::vector<std::vector<double>>{{-1.0, 4.0, 0.5}});
+  evaluator.SetVariableValue("z", variable_values["z"]);
+  evaluator.Evaluate();
+  ExpectFullEvaluationValues(graph, variable_values, evaluator);
+  EXPECT_EQ(evaluator.stats().num_evaluated_operations, 5 + 3);
+  EXPECT_EQ(evaluator.stats().num_skipped_operations, 0);
+
+  // relu_x stays 0, so sum is not evaluated again.
+  variable_values["x"] =
+      DoubleTensor(std::vector<std::vector<double>>{{1.0, -5.0, 3.0}});
+  evaluator.SetVariableValue("x", variable_values["x"]);
+  evaluator.Evaluate();
+  ExpectFullEvaluationValues(graph, variable_values, evaluator);
+  EXPECT_EQ(evaluator.stats().num_evaluated_operations, 5 + 3 + 2);
+  EXPECT_EQ(evaluator.stats().num_skipped_operations, 1);
+}
+
+TEST(IncrementalEvaluatorTest, UpdatesRightOperandAndEmbeddingLookup) {
+  NeuralNetGraph graph;
+  const int x = AddToGraph(VariableOperation::Create("x", Shape({3, 2})), {},
+                           &graph);
+  const int ids = AddToGraph(
+      VariableOperation::Create("ids", Shape({1, 2, 4})), {}, &graph);
+  const int w = AddConstant("w", MakeWeights(Shape({2, 3}), 1), &graph);
+  const int params =
+      AddConstant("params", MakeWeights(Shape({4, 3}), 2), &graph);
+  AddToGraph(MatmulOperation::Create("left", Shape({2, 3}), Shape({3, 2})),
+             {w, x}, &graph);
+  AddToGraph(EmbeddingLookupOperation::Create("lookup", Shape({4, 3}),
+                                              Shape({1, 2, 4})),
+             {params, ids}, &graph);
+  absl::flat_hash_map<std::string, DoubleTensor> variable_values = {
+      {"x", MakeWeights(Shape({3, 2}), 3)},
+      {"ids", DoubleTensor::FromFlatData(Shape({1, 2, 4}),
+                                         {0, 1, 0, 0, 0, 0, 0, 1})}};
+  IncrementalEvaluator evaluator(&graph, variable_values);
+  evaluator.Evaluate();
+
+  (*variable_values["x"].mutable_flat_values())[3] = 0.25;
+  evaluator.SetVariableElement("x", 3, 0.25);
+  variable_values["ids"] = DoubleTensor::FromFlatData(
+      Shape({1, 2, 4}), {0, 1, 0, 0, 0, 0, 1, 0});
+  evaluator.SetVariableValue("ids", variable_values["ids"]);
+  evaluator.Evaluate();
+  ExpectFullEvaluationValues(graph, variable_values, evaluator);
+  EXPECT_EQ(evaluator.stats().num_delta_updates, 2);
+}
+
+}  // namespace
+}  // namespace tf_opt
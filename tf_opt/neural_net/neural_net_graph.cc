@@ -0,0 +1,197 @@
+// Copyright 2026 The tf.opt Authors.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "tf_opt/neural_net/neural_net_graph.h"
+
+#include <functional>
+#include <memory>
+#include <queue>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "absl/container/flat_hash_map.h"
+#include "absl/status/status.h"
+#include "absl/status/statusor.h"
+#include "absl/strings/str_cat.h"
+#include "tf_opt/neural_net/op_registry.h"
+#include "tf_opt/neural_net/ops/constant_operation.h"
+#include "tf_opt/neural_net/ops/variable_operation.h"
+#include "tf_opt/tensor/tensor.h"
+
+namespace tf_opt {
+
+absl::StatusOr<NeuralNetGraph> NeuralNetGraph::FromProto(
+    const proto::NeuralNet& neural_net) {
+  NeuralNetGraph graph;
+  for (const proto::ParameterValue& param : neural_net.params()) {
+    TFOPT_ASSIGN_OR_RETURN(
+        ConstantOperation constant,
+        ConstantOperation::Create(param.name(), ProtoToDoubleTensor(param)));
+    TFOPT_RETURN_IF_ERROR(
+        graph
+            .AddOperation(
+                std::make_unique<ConstantOperation>(std::move(constant)), {})
+            .status());
+  }
+
+  // Sort the tensor nodes topologically (Kahn's algorithm). Among the nodes
+  // that are ready, the first one in the proto is picked, so that sorted
+  // protos keep their order.
+  const int num_nodes = neural_net.tensor_nodes_size();
+  absl::flat_hash_map<std::string, int> node_index;
+  for (int i = 0; i < num_nodes; ++i) {
+    const std::string& name = neural_net.tensor_nodes(i).name();
+    if (graph.name_to_id_.contains(name) ||
+        !node_index.try_emplace(name, i).second) {
+      return absl::InvalidArgumentError(
+          absl::StrCat("Duplicate name in neural net: ", name));
+    }
+  }
+  std::vector<int> num_missing_inputs(num_nodes, 0);
+  std::vector<std::vector<int>> dependents(num_nodes);
+  for (int i = 0; i < num_nodes; ++i) {
+    const proto::TensorNode& node = neural_net.tensor_nodes(i);
+    for (const std::string& input_name : node.input_names()) {
+      const auto it = node_index.find(input_name);
+      if (it != node_index.end()) {
+        dependents[it->second].push_back(i);
+        ++num_missing_inputs[i];
+      } else if (!graph.name_to_id_.contains(input_name)) {
+        return absl::InvalidArgumentError(
+            absl::StrCat("Node: ", node.name(),
+                         " has undefined input: ", input_name));
+      }
+    }
+  }
+  std::priority_queue<int, std::vector<int>, std::greater<int>> ready;
+  for (int i = 0; i < num_nodes; ++i) {
+    if (num_missing_inputs[i] == 0) {
+      ready.push(i);
+    }
+  }
+  int num_added = 0;
+  while (!ready.empty()) {
+    const int i = ready.top();
+    ready.pop();
+    const proto::TensorNode& node = neural_net.tensor_nodes(i);
+    std::vector<int> input_ids;
+    std::vector<Shape> input_shapes;
+    for (const std::string& input_name : node.input_names()) {
+      const int input_id = graph.name_to_id_.at(input_name);
+      input_ids.push_back(input_id);
+      input_shapes.push_back(graph.operation(input_id).output_shape());
+    }
+    TFOPT_ASSIGN_OR_RETURN(
+        std::unique_ptr<Operation> operation,
+        op_registry::MakeOperation(
+            node.op_type(), node.name(), std::move(input_shapes),
+            Shape(node.out_dimension()), Operation::Options(node.options())));
+    TFOPT_RETURN_IF_ERROR(
+        graph.AddOperation(std::move(operation), std::move(input_ids))
+            .status());
+    ++num_added;
+    for (const int dependent : dependents[i]) {
+      if (--num_missing_inputs[dependent] == 0) {
+        ready.push(dependent);
+      }
+    }
+  }
+  if (num_added < num_nodes) {
+    for (int i = 0; i < num_nodes; ++i) {
+      if (num_missing_inputs[i] > 0) {
+        return absl::InvalidArgumentError(
+            absl::StrCat("Neural net has a cycle through node: ",
+                         neural_net.tensor_nodes(i).name()));
+      }
+    }
+  }
+  return graph;
+}
+
+absl::StatusOr<int> NeuralNetGraph::AddOperation(
+    std::unique_ptr<Operation> operation, std::vector<int> input_ids) {
+  CHECK(operation != nullptr);
+  const int id = num_operations();
+  std::vector<Shape> input_shapes;
+  for (const int input_id : input_ids) {
+    if (input_id < 0 || input_id >= id) {
+      return absl::InvalidArgumentError(
+          absl::StrCat("Node: ", operation->name(),
+                       " has input id out of range: ", input_id));
+    }
+    input_shapes.push_back(operations_[input_id]->output_shape());
+  }
+  TFOPT_RETURN_IF_ERROR(
+      internal::CheckInputShapesAreCorrect(operation.get(), input_shapes));
+  if (!name_to_id_.try_emplace(operation->name(), id).second) {
+    return absl::InvalidArgumentError(
+        absl::StrCat("Duplicate name in neural net: ", operation->name()));
+  }
+  for (const int input_id : input_ids) {
+    std::vector<int>& input_consumers = consumers_[input_id];
+    if (input_consumers.empty() || input_consumers.back() != id) {
+      input_consumers.push_back(id);
+    }
+  }
+  if (dynamic_cast<const VariableOperation*>(operation.get()) != nullptr) {
+    variables_.push_back(id);
+  }
+  operations_.push_back(std::move(operation));
+  inputs_.push_back(std::move(input_ids));
+  consumers_.emplace_back();
+  return id;
+}
+
+proto::NeuralNet NeuralNetGraph::ToProto() const {
+  proto::NeuralNet result;
+  for (int id = 0; id < num_operations(); ++id) {
+    const Operation& op = operation(id);
+    if (const auto* constant = dynamic_cast<const ConstantOperation*>(&op)) {
+      *result.add_params() = constant->ToProto();
+      continue;
+    }
+    std::vector<std::string> input_names;
+    for (const int input_id : inputs_[id]) {
+      input_names.push_back(operations_[input_id]->name());
+    }
+    *result.add_tensor_nodes() = op.ToProto(input_names);
+  }
+  return result;
+}
+
+std::vector<int> NeuralNetGraph::Sinks() const {
+  std::vector<int> result;
+  for (int id = 0; id < num_operations(); ++id) {
+    if (consumers_[id].empty()) {
+      result.push_back(id);
+    }
+  }
+  return result;
+}
+
+absl::StatusOr<int> NeuralNetGraph::OperationId(absl::string_view name) const {
+  const auto it = name_to_id_.find(name);
+  if (it == name_to_id_.end()) {
+    return absl::NotFoundError(
+        absl::StrCat("No operation in neural net with name: ", name));
+  }
+  return it->second;
+}
+
+int NeuralNetGraph::OperationIdOrDie(absl::string_view name) const {
+  return OperationId(name).value();
+}
+
+}  // namespace tf_opt
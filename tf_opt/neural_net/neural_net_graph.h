@@ -0,0 +1,162 @@
+// Copyright 2026 The tf.opt Authors.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef TF_OPT_NEURAL_NET_NEURAL_NET_GRAPH_H_
+#define TF_OPT_NEURAL_NET_NEURAL_NET_GRAPH_H_
+
+#include <memory>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "ortools/base/logging.h"
+#include "absl/container/flat_hash_map.h"
+#include "absl/status/statusor.h"
+#include "absl/strings/string_view.h"
+#include "tf_opt/neural_net/neural_net.pb.h"
+#include "tf_opt/neural_net/operation.h"
+#include "tf_opt/neural_net/operation_evaluator.h"
+#include "tf_opt/open_source/status_macros.h"
+
+namespace tf_opt {
+
+// A neural network as a DAG of Operations, where each operation is identified
+// by a dense integer id in [0, num_operations()).
+//
+// Ids are assigned in a topological order: the inputs of an operation always
+// have smaller ids than the operation itself. Iterating over the ids in
+// increasing order is therefore a valid execution plan, and the names used in
+// the proto are only looked up once, when the graph is built.
+//
+// Typical use:
+//   TFOPT_ASSIGN_OR_RETURN(NeuralNetGraph graph,
+//                          NeuralNetGraph::FromProto(neural_net_proto));
+//   MyEvaluator evaluator(...);  // An OperationEvaluator<DoubleTensor>.
+//   std::vector<DoubleTensor> values = graph.Evaluate(&evaluator);
+//   const DoubleTensor& output = values[graph.OperationIdOrDie("output")];
+class NeuralNetGraph {
+ public:
+  // An empty graph, see AddOperation().
+  NeuralNetGraph() = default;
+
+  NeuralNetGraph(NeuralNetGraph&&) = default;
+  NeuralNetGraph& operator=(NeuralNetGraph&&) = default;
+
+  // Builds the graph of a NeuralNet proto. Parameters become
+  // ConstantOperations and tensor nodes are built with
+  // op_registry::MakeOperation(). The tensor nodes need not be sorted.
+  //
+  // Returns an error if names are not unique, if an input name is not
+  // defined, if the nodes have a cycle, or if an operation is invalid.
+  static absl::StatusOr<NeuralNetGraph> FromProto(
+      const proto::NeuralNet& neural_net);
+
+  // Adds operation to the graph, with the operations of ids "input_ids" as
+  // inputs, and returns its id. The inputs must already be in the graph, and
+  // their output shapes must match the input shapes of operation. The name of
+  // operation must be unique in the graph.
+  absl::StatusOr<int> AddOperation(std::unique_ptr<Operation> operation,
+                                   std::vector<int> input_ids);
+
+  // Inverse of FromProto(), up to the order of the nodes.
+  proto::NeuralNet ToProto() const;
+
+  int num_operations() const { return operations_.size(); }
+
+  const Operation& operation(int id) const { return *operations_[id]; }
+
+  // The ids of the inputs of operation "id", in order.
+  const std::vector<int>& inputs(int id) const { return inputs_[id]; }
+
+  // The ids of the operations that take operation "id" as an input, sorted
+  // and without duplicates.
+  const std::vector<int>& consumers(int id) const { return consumers_[id]; }
+
+  // The ids of the VariableOperations, in increasing order.
+  const std::vector<int>& variables() const { return variables_; }
+
+  // The ids of the operations that are not an input of any other operation,
+  // in increasing order. These are typically the outputs of the network.
+  std::vector<int> Sinks() const;
+
+  // Returns the id of the operation called "name", or a NotFound error.
+  absl::StatusOr<int> OperationId(absl::string_view name) const;
+  int OperationIdOrDie(absl::string_view name) const;
+
+  // Evaluates every operation of the graph, in order, and returns the results
+  // indexed by operation id.
+  template <typename T>
+  std::vector<T> Evaluate(OperationEvaluator<T>* evaluator) const;
+
+  // Like above, but returns the first error, if any.
+  template <typename T>
+  absl::StatusOr<std::vector<T>> Evaluate(
+      UnsafeOperationEvaluator<T>* evaluator) const;
+
+ private:
+  // The arguments to Evaluate the operation "id".
+  template <typename T>
+  std::vector<const T*> EvaluateInputs(int id,
+                                       const std::vector<T>& values) const;
+
+  std::vector<std::unique_ptr<Operation>> operations_;
+  std::vector<std::vector<int>> inputs_;
+  std::vector<std::vector<int>> consumers_;
+  std::vector<int> variables_;
+  absl::flat_hash_map<std::string, int> name_to_id_;
+};
+
+// ///////////////////////////// Implementation ////////////////////////////////
+
+template <typename T>
+std::vector<const T*> NeuralNetGraph::EvaluateInputs(
+    const int id, const std::vector<T>& values) const {
+  std::vector<const T*> result;
+  result.reserve(inputs_[id].size());
+  for (const int input : inputs_[id]) {
+    result.push_back(&values[input]);
+  }
+  return result;
+}
+
+template <typename T>
+std::vector<T> NeuralNetGraph::Evaluate(
+    OperationEvaluator<T>* evaluator) const {
+  CHECK(evaluator != nullptr);
+  std::vector<T> values(num_operations());
+  for (int id = 0; id < num_operations(); ++id) {
+    values[id] =
+        evaluator->Evaluate(operations_[id].get(), EvaluateInputs(id, values));
+  }
+  return values;
+}
+
+template <typename T>
+absl::StatusOr<std::vector<T>> NeuralNetGraph::Evaluate(
+    UnsafeOperationEvaluator<T>* evaluator) const {
+  CHECK(evaluator != nullptr);
+  std::vector<T> values(num_operations());
+  for (int id = 0; id < num_operations(); ++id) {
+    TFOPT_ASSIGN_OR_RETURN(values[id],
+                           evaluator->Evaluate(operations_[id].get(),
+                                               EvaluateInputs(id, values)),
+                           _ << "while evaluating operation: "
+                             << operations_[id]->name());
+  }
+  return values;
+}
+
+}  // namespace tf_opt
+
+#endif  // TF_OPT_NEURAL_NET_NEURAL_NET_GRAPH_H_
@@ -0,0 +1,334 @@
+// Copyright 2026 The tf.opt Authors.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "tf_opt/neural_net/neural_net_graph.h"
+
+#include <memory>
+#include <string>
+#include <type_traits>
+#include <vector>
+
+#include "gmock/gmock.h"
+#include "gtest/gtest.h"
+#include "absl/status/statusor.h"
+#include "tf_opt/neural_net/neural_net.pb.h"
+#include "tf_opt/neural_net/operation_evaluator.h"
+#include "tf_opt/neural_net/operation_testing.h"
+#include "tf_opt/neural_net/ops/all_operations.h"
+#include "tf_opt/open_source/status_matchers.h"
+#include "tf_opt/tensor/shape.h"
+#include "tf_opt/tensor/tensor.h"
+
+namespace tf_opt {
+namespace {
+
+using ::testing::ElementsAre;
+using ::testing::HasSubstr;
+using ::testing::IsEmpty;
+using ::tf_opt::testing::IsOkAndHolds;
+using ::tf_opt::testing::StatusIs;
+
+constexpr absl::StatusCode kInvalidArgument =
+    absl::StatusCode::kInvalidArgument;
+
+void AddParam(const std::string& name, const DoubleTensor& value,
+              proto::NeuralNet* neural_net) {
+  proto::ParameterValue* param = neural_net->add_params();
+  DoubleTensorToProto(value, param);
+  param->set_name(name);
+}
+
+void AddNode(const std::string& name, const proto::OpType op_type,
+             const Shape& output_shape,
+             const std::vector<std::string>& input_names,
+             proto::NeuralNet* neural_net) {
+  proto::TensorNode* node = neural_net->add_tensor_nodes();
+  node->set_name(name);
+  node->set_op_type(op_type);
+  *node->mutable_out_dimension() = output_shape.AsProto();
+  for (const std::string& input_name : input_names) {
+    node->add_input_names(input_name);
+  }
+}
+
+// relu(x * w + b), with the tensor nodes listed in reverse order.
+proto::NeuralNet MakeDenseLayer() {
+  proto::NeuralNet result;
+  AddParam("w", DoubleTensor({{1.0, 2.0}, {3.0, 4.0}, {5.0, 6.0}}), &result);
+  AddParam("b", DoubleTensor({1.0, -1.0}), &result);
+  AddNode("relu", proto::RELU, Shape({1, 2}), {"add"}, &result);
+  AddNode("add", proto::ADD, Shape({1, 2}), {"matmul", "b"}, &result);
+  AddNode("matmul", proto::MAT_MUL, Shape({1, 2}), {"x", "w"}, &result);
+  AddNode("x", proto::INPUT, Shape({1, 3}), {}, &result);
+  return result;
+}
+
+// Evaluates the output shape of each operation, and records the order in
+// which operations are evaluated. When ResultType is a StatusOr, fails on the
+// operation named fail_on.
+template <typename ResultType>
+class RecordingEvaluator
+    : public AbstractOperationEvaluator<ResultType, Shape> {
+ public:
+  explicit RecordingEvaluator(std::string fail_on = "")
+      : fail_on_(std::move(fail_on)) {}
+
+  const std::vector<std::string>& visited() const { return visited_; }
+
+ protected:
+  Shape GetShape(const Shape& tensor) const override { return tensor; }
+
+  ResultType EvaluateAdd(const AddOperation& op, const Shape&,
+                         const Shape&) override {
+    return Record(op);
+  }
+  ResultType EvaluateClippedRelu(const ClippedReluOperation& op,
+                                 const Shape&) override {
+    return Record(op);
+  }
+  ResultType EvaluateConcat(const ConcatOperation& op,
+                            const std::vector<const Shape*>&) override {
+    return Record(op);
+  }
+  ResultType EvaluateConstant(const ConstantOperation& op) override {
+    return Record(op);
+  }
+  ResultType EvaluateConv1d(const Conv1dOperation& op, const Shape&,
+                            const Shape&) override {
+    return Record(op);
+  }
+  ResultType EvaluateConv2d(const Conv2dOperation& op, const Shape&,
+                            const Shape&) override {
+    return Record(op);
+  }
+  ResultType EvaluateDivide(const DivideOperation& op, const Shape&,
+                            const Shape&) override {
+    return Record(op);
+  }
+  ResultType EvaluateEmbeddingLookup(const EmbeddingLookupOperation& op,
+                                     const Shape&, const Shape&) override {
+    return Record(op);
+  }
+  ResultType EvaluateExpandDims(const ExpandDimsOperation& op,
+                                const Shape&) override {
+    return Record(op);
+  }
+  ResultType EvaluateMatmul(const MatmulOperation& op, const Shape&,
+                            const Shape&) override {
+    return Record(op);
+  }
+  ResultType EvaluateMaxpool(const MaxpoolOperation& op,
+                             const Shape&) override {
+    return Record(op);
+  }
+  ResultType EvaluateMultiply(const MultiplyOperation& op, const Shape&,
+                              const Shape&) override {
+    return Record(op);
+  }
+  ResultType EvaluateReduceMax(const ReduceMaxOperation& op,
+                               const Shape&) override {
+    return Record(op);
+  }
+  ResultType EvaluateReduceMean(const ReduceMeanOperation& op,
+                                const Shape&) override {
+    return Record(op);
+  }
+  ResultType EvaluateReduceMin(const ReduceMinOperation& op,
+                               const Shape&) override {
+    return Record(op);
+  }
+  ResultType EvaluateReduceSum(const ReduceSumOperation& op,
+                               const Shape&) override {
+    return Record(op);
+  }
+  ResultType EvaluateRelu(const ReluOperation& op, const Shape&) override {
+    return Record(op);
+  }
+  ResultType EvaluateReshape(const ReshapeOperation& op,
+                             const Shape&) override {
+    return Record(op);
+  }
+  ResultType EvaluateSlice(const SliceOperation& op, const Shape&) override {
+    return Record(op);
+  }
+  ResultType EvaluateSqueeze(const SqueezeOperation& op,
+                             const Shape&) override {
+    return Record(op);
+  }
+  ResultType EvaluateSubtract(const SubtractOperation& op, const Shape&,
+                              const Shape&) override {
+    return Record(op);
+  }
+  ResultType EvaluateVariable(const VariableOperation& op) override {
+    return Record(op);
+  }
+
+ private:
+  ResultType Record(const Operation& op) {
+    visited_.push_back(op.name());
+    if constexpr (!std::is_same_v<ResultType, Shape>) {
+      if (op.name() == fail_on_) {
+        return absl::InternalError("failed on purpose");
+      }
+    }
+    return op.output_shape();
+  }
+
+  std::string fail_on_;
+  std::vector<std::string> visited_;
+};
+
+TEST(NeuralNetGraphTest, FromProtoSortsTopologically) {
+  TFOPT_ASSERT_OK_AND_ASSIGN(const NeuralNetGraph graph,
+                             NeuralNetGraph::FromProto(MakeDenseLayer()));
+  ASSERT_EQ(graph.num_operations(), 6);
+  std::vector<std::string> names;
+  for (int id = 0; id < graph.num_operations(); ++id) {
+    names.push_back(graph.operation(id).name());
+    for (const int input : graph.inputs(id)) {
+      EXPECT_LT(input, id);
+    }
+  }
+  EXPECT_THAT(names, ElementsAre("w", "b", "x", "matmul", "add", "relu"));
+  EXPECT_THAT(graph.inputs(3), ElementsAre(2, 0));
+  EXPECT_THAT(graph.inputs(4), ElementsAre(3, 1));
+  EXPECT_THAT(graph.consumers(3), ElementsAre(4));
+  EXPECT_THAT(graph.consumers(5), IsEmpty());
+  EXPECT_THAT(graph.variables(), ElementsAre(2));
+  EXPECT_THAT(graph.Sinks(), ElementsAre(5));
+  EXPECT_THAT(graph.OperationId("add"), IsOkAndHolds(4));
+  EXPECT_EQ(graph.OperationIdOrDie("relu"), 5);
+  EXPECT_THAT(graph.OperationId("missing"),
+              StatusIs(absl::StatusCode::kNotFound));
+  EXPECT_THAT(graph.operation(3),
+              OperationArgsAre("matmul", {Shape({1, 3}), Shape({3, 2})},
+                               Shape({1, 2})));
+  const auto* w = dynamic_cast<const ConstantOperation*>(&graph.operation(0));
+  ASSERT_NE(w, nullptr);
+  EXPECT_EQ(w->value(), DoubleTensor({{1.0, 2.0}, {3.0, 4.0}, {5.0, 6.0}}));
+}
+
+TEST(NeuralNetGraphTest, RepeatedInput) {
+  proto::NeuralNet neural_net;
+  AddNode("x", proto::INPUT, Shape({2}), {}, &neural_net);
+  AddNode("square", proto::MULTIPLY, Shape({2}), {"x", "x"}, &neural_net);
+  TFOPT_ASSERT_OK_AND_ASSIGN(const NeuralNetGraph graph,
+                             NeuralNetGraph::FromProto(neural_net));
+  EXPECT_THAT(graph.inputs(1), ElementsAre(0, 0));
+  EXPECT_THAT(graph.consumers(0), ElementsAre(1));
+}
+
+TEST(NeuralNetGraphTest, ToProtoRoundTrip) {
+  TFOPT_ASSERT_OK_AND_ASSIGN(const NeuralNetGraph graph,
+                             NeuralNetGraph::FromProto(MakeDenseLayer()));
+  const proto::NeuralNet neural_net = graph.ToProto();
+  ASSERT_EQ(neural_net.params_size(), 2);
+  ASSERT_EQ(neural_net.tensor_nodes_size(), 4);
+  EXPECT_EQ(neural_net.tensor_nodes(1).name(), "matmul");
+  EXPECT_THAT(neural_net.tensor_nodes(1).input_names(), ElementsAre("x", "w"));
+  TFOPT_ASSERT_OK_AND_ASSIGN(const NeuralNetGraph round_trip,
+                             NeuralNetGraph::FromProto(neural_net));
+  ASSERT_EQ(round_trip.num_operations(), graph.num_operations());
+  for (int id = 0; id < graph.num_operations(); ++id) {
+    EXPECT_EQ(round_trip.operation(id).name(), graph.operation(id).name());
+    EXPECT_EQ(round_trip.inputs(id), graph.inputs(id));
+  }
+}
+
+TEST(NeuralNetGraphTest, DuplicateName) {
+  proto::NeuralNet neural_net = MakeDenseLayer();
+  AddNode("w", proto::INPUT, Shape({1}), {}, &neural_net);
+  EXPECT_THAT(NeuralNetGraph::FromProto(neural_net),
+              StatusIs(kInvalidArgument, HasSubstr("Duplicate name")));
+}
+
+TEST(NeuralNetGraphTest, UndefinedInput) {
+  proto::NeuralNet neural_net = MakeDenseLayer();
+  AddNode("relu2", proto::RELU, Shape({1, 2}), {"relu3"}, &neural_net);
+  EXPECT_THAT(NeuralNetGraph::FromProto(neural_net),
+              StatusIs(kInvalidArgument, HasSubstr("undefined input: relu3")));
+}
+
+TEST(NeuralNetGraphTest, Cycle) {
+  proto::NeuralNet neural_net;
+  AddNode("x", proto::INPUT, Shape({2}), {}, &neural_net);
+  AddNode("a", proto::ADD, Shape({2}), {"x", "b"}, &neural_net);
+  AddNode("b", proto::RELU, Shape({2}), {"a"}, &neural_net);
+  EXPECT_THAT(NeuralNetGraph::FromProto(neural_net),
+              StatusIs(kInvalidArgument, HasSubstr("cycle")));
+}
+
+TEST(NeuralNetGraphTest, InvalidOperation) {
+  proto::NeuralNet neural_net = MakeDenseLayer();
+  // Wrong output shape.
+  neural_net.mutable_tensor_nodes(0)->mutable_out_dimension()->add_dim_sizes(
+      1);
+  EXPECT_THAT(NeuralNetGraph::FromProto(neural_net),
+              StatusIs(kInvalidArgument));
+}
+
+TEST(NeuralNetGraphTest, AddOperation) {
+  NeuralNetGraph graph;
+  TFOPT_ASSERT_OK_AND_ASSIGN(const VariableOperation x,
+                             VariableOperation::Create("x", Shape({3})));
+  EXPECT_THAT(graph.AddOperation(std::make_unique<VariableOperation>(x), {}),
+              IsOkAndHolds(0));
+  TFOPT_ASSERT_OK_AND_ASSIGN(const ReluOperation relu,
+                             ReluOperation::Create("relu", Shape({3})));
+  EXPECT_THAT(graph.AddOperation(std::make_unique<ReluOperation>(relu), {1}),
+              StatusIs(kInvalidArgument, HasSubstr("out of range")));
+  EXPECT_THAT(graph.AddOperation(std::make_unique<ReluOperation>(relu), {0}),
+              IsOkAndHolds(1));
+  EXPECT_THAT(graph.AddOperation(std::make_unique<ReluOperation>(relu), {0}),
+              StatusIs(kInvalidArgument, HasSubstr("Duplicate name")));
+  TFOPT_ASSERT_OK_AND_ASSIGN(const ReluOperation bad_relu,
+                             ReluOperation::Create("bad_relu", Shape({4})));
+  EXPECT_THAT(
+      graph.AddOperation(std::make_unique<ReluOperation>(bad_relu), {0}),
+      StatusIs(kInvalidArgument));
+  EXPECT_EQ(graph.num_operations(), 2);
+}
+
+TEST(NeuralNetGraphTest, EvaluateInTopologicalOrder) {
+  TFOPT_ASSERT_OK_AND_ASSIGN(const NeuralNetGraph graph,
+                             NeuralNetGraph::FromProto(MakeDenseLayer()));
+  RecordingEvaluator<Shape> evaluator;
+  const std::vector<Shape> shapes = graph.Evaluate(&evaluator);
+  EXPECT_THAT(evaluator.visited(),
+              ElementsAre("w", "b", "x", "matmul", "add", "relu"));
+  EXPECT_THAT(shapes, ElementsAre(Shape({3, 2}), Shape({2}), Shape({1, 3}),
+                                  Shape({1, 2}), Shape({1, 2}), Shape({1, 2})));
+}
+
+TEST(NeuralNetGraphTest, UnsafeEvaluateSuccess) {
+  TFOPT_ASSERT_OK_AND_ASSIGN(const NeuralNetGraph graph,
+                             NeuralNetGraph::FromProto(MakeDenseLayer()));
+  RecordingEvaluator<absl::StatusOr<Shape>> evaluator;
+  TFOPT_ASSERT_OK_AND_ASSIGN(const std::vector<Shape> shapes,
+                             graph.Evaluate(&evaluator));
+  EXPECT_EQ(shapes.size(), 6);
+}
+
+TEST(NeuralNetGraphTest, UnsafeEvaluateStopsOnError) {
+  TFOPT_ASSERT_OK_AND_ASSIGN(const NeuralNetGraph graph,
+                             NeuralNetGraph::FromProto(MakeDenseLayer()));
+  RecordingEvaluator<absl::StatusOr<Shape>> evaluator("matmul");
+  EXPECT_THAT(graph.Evaluate(&evaluator),
+              StatusIs(absl::StatusCode::kInternal,
+                       HasSubstr("while evaluating operation: matmul")));
+  EXPECT_THAT(evaluator.visited(), ElementsAre("w", "b", "x", "matmul"));
+}
+
+}  // namespace
+}  // namespace tf_opt
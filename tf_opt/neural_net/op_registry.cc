@@ -15,7 +15,9 @@
 #include "tf_opt/neural_net/op_registry.h"
 
 #include <memory>
+#include <string>
 #include <utility>
+#include <vector>
 
 #include "ortools/base/logging.h"
 #include "absl/memory/memory.h"
@@ -45,6 +47,7 @@ ReturnType ApplyForOpType(const proto::OpType op_type, const Transformer& t,
     TFOPT_OP_CASE(proto::CONV1D, Conv1dOperation);
     TFOPT_OP_CASE(proto::CONV2D, Conv2dOperation);
     TFOPT_OP_CASE(proto::EXPAND_DIMS, ExpandDimsOperation);
+    TFOPT_OP_CASE(proto::FUSED_LINEAR, FusedLinearOperation);
     TFOPT_OP_CASE(proto::MAT_MUL, MatmulOperation);
     TFOPT_OP_CASE(proto::MAX_POOL, MaxpoolOperation);
     TFOPT_OP_CASE(proto::EMBEDDING_LOOKUP, EmbeddingLookupOperation);
@@ -90,5 +93,18 @@ absl::StatusOr<std::unique_ptr<Operation>> MakeOperation(
       std::move(output_shape), options);
 }
 
+absl::StatusOr<std::unique_ptr<Operation>> CloneOperation(
+    const Operation& op, std::string op_name) {
+  if (const auto* constant = dynamic_cast<const ConstantOperation*>(&op)) {
+    std::unique_ptr<Operation> result = std::make_unique<ConstantOperation>(
+        std::move(op_name), constant->value());
+    return result;
+  }
+  const proto::TensorNode node =
+      op.ToProto(std::vector<std::string>(op.input_shapes().size()));
+  return MakeOperation(node.op_type(), std::move(op_name), op.input_shapes(),
+                       op.output_shape(), Operation::Options(node.options()));
+}
+
 }  // namespace op_registry
 }  // namespace tf_opt
@@ -33,6 +33,12 @@ absl::StatusOr<std::unique_ptr<Operation>> MakeOperation(
     proto::OpType op_type, std::string op_name, std::vector<Shape> input_shapes,
     Shape output_shape, const Operation::Options& options);
 
+// A copy of op called "op_name", e.g. to build a rewritten NeuralNetGraph.
+// Goes through Operation::ToProto() and MakeOperation(), except for
+// ConstantOperations, which are copied with their value.
+absl::StatusOr<std::unique_ptr<Operation>> CloneOperation(const Operation& op,
+                                                          std::string op_name);
+
 }  // namespace op_registry
 }  // namespace tf_opt
 
@@ -16,6 +16,7 @@
 
 #include <memory>
 #include <string>
+#include <vector>
 
 #include "gmock/gmock.h"
 #include "gtest/gtest.h"
@@ -23,8 +24,10 @@
 #include "tf_opt/neural_net/neural_net.pb.h"
 #include "tf_opt/neural_net/operation.h"
 #include "tf_opt/neural_net/operation_testing.h"
+#include "tf_opt/neural_net/ops/constant_operation.h"
 #include "tf_opt/open_source/status_matchers.h"
 #include "tf_opt/tensor/shape.h"
+#include "tf_opt/tensor/tensor.h"
 
 namespace tf_opt {
 namespace {
@@ -56,5 +59,30 @@ TEST(OpRegistryTest, MakeOperationFailure) {
               StatusIs(kInvalidArgument));
 }
 
+TEST(OpRegistryTest, CloneOperation) {
+  const Shape left({2, 3});
+  const Shape right({1, 3});
+  TFOPT_ASSERT_OK_AND_ASSIGN(
+      std::unique_ptr<Operation> op,
+      op_registry::MakeOperation(proto::SUBTRACT, "subtract", {left, right},
+                                 left, Operation::Options()));
+  TFOPT_ASSERT_OK_AND_ASSIGN(std::unique_ptr<Operation> clone,
+                             op_registry::CloneOperation(*op, "clone"));
+  EXPECT_THAT(*clone, OperationArgsAre("clone", {left, right}, left));
+  EXPECT_EQ(clone->ToProto({"a", "b"}).op_type(), proto::SUBTRACT);
+}
+
+TEST(OpRegistryTest, CloneConstantOperation) {
+  const ConstantOperation constant("constant",
+                                   DoubleTensor(std::vector<double>{1, 2}));
+  TFOPT_ASSERT_OK_AND_ASSIGN(
+      std::unique_ptr<Operation> clone,
+      op_registry::CloneOperation(constant, "clone"));
+  const auto* cloned = dynamic_cast<const ConstantOperation*>(clone.get());
+  ASSERT_NE(cloned, nullptr);
+  EXPECT_EQ(cloned->name(), "clone");
+  EXPECT_EQ(cloned->value().flat_values(), constant.value().flat_values());
+}
+
 }  // namespace
 }  // namespace tf_opt
@@ -15,14 +15,18 @@
 #ifndef TF_OPT_NEURAL_NET_OPERATION_EVALUATOR_H_
 #define TF_OPT_NEURAL_NET_OPERATION_EVALUATOR_H_
 
+#include <type_traits>
+#include <utility>
 #include <vector>
 
+#include "ortools/base/logging.h"
 #include "absl/status/statusor.h"
 #include "absl/strings/str_cat.h"
 #include "tf_opt/neural_net/operation.h"
 #include "tf_opt/neural_net/operation_visitor.h"
 #include "tf_opt/neural_net/ops/all_operations.h"
 #include "tf_opt/open_source/status_macros.h"
+#include "tf_opt/tensor/element_operations.h"
 #include "tf_opt/tensor/shape.h"
 
 namespace tf_opt {
@@ -49,6 +53,10 @@ absl::Status CheckInputShapesAreCorrect(const Operation* operation,
 // method EvaluateXXX() and a new Visit(XXX) method that delegates to
 // EvaluateXXX().
 //
+// EvaluateFusedLinear() is the exception: by default, it evaluates the
+// unfused operations that a FusedLinearOperation stands for, so subclasses
+// only override it when they have a fused kernel.
+//
 // ResultType must be moveable, need not be copyable.
 template <typename ResultType, typename InputTensorType>
 class AbstractOperationEvaluator : public OperationVisitor {
@@ -98,6 +106,10 @@ class AbstractOperationEvaluator : public OperationVisitor {
     DoVisit1(operation, &AbstractOperationEvaluator::EvaluateExpandDims);
   }
 
+  void Visit(const FusedLinearOperation& operation) override {
+    DoVisit3(operation, &AbstractOperationEvaluator::EvaluateFusedLinear);
+  }
+
   void Visit(const MatmulOperation& operation) override {
     DoVisit2(operation, &AbstractOperationEvaluator::EvaluateMatmul);
   }
@@ -188,6 +200,15 @@ class AbstractOperationEvaluator : public OperationVisitor {
   virtual ResultType EvaluateExpandDims(const ExpandDimsOperation& operation,
                                         const InputTensorType& input) = 0;
 
+  // Evaluates operation.linear(), operation.bias_add() and the activation
+  // with the EvaluateXXX() methods above, in turn.
+  virtual ResultType EvaluateFusedLinear(const FusedLinearOperation& operation,
+                                         const InputTensorType& value,
+                                         const InputTensorType& weights,
+                                         const InputTensorType& bias) {
+    return EvaluateUnfused(operation, value, weights, bias);
+  }
+
   virtual ResultType EvaluateMatmul(const MatmulOperation& operation,
                                     const InputTensorType& left,
                                     const InputTensorType& right) = 0;
@@ -238,6 +259,18 @@ class AbstractOperationEvaluator : public OperationVisitor {
     result_ = (this->*m)(operation, inputs_);
   }
 
+  // Helper for Visit methods on operations that take in three inputs.
+  // OpType is the subclass of Operation to invoke.  'Method' is a function
+  // pointer to an EvaluateXXX() method with signature
+  // ResultType (AbstractOperationEvaluator::*)(const OpType&, const InputType&,
+  //                                            const InputType&,
+  //                                            const InputType&).
+  template <typename OpType, typename Method>
+  void DoVisit3(const OpType& operation, Method m) {
+    EnsureEvaluateReady(&operation);
+    result_ = (this->*m)(operation, *inputs_[0], *inputs_[1], *inputs_[2]);
+  }
+
   // Helper for Visit methods on operations that take in two inputs.
   // OpType is the subclass of Operation to invoke.  'Method' is a function
   // pointer to an EvaluateXXX() method with signature
@@ -270,6 +303,43 @@ class AbstractOperationEvaluator : public OperationVisitor {
     result_ = (this->*m)(operation);
   }
 
+  // The default EvaluateFusedLinear(). When ResultType is a StatusOr, returns
+  // the first error of the components.
+  ResultType EvaluateUnfused(const FusedLinearOperation& operation,
+                             const InputTensorType& value,
+                             const InputTensorType& weights,
+                             const InputTensorType& bias) {
+    const auto evaluate_linear = [&]() {
+      return operation.matmul() != nullptr
+                 ? EvaluateMatmul(*operation.matmul(), value, weights)
+                 : EvaluateConv2d(*operation.conv2d(), value, weights);
+    };
+    const auto evaluate_activation = [&](const InputTensorType& input) {
+      return operation.relu() != nullptr
+                 ? EvaluateRelu(*operation.relu(), input)
+                 : EvaluateClippedRelu(*operation.clipped_relu(), input);
+    };
+    const bool has_activation = operation.activation() != Activation::kIdentity;
+    if constexpr (std::is_same_v<ResultType, InputTensorType>) {
+      ResultType result =
+          EvaluateAdd(operation.bias_add(), evaluate_linear(), bias);
+      return has_activation ? evaluate_activation(result) : std::move(result);
+    } else if constexpr (std::is_same_v<ResultType,
+                                        absl::StatusOr<InputTensorType>>) {
+      TFOPT_ASSIGN_OR_RETURN(const InputTensorType linear, evaluate_linear());
+      TFOPT_ASSIGN_OR_RETURN(InputTensorType result,
+                             EvaluateAdd(operation.bias_add(), linear, bias));
+      if (has_activation) {
+        return evaluate_activation(result);
+      }
+      return std::move(result);
+    } else {
+      LOG(FATAL) << "EvaluateFusedLinear() must be overridden to evaluate: "
+                 << operation.name();
+      return ResultType();
+    }
+  }
+
   // Prepares inputs_ to evaluate, CHECK fails on a shape error.
   void EnsureEvaluateReady(const Operation* operation) {
     std::vector<Shape> input_shapes;
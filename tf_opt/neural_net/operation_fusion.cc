@@ -0,0 +1,186 @@
+// Copyright 2026 The tf.opt Authors.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "tf_opt/neural_net/operation_fusion.h"
+
+#include <memory>
+#include <optional>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "absl/status/statusor.h"
+#include "tf_opt/neural_net/neural_net_graph.h"
+#include "tf_opt/neural_net/op_registry.h"
+#include "tf_opt/neural_net/operation.h"
+#include "tf_opt/neural_net/ops/all_operations.h"
+#include "tf_opt/open_source/status_macros.h"
+#include "tf_opt/tensor/element_operations.h"
+#include "tf_opt/tensor/math.h"
+
+namespace tf_opt {
+
+namespace {
+
+// A MatMul or Conv2d, its bias and its activation, to be fused.
+struct LinearPattern {
+  int linear = -1;
+  int bias_add = -1;
+  // -1 if there is no activation.
+  int activation = -1;
+
+  // The inputs of the fused operation: the value, the weights and the bias.
+  std::vector<int> inputs;
+};
+
+// The only consumer of operation "id", or -1.
+int SingleConsumer(const NeuralNetGraph& graph, const int id) {
+  const std::vector<int>& consumers = graph.consumers(id);
+  return consumers.size() == 1 ? consumers[0] : -1;
+}
+
+// The pattern that starts at operation "id", if any.
+std::optional<LinearPattern> MatchLinearPattern(const NeuralNetGraph& graph,
+                                                const int id) {
+  const Operation& linear = graph.operation(id);
+  if (dynamic_cast<const MatmulOperation*>(&linear) == nullptr &&
+      dynamic_cast<const Conv2dOperation*>(&linear) == nullptr) {
+    return std::nullopt;
+  }
+  LinearPattern pattern;
+  pattern.linear = id;
+  pattern.bias_add = SingleConsumer(graph, id);
+  if (pattern.bias_add < 0 || dynamic_cast<const AddOperation*>(
+                                  &graph.operation(pattern.bias_add)) ==
+                                  nullptr) {
+    return std::nullopt;
+  }
+  const std::vector<int>& add_inputs = graph.inputs(pattern.bias_add);
+  const int bias = add_inputs[0] == id ? add_inputs[1] : add_inputs[0];
+  if (bias == id ||
+      !IsTrailingBiasShape(linear.output_shape(),
+                           graph.operation(bias).output_shape())) {
+    return std::nullopt;
+  }
+  pattern.inputs = graph.inputs(id);
+  pattern.inputs.push_back(bias);
+
+  const int activation = SingleConsumer(graph, pattern.bias_add);
+  if (activation >= 0) {
+    const Operation& op = graph.operation(activation);
+    if (const auto* relu = dynamic_cast<const ReluOperation*>(&op)) {
+      if (relu->formulation() == kDefaultRelu) pattern.activation = activation;
+    } else if (const auto* clipped_relu =
+                   dynamic_cast<const ClippedReluOperation*>(&op)) {
+      if (clipped_relu->formulation() == kDefaultClippedRelu) {
+        pattern.activation = activation;
+      }
+    }
+  }
+  return pattern;
+}
+
+absl::StatusOr<std::unique_ptr<Operation>> MakeFusedOperation(
+    const NeuralNetGraph& graph, const LinearPattern& pattern) {
+  const int last =
+      pattern.activation >= 0 ? pattern.activation : pattern.bias_add;
+  std::string name = graph.operation(last).name();
+  Activation activation = Activation::kIdentity;
+  double cap = 0.0;
+  if (pattern.activation >= 0) {
+    const Operation& op = graph.operation(pattern.activation);
+    if (const auto* clipped_relu =
+            dynamic_cast<const ClippedReluOperation*>(&op)) {
+      activation = Activation::kClippedRelu;
+      cap = clipped_relu->cap();
+    } else {
+      activation = Activation::kRelu;
+    }
+  }
+  const Operation& linear = graph.operation(pattern.linear);
+  const Shape& bias_shape =
+      graph.operation(pattern.inputs[2]).output_shape();
+  std::optional<FusedLinearOperation> fused;
+  if (const auto* conv2d = dynamic_cast<const Conv2dOperation*>(&linear)) {
+    TFOPT_ASSIGN_OR_RETURN(
+        fused, FusedLinearOperation::CreateConv2d(
+                   std::move(name), conv2d->input_value(), conv2d->filter(),
+                   bias_shape, conv2d->stride(), conv2d->padding(),
+                   activation, cap));
+  } else {
+    TFOPT_ASSIGN_OR_RETURN(
+        fused, FusedLinearOperation::CreateMatmul(
+                   std::move(name), linear.input_shape(0),
+                   linear.input_shape(1), bias_shape, activation, cap));
+  }
+  return std::make_unique<FusedLinearOperation>(*std::move(fused));
+}
+
+}  // namespace
+
+absl::StatusOr<NeuralNetGraph> FuseLinearOperations(
+    const NeuralNetGraph& graph, OperationFusionStats* stats) {
+  const int num_operations = graph.num_operations();
+  // The pattern that ends at each operation, and the operations that are
+  // replaced by a pattern ending at a later operation.
+  std::vector<std::optional<LinearPattern>> patterns(num_operations);
+  std::vector<bool> absorbed(num_operations, false);
+  int num_fused_operations = 0;
+  int num_replaced_operations = 0;
+  for (int id = 0; id < num_operations; ++id) {
+    std::optional<LinearPattern> pattern = MatchLinearPattern(graph, id);
+    // The Add of two products is only fused with the first one.
+    if (!pattern.has_value() || absorbed[pattern->bias_add] ||
+        patterns[pattern->bias_add].has_value()) {
+      continue;
+    }
+    const int last =
+        pattern->activation >= 0 ? pattern->activation : pattern->bias_add;
+    absorbed[pattern->linear] = true;
+    if (last != pattern->bias_add) absorbed[pattern->bias_add] = true;
+    ++num_fused_operations;
+    num_replaced_operations += pattern->activation >= 0 ? 3 : 2;
+    patterns[last] = *std::move(pattern);
+  }
+
+  NeuralNetGraph result;
+  std::vector<int> new_ids(num_operations, -1);
+  for (int id = 0; id < num_operations; ++id) {
+    if (absorbed[id]) continue;
+    std::unique_ptr<Operation> new_op;
+    std::vector<int> new_inputs;
+    if (patterns[id].has_value()) {
+      TFOPT_ASSIGN_OR_RETURN(new_op, MakeFusedOperation(graph, *patterns[id]));
+      for (const int input : patterns[id]->inputs) {
+        new_inputs.push_back(new_ids[input]);
+      }
+    } else {
+      const Operation& op = graph.operation(id);
+      TFOPT_ASSIGN_OR_RETURN(new_op,
+                             op_registry::CloneOperation(op, op.name()));
+      for (const int input : graph.inputs(id)) {
+        new_inputs.push_back(new_ids[input]);
+      }
+    }
+    TFOPT_ASSIGN_OR_RETURN(
+        new_ids[id], result.AddOperation(std::move(new_op), new_inputs));
+  }
+  if (stats != nullptr) {
+    stats->num_fused_operations = num_fused_operations;
+    stats->num_replaced_operations = num_replaced_operations;
+  }
+  return result;
+}
+
+}  // namespace tf_opt
@@ -0,0 +1,53 @@
+// Copyright 2026 The tf.opt Authors.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef TF_OPT_NEURAL_NET_OPERATION_FUSION_H_
+#define TF_OPT_NEURAL_NET_OPERATION_FUSION_H_
+
+#include "absl/status/statusor.h"
+#include "tf_opt/neural_net/neural_net_graph.h"
+
+namespace tf_opt {
+
+struct OperationFusionStats {
+  // The FusedLinearOperations created.
+  int num_fused_operations = 0;
+
+  // The operations of the graph that were replaced by a fused operation.
+  int num_replaced_operations = 0;
+};
+
+// Replaces each MatMul or Conv2d followed by an Add of a bias, and optionally
+// by a ReLU or a clipped ReLU, by a single FusedLinearOperation, which
+// DoubleEvaluator computes without materializing the intermediate tensors.
+//
+// The bias is either operand of the Add, and must fit the trailing
+// dimensions of the linear operation (see IsTrailingBiasShape() in math.h),
+// so that the Add does not broadcast the result of the linear operation.
+// Only operations with a single consumer are merged into the next one, so
+// the operations whose result is used elsewhere are kept. Activations with a
+// non-default MIP formulation are not fused, since the fused operation uses
+// the default one. The fused operation takes the name of the last operation
+// it replaces, and the other names disappear.
+//
+// Evaluators without a fused kernel evaluate the components of the fused
+// operations (see FusedLinearOperation), so the result can still be encoded
+// with MipEncoder or bounded with SymbolicBoundsEvaluator, with the same
+// results as graph.
+absl::StatusOr<NeuralNetGraph> FuseLinearOperations(
+    const NeuralNetGraph& graph, OperationFusionStats* stats = nullptr);
+
+}  // namespace tf_opt
+
+#endif  // TF_OPT_NEURAL_NET_OPERATION_FUSION_H_
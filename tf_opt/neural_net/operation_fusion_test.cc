@@ -0,0 +1,239 @@
+// Copyright 2026 The tf.opt Authors.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "tf_opt/neural_net/operation_fusion.h"
+
+#include <memory>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "gtest/gtest.h"
+#include "absl/status/statusor.h"
+#include "tf_opt/bounds/bounds.h"
+#include "tf_opt/neural_net/double_evaluator.h"
+#include "tf_opt/neural_net/neural_net_graph.h"
+#include "tf_opt/neural_net/operation_testing.h"
+#include "tf_opt/neural_net/ops/all_operations.h"
+#include "tf_opt/neural_net/symbolic_bounds_evaluator.h"
+#include "tf_opt/open_source/status_matchers.h"
+#include "tf_opt/tensor/element_operations.h"
+#include "tf_opt/tensor/shape.h"
+#include "tf_opt/tensor/tensor.h"
+#include "tf_opt/tensor/tensor_testing.h"
+#include "tf_opt/tensor/window.h"
+
+namespace tf_opt {
+namespace {
+
+const FusedLinearOperation* FindFused(const NeuralNetGraph& graph,
+                                      const std::string& name) {
+  return dynamic_cast<const FusedLinearOperation*>(
+      &graph.operation(graph.OperationIdOrDie(name)));
+}
+
+// Checks that every operation of fused has the same value as in graph, at x.
+void ExpectSameValues(const NeuralNetGraph& graph,
+                      const NeuralNetGraph& fused, const DoubleTensor& x) {
+  DoubleEvaluator evaluator({{"x", x}});
+  const std::vector<DoubleTensor> values = graph.Evaluate(&evaluator);
+  const std::vector<DoubleTensor> fused_values = fused.Evaluate(&evaluator);
+  for (int id = 0; id < fused.num_operations(); ++id) {
+    const std::string& name = fused.operation(id).name();
+    const DoubleTensor& expected = values[graph.OperationIdOrDie(name)];
+    ASSERT_EQ(fused_values[id].dimension(), expected.dimension()) << name;
+    EXPECT_EQ(fused_values[id].flat_values(), expected.flat_values())
+        << name;
+  }
+}
+
+// x -> MatMul -> Add -> Relu "hidden" -> MatMul -> Add "logits", with the
+// bias of the logits on the left of the Add.
+NeuralNetGraph MakeDenseNet() {
+  NeuralNetGraph graph;
+  const int x = AddToGraph(VariableOperation::Create("x", Shape({2, 3})), {},
+                           &graph);
+  const int w1 = AddConstant("w1", MakeWeights(Shape({3, 4}), 1), &graph);
+  const int b1 = AddConstant("b1", MakeWeights(Shape({4}), 2), &graph);
+  const int w2 = AddConstant("w2", MakeWeights(Shape({4, 2}), 3), &graph);
+  const int b2 = AddConstant("b2", MakeWeights(Shape({1, 2}), 4), &graph);
+  const int matmul1 = AddToGraph(
+      MatmulOperation::Create("matmul1", Shape({2, 3}), Shape({3, 4})),
+      {x, w1}, &graph);
+  const int add1 = AddToGraph(
+      AddOperation::Create("add1", Shape({2, 4}), Shape({4})), {matmul1, b1},
+      &graph);
+  const int hidden = AddToGraph(
+      ReluOperation::Create("hidden", Shape({2, 4})), {add1}, &graph);
+  const int matmul2 = AddToGraph(
+      MatmulOperation::Create("matmul2", Shape({2, 4}), Shape({4, 2})),
+      {hidden, w2}, &graph);
+  AddToGraph(AddOperation::Create("logits", Shape({1, 2}), Shape({2, 2})),
+             {b2, matmul2}, &graph);
+  return graph;
+}
+
+TEST(FuseLinearOperationsTest, FusesDenseLayers) {
+  const NeuralNetGraph graph = MakeDenseNet();
+  OperationFusionStats stats;
+  TFOPT_ASSERT_OK_AND_ASSIGN(const NeuralNetGraph fused,
+                             FuseLinearOperations(graph, &stats));
+  EXPECT_EQ(stats.num_fused_operations, 2);
+  EXPECT_EQ(stats.num_replaced_operations, 5);
+  EXPECT_EQ(fused.num_operations(), 7);
+  const FusedLinearOperation* hidden = FindFused(fused, "hidden");
+  ASSERT_NE(hidden, nullptr);
+  EXPECT_EQ(hidden->activation(), Activation::kRelu);
+  const FusedLinearOperation* logits = FindFused(fused, "logits");
+  ASSERT_NE(logits, nullptr);
+  EXPECT_EQ(logits->activation(), Activation::kIdentity);
+  EXPECT_EQ(fused.inputs(fused.OperationIdOrDie("logits")),
+            (std::vector<int>{fused.OperationIdOrDie("hidden"),
+                              fused.OperationIdOrDie("w2"),
+                              fused.OperationIdOrDie("b2")}));
+  EXPECT_FALSE(fused.OperationId("matmul1").ok());
+  EXPECT_FALSE(fused.OperationId("add1").ok());
+  ExpectSameValues(graph, fused, MakeWeights(Shape({2, 3}), 5));
+}
+
+TEST(FuseLinearOperationsTest, FusesConvolutionAndClippedRelu) {
+  NeuralNetGraph graph;
+  const int x = AddToGraph(
+      VariableOperation::Create("x", Shape({1, 5, 5, 2})), {}, &graph);
+  const int filter =
+      AddConstant("filter", MakeWeights(Shape({3, 3, 2, 3}), 1), &graph);
+  const int bias = AddConstant("bias", MakeWeights(Shape({3}), 2), &graph);
+  const int conv = AddToGraph(
+      Conv2dOperation::Create("conv", Shape({1, 5, 5, 2}),
+                              Shape({3, 3, 2, 3}), Position2D(2, 1),
+                              PaddingType::SAME),
+      {x, filter}, &graph);
+  const int add = AddToGraph(
+      AddOperation::Create("add", Shape({1, 3, 5, 3}), Shape({3})),
+      {conv, bias}, &graph);
+  AddToGraph(ClippedReluOperation::Create("out", Shape({1, 3, 5, 3}), 0.5),
+             {add}, &graph);
+  TFOPT_ASSERT_OK_AND_ASSIGN(const NeuralNetGraph fused,
+                             FuseLinearOperations(graph));
+  EXPECT_EQ(fused.num_operations(), 4);
+  const FusedLinearOperation* out = FindFused(fused, "out");
+  ASSERT_NE(out, nullptr);
+  ASSERT_NE(out->conv2d(), nullptr);
+  EXPECT_EQ(out->conv2d()->stride(), Position2D(2, 1));
+  EXPECT_EQ(out->activation(), Activation::kClippedRelu);
+  EXPECT_EQ(out->cap(), 0.5);
+  ExpectSameValues(graph, fused, MakeWeights(Shape({1, 5, 5, 2}), 3));
+}
+
+TEST(FuseLinearOperationsTest, KeepsSharedAndBroadcastingOperations) {
+  NeuralNetGraph graph;
+  const int x = AddToGraph(VariableOperation::Create("x", Shape({2, 3})), {},
+                           &graph);
+  const int w = AddConstant("w", MakeWeights(Shape({3, 3}), 1), &graph);
+  const int row_bias =
+      AddConstant("row_bias", MakeWeights(Shape({3}), 2), &graph);
+  const int column_bias =
+      AddConstant("column_bias", MakeWeights(Shape({2, 1}), 3), &graph);
+  // Used by two operations.
+  const int shared = AddToGraph(
+      MatmulOperation::Create("shared", Shape({2, 3}), Shape({3, 3})), {x, w},
+      &graph);
+  const int shared_add = AddToGraph(
+      AddOperation::Create("shared_add", Shape({2, 3}), Shape({3})),
+      {shared, row_bias}, &graph);
+  AddToGraph(ReluOperation::Create("shared_relu", Shape({2, 3})), {shared},
+             &graph);
+  // The bias is broadcast along the rows.
+  const int broadcast = AddToGraph(
+      MatmulOperation::Create("broadcast", Shape({2, 3}), Shape({3, 3})),
+      {shared_add, w}, &graph);
+  const int broadcast_add = AddToGraph(
+      AddOperation::Create("broadcast_add", Shape({2, 3}), Shape({2, 1})),
+      {broadcast, column_bias}, &graph);
+  // The ReLU has its own formulation, only the MatMul and Add are fused.
+  const int dense = AddToGraph(
+      MatmulOperation::Create("dense", Shape({2, 3}), Shape({3, 3})),
+      {broadcast_add, w}, &graph);
+  const int dense_add = AddToGraph(
+      AddOperation::Create("dense_add", Shape({2, 3}), Shape({3})),
+      {dense, row_bias}, &graph);
+  AddToGraph(ReluOperation::Create("dense_relu", Shape({2, 3}),
+                                   ReluImplementationType::kMultipleChoice),
+             {dense_add}, &graph);
+
+  OperationFusionStats stats;
+  TFOPT_ASSERT_OK_AND_ASSIGN(const NeuralNetGraph fused,
+                             FuseLinearOperations(graph, &stats));
+  EXPECT_EQ(stats.num_fused_operations, 1);
+  EXPECT_EQ(stats.num_replaced_operations, 2);
+  EXPECT_EQ(fused.num_operations(), graph.num_operations() - 1);
+  EXPECT_EQ(FindFused(fused, "shared"), nullptr);
+  EXPECT_EQ(FindFused(fused, "broadcast_add"), nullptr);
+  const FusedLinearOperation* dense_fused = FindFused(fused, "dense_add");
+  ASSERT_NE(dense_fused, nullptr);
+  EXPECT_EQ(dense_fused->activation(), Activation::kIdentity);
+  EXPECT_EQ(FindFused(fused, "dense_relu"), nullptr);
+  ExpectSameValues(graph, fused, MakeWeights(Shape({2, 3}), 4));
+}
+
+// A bias with more dimensions than the MatMul changes the shape of the Add.
+TEST(FuseLinearOperationsTest, KeepsRankIncreasingBias) {
+  NeuralNetGraph graph;
+  const int x = AddToGraph(VariableOperation::Create("x", Shape({1, 2})), {},
+                           &graph);
+  const int w = AddConstant("w", MakeWeights(Shape({2, 3}), 1), &graph);
+  const int b = AddConstant("b", MakeWeights(Shape({1, 1, 3}), 2), &graph);
+  const int matmul = AddToGraph(
+      MatmulOperation::Create("matmul", Shape({1, 2}), Shape({2, 3})), {x, w},
+      &graph);
+  const int add = AddToGraph(
+      AddOperation::Create("add", Shape({1, 3}), Shape({1, 1, 3})),
+      {matmul, b}, &graph);
+  AddToGraph(ReluOperation::Create("relu", Shape({1, 1, 3})), {add}, &graph);
+
+  OperationFusionStats stats;
+  TFOPT_ASSERT_OK_AND_ASSIGN(const NeuralNetGraph fused,
+                             FuseLinearOperations(graph, &stats));
+  EXPECT_EQ(stats.num_fused_operations, 0);
+  EXPECT_EQ(fused.num_operations(), graph.num_operations());
+  EXPECT_EQ(FindFused(fused, "relu"), nullptr);
+  ExpectSameValues(graph, fused, MakeWeights(Shape({1, 2}), 3));
+}
+
+TEST(FuseLinearOperationsTest, ProtoRoundTrip) {
+  TFOPT_ASSERT_OK_AND_ASSIGN(const NeuralNetGraph fused,
+                             FuseLinearOperations(MakeDenseNet()));
+  TFOPT_ASSERT_OK_AND_ASSIGN(const NeuralNetGraph parsed,
+                             NeuralNetGraph::FromProto(fused.ToProto()));
+  ASSERT_NE(FindFused(parsed, "hidden"), nullptr);
+  ExpectSameValues(fused, parsed, MakeWeights(Shape({2, 3}), 6));
+}
+
+TEST(FuseLinearOperationsTest, SymbolicBoundsAreUnchanged) {
+  const NeuralNetGraph graph = MakeDenseNet();
+  TFOPT_ASSERT_OK_AND_ASSIGN(const NeuralNetGraph fused,
+                             FuseLinearOperations(graph));
+  SymbolicBoundsEvaluator evaluator(
+      {{"x", BoundsTensor(Shape({2, 3}), Bounds(-1.0, 1.0))}});
+  const std::vector<SymbolicBounds> values = graph.Evaluate(&evaluator);
+  const std::vector<SymbolicBounds> fused_values = fused.Evaluate(&evaluator);
+  for (const std::string name : {"hidden", "logits"}) {
+    EXPECT_EQ(fused_values[fused.OperationIdOrDie(name)].bounds.flat_values(),
+              values[graph.OperationIdOrDie(name)].bounds.flat_values())
+        << name;
+  }
+}
+
+}  // namespace
+}  // namespace tf_opt
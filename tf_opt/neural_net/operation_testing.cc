@@ -15,6 +15,7 @@
 #include "tf_opt/neural_net/operation_testing.h"
 
 #include "ortools/base/container_logging.h"
+#include "tf_opt/neural_net/ops/constant_operation.h"
 
 namespace tf_opt {
 namespace {
@@ -74,4 +75,11 @@ testing::Matcher<const Operation&> OperationArgsAre(
       std::vector<Shape>(input_shapes.begin(), input_shapes.end()),
       output_shape));
 }
+
+int AddConstant(const std::string& name, DoubleTensor value,
+                NeuralNetGraph* graph) {
+  return AddToGraph(ConstantOperation::Create(name, std::move(value)), {},
+                    graph);
+}
+
 }  // namespace tf_opt
@@ -15,10 +15,18 @@
 #ifndef TF_OPT_NEURAL_NET_OPERATION_TESTING_H_
 #define TF_OPT_NEURAL_NET_OPERATION_TESTING_H_
 
+#include <memory>
+#include <string>
+#include <utility>
+#include <vector>
+
 #include "gmock/gmock.h"
+#include "absl/status/statusor.h"
 #include "absl/types/span.h"
+#include "tf_opt/neural_net/neural_net_graph.h"
 #include "tf_opt/neural_net/operation.h"
 #include "tf_opt/tensor/shape.h"
+#include "tf_opt/tensor/tensor.h"
 
 namespace tf_opt {
 
@@ -26,6 +34,21 @@ testing::Matcher<const Operation&> OperationArgsAre(
     absl::string_view name, absl::Span<const Shape> input_shapes,
     const Shape& output_shape);
 
+// Adds the operation to the graph, reading its inputs from the operations with
+// ids input_ids, and returns its id. Dies if the operation could not be created
+// or added.
+template <typename OperationType>
+int AddToGraph(absl::StatusOr<OperationType> operation,
+               std::vector<int> input_ids, NeuralNetGraph* graph) {
+  auto op = std::make_unique<OperationType>(std::move(operation).value());
+  return graph->AddOperation(std::move(op), std::move(input_ids)).value();
+}
+
+// Adds a ConstantOperation with the given value to the graph and returns its
+// id.
+int AddConstant(const std::string& name, DoubleTensor value,
+                NeuralNetGraph* graph);
+
 }  // namespace tf_opt
 
 #endif  // TF_OPT_NEURAL_NET_OPERATION_TESTING_H_
@@ -28,6 +28,7 @@ class Conv1dOperation;
 class Conv2dOperation;
 class EmbeddingLookupOperation;
 class ExpandDimsOperation;
+class FusedLinearOperation;
 template <LinearReduction T>
 class LinearReduceOperation;
 class MatmulOperation;
@@ -68,6 +69,7 @@ class OperationVisitor {
   virtual void Visit(const Conv2dOperation& operation) = 0;
   virtual void Visit(const EmbeddingLookupOperation& operation) = 0;
   virtual void Visit(const ExpandDimsOperation& operation) = 0;
+  virtual void Visit(const FusedLinearOperation& operation) = 0;
   virtual void Visit(const LinearReduceOperation<LinearReduction::kMean>&
                          operation) = 0;  // ReduceMeanOperation
   virtual void Visit(const LinearReduceOperation<LinearReduction::kSum>&
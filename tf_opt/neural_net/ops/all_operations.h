@@ -25,6 +25,7 @@
 #include "tf_opt/neural_net/ops/conv2d_operation.h"
 #include "tf_opt/neural_net/ops/embedding_lookup_operation.h"
 #include "tf_opt/neural_net/ops/expand_dims_operation.h"
+#include "tf_opt/neural_net/ops/fused_linear_operation.h"
 #include "tf_opt/neural_net/ops/matmul_operation.h"
 #include "tf_opt/neural_net/ops/maxpool_operation.h"
 #include "tf_opt/neural_net/ops/reduce_operations.h"
@@ -0,0 +1,251 @@
+// Copyright 2026 The tf.opt Authors.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "tf_opt/neural_net/ops/fused_linear_operation.h"
+
+#include <optional>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "ortools/base/logging.h"
+#include "absl/status/statusor.h"
+#include "absl/strings/str_cat.h"
+#include "tf_opt/neural_net/operation_validator.h"
+#include "tf_opt/open_source/status_macros.h"
+#include "tf_opt/tensor/math.h"
+
+namespace tf_opt {
+
+constexpr const char FusedLinearOperation::kOptionsLinearKey[];
+constexpr const char FusedLinearOperation::kOptionsLinearMatmul[];
+constexpr const char FusedLinearOperation::kOptionsLinearConv2d[];
+constexpr const char FusedLinearOperation::kOptionsActivationKey[];
+constexpr const char FusedLinearOperation::kOptionsActivationIdentity[];
+constexpr const char FusedLinearOperation::kOptionsActivationRelu[];
+constexpr const char FusedLinearOperation::kOptionsActivationClippedRelu[];
+constexpr const char FusedLinearOperation::kOptionsCapKey[];
+
+namespace {
+
+const char* ActivationName(const Activation activation) {
+  switch (activation) {
+    case Activation::kIdentity:
+      return FusedLinearOperation::kOptionsActivationIdentity;
+    case Activation::kRelu:
+      return FusedLinearOperation::kOptionsActivationRelu;
+    case Activation::kClippedRelu:
+      return FusedLinearOperation::kOptionsActivationClippedRelu;
+  }
+  LOG(FATAL) << "Unknown activation: " << static_cast<int>(activation);
+}
+
+}  // namespace
+
+FusedLinearOperation::FusedLinearOperation(
+    std::string op_name, std::vector<Shape> input_shapes,
+    std::optional<MatmulOperation> matmul,
+    std::optional<Conv2dOperation> conv2d, AddOperation bias_add,
+    std::optional<ReluOperation> relu,
+    std::optional<ClippedReluOperation> clipped_relu,
+    const Activation activation, const double cap)
+    : Operation(std::move(op_name), std::move(input_shapes),
+                bias_add.output_shape()),
+      matmul_(std::move(matmul)),
+      conv2d_(std::move(conv2d)),
+      bias_add_(std::move(bias_add)),
+      relu_(std::move(relu)),
+      clipped_relu_(std::move(clipped_relu)),
+      activation_(activation),
+      cap_(cap) {}
+
+absl::StatusOr<FusedLinearOperation> FusedLinearOperation::CreateMatmul(
+    std::string op_name, Shape value_shape, Shape weights_shape,
+    Shape bias_shape, const Activation activation, const double cap) {
+  TFOPT_ASSIGN_OR_RETURN(
+      MatmulOperation matmul,
+      MatmulOperation::Create(absl::StrCat(op_name, "/linear"),
+                              std::move(value_shape),
+                              std::move(weights_shape)));
+  return CreateFromLinear(std::move(op_name), std::move(matmul), std::nullopt,
+                          std::move(bias_shape), activation, cap);
+}
+
+absl::StatusOr<FusedLinearOperation> FusedLinearOperation::CreateConv2d(
+    std::string op_name, Shape value_shape, Shape filter_shape,
+    Shape bias_shape, const Position2D stride, const PaddingType padding,
+    const Activation activation, const double cap) {
+  TFOPT_ASSIGN_OR_RETURN(
+      Conv2dOperation conv2d,
+      Conv2dOperation::Create(absl::StrCat(op_name, "/linear"),
+                              std::move(value_shape), std::move(filter_shape),
+                              stride, padding));
+  return CreateFromLinear(std::move(op_name), std::nullopt, std::move(conv2d),
+                          std::move(bias_shape), activation, cap);
+}
+
+absl::StatusOr<FusedLinearOperation> FusedLinearOperation::CreateFromLinear(
+    std::string op_name, std::optional<MatmulOperation> matmul,
+    std::optional<Conv2dOperation> conv2d, Shape bias_shape,
+    const Activation activation, const double cap) {
+  const Operation& linear =
+      matmul.has_value() ? static_cast<const Operation&>(*matmul) : *conv2d;
+  if (!IsTrailingBiasShape(linear.output_shape(), bias_shape)) {
+    OperationValidator validator("FusedLinearOperation", op_name);
+    return validator.OperationValidationError(absl::StrCat(
+        "Bias of shape ", bias_shape.ToString(),
+        " does not fit the trailing dimensions of ",
+        linear.output_shape().ToString()));
+  }
+  std::vector<Shape> input_shapes = linear.input_shapes();
+  input_shapes.push_back(bias_shape);
+  const bool has_activation = activation != Activation::kIdentity;
+  TFOPT_ASSIGN_OR_RETURN(
+      AddOperation bias_add,
+      AddOperation::Create(
+          has_activation ? absl::StrCat(op_name, "/bias_add") : op_name,
+          linear.output_shape(), std::move(bias_shape)));
+  std::optional<ReluOperation> relu;
+  std::optional<ClippedReluOperation> clipped_relu;
+  if (activation == Activation::kRelu) {
+    TFOPT_ASSIGN_OR_RETURN(
+        relu, ReluOperation::Create(op_name, linear.output_shape()));
+  } else if (activation == Activation::kClippedRelu) {
+    TFOPT_ASSIGN_OR_RETURN(clipped_relu,
+                           ClippedReluOperation::Create(
+                               op_name, linear.output_shape(), cap));
+  }
+  return FusedLinearOperation(std::move(op_name), std::move(input_shapes),
+                              std::move(matmul), std::move(conv2d),
+                              std::move(bias_add), std::move(relu),
+                              std::move(clipped_relu), activation,
+                              activation == Activation::kClippedRelu ? cap
+                                                                     : 0.0);
+}
+
+absl::StatusOr<FusedLinearOperation> FusedLinearOperation::GenericCreate(
+    std::string op_name, std::vector<Shape> input_shapes, Shape output_shape,
+    const Options& options) {
+  OperationValidator validator("FusedLinearOperation", op_name);
+  TFOPT_RETURN_IF_ERROR(
+      validator.ExpectInputSizeEquals(input_shapes.size(), 3));
+  TFOPT_ASSIGN_OR_RETURN(const std::string linear_name,
+                         validator.StringOption(options, kOptionsLinearKey));
+  TFOPT_ASSIGN_OR_RETURN(
+      const std::string activation_name,
+      validator.StringOption(options, kOptionsActivationKey));
+  int num_options = 2;
+  Activation activation;
+  double cap = 0.0;
+  if (activation_name == kOptionsActivationIdentity) {
+    activation = Activation::kIdentity;
+  } else if (activation_name == kOptionsActivationRelu) {
+    activation = Activation::kRelu;
+  } else if (activation_name == kOptionsActivationClippedRelu) {
+    activation = Activation::kClippedRelu;
+    TFOPT_ASSIGN_OR_RETURN(cap,
+                           validator.DoubleOption(options, kOptionsCapKey));
+    ++num_options;
+  } else {
+    return validator.OperationValidationError(
+        absl::StrCat("Unrecognized activation: ", activation_name));
+  }
+
+  std::optional<FusedLinearOperation> result;
+  if (linear_name == kOptionsLinearMatmul) {
+    TFOPT_ASSIGN_OR_RETURN(
+        result,
+        CreateMatmul(op_name, std::move(input_shapes[0]),
+                     std::move(input_shapes[1]), std::move(input_shapes[2]),
+                     activation, cap),
+        _ << validator.base_error_message());
+  } else if (linear_name == kOptionsLinearConv2d) {
+    TFOPT_ASSIGN_OR_RETURN(
+        const int stride_row,
+        validator.IntegerOption(options,
+                                Conv2dOperation::kOptionsStrideRowKey));
+    TFOPT_ASSIGN_OR_RETURN(
+        const int stride_column,
+        validator.IntegerOption(options,
+                                Conv2dOperation::kOptionsStrideColKey));
+    TFOPT_ASSIGN_OR_RETURN(
+        const std::string padding_name,
+        validator.StringOption(options, Conv2dOperation::kOptionsPaddingKey));
+    PaddingType padding;
+    if (!PaddingTypeFromString(padding_name, &padding)) {
+      return validator.OperationValidationError("Invalid padding string");
+    }
+    num_options += 3;
+    TFOPT_ASSIGN_OR_RETURN(
+        result,
+        CreateConv2d(op_name, std::move(input_shapes[0]),
+                     std::move(input_shapes[1]), std::move(input_shapes[2]),
+                     Position2D(stride_row, stride_column), padding,
+                     activation, cap),
+        _ << validator.base_error_message());
+  } else {
+    return validator.OperationValidationError(
+        absl::StrCat("Unrecognized linear operation: ", linear_name));
+  }
+  TFOPT_RETURN_IF_ERROR(
+      validator.ExpectOptionsSizeAtMost(options.size(), num_options));
+  TFOPT_RETURN_IF_ERROR(
+      validator.ExpectOutputShapeEquals(output_shape, result->output_shape()));
+  return std::move(*result);
+}
+
+proto::TensorNode FusedLinearOperation::ToProto(
+    const std::vector<std::string>& inputs) const {
+  CHECK_EQ(inputs.size(), 3);
+  proto::TensorNode result;
+  result.set_name(name());
+  result.set_op_type(proto::OpType::FUSED_LINEAR);
+  *result.mutable_out_dimension() = output_shape().AsProto();
+  for (const std::string& input : inputs) {
+    result.add_input_names(input);
+  }
+  proto::Options& options = *result.mutable_options();
+  proto::Options::StringOption& linear_option =
+      *options.add_string_options();
+  linear_option.set_name(kOptionsLinearKey);
+  linear_option.set_value(conv2d_.has_value() ? kOptionsLinearConv2d
+                                              : kOptionsLinearMatmul);
+  proto::Options::StringOption& activation_option =
+      *options.add_string_options();
+  activation_option.set_name(kOptionsActivationKey);
+  activation_option.set_value(ActivationName(activation_));
+  if (activation_ == Activation::kClippedRelu) {
+    proto::Options::DoubleOption& cap_option = *options.add_double_options();
+    cap_option.set_name(kOptionsCapKey);
+    cap_option.set_value(cap_);
+  }
+  if (conv2d_.has_value()) {
+    proto::Options::StringOption& padding_option =
+        *options.add_string_options();
+    padding_option.set_name(Conv2dOperation::kOptionsPaddingKey);
+    padding_option.set_value(ToString(conv2d_->padding()));
+    proto::Options::IntegerOption& stride_row_option =
+        *options.add_integer_options();
+    stride_row_option.set_name(Conv2dOperation::kOptionsStrideRowKey);
+    stride_row_option.set_value(conv2d_->stride().row);
+    proto::Options::IntegerOption& stride_col_option =
+        *options.add_integer_options();
+    stride_col_option.set_name(Conv2dOperation::kOptionsStrideColKey);
+    stride_col_option.set_value(conv2d_->stride().col);
+  }
+  result.set_output_type(proto::TensorNode::FLOAT32);
+  return result;
+}
+
+}  // namespace tf_opt
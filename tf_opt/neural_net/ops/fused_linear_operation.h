@@ -0,0 +1,151 @@
+// Copyright 2026 The tf.opt Authors.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef TF_OPT_SHARED_OPS_FUSED_LINEAR_OPERATION_H_
+#define TF_OPT_SHARED_OPS_FUSED_LINEAR_OPERATION_H_
+
+#include <optional>
+#include <string>
+#include <vector>
+
+#include "absl/status/statusor.h"
+#include "tf_opt/neural_net/operation.h"
+#include "tf_opt/neural_net/operation_visitor.h"
+#include "tf_opt/neural_net/ops/arithmetic_operations.h"
+#include "tf_opt/neural_net/ops/clipped_relu_operation.h"
+#include "tf_opt/neural_net/ops/conv2d_operation.h"
+#include "tf_opt/neural_net/ops/matmul_operation.h"
+#include "tf_opt/neural_net/ops/relu_operation.h"
+#include "tf_opt/tensor/element_operations.h"
+#include "tf_opt/tensor/shape.h"
+#include "tf_opt/tensor/window.h"
+
+namespace tf_opt {
+
+// Computes activation(linear(value, weights) + bias) as a single operation,
+// where linear is MatMul or Conv2d, and activation is the identity, a ReLU or
+// a clipped ReLU: a dense or convolution layer. See FuseLinearOperations() in
+// operation_fusion.h, which replaces the three operations by this one.
+//
+// The operation keeps the unfused operations it stands for, see matmul(),
+// conv2d(), bias_add(), relu() and clipped_relu(). Evaluators with a fused
+// kernel (e.g. DoubleEvaluator) compute the result in a single pass, the
+// others evaluate the components in turn (see
+// AbstractOperationEvaluator::EvaluateFusedLinear()); e.g. MipEncoder still
+// encodes the pre-activation, and its ReLU is named like this operation.
+//
+// The components are named op_name + "/linear" and op_name + "/bias_add",
+// and the activation op_name. Without activation, the bias add is op_name.
+// The ReLUs use the default formulation.
+class FusedLinearOperation : public Operation {
+ public:
+  static constexpr const char kOptionsLinearKey[] = "linear";
+  static constexpr const char kOptionsLinearMatmul[] = "matmul";
+  static constexpr const char kOptionsLinearConv2d[] = "conv2d";
+  static constexpr const char kOptionsActivationKey[] = "activation";
+  static constexpr const char kOptionsActivationIdentity[] = "identity";
+  static constexpr const char kOptionsActivationRelu[] = "relu";
+  static constexpr const char kOptionsActivationClippedRelu[] =
+      "clipped_relu";
+  static constexpr const char kOptionsCapKey[] = "cap";
+
+  // Fuses MatMul(value, weights) + bias. The bias must fit the trailing
+  // dimensions of the product (see IsTrailingBiasShape() in math.h). The cap
+  // is only used by Activation::kClippedRelu.
+  static absl::StatusOr<FusedLinearOperation> CreateMatmul(
+      std::string op_name, Shape value_shape, Shape weights_shape,
+      Shape bias_shape, Activation activation = Activation::kIdentity,
+      double cap = 0.0);
+
+  // Like above, for Conv2d(value, filter) + bias, see Conv2dOperation.
+  static absl::StatusOr<FusedLinearOperation> CreateConv2d(
+      std::string op_name, Shape value_shape, Shape filter_shape,
+      Shape bias_shape, Position2D stride, PaddingType padding,
+      Activation activation = Activation::kIdentity, double cap = 0.0);
+
+  // Expected input format:
+  //   input_shapes: The shapes of the value, the weights (or filter) and the
+  //       bias.
+  //   output_shape: The shape of the linear operation.
+  //   options: Must have a string key kOptionsLinearKey, with value
+  //       kOptionsLinearMatmul or kOptionsLinearConv2d, and a string key
+  //       kOptionsActivationKey with value kOptionsActivationIdentity,
+  //       kOptionsActivationRelu or kOptionsActivationClippedRelu. A clipped
+  //       ReLU must have a double key kOptionsCapKey. A convolution must have
+  //       the options of Conv2dOperation.
+  static absl::StatusOr<FusedLinearOperation> GenericCreate(
+      std::string op_name, std::vector<Shape> input_shapes, Shape output_shape,
+      const Options& options);
+
+  const Shape& value() const { return input_shape(0); }
+  const Shape& weights() const { return input_shape(1); }
+  const Shape& bias() const { return input_shape(2); }
+  Activation activation() const { return activation_; }
+  double cap() const { return cap_; }
+
+  // The linear operation: exactly one of matmul() and conv2d() is not null.
+  const MatmulOperation* matmul() const {
+    return matmul_.has_value() ? &*matmul_ : nullptr;
+  }
+  const Conv2dOperation* conv2d() const {
+    return conv2d_.has_value() ? &*conv2d_ : nullptr;
+  }
+  const Operation& linear() const {
+    return matmul_.has_value() ? static_cast<const Operation&>(*matmul_)
+                               : *conv2d_;
+  }
+  const AddOperation& bias_add() const { return bias_add_; }
+
+  // The activation, null unless activation() is kRelu (resp. kClippedRelu).
+  const ReluOperation* relu() const {
+    return relu_.has_value() ? &*relu_ : nullptr;
+  }
+  const ClippedReluOperation* clipped_relu() const {
+    return clipped_relu_.has_value() ? &*clipped_relu_ : nullptr;
+  }
+
+  void Accept(OperationVisitor* visitor) const override {
+    visitor->Visit(*this);
+  }
+
+  proto::TensorNode ToProto(
+      const std::vector<std::string>& inputs) const override;
+
+ private:
+  FusedLinearOperation(std::string op_name, std::vector<Shape> input_shapes,
+                       std::optional<MatmulOperation> matmul,
+                       std::optional<Conv2dOperation> conv2d,
+                       AddOperation bias_add,
+                       std::optional<ReluOperation> relu,
+                       std::optional<ClippedReluOperation> clipped_relu,
+                       Activation activation, double cap);
+
+  // Completes an operation from its linear component.
+  static absl::StatusOr<FusedLinearOperation> CreateFromLinear(
+      std::string op_name, std::optional<MatmulOperation> matmul,
+      std::optional<Conv2dOperation> conv2d, Shape bias_shape,
+      Activation activation, double cap);
+
+  std::optional<MatmulOperation> matmul_;
+  std::optional<Conv2dOperation> conv2d_;
+  AddOperation bias_add_;
+  std::optional<ReluOperation> relu_;
+  std::optional<ClippedReluOperation> clipped_relu_;
+  Activation activation_;
+  double cap_;
+};
+
+}  // namespace tf_opt
+
+#endif  // TF_OPT_SHARED_OPS_FUSED_LINEAR_OPERATION_H_
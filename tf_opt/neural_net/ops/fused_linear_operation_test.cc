@@ -0,0 +1,182 @@
+// Copyright 2026 The tf.opt Authors.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "tf_opt/neural_net/ops/fused_linear_operation.h"
+
+#include <string>
+#include <vector>
+
+#include "gmock/gmock.h"
+#include "gtest/gtest.h"
+#include "tf_opt/neural_net/operation.h"
+#include "tf_opt/neural_net/operation_testing.h"
+#include "tf_opt/open_source/status_matchers.h"
+#include "tf_opt/tensor/element_operations.h"
+#include "tf_opt/tensor/shape.h"
+#include "tf_opt/tensor/window.h"
+
+namespace tf_opt {
+namespace {
+
+using ::tf_opt::testing::StatusIs;
+constexpr absl::StatusCode kInvalidArgument =
+    absl::StatusCode::kInvalidArgument;
+
+TEST(FusedLinearOperationTest, CreateMatmul) {
+  const Shape value({2, 3});
+  const Shape weights({3, 4});
+  const Shape bias({4});
+  TFOPT_ASSERT_OK_AND_ASSIGN(
+      const FusedLinearOperation op,
+      FusedLinearOperation::CreateMatmul("dense", value, weights, bias,
+                                         Activation::kRelu));
+  EXPECT_THAT(op, OperationArgsAre("dense", {value, weights, bias},
+                                   Shape({2, 4})));
+  EXPECT_EQ(op.activation(), Activation::kRelu);
+  ASSERT_NE(op.matmul(), nullptr);
+  EXPECT_EQ(op.conv2d(), nullptr);
+  EXPECT_THAT(*op.matmul(),
+              OperationArgsAre("dense/linear", {value, weights},
+                               Shape({2, 4})));
+  EXPECT_THAT(op.bias_add(),
+              OperationArgsAre("dense/bias_add", {Shape({2, 4}), bias},
+                               Shape({2, 4})));
+  ASSERT_NE(op.relu(), nullptr);
+  EXPECT_THAT(*op.relu(), OperationArgsAre("dense", {Shape({2, 4})},
+                                           Shape({2, 4})));
+  EXPECT_EQ(op.clipped_relu(), nullptr);
+}
+
+TEST(FusedLinearOperationTest, CreateMatmulWithoutActivation) {
+  TFOPT_ASSERT_OK_AND_ASSIGN(
+      const FusedLinearOperation op,
+      FusedLinearOperation::CreateMatmul("logits", Shape({1, 3}),
+                                         Shape({3, 2}), Shape({1, 2})));
+  EXPECT_EQ(op.activation(), Activation::kIdentity);
+  EXPECT_EQ(op.bias_add().name(), "logits");
+  EXPECT_EQ(op.relu(), nullptr);
+  EXPECT_EQ(op.clipped_relu(), nullptr);
+}
+
+TEST(FusedLinearOperationTest, CreateConv2d) {
+  const Shape value({1, 4, 4, 1});
+  const Shape filter({2, 2, 1, 3});
+  const Shape bias({3});
+  TFOPT_ASSERT_OK_AND_ASSIGN(
+      const FusedLinearOperation op,
+      FusedLinearOperation::CreateConv2d(
+          "conv", value, filter, bias, Position2D(2, 2), PaddingType::VALID,
+          Activation::kClippedRelu, 6.0));
+  EXPECT_THAT(op, OperationArgsAre("conv", {value, filter, bias},
+                                   Shape({1, 2, 2, 3})));
+  EXPECT_EQ(op.matmul(), nullptr);
+  ASSERT_NE(op.conv2d(), nullptr);
+  EXPECT_EQ(op.conv2d()->stride(), Position2D(2, 2));
+  EXPECT_EQ(op.conv2d()->padding(), PaddingType::VALID);
+  ASSERT_NE(op.clipped_relu(), nullptr);
+  EXPECT_EQ(op.clipped_relu()->cap(), 6.0);
+  EXPECT_EQ(op.cap(), 6.0);
+}
+
+TEST(FusedLinearOperationTest, CreateBadShapes) {
+  EXPECT_THAT(FusedLinearOperation::CreateMatmul("dense", Shape({2, 3}),
+                                                 Shape({2, 4}), Shape({4})),
+              StatusIs(kInvalidArgument));
+  // The bias must not broadcast the product.
+  EXPECT_THAT(FusedLinearOperation::CreateMatmul("dense", Shape({2, 3}),
+                                                 Shape({3, 4}), Shape({2, 1})),
+              StatusIs(kInvalidArgument));
+  EXPECT_THAT(
+      FusedLinearOperation::CreateMatmul("dense", Shape({2, 3}), Shape({3, 4}),
+                                         Shape({4}), Activation::kClippedRelu,
+                                         -1.0),
+      StatusIs(kInvalidArgument));
+}
+
+TEST(FusedLinearOperationTest, GenericCreateMatmul) {
+  Operation::Options options;
+  options.string_options[FusedLinearOperation::kOptionsLinearKey] =
+      FusedLinearOperation::kOptionsLinearMatmul;
+  options.string_options[FusedLinearOperation::kOptionsActivationKey] =
+      FusedLinearOperation::kOptionsActivationClippedRelu;
+  options.double_options[FusedLinearOperation::kOptionsCapKey] = 2.0;
+  TFOPT_ASSERT_OK_AND_ASSIGN(
+      const FusedLinearOperation op,
+      FusedLinearOperation::GenericCreate(
+          "dense", {Shape({2, 3}), Shape({3, 4}), Shape({4})}, Shape({2, 4}),
+          options));
+  EXPECT_EQ(op.activation(), Activation::kClippedRelu);
+  EXPECT_EQ(op.cap(), 2.0);
+  EXPECT_NE(op.matmul(), nullptr);
+}
+
+TEST(FusedLinearOperationTest, GenericCreateErrors) {
+  Operation::Options options;
+  options.string_options[FusedLinearOperation::kOptionsLinearKey] =
+      FusedLinearOperation::kOptionsLinearMatmul;
+  options.string_options[FusedLinearOperation::kOptionsActivationKey] =
+      FusedLinearOperation::kOptionsActivationRelu;
+  const std::vector<Shape> inputs = {Shape({2, 3}), Shape({3, 4}),
+                                     Shape({4})};
+  EXPECT_THAT(FusedLinearOperation::GenericCreate("dense", inputs,
+                                                  Shape({2, 5}), options),
+              StatusIs(kInvalidArgument));
+  EXPECT_THAT(FusedLinearOperation::GenericCreate(
+                  "dense", {Shape({2, 3}), Shape({3, 4})}, Shape({2, 4}),
+                  options),
+              StatusIs(kInvalidArgument));
+  Operation::Options extra_option = options;
+  extra_option.double_options[FusedLinearOperation::kOptionsCapKey] = 2.0;
+  EXPECT_THAT(FusedLinearOperation::GenericCreate("dense", inputs,
+                                                  Shape({2, 4}), extra_option),
+              StatusIs(kInvalidArgument));
+  Operation::Options bad_activation = options;
+  bad_activation.string_options[FusedLinearOperation::kOptionsActivationKey] =
+      "sigmoid";
+  EXPECT_THAT(FusedLinearOperation::GenericCreate(
+                  "dense", inputs, Shape({2, 4}), bad_activation),
+              StatusIs(kInvalidArgument));
+  Operation::Options conv_without_stride = options;
+  conv_without_stride.string_options[FusedLinearOperation::kOptionsLinearKey] =
+      FusedLinearOperation::kOptionsLinearConv2d;
+  EXPECT_THAT(FusedLinearOperation::GenericCreate(
+                  "dense", inputs, Shape({2, 4}), conv_without_stride),
+              StatusIs(kInvalidArgument));
+}
+
+TEST(FusedLinearOperationTest, ToProtoRoundTrip) {
+  TFOPT_ASSERT_OK_AND_ASSIGN(
+      const FusedLinearOperation op,
+      FusedLinearOperation::CreateConv2d(
+          "conv", Shape({1, 4, 4, 1}), Shape({2, 2, 1, 3}), Shape({3}),
+          Position2D(1, 2), PaddingType::SAME, Activation::kClippedRelu,
+          6.0));
+  const proto::TensorNode node = op.ToProto({"x", "filter", "bias"});
+  EXPECT_EQ(node.op_type(), proto::FUSED_LINEAR);
+  TFOPT_ASSERT_OK_AND_ASSIGN(
+      const FusedLinearOperation parsed,
+      FusedLinearOperation::GenericCreate(
+          node.name(), op.input_shapes(), Shape(node.out_dimension()),
+          Operation::Options(node.options())));
+  EXPECT_THAT(parsed, OperationArgsAre("conv", op.input_shapes(),
+                                       op.output_shape()));
+  ASSERT_NE(parsed.conv2d(), nullptr);
+  EXPECT_EQ(parsed.conv2d()->stride(), Position2D(1, 2));
+  EXPECT_EQ(parsed.conv2d()->padding(), PaddingType::SAME);
+  EXPECT_EQ(parsed.activation(), Activation::kClippedRelu);
+  EXPECT_EQ(parsed.cap(), 6.0);
+}
+
+}  // namespace
+}  // namespace tf_opt
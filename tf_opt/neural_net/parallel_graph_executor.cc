@@ -0,0 +1,41 @@
+// Copyright 2026 The tf.opt Authors.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "tf_opt/neural_net/parallel_graph_executor.h"
+
+#include <algorithm>
+#include <vector>
+
+#include "ortools/base/logging.h"
+
+namespace tf_opt {
+
+ParallelGraphExecutor::ParallelGraphExecutor(const NeuralNetGraph* graph,
+                                             WorkStealingThreadPool* pool)
+    : graph_(graph), pool_(pool) {
+  CHECK(graph_ != nullptr);
+  CHECK(pool_ != nullptr);
+  num_distinct_inputs_.reserve(graph_->num_operations());
+  for (int id = 0; id < graph_->num_operations(); ++id) {
+    std::vector<int> inputs = graph_->inputs(id);
+    std::sort(inputs.begin(), inputs.end());
+    num_distinct_inputs_.push_back(
+        std::unique(inputs.begin(), inputs.end()) - inputs.begin());
+    if (inputs.empty()) {
+      sources_.push_back(id);
+    }
+  }
+}
+
+}  // namespace tf_opt
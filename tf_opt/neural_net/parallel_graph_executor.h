@@ -0,0 +1,124 @@
+// Copyright 2026 The tf.opt Authors.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef TF_OPT_NEURAL_NET_PARALLEL_GRAPH_EXECUTOR_H_
+#define TF_OPT_NEURAL_NET_PARALLEL_GRAPH_EXECUTOR_H_
+
+#include <atomic>
+#include <functional>
+#include <memory>
+#include <vector>
+
+#include "ortools/base/logging.h"
+#include "absl/synchronization/blocking_counter.h"
+#include "tf_opt/neural_net/neural_net_graph.h"
+#include "tf_opt/neural_net/operation_evaluator.h"
+#include "tf_opt/util/work_stealing_thread_pool.h"
+
+namespace tf_opt {
+
+// Evaluates the operations of a NeuralNetGraph on a WorkStealingThreadPool,
+// running independent operations (e.g. the towers of a wide network, or the
+// two operands of a MatMul) concurrently.
+//
+// Each operation has a counter of the inputs it still waits for. It is
+// scheduled on the pool when the counter reaches zero, by the worker that
+// evaluated its last input. Since evaluators are stateful, each worker uses
+// its own evaluator. The results are the same as NeuralNetGraph::Evaluate(),
+// provided the evaluators compute each operation deterministically.
+//
+// Example use:
+//   WorkStealingThreadPool pool(16);
+//   ParallelGraphExecutor executor(&graph, &pool);
+//   std::vector<DoubleTensor> values = executor.Evaluate<DoubleTensor>(
+//       [&] { return std::make_unique<DoubleEvaluator>(variable_values); });
+class ParallelGraphExecutor {
+ public:
+  // Creates one evaluator for a worker of the pool.
+  template <typename T>
+  using EvaluatorFactory =
+      std::function<std::unique_ptr<OperationEvaluator<T>>()>;
+
+  // The graph and pool must outlive this.
+  ParallelGraphExecutor(const NeuralNetGraph* graph,
+                        WorkStealingThreadPool* pool);
+
+  // Evaluates every operation of the graph and returns the results indexed by
+  // operation id, like NeuralNetGraph::Evaluate(). Calls make_evaluator once
+  // per worker of the pool. Blocks until all operations are evaluated, so it
+  // must not be called from a task of the pool. Evaluate() calls may run
+  // concurrently on the same pool.
+  template <typename T>
+  std::vector<T> Evaluate(const EvaluatorFactory<T>& make_evaluator) const;
+
+ private:
+  const NeuralNetGraph* graph_;
+  WorkStealingThreadPool* pool_;
+  // The number of distinct inputs of each operation.
+  std::vector<int> num_distinct_inputs_;
+  // The operations without inputs.
+  std::vector<int> sources_;
+};
+
+// ///////////////////////////// Implementation ////////////////////////////////
+
+template <typename T>
+std::vector<T> ParallelGraphExecutor::Evaluate(
+    const EvaluatorFactory<T>& make_evaluator) const {
+  CHECK_EQ(pool_->CurrentWorkerIndex(), -1)
+      << "ParallelGraphExecutor::Evaluate() called from its own pool.";
+  std::vector<std::unique_ptr<OperationEvaluator<T>>> evaluators;
+  for (int i = 0; i < pool_->num_threads(); ++i) {
+    evaluators.push_back(make_evaluator());
+    CHECK(evaluators.back() != nullptr);
+  }
+  const int num_operations = graph_->num_operations();
+  std::vector<T> values(num_operations);
+  std::vector<std::atomic<int>> num_missing_inputs(num_operations);
+  for (int id = 0; id < num_operations; ++id) {
+    num_missing_inputs[id].store(num_distinct_inputs_[id],
+                                 std::memory_order_relaxed);
+  }
+  absl::BlockingCounter num_remaining(num_operations);
+
+  // Evaluates operation id, then schedules the consumers it made ready. The
+  // acquire-release decrements order the write of values[id] before the
+  // evaluation of its consumers.
+  std::function<void(int)> run = [&](const int id) {
+    OperationEvaluator<T>* evaluator =
+        evaluators[pool_->CurrentWorkerIndex()].get();
+    std::vector<const T*> inputs;
+    inputs.reserve(graph_->inputs(id).size());
+    for (const int input : graph_->inputs(id)) {
+      inputs.push_back(&values[input]);
+    }
+    values[id] = evaluator->Evaluate(&graph_->operation(id), inputs);
+    for (const int consumer : graph_->consumers(id)) {
+      if (num_missing_inputs[consumer].fetch_sub(
+              1, std::memory_order_acq_rel) == 1) {
+        pool_->Schedule([&run, consumer] { run(consumer); });
+      }
+    }
+    num_remaining.DecrementCount();
+  };
+  for (const int source : sources_) {
+    pool_->Schedule([&run, source] { run(source); });
+  }
+  num_remaining.Wait();
+  return values;
+}
+
+}  // namespace tf_opt
+
+#endif  // TF_OPT_NEURAL_NET_PARALLEL_GRAPH_EXECUTOR_H_
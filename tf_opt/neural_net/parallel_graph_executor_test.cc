@@ -0,0 +1,133 @@
+// Copyright 2026 The tf.opt Authors.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "tf_opt/neural_net/parallel_graph_executor.h"
+
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "gmock/gmock.h"
+#include "gtest/gtest.h"
+#include "absl/container/flat_hash_map.h"
+#include "absl/strings/str_cat.h"
+#include "tf_opt/neural_net/double_evaluator.h"
+#include "tf_opt/neural_net/neural_net_graph.h"
+#include "tf_opt/neural_net/operation_testing.h"
+#include "tf_opt/neural_net/ops/all_operations.h"
+#include "tf_opt/tensor/shape.h"
+#include "tf_opt/tensor/tensor.h"
+#include "tf_opt/tensor/tensor_testing.h"
+
+namespace tf_opt {
+namespace {
+
+using Matrix = std::vector<std::vector<double>>;
+
+// num_towers towers of relu(x * w1 + b1) * w2 on a shared input x, and the
+// concatenation of their outputs. Each tower squares its input first, which
+// gives an operation with a repeated input.
+NeuralNetGraph MakeMultiTowerNet(const int num_towers) {
+  constexpr int kInput = 8;
+  constexpr int kHidden = 16;
+  constexpr int kOutput = 4;
+  NeuralNetGraph graph;
+  const Shape input_shape({1, kInput});
+  const int x =
+      AddToGraph(VariableOperation::Create("x", input_shape), {}, &graph);
+  std::vector<int> tower_outputs;
+  std::vector<Shape> tower_shapes;
+  for (int t = 0; t < num_towers; ++t) {
+    const std::string prefix = absl::StrCat("tower", t, "/");
+    const int square = AddToGraph(
+        MultiplyOperation::Create(prefix + "square", input_shape, input_shape),
+        {x, x}, &graph);
+    const int w1 = AddConstant(
+        prefix + "w1", MakeWeights(Shape({kInput, kHidden}), t), &graph);
+    const int b1 = AddConstant(prefix + "b1",
+                               MakeWeights(Shape({kHidden}), t + 100), &graph);
+    const int w2 = AddConstant(
+        prefix + "w2", MakeWeights(Shape({kHidden, kOutput}), t), &graph);
+    const Shape hidden_shape({1, kHidden});
+    const int matmul1 = AddToGraph(
+        MatmulOperation::Create(prefix + "matmul1", input_shape,
+                                Shape({kInput, kHidden})),
+        {square, w1}, &graph);
+    const int add = AddToGraph(
+        AddOperation::Create(prefix + "add", hidden_shape, Shape({kHidden})),
+        {matmul1, b1}, &graph);
+    const int relu = AddToGraph(
+        ReluOperation::Create(prefix + "relu", hidden_shape), {add}, &graph);
+    tower_outputs.push_back(AddToGraph(
+        MatmulOperation::Create(prefix + "matmul2", hidden_shape,
+                                Shape({kHidden, kOutput})),
+        {relu, w2}, &graph));
+    tower_shapes.push_back(Shape({1, kOutput}));
+  }
+  AddToGraph(ConcatOperation::Create("concat", tower_shapes, 1), tower_outputs,
+             &graph);
+  return graph;
+}
+
+absl::flat_hash_map<std::string, DoubleTensor> InputValues() {
+  return {{"x", DoubleTensor(Matrix{
+                    {0.5, -1.0, 2.0, 0.25, -0.75, 1.5, 3.0, -2.0}})}};
+}
+
+TEST(ParallelGraphExecutorTest, SameResultsAsSequential) {
+  const NeuralNetGraph graph = MakeMultiTowerNet(16);
+  DoubleEvaluator sequential_evaluator(InputValues());
+  const std::vector<DoubleTensor> expected =
+      graph.Evaluate(&sequential_evaluator);
+
+  WorkStealingThreadPool pool(4);
+  ParallelGraphExecutor executor(&graph, &pool);
+  // Runs several times, since the schedule changes between runs.
+  for (int run = 0; run < 10; ++run) {
+    const std::vector<DoubleTensor> actual =
+        executor.Evaluate<DoubleTensor>([] {
+          return std::make_unique<DoubleEvaluator>(InputValues());
+        });
+    ASSERT_EQ(actual.size(), expected.size());
+    for (int id = 0; id < graph.num_operations(); ++id) {
+      EXPECT_THAT(actual[id], DoubleTensorEquals(expected[id]))
+          << graph.operation(id).name();
+    }
+  }
+}
+
+TEST(ParallelGraphExecutorTest, OneEvaluatorPerWorker) {
+  const NeuralNetGraph graph = MakeMultiTowerNet(2);
+  WorkStealingThreadPool pool(3);
+  ParallelGraphExecutor executor(&graph, &pool);
+  int num_evaluators = 0;
+  executor.Evaluate<DoubleTensor>([&num_evaluators] {
+    ++num_evaluators;
+    return std::make_unique<DoubleEvaluator>(InputValues());
+  });
+  EXPECT_EQ(num_evaluators, 3);
+}
+
+TEST(ParallelGraphExecutorTest, EmptyGraph) {
+  const NeuralNetGraph graph;
+  WorkStealingThreadPool pool(2);
+  ParallelGraphExecutor executor(&graph, &pool);
+  EXPECT_TRUE(executor
+                  .Evaluate<DoubleTensor>(
+                      [] { return std::make_unique<DoubleEvaluator>(); })
+                  .empty());
+}
+
+}  // namespace
+}  // namespace tf_opt
@@ -0,0 +1,481 @@
+// Copyright 2026 The tf.opt Authors.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "tf_opt/neural_net/symbolic_bounds_evaluator.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <limits>
+#include <optional>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "ortools/base/logging.h"
+#include "absl/algorithm/container.h"
+#include "tf_opt/tensor/concat.h"
+#include "tf_opt/tensor/convolve.h"
+#include "tf_opt/tensor/embedding_lookup.h"
+#include "tf_opt/tensor/math.h"
+#include "tf_opt/tensor/pooling.h"
+#include "tf_opt/tensor/reduce.h"
+
+namespace tf_opt {
+namespace {
+
+// The value of "tensor" if its bounds are a single point everywhere, e.g. for
+// constants.
+std::optional<DoubleTensor> PointValue(const SymbolicBounds& tensor) {
+  DoubleTensor result(tensor.bounds.dimension());
+  for (int64_t i = 0; i < tensor.bounds.size(); ++i) {
+    const Bounds bounds = tensor.bounds.flat_value(i);
+    if (bounds.lb() != bounds.ub()) return std::nullopt;
+    (*result.mutable_flat_values())[i] = bounds.lb();
+  }
+  return result;
+}
+
+// A tensor of the shape of "tensor" with value i + 1 at flat index i, so that
+// the padding zeros of the pooling functions stand out.
+DoubleTensor ShiftedFlatIndices(const Shape& shape) {
+  DoubleTensor result(shape);
+  for (int64_t i = 0; i < result.size(); ++i) {
+    (*result.mutable_flat_values())[i] = i + 1;
+  }
+  return result;
+}
+
+std::vector<int64_t> UnshiftIndices(absl::Span<const double> shifted) {
+  std::vector<int64_t> result;
+  result.reserve(shifted.size());
+  for (const double index : shifted) {
+    result.push_back(static_cast<int64_t>(index) - 1);
+  }
+  return result;
+}
+
+// Relaxations of y = relu(x) for x in [lb, ub], with lb < 0 < ub: the upper
+// bound is the chord from (lb, 0) to (ub, ub), and the lower bound is either 0
+// or x, whichever has the smallest area between it and the function.
+LinearBounds RelaxRelu(const LinearBounds& input, const double lb,
+                       const double ub) {
+  const double lower_slope = ub > -lb ? 1.0 : 0.0;
+  if (!std::isfinite(lb) || !std::isfinite(ub)) {
+    return input.Relax(lower_slope, 0.0, 0.0, ub);
+  }
+  const double upper_slope = ub / (ub - lb);
+  return input.Relax(lower_slope, 0.0, upper_slope, -upper_slope * lb);
+}
+
+// Relaxations of y = min(cap, max(0, x)) for x in [lb, ub], with lb < cap and
+// ub > 0, which is not the identity on [lb, ub].
+LinearBounds RelaxClippedRelu(const LinearBounds& input, const double lb,
+                              const double ub, const double cap) {
+  if (ub <= cap) {
+    return RelaxRelu(input, lb, ub);
+  }
+  if (lb >= 0.0) {
+    // min(cap, x) is concave: the chord from (lb, lb) to (ub, cap) is below
+    // it, and either x or cap is above it.
+    const double lower_slope = (cap - lb) / (ub - lb);
+    const double lower_intercept = lb - lower_slope * lb;
+    if (ub - cap >= cap - lb) {
+      return input.Relax(lower_slope, lower_intercept, 0.0, cap);
+    }
+    return input.Relax(lower_slope, lower_intercept, 1.0, 0.0);
+  }
+  // Both kinks are in (lb, ub): the line from (lb, 0) to (cap, cap) is above
+  // the function, and the line from (0, 0) to (ub, cap) is below it.
+  if (!std::isfinite(lb)) {
+    return input.Relax(cap / ub, 0.0, 0.0, cap);
+  }
+  const double upper_slope = cap / (cap - lb);
+  return input.Relax(cap / ub, 0.0, upper_slope, -upper_slope * lb);
+}
+
+}  // namespace
+
+SymbolicBoundsEvaluator::SymbolicBoundsEvaluator(
+    const absl::flat_hash_map<std::string, BoundsTensor>& variable_bounds) {
+  std::vector<std::string> names;
+  for (const auto& [name, bounds] : variable_bounds) {
+    names.push_back(name);
+  }
+  absl::c_sort(names);
+  for (const std::string& name : names) {
+    const BoundsTensor& bounds = variable_bounds.at(name);
+    variables_[name] = {static_cast<int64_t>(input_bounds_.size()), bounds};
+    input_bounds_.insert(input_bounds_.end(), bounds.flat_values().begin(),
+                         bounds.flat_values().end());
+  }
+}
+
+std::optional<int64_t> SymbolicBoundsEvaluator::input_offset(
+    absl::string_view name) const {
+  const auto it = variables_.find(name);
+  if (it == variables_.end()) return std::nullopt;
+  return it->second.offset;
+}
+
+SymbolicBounds SymbolicBoundsEvaluator::MakeResult(
+    Tensor<LinearBounds> linear, const BoundsTensor& interval) const {
+  CHECK(linear.dimension() == interval.dimension());
+  SymbolicBounds result{std::move(linear), BoundsTensor(interval.dimension())};
+  std::vector<Bounds>& bounds = *result.bounds.mutable_flat_values();
+  for (int64_t i = 0; i < interval.size(); ++i) {
+    bounds[i] = Intersect(Concretize(result.linear.flat_value(i)),
+                          interval.flat_value(i));
+  }
+  return result;
+}
+
+SymbolicBounds SymbolicBoundsEvaluator::FromInterval(
+    const BoundsTensor& interval) {
+  SymbolicBounds result{Tensor<LinearBounds>(interval.dimension()), interval};
+  std::vector<LinearBounds>& linear = *result.linear.mutable_flat_values();
+  for (int64_t i = 0; i < interval.size(); ++i) {
+    linear[i] = LinearBounds(interval.flat_value(i));
+  }
+  return result;
+}
+
+LinearBounds SymbolicBoundsEvaluator::MaxOfElements(
+    const SymbolicBounds& input, const std::vector<int64_t>& indices,
+    const bool minimize, Bounds* result_bounds) const {
+  CHECK(!indices.empty());
+  // The min is the opposite of the max of the opposites.
+  const double sign = minimize ? -1.0 : 1.0;
+  const auto element_bounds = [&input, sign](const int64_t index) {
+    const Bounds bounds =
+        index < 0 ? Bounds(0.0) : input.bounds.flat_value(index);
+    return sign > 0 ? bounds : -bounds;
+  };
+  // The element with the largest lower bound is a lower bound of the max.
+  int64_t best = 0;
+  double max_ub = element_bounds(indices[0]).ub();
+  for (int64_t i = 1; i < indices.size(); ++i) {
+    const Bounds bounds = element_bounds(indices[i]);
+    if (bounds.lb() > element_bounds(indices[best]).lb()) best = i;
+    max_ub = std::max(max_ub, bounds.ub());
+  }
+  const double best_lb = element_bounds(indices[best]).lb();
+  double other_max_ub = -std::numeric_limits<double>::infinity();
+  for (int64_t i = 0; i < indices.size(); ++i) {
+    if (i != best) {
+      other_max_ub = std::max(other_max_ub, element_bounds(indices[i]).ub());
+    }
+  }
+  const Bounds max_bounds(best_lb, max_ub);
+  *result_bounds = sign > 0 ? max_bounds : -max_bounds;
+  const int64_t best_index = indices[best];
+  const LinearBounds best_linear =
+      best_index < 0 ? LinearBounds(0.0)
+                     : input.linear.flat_value(best_index) * sign;
+  // The best element is the max when it dominates all others.
+  const LinearBounds max_linear =
+      best_lb >= other_max_ub
+          ? best_linear
+          : LinearBounds::FromLowerAndUpper(best_linear,
+                                            LinearBounds(Bounds(max_ub)));
+  return max_linear * sign;
+}
+
+SymbolicBounds SymbolicBoundsEvaluator::EvaluateAdd(
+    const AddOperation& op, const SymbolicBounds& left,
+    const SymbolicBounds& right) {
+  return MakeResult(Add(left.linear, right.linear),
+                    Add(left.bounds, right.bounds));
+}
+
+SymbolicBounds SymbolicBoundsEvaluator::EvaluateClippedRelu(
+    const ClippedReluOperation& op, const SymbolicBounds& input) {
+  const double cap = op.cap();
+  Tensor<LinearBounds> linear(input.linear.dimension());
+  for (int64_t i = 0; i < input.bounds.size(); ++i) {
+    const Bounds bounds = input.bounds.flat_value(i);
+    LinearBounds& result = (*linear.mutable_flat_values())[i];
+    if (bounds.ub() <= 0.0) {
+      result = LinearBounds(0.0);
+    } else if (bounds.lb() >= cap) {
+      result = LinearBounds(cap);
+    } else if (bounds.lb() >= 0.0 && bounds.ub() <= cap) {
+      result = input.linear.flat_value(i);
+    } else {
+      result = RelaxClippedRelu(input.linear.flat_value(i), bounds.lb(),
+                                bounds.ub(), cap);
+    }
+  }
+  return MakeResult(std::move(linear),
+                    ElementwiseClippedRelu(input.bounds, cap));
+}
+
+SymbolicBounds SymbolicBoundsEvaluator::EvaluateConcat(
+    const ConcatOperation& op,
+    const std::vector<const SymbolicBounds*>& inputs) {
+  std::vector<const Tensor<LinearBounds>*> linear;
+  std::vector<const BoundsTensor*> bounds;
+  for (const SymbolicBounds* input : inputs) {
+    linear.push_back(&input->linear);
+    bounds.push_back(&input->bounds);
+  }
+  return MakeResult(Concat(linear, op.axis()), Concat(bounds, op.axis()));
+}
+
+SymbolicBounds SymbolicBoundsEvaluator::EvaluateConstant(
+    const ConstantOperation& op) {
+  return FromInterval(DoubleTensorToBoundsTensor(op.value()));
+}
+
+SymbolicBounds SymbolicBoundsEvaluator::EvaluateConv1d(
+    const Conv1dOperation& op, const SymbolicBounds& value,
+    const SymbolicBounds& filters) {
+  const BoundsTensor interval =
+      Conv1d<Bounds>(value.bounds, filters.bounds, op.stride(), op.padding())
+          .value();
+  if (const std::optional<DoubleTensor> point = PointValue(filters)) {
+    return MakeResult(Conv1d<LinearBounds>(value.linear, *point, op.stride(),
+                                           op.padding())
+                          .value(),
+                      interval);
+  }
+  if (const std::optional<DoubleTensor> point = PointValue(value)) {
+    return MakeResult(Conv1d<LinearBounds>(*point, filters.linear, op.stride(),
+                                           op.padding())
+                          .value(),
+                      interval);
+  }
+  return FromInterval(interval);
+}
+
+SymbolicBounds SymbolicBoundsEvaluator::EvaluateConv2d(
+    const Conv2dOperation& op, const SymbolicBounds& value,
+    const SymbolicBounds& filters) {
+  const BoundsTensor interval =
+      Conv2d<Bounds>(value.bounds, filters.bounds, op.stride(), op.padding())
+          .value();
+  if (const std::optional<DoubleTensor> point = PointValue(filters)) {
+    return MakeResult(Conv2d<LinearBounds>(value.linear, *point, op.stride(),
+                                           op.padding())
+                          .value(),
+                      interval);
+  }
+  if (const std::optional<DoubleTensor> point = PointValue(value)) {
+    return MakeResult(Conv2d<LinearBounds>(*point, filters.linear, op.stride(),
+                                           op.padding())
+                          .value(),
+                      interval);
+  }
+  return FromInterval(interval);
+}
+
+SymbolicBounds SymbolicBoundsEvaluator::EvaluateDivide(
+    const DivideOperation& op, const SymbolicBounds& left,
+    const SymbolicBounds& right) {
+  const BoundsTensor interval = Divide(left.bounds, right.bounds);
+  const std::optional<DoubleTensor> point = PointValue(right);
+  if (point.has_value() && !absl::c_linear_search(point->flat_values(), 0.0)) {
+    return MakeResult(
+        internal::Divide<LinearBounds, LinearBounds, double>(left.linear,
+                                                             *point),
+        interval);
+  }
+  return FromInterval(interval);
+}
+
+SymbolicBounds SymbolicBoundsEvaluator::EvaluateEmbeddingLookup(
+    const EmbeddingLookupOperation& op, const SymbolicBounds& params,
+    const SymbolicBounds& ids) {
+  const BoundsTensor interval =
+      EmbeddingLookup<Bounds>(params.bounds, ids.bounds);
+  if (const std::optional<DoubleTensor> point = PointValue(params)) {
+    return MakeResult(EmbeddingLookup<LinearBounds>(*point, ids.linear),
+                      interval);
+  }
+  if (const std::optional<DoubleTensor> point = PointValue(ids)) {
+    return MakeResult(EmbeddingLookup<LinearBounds>(params.linear, *point),
+                      interval);
+  }
+  return FromInterval(interval);
+}
+
+SymbolicBounds SymbolicBoundsEvaluator::EvaluateExpandDims(
+    const ExpandDimsOperation& op, const SymbolicBounds& input) {
+  return {input.linear.ExpandDims(op.axis()),
+          input.bounds.ExpandDims(op.axis())};
+}
+
+SymbolicBounds SymbolicBoundsEvaluator::EvaluateMatmul(
+    const MatmulOperation& op, const SymbolicBounds& left,
+    const SymbolicBounds& right) {
+  const BoundsTensor interval = MatMul(left.bounds, right.bounds);
+  if (const std::optional<DoubleTensor> point = PointValue(right)) {
+    return MakeResult(
+        internal::MatMul<LinearBounds, LinearBounds, double>(left.linear,
+                                                             *point),
+        interval);
+  }
+  if (const std::optional<DoubleTensor> point = PointValue(left)) {
+    return MakeResult(
+        internal::MatMul<LinearBounds, double, LinearBounds>(*point,
+                                                             right.linear),
+        interval);
+  }
+  return FromInterval(interval);
+}
+
+SymbolicBounds SymbolicBoundsEvaluator::EvaluateMaxpool(
+    const MaxpoolOperation& op, const SymbolicBounds& input) {
+  const Shape output_shape =
+      Pool2dOutputShape(input.bounds.dimension(), op.ksize(), op.stride(),
+                        op.padding())
+          .value();
+  BoundsTensor interval(output_shape);
+  Tensor<LinearBounds> linear = internal::Pool<LinearBounds, double>(
+      ShiftedFlatIndices(input.bounds.dimension()), op.ksize(), op.stride(),
+      op.padding(),
+      [this, &input, &interval](const std::vector<double>& window,
+                                const int64_t output_index) {
+        return MaxOfElements(
+            input, UnshiftIndices(window), /*minimize=*/false,
+            &(*interval.mutable_flat_values())[output_index]);
+      });
+  return MakeResult(std::move(linear), interval);
+}
+
+SymbolicBounds SymbolicBoundsEvaluator::EvaluateMultiply(
+    const MultiplyOperation& op, const SymbolicBounds& left,
+    const SymbolicBounds& right) {
+  const BoundsTensor interval = Multiply(left.bounds, right.bounds);
+  if (const std::optional<DoubleTensor> point = PointValue(right)) {
+    return MakeResult(
+        internal::Multiply<LinearBounds, LinearBounds, double>(left.linear,
+                                                               *point),
+        interval);
+  }
+  if (const std::optional<DoubleTensor> point = PointValue(left)) {
+    return MakeResult(
+        internal::Multiply<LinearBounds, double, LinearBounds>(*point,
+                                                               right.linear),
+        interval);
+  }
+  return FromInterval(interval);
+}
+
+SymbolicBounds SymbolicBoundsEvaluator::EvaluateReduceMax(
+    const ReduceMaxOperation& op, const SymbolicBounds& input) {
+  const Shape output_shape =
+      ReduceOutputShape(input.bounds.dimension(), op.axes()).value();
+  BoundsTensor interval(output_shape);
+  Tensor<LinearBounds> linear = internal::Reduce<LinearBounds>(
+      ShiftedFlatIndices(input.bounds.dimension()), op.axes(),
+      [this, &input, &interval](absl::Span<const double> elements,
+                                const int64_t output_index) {
+        return MaxOfElements(
+            input, UnshiftIndices(elements), /*minimize=*/false,
+            &(*interval.mutable_flat_values())[output_index]);
+      });
+  return MakeResult(std::move(linear), interval);
+}
+
+SymbolicBounds SymbolicBoundsEvaluator::EvaluateReduceMean(
+    const ReduceMeanOperation& op, const SymbolicBounds& input) {
+  return MakeResult(ReduceMean(input.linear, op.axes()),
+                    ReduceMean(input.bounds, op.axes()));
+}
+
+SymbolicBounds SymbolicBoundsEvaluator::EvaluateReduceMin(
+    const ReduceMinOperation& op, const SymbolicBounds& input) {
+  const Shape output_shape =
+      ReduceOutputShape(input.bounds.dimension(), op.axes()).value();
+  BoundsTensor interval(output_shape);
+  Tensor<LinearBounds> linear = internal::Reduce<LinearBounds>(
+      ShiftedFlatIndices(input.bounds.dimension()), op.axes(),
+      [this, &input, &interval](absl::Span<const double> elements,
+                                const int64_t output_index) {
+        return MaxOfElements(
+            input, UnshiftIndices(elements), /*minimize=*/true,
+            &(*interval.mutable_flat_values())[output_index]);
+      });
+  return MakeResult(std::move(linear), interval);
+}
+
+SymbolicBounds SymbolicBoundsEvaluator::EvaluateReduceSum(
+    const ReduceSumOperation& op, const SymbolicBounds& input) {
+  return MakeResult(ReduceSum(input.linear, op.axes()),
+                    ReduceSum(input.bounds, op.axes()));
+}
+
+SymbolicBounds SymbolicBoundsEvaluator::EvaluateRelu(
+    const ReluOperation& op, const SymbolicBounds& input) {
+  Tensor<LinearBounds> linear(input.linear.dimension());
+  for (int64_t i = 0; i < input.bounds.size(); ++i) {
+    const Bounds bounds = input.bounds.flat_value(i);
+    LinearBounds& result = (*linear.mutable_flat_values())[i];
+    if (bounds.ub() <= 0.0) {
+      result = LinearBounds(0.0);
+    } else if (bounds.lb() >= 0.0) {
+      result = input.linear.flat_value(i);
+    } else {
+      result = RelaxRelu(input.linear.flat_value(i), bounds.lb(), bounds.ub());
+    }
+  }
+  return MakeResult(std::move(linear), ElementwiseRelu(input.bounds));
+}
+
+SymbolicBounds SymbolicBoundsEvaluator::EvaluateReshape(
+    const ReshapeOperation& op, const SymbolicBounds& input) {
+  return {input.linear.Reshape(op.output_shape()),
+          input.bounds.Reshape(op.output_shape())};
+}
+
+SymbolicBounds SymbolicBoundsEvaluator::EvaluateSlice(
+    const SliceOperation& op, const SymbolicBounds& input) {
+  return {input.linear.Slice(op.begin(), op.sizes()),
+          input.bounds.Slice(op.begin(), op.sizes())};
+}
+
+SymbolicBounds SymbolicBoundsEvaluator::EvaluateSqueeze(
+    const SqueezeOperation& op, const SymbolicBounds& input) {
+  if (op.axes().empty()) {
+    return {input.linear.Squeeze(), input.bounds.Squeeze()};
+  }
+  return {input.linear.Squeeze(op.axes()), input.bounds.Squeeze(op.axes())};
+}
+
+SymbolicBounds SymbolicBoundsEvaluator::EvaluateSubtract(
+    const SubtractOperation& op, const SymbolicBounds& left,
+    const SymbolicBounds& right) {
+  return MakeResult(Subtract(left.linear, right.linear),
+                    Subtract(left.bounds, right.bounds));
+}
+
+SymbolicBounds SymbolicBoundsEvaluator::EvaluateVariable(
+    const VariableOperation& op) {
+  const auto it = variables_.find(op.name());
+  CHECK(it != variables_.end()) << "No bounds for variable: " << op.name();
+  const VariableInputs& variable = it->second;
+  CHECK(variable.bounds.dimension() == op.output_shape())
+      << "Bounds for variable: " << op.name() << " have shape "
+      << variable.bounds.dimension().ToString() << ", expected "
+      << op.output_shape().ToString();
+  Tensor<LinearBounds> linear(variable.bounds.dimension());
+  for (int64_t i = 0; i < linear.size(); ++i) {
+    (*linear.mutable_flat_values())[i] =
+        LinearBounds::Input(variable.offset + i);
+  }
+  return {std::move(linear), variable.bounds};
+}
+
+}  // namespace tf_opt
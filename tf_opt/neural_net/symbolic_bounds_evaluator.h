@@ -0,0 +1,182 @@
+// Copyright 2026 The tf.opt Authors.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef TF_OPT_NEURAL_NET_SYMBOLIC_BOUNDS_EVALUATOR_H_
+#define TF_OPT_NEURAL_NET_SYMBOLIC_BOUNDS_EVALUATOR_H_
+
+#include <cstdint>
+#include <optional>
+#include <string>
+#include <vector>
+
+#include "absl/container/flat_hash_map.h"
+#include "absl/strings/string_view.h"
+#include "tf_opt/bounds/bounds.h"
+#include "tf_opt/bounds/linear_bounds.h"
+#include "tf_opt/neural_net/operation_evaluator.h"
+#include "tf_opt/neural_net/ops/all_operations.h"
+#include "tf_opt/tensor/shape.h"
+#include "tf_opt/tensor/tensor.h"
+
+namespace tf_opt {
+
+// The result of symbolic bound propagation for one operation.
+struct SymbolicBounds {
+  // Lower and upper bounds on each element, as affine functions of the
+  // elements of the input variables (see SymbolicBoundsEvaluator).
+  Tensor<LinearBounds> linear;
+
+  // Bounds on each element: the linear bounds minimized and maximized over
+  // the input box, intersected with the bounds from interval arithmetic.
+  BoundsTensor bounds;
+};
+
+// Propagates bounds through a neural network in the style of DeepPoly (Singh
+// et al., "An Abstract Domain for Certifying Neural Networks", 2019) and
+// CROWN (Zhang et al., "Efficient Neural Network Robustness Certification
+// with General Activation Functions", 2018). Each element carries a linear
+// lower and upper bound in terms of the elements of the variables, so that
+// correlations between neurons are not lost: e.g. x - x is exactly zero,
+// where interval arithmetic gives [lb - ub, ub - lb].
+//
+// Linear operations are applied to the linear bounds exactly. Nonlinear ones
+// (ReLU, clipped ReLU, max pooling, ReduceMax and ReduceMin) first compute
+// concrete bounds on their input, and replace the function by linear bounds
+// that hold over that range: the triangle relaxation for ReLUs, and for a
+// max, the linear lower bound of the element with the largest lower bound.
+// Products where neither operand is a constant (Multiply, Divide, MatMul,
+// convolutions and EmbeddingLookup) fall back to interval arithmetic. The
+// bounds are propagated forward only, without back-substitution, and every
+// result is intersected with interval arithmetic, so the bounds are never
+// looser than those of Tensor<Bounds>.
+//
+// The cost of each operation is proportional to its output size times the
+// number of inputs.
+//
+// Example use:
+//   SymbolicBoundsEvaluator evaluator(
+//       {{"x", BoundsTensor(Shape({1, 784}), Bounds(0.0, 1.0))}});
+//   std::vector<SymbolicBounds> values = graph.Evaluate(&evaluator);
+//   const BoundsTensor& logits =
+//       values[graph.OperationIdOrDie("logits")].bounds;
+class SymbolicBoundsEvaluator : public OperationEvaluator<SymbolicBounds> {
+ public:
+  // The bounds on each VariableOperation, by name. Evaluating a variable
+  // without bounds, or with bounds of a different shape, CHECK fails.
+  //
+  // The inputs of the linear bounds are the elements of the variables, in
+  // the order of their names, and in flat order within each variable.
+  explicit SymbolicBoundsEvaluator(
+      const absl::flat_hash_map<std::string, BoundsTensor>& variable_bounds);
+
+  int64_t num_inputs() const { return input_bounds_.size(); }
+
+  // The bounds of each input.
+  const std::vector<Bounds>& input_bounds() const { return input_bounds_; }
+
+  // The index of the first input of variable "name", or nullopt if there are
+  // no bounds for this variable.
+  std::optional<int64_t> input_offset(absl::string_view name) const;
+
+  // The bounds implied by linear_bounds on the input box.
+  Bounds Concretize(const LinearBounds& linear_bounds) const {
+    return linear_bounds.Concretize(input_bounds_);
+  }
+
+ protected:
+  Shape GetShape(const SymbolicBounds& tensor) const override {
+    return tensor.bounds.dimension();
+  }
+
+  SymbolicBounds EvaluateAdd(const AddOperation& op,
+                             const SymbolicBounds& left,
+                             const SymbolicBounds& right) override;
+  SymbolicBounds EvaluateClippedRelu(const ClippedReluOperation& op,
+                                     const SymbolicBounds& input) override;
+  SymbolicBounds EvaluateConcat(
+      const ConcatOperation& op,
+      const std::vector<const SymbolicBounds*>& inputs) override;
+  SymbolicBounds EvaluateConstant(const ConstantOperation& op) override;
+  SymbolicBounds EvaluateConv1d(const Conv1dOperation& op,
+                                const SymbolicBounds& value,
+                                const SymbolicBounds& filters) override;
+  SymbolicBounds EvaluateConv2d(const Conv2dOperation& op,
+                                const SymbolicBounds& value,
+                                const SymbolicBounds& filters) override;
+  SymbolicBounds EvaluateDivide(const DivideOperation& op,
+                                const SymbolicBounds& left,
+                                const SymbolicBounds& right) override;
+  SymbolicBounds EvaluateEmbeddingLookup(const EmbeddingLookupOperation& op,
+                                         const SymbolicBounds& params,
+                                         const SymbolicBounds& ids) override;
+  SymbolicBounds EvaluateExpandDims(const ExpandDimsOperation& op,
+                                    const SymbolicBounds& input) override;
+  SymbolicBounds EvaluateMatmul(const MatmulOperation& op,
+                                const SymbolicBounds& left,
+                                const SymbolicBounds& right) override;
+  SymbolicBounds EvaluateMaxpool(const MaxpoolOperation& op,
+                                 const SymbolicBounds& input) override;
+  SymbolicBounds EvaluateMultiply(const MultiplyOperation& op,
+                                  const SymbolicBounds& left,
+                                  const SymbolicBounds& right) override;
+  SymbolicBounds EvaluateReduceMax(const ReduceMaxOperation& op,
+                                   const SymbolicBounds& input) override;
+  SymbolicBounds EvaluateReduceMean(const ReduceMeanOperation& op,
+                                    const SymbolicBounds& input) override;
+  SymbolicBounds EvaluateReduceMin(const ReduceMinOperation& op,
+                                   const SymbolicBounds& input) override;
+  SymbolicBounds EvaluateReduceSum(const ReduceSumOperation& op,
+                                   const SymbolicBounds& input) override;
+  SymbolicBounds EvaluateRelu(const ReluOperation& op,
+                              const SymbolicBounds& input) override;
+  SymbolicBounds EvaluateReshape(const ReshapeOperation& op,
+                                 const SymbolicBounds& input) override;
+  SymbolicBounds EvaluateSlice(const SliceOperation& op,
+                               const SymbolicBounds& input) override;
+  SymbolicBounds EvaluateSqueeze(const SqueezeOperation& op,
+                                 const SymbolicBounds& input) override;
+  SymbolicBounds EvaluateSubtract(const SubtractOperation& op,
+                                  const SymbolicBounds& left,
+                                  const SymbolicBounds& right) override;
+  SymbolicBounds EvaluateVariable(const VariableOperation& op) override;
+
+ private:
+  // Intersects the concretized linear bounds with "interval".
+  SymbolicBounds MakeResult(Tensor<LinearBounds> linear,
+                            const BoundsTensor& interval) const;
+
+  // The result of an operation that could only be evaluated with interval
+  // arithmetic, as constant linear bounds.
+  static SymbolicBounds FromInterval(const BoundsTensor& interval);
+
+  // The linear bounds of the max (or min if "minimize") of some elements of
+  // "input", given by their flat indices, and sets *result_bounds to the
+  // interval bounds. A negative index stands for a padding zero.
+  LinearBounds MaxOfElements(const SymbolicBounds& input,
+                             const std::vector<int64_t>& indices,
+                             bool minimize, Bounds* result_bounds) const;
+
+  struct VariableInputs {
+    // The index of the first input of the variable.
+    int64_t offset;
+    BoundsTensor bounds;
+  };
+
+  absl::flat_hash_map<std::string, VariableInputs> variables_;
+  std::vector<Bounds> input_bounds_;
+};
+
+}  // namespace tf_opt
+
+#endif  // TF_OPT_NEURAL_NET_SYMBOLIC_BOUNDS_EVALUATOR_H_
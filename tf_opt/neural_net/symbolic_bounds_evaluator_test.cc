@@ -0,0 +1,321 @@
+// Copyright 2026 The tf.opt Authors.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "tf_opt/neural_net/symbolic_bounds_evaluator.h"
+
+#include <cstdint>
+#include <memory>
+#include <random>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "gmock/gmock.h"
+#include "gtest/gtest.h"
+#include "absl/container/flat_hash_map.h"
+#include "tf_opt/bounds/bounds.h"
+#include "tf_opt/neural_net/double_evaluator.h"
+#include "tf_opt/neural_net/neural_net_graph.h"
+#include "tf_opt/neural_net/operation_testing.h"
+#include "tf_opt/neural_net/ops/all_operations.h"
+#include "tf_opt/tensor/shape.h"
+#include "tf_opt/tensor/tensor.h"
+#include "tf_opt/tensor/tensor_testing.h"
+#include "tf_opt/tensor/window.h"
+
+namespace tf_opt {
+namespace {
+
+using Matrix = std::vector<std::vector<double>>;
+
+Shape OutputShape(const NeuralNetGraph& graph, const int id) {
+  return graph.operation(id).output_shape();
+}
+
+// Checks that the value of every operation at random points of the box
+// variable_bounds is within the bounds computed by SymbolicBoundsEvaluator.
+void ExpectSound(
+    const NeuralNetGraph& graph,
+    const absl::flat_hash_map<std::string, BoundsTensor>& variable_bounds) {
+  SymbolicBoundsEvaluator symbolic_evaluator(variable_bounds);
+  const std::vector<SymbolicBounds> bounds =
+      graph.Evaluate(&symbolic_evaluator);
+  std::mt19937 random(1234);
+  for (int sample = 0; sample < 200; ++sample) {
+    DoubleEvaluator evaluator;
+    for (const auto& [name, box] : variable_bounds) {
+      DoubleTensor point(box.dimension());
+      for (int64_t i = 0; i < box.size(); ++i) {
+        std::uniform_real_distribution<double> distribution(
+            box.flat_value(i).lb(), box.flat_value(i).ub());
+        (*point.mutable_flat_values())[i] = distribution(random);
+      }
+      evaluator.set_variable_value(name, std::move(point));
+    }
+    const std::vector<DoubleTensor> values = graph.Evaluate(&evaluator);
+    for (int id = 0; id < graph.num_operations(); ++id) {
+      ASSERT_EQ(bounds[id].bounds.dimension(), values[id].dimension());
+      for (int64_t i = 0; i < values[id].size(); ++i) {
+        const Bounds element_bounds = bounds[id].bounds.flat_value(i);
+        const double value = values[id].flat_value(i);
+        ASSERT_GE(value, element_bounds.lb() - 1e-9)
+            << graph.operation(id).name() << " at " << i;
+        ASSERT_LE(value, element_bounds.ub() + 1e-9)
+            << graph.operation(id).name() << " at " << i;
+      }
+    }
+  }
+}
+
+TEST(SymbolicBoundsEvaluatorTest, InputOffsets) {
+  const SymbolicBoundsEvaluator evaluator(
+      {{"y", BoundsTensor(Shape({2}), Bounds(0.0, 1.0))},
+       {"x", BoundsTensor(Shape({3}), Bounds(-1.0, 1.0))}});
+  EXPECT_EQ(evaluator.num_inputs(), 5);
+  EXPECT_EQ(evaluator.input_offset("x"), 0);
+  EXPECT_EQ(evaluator.input_offset("y"), 3);
+  EXPECT_EQ(evaluator.input_offset("z"), std::nullopt);
+  EXPECT_EQ(evaluator.input_bounds()[3], Bounds(0.0, 1.0));
+}
+
+TEST(SymbolicBoundsEvaluatorTest, KeepsCorrelations) {
+  // 2x - x is exactly x, where interval arithmetic gives [-1, 3].
+  NeuralNetGraph graph;
+  const int x = AddToGraph(VariableOperation::Create("x", Shape({2})), {},
+                           &graph);
+  const int two = AddToGraph(
+      ConstantOperation::Create("two", DoubleTensor({2.0, 2.0})), {}, &graph);
+  const int double_x = AddToGraph(
+      MultiplyOperation::Create("double_x", Shape({2}), Shape({2})), {two, x},
+      &graph);
+  const int difference = AddToGraph(
+      SubtractOperation::Create("difference", Shape({2}), Shape({2})),
+      {double_x, x}, &graph);
+  SymbolicBoundsEvaluator evaluator(
+      {{"x", BoundsTensor(Shape({2}), Bounds(0.0, 1.0))}});
+  const std::vector<SymbolicBounds> bounds = graph.Evaluate(&evaluator);
+  EXPECT_EQ(bounds[difference].bounds.flat_value(0), Bounds(0.0, 1.0));
+  EXPECT_EQ(bounds[difference].bounds.flat_value(1), Bounds(0.0, 1.0));
+}
+
+TEST(SymbolicBoundsEvaluatorTest, ReluRelaxation) {
+  // z = relu(x) - 0.75 x for x in [-1, 3]. The triangle relaxation gives
+  // x <= relu(x) <= 0.75 x + 0.75, so -0.25 <= z <= 0.75, where interval
+  // arithmetic gives [0, 3] - [-0.75, 2.25] = [-2.25, 3.75].
+  NeuralNetGraph graph;
+  const int x = AddToGraph(VariableOperation::Create("x", Shape({1})), {},
+                           &graph);
+  const int relu =
+      AddToGraph(ReluOperation::Create("relu", Shape({1})), {x}, &graph);
+  const int scale = AddToGraph(
+      ConstantOperation::Create("scale", DoubleTensor(Shape({1}), 0.75)), {},
+      &graph);
+  const int scaled_x = AddToGraph(
+      MultiplyOperation::Create("scaled_x", Shape({1}), Shape({1})),
+      {x, scale}, &graph);
+  const int z = AddToGraph(
+      SubtractOperation::Create("z", Shape({1}), Shape({1})), {relu, scaled_x},
+      &graph);
+  SymbolicBoundsEvaluator evaluator(
+      {{"x", BoundsTensor(Shape({1}), Bounds(-1.0, 3.0))}});
+  const std::vector<SymbolicBounds> bounds = graph.Evaluate(&evaluator);
+  EXPECT_EQ(bounds[relu].bounds.flat_value(0), Bounds(0.0, 3.0));
+  const Bounds z_bounds = bounds[z].bounds.flat_value(0);
+  EXPECT_DOUBLE_EQ(z_bounds.lb(), -0.25);
+  EXPECT_DOUBLE_EQ(z_bounds.ub(), 0.75);
+}
+
+TEST(SymbolicBoundsEvaluatorTest, StableRelus) {
+  NeuralNetGraph graph;
+  const int x = AddToGraph(VariableOperation::Create("x", Shape({2})), {},
+                           &graph);
+  const int relu =
+      AddToGraph(ReluOperation::Create("relu", Shape({2})), {x}, &graph);
+  const int difference = AddToGraph(
+      SubtractOperation::Create("difference", Shape({2}), Shape({2})),
+      {relu, x}, &graph);
+  BoundsTensor box(Shape({2}));
+  box.set_flat_value(0, Bounds(1.0, 2.0));
+  box.set_flat_value(1, Bounds(-2.0, -1.0));
+  SymbolicBoundsEvaluator evaluator({{"x", box}});
+  const std::vector<SymbolicBounds> bounds = graph.Evaluate(&evaluator);
+  // Active: relu(x) - x = 0. Inactive: relu(x) - x = -x.
+  EXPECT_EQ(bounds[difference].bounds.flat_value(0), Bounds(0.0, 0.0));
+  EXPECT_EQ(bounds[difference].bounds.flat_value(1), Bounds(1.0, 2.0));
+}
+
+TEST(SymbolicBoundsEvaluatorTest, DominatedMaxIsExact) {
+  // The second element always is the max, so max - x[1] is exactly zero.
+  NeuralNetGraph graph;
+  const int x = AddToGraph(VariableOperation::Create("x", Shape({1, 3})), {},
+                           &graph);
+  const int max = AddToGraph(
+      ReduceMaxOperation::Create("max", Shape({1, 3}), {1}), {x}, &graph);
+  const int second = AddToGraph(
+      SliceOperation::Create("second", Shape({1, 3}), {0, 1}, {1, 1}), {x},
+      &graph);
+  const int second_vector = AddToGraph(
+      ReshapeOperation::Create("second_vector", Shape({1, 1}), Shape({1})),
+      {second}, &graph);
+  const int difference = AddToGraph(
+      SubtractOperation::Create("difference", Shape({1}), Shape({1})),
+      {max, second_vector}, &graph);
+  BoundsTensor box(Shape({1, 3}));
+  box.set_flat_value(0, Bounds(-1.0, 1.0));
+  box.set_flat_value(1, Bounds(2.0, 5.0));
+  box.set_flat_value(2, Bounds(0.0, 2.0));
+  SymbolicBoundsEvaluator evaluator({{"x", box}});
+  const std::vector<SymbolicBounds> bounds = graph.Evaluate(&evaluator);
+  EXPECT_EQ(bounds[max].bounds.flat_value(0), Bounds(2.0, 5.0));
+  EXPECT_EQ(bounds[difference].bounds.flat_value(0), Bounds(0.0, 0.0));
+}
+
+TEST(SymbolicBoundsEvaluatorTest, SoundOnDenseNetwork) {
+  NeuralNetGraph graph;
+  const int x = AddToGraph(VariableOperation::Create("x", Shape({1, 4})), {},
+                           &graph);
+  const int w1 = AddToGraph(
+      ConstantOperation::Create("w1", MakeWeights(Shape({4, 6}), 1)), {},
+      &graph);
+  const int matmul1 = AddToGraph(
+      MatmulOperation::Create("matmul1", Shape({1, 4}), Shape({4, 6})),
+      {x, w1}, &graph);
+  const int b1 = AddToGraph(
+      ConstantOperation::Create("b1", MakeWeights(Shape({6}), 2)), {}, &graph);
+  const int add = AddToGraph(
+      AddOperation::Create("add", Shape({1, 6}), Shape({6})), {matmul1, b1},
+      &graph);
+  const int relu =
+      AddToGraph(ReluOperation::Create("relu", Shape({1, 6})), {add}, &graph);
+  const int w2 = AddToGraph(
+      ConstantOperation::Create("w2", MakeWeights(Shape({6, 3}), 3)), {},
+      &graph);
+  const int matmul2 = AddToGraph(
+      MatmulOperation::Create("matmul2", Shape({1, 6}), Shape({6, 3})),
+      {relu, w2}, &graph);
+  const int clipped = AddToGraph(
+      ClippedReluOperation::Create("clipped", Shape({1, 3}), 0.5), {matmul2},
+      &graph);
+  const int concat = AddToGraph(
+      ConcatOperation::Create("concat", {Shape({1, 6}), Shape({1, 3})}, 1),
+      {relu, clipped}, &graph);
+  const int max = AddToGraph(
+      ReduceMaxOperation::Create("max", Shape({1, 9}), {1}), {concat}, &graph);
+  const int min = AddToGraph(
+      ReduceMinOperation::Create("min", Shape({1, 3}), {1}), {matmul2},
+      &graph);
+  const int mean = AddToGraph(
+      ReduceMeanOperation::Create("mean", Shape({1, 9}), {1}), {concat},
+      &graph);
+  const int three = AddToGraph(
+      ConstantOperation::Create("three", DoubleTensor(Shape({1}), 3.0)), {},
+      &graph);
+  AddToGraph(DivideOperation::Create("divide", Shape({1}), Shape({1})),
+             {mean, three}, &graph);
+  AddToGraph(MultiplyOperation::Create("product", Shape({1}), Shape({1})),
+             {max, min}, &graph);
+  AddToGraph(MultiplyOperation::Create("square", Shape({1, 4}), Shape({1, 4})),
+             {x, x}, &graph);
+  AddToGraph(DivideOperation::Create("ratio", Shape({1}), Shape({1})),
+             {max, min}, &graph);
+  ExpectSound(graph, {{"x", BoundsTensor(Shape({1, 4}), Bounds(-1.0, 1.0))}});
+}
+
+TEST(SymbolicBoundsEvaluatorTest, SoundOnConvolutionalNetwork) {
+  NeuralNetGraph graph;
+  const int x = AddToGraph(VariableOperation::Create("x", Shape({1, 3, 3, 1})),
+                           {}, &graph);
+  const int filter = AddToGraph(
+      ConstantOperation::Create("filter", MakeWeights(Shape({2, 2, 1, 2}), 4)),
+      {}, &graph);
+  const int conv2d = AddToGraph(
+      Conv2dOperation::Create("conv2d", Shape({1, 3, 3, 1}),
+                              Shape({2, 2, 1, 2}), Position2D(1, 1),
+                              PaddingType::SAME),
+      {x, filter}, &graph);
+  const int relu = AddToGraph(
+      ReluOperation::Create("relu", OutputShape(graph, conv2d)), {conv2d},
+      &graph);
+  const int maxpool = AddToGraph(
+      MaxpoolOperation::Create("maxpool", OutputShape(graph, relu),
+                               Position2D(2, 2), Position2D(1, 1),
+                               PaddingType::VALID),
+      {relu}, &graph);
+  const int flat = AddToGraph(
+      ReshapeOperation::Create("flat", OutputShape(graph, maxpool),
+                               Shape({1, OutputShape(graph, maxpool).size()})),
+      {maxpool}, &graph);
+  const int expanded = AddToGraph(
+      ExpandDimsOperation::Create("expanded", OutputShape(graph, flat), 0),
+      {flat}, &graph);
+  const int squeezed = AddToGraph(
+      SqueezeOperation::Create("squeezed", OutputShape(graph, expanded), {0}),
+      {expanded}, &graph);
+  // Without axes, removes both leading dimensions of size 1.
+  const int squeezed_all = AddToGraph(
+      SqueezeOperation::Create("squeezed_all", OutputShape(graph, expanded),
+                               {}),
+      {expanded}, &graph);
+  EXPECT_EQ(OutputShape(graph, squeezed_all).num_dimensions(), 1);
+  AddToGraph(ReduceSumOperation::Create("sum", OutputShape(graph, squeezed),
+                                        {1}),
+             {squeezed}, &graph);
+  const int sequence = AddToGraph(
+      ReshapeOperation::Create("sequence", Shape({1, 3, 3, 1}),
+                               Shape({1, 9, 1})),
+      {x}, &graph);
+  const int filter1d = AddToGraph(
+      ConstantOperation::Create("filter1d", MakeWeights(Shape({3, 1, 2}), 5)),
+      {}, &graph);
+  AddToGraph(Conv1dOperation::Create("conv1d", Shape({1, 9, 1}),
+                                     Shape({3, 1, 2}), 2, PaddingType::VALID),
+             {sequence, filter1d}, &graph);
+  ExpectSound(graph,
+              {{"x", BoundsTensor(Shape({1, 3, 3, 1}), Bounds(-1.0, 2.0))}});
+}
+
+TEST(SymbolicBoundsEvaluatorTest, SoundOnEmbeddingLookup) {
+  NeuralNetGraph graph;
+  const int ids = AddToGraph(VariableOperation::Create("ids", Shape({1, 3})),
+                             {}, &graph);
+  const int params = AddToGraph(
+      ConstantOperation::Create("params", MakeWeights(Shape({3, 2}), 6)), {},
+      &graph);
+  const int lookup = AddToGraph(
+      EmbeddingLookupOperation::Create("lookup", Shape({3, 2}), Shape({1, 3})),
+      {params, ids}, &graph);
+  AddToGraph(ReluOperation::Create("relu", OutputShape(graph, lookup)),
+             {lookup}, &graph);
+  ExpectSound(graph,
+              {{"ids", BoundsTensor(Shape({1, 3}), Bounds(0.0, 1.0))}});
+}
+
+TEST(SymbolicBoundsEvaluatorDeathTest, MissingVariable) {
+  SymbolicBoundsEvaluator evaluator(
+      {{"y", BoundsTensor(Shape({2}), Bounds(0.0, 1.0))}});
+  const VariableOperation x =
+      VariableOperation::Create("x", Shape({2})).value();
+  EXPECT_DEATH(evaluator.Evaluate(&x, {}), "No bounds for variable: x");
+}
+
+TEST(SymbolicBoundsEvaluatorDeathTest, WrongShape) {
+  SymbolicBoundsEvaluator evaluator(
+      {{"x", BoundsTensor(Shape({3}), Bounds(0.0, 1.0))}});
+  const VariableOperation x =
+      VariableOperation::Create("x", Shape({2})).value();
+  EXPECT_DEATH(evaluator.Evaluate(&x, {}), "have shape");
+}
+
+}  // namespace
+}  // namespace tf_opt
@@ -0,0 +1,216 @@
+// Copyright 2026 The tf.opt Authors.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "tf_opt/optimize/mip/bound_tightener.h"
+
+#include <algorithm>
+#include <atomic>
+#include <cstdint>
+#include <memory>
+#include <numeric>
+#include <optional>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "ortools/base/logging.h"
+#include "absl/time/clock.h"
+#include "absl/time/time.h"
+#include "ortools/linear_solver/linear_solver.h"
+#include "ortools/linear_solver/linear_solver.pb.h"
+#include "tf_opt/bounds/bounds.h"
+#include "tf_opt/util/work_stealing_thread_pool.h"
+
+namespace tf_opt {
+
+using operations_research::MPModelProto;
+using operations_research::MPObjective;
+using operations_research::MPSolver;
+using operations_research::MPSolverParameters;
+using operations_research::MPVariable;
+
+namespace {
+
+// A copy of the model on which one worker solves bound problems. The objective
+// is swapped between solves, and everything else is kept, so that solvers
+// supporting incrementality start from their previous basis.
+class BoundSolver {
+ public:
+  BoundSolver(const MPModelProto& model_proto,
+              const MPSolver::OptimizationProblemType problem_type,
+              const bool warm_start)
+      : solver_("bound_tightening_solver", problem_type),
+        warm_start_(warm_start) {
+    std::string error_msg;
+    const auto status = solver_.LoadModelFromProto(model_proto, &error_msg);
+    CHECK_EQ(status, operations_research::MPSOLVER_MODEL_IS_VALID)
+        << error_msg;
+    solver_.SuppressOutput();
+    solver_.MutableObjective()->Clear();
+    parameters_.SetIntegerParam(
+        MPSolverParameters::INCREMENTALITY,
+        warm_start ? MPSolverParameters::INCREMENTALITY_ON
+                   : MPSolverParameters::INCREMENTALITY_OFF);
+  }
+
+  // Returns a valid lower bound (or upper bound, if maximize) of the variable
+  // of the given index over the model, or nullopt if the solver found none
+  // before the deadline.
+  std::optional<double> Solve(int variable_index, bool maximize,
+                              absl::Time deadline);
+
+  void SetBounds(const int variable_index, const Bounds bounds) {
+    solver_.variable(variable_index)->SetBounds(bounds.lb(), bounds.ub());
+  }
+
+ private:
+  MPSolver solver_;
+  MPSolverParameters parameters_;
+  const bool warm_start_;
+  // The last solution found, as a hint for the next MIP solve.
+  std::vector<std::pair<const MPVariable*, double>> hint_;
+  int objective_index_ = -1;
+};
+
+std::optional<double> BoundSolver::Solve(const int variable_index,
+                                         const bool maximize,
+                                         const absl::Time deadline) {
+  MPObjective* const objective = solver_.MutableObjective();
+  if (objective_index_ >= 0) {
+    objective->SetCoefficient(solver_.variable(objective_index_), 0.0);
+  }
+  objective->SetCoefficient(solver_.variable(variable_index), 1.0);
+  objective->SetOptimizationDirection(maximize);
+  objective_index_ = variable_index;
+  if (deadline != absl::InfiniteFuture()) {
+    solver_.SetTimeLimit(
+        std::max(deadline - absl::Now(), absl::ZeroDuration()));
+  }
+  if (!hint_.empty()) {
+    solver_.SetHint(hint_);
+  }
+
+  const MPSolver::ResultStatus status = solver_.Solve(parameters_);
+  if (!solver_.IsMIP()) {
+    if (status != MPSolver::OPTIMAL) return std::nullopt;
+    return solver_.Objective().Value();
+  }
+  if (status != MPSolver::OPTIMAL && status != MPSolver::FEASIBLE) {
+    return std::nullopt;
+  }
+  if (warm_start_) {
+    hint_.clear();
+    for (const MPVariable* variable : solver_.variables()) {
+      hint_.emplace_back(variable, variable->solution_value());
+    }
+  }
+  // Unlike the objective value, the best bound is valid even if the solver
+  // stopped on a gap or on the time limit.
+  return solver_.Objective().BestBound();
+}
+
+// The order in which the neurons of a layer are tightened: the unstable
+// neurons first, by decreasing min(-lb, ub), then the stable ones.
+std::vector<int> TighteningOrder(const std::vector<Bounds>& bounds) {
+  std::vector<int> order(bounds.size());
+  std::iota(order.begin(), order.end(), 0);
+  const auto instability = [&bounds](const int i) {
+    return std::min(-bounds[i].lb(), bounds[i].ub());
+  };
+  std::stable_sort(order.begin(), order.end(), [&](const int a, const int b) {
+    return instability(a) > instability(b);
+  });
+  return order;
+}
+
+}  // namespace
+
+BoundTighteningResult TightenBounds(
+    const MPSolver& solver,
+    const std::vector<std::vector<const MPVariable*>>& layers,
+    const BoundTighteningOptions& options) {
+  CHECK_GT(options.num_threads, 0);
+  const absl::Time deadline = absl::Now() + options.time_limit;
+  BoundTighteningResult result;
+  for (const std::vector<const MPVariable*>& layer : layers) {
+    std::vector<Bounds>& layer_bounds = result.bounds.emplace_back();
+    for (const MPVariable* variable : layer) {
+      layer_bounds.emplace_back(variable->lb(), variable->ub());
+    }
+  }
+
+  MPModelProto model_proto;
+  solver.ExportModelToProto(&model_proto);
+  MPSolver::OptimizationProblemType problem_type = solver.ProblemType();
+  if (options.relax_integrality && solver.IsMIP()) {
+    for (int i = 0; i < model_proto.variable_size(); ++i) {
+      model_proto.mutable_variable(i)->set_is_integer(false);
+    }
+    problem_type = MPSolver::GLOP_LINEAR_PROGRAMMING;
+  }
+
+  WorkStealingThreadPool pool(options.num_threads);
+  std::vector<std::unique_ptr<BoundSolver>> bound_solvers(options.num_threads);
+  ParallelFor(options.num_threads, &pool, [&](const int i) {
+    bound_solvers[i] = std::make_unique<BoundSolver>(model_proto, problem_type,
+                                                     options.warm_start);
+  });
+
+  std::atomic<int64_t> num_solves = 0;
+  std::atomic<bool> time_limit_reached = false;
+  for (int layer = 0; layer < layers.size(); ++layer) {
+    std::vector<Bounds>& layer_bounds = result.bounds[layer];
+    const std::vector<int> order = TighteningOrder(layer_bounds);
+    std::atomic<int> next = 0;
+    ParallelFor(options.num_threads, &pool, [&](int) {
+      // A worker runs one task at a time, so it owns its solver.
+      BoundSolver& bound_solver = *bound_solvers[pool.CurrentWorkerIndex()];
+      for (int k = next++; k < order.size(); k = next++) {
+        if (absl::Now() >= deadline) {
+          time_limit_reached = true;
+          return;
+        }
+        const int i = order[k];
+        const int variable_index = layers[layer][i]->index();
+        Bounds bounds = layer_bounds[i];
+        if (const std::optional<double> lb =
+                bound_solver.Solve(variable_index, /*maximize=*/false,
+                                   deadline)) {
+          bounds = Intersect(
+              bounds, Bounds(*lb - options.tolerance, MPSolver::infinity()));
+        }
+        if (const std::optional<double> ub =
+                bound_solver.Solve(variable_index, /*maximize=*/true,
+                                   deadline)) {
+          bounds = Intersect(
+              bounds, Bounds(-MPSolver::infinity(), *ub + options.tolerance));
+        }
+        num_solves += 2;
+        layer_bounds[i] = bounds;
+      }
+    });
+    if (time_limit_reached) break;
+    if (layer + 1 == layers.size()) break;
+    ParallelFor(options.num_threads, &pool, [&](const int s) {
+      for (int i = 0; i < layer_bounds.size(); ++i) {
+        bound_solvers[s]->SetBounds(layers[layer][i]->index(), layer_bounds[i]);
+      }
+    });
+  }
+  result.num_solves = num_solves;
+  result.time_limit_reached = time_limit_reached;
+  return result;
+}
+
+}  // namespace tf_opt
@@ -0,0 +1,83 @@
+// Copyright 2026 The tf.opt Authors.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef TF_OPT_OPTIMIZE_MIP_BOUND_TIGHTENER_H_
+#define TF_OPT_OPTIMIZE_MIP_BOUND_TIGHTENER_H_
+
+#include <cstdint>
+#include <vector>
+
+#include "absl/time/time.h"
+#include "ortools/linear_solver/linear_solver.h"
+#include "tf_opt/bounds/bounds.h"
+
+namespace tf_opt {
+
+struct BoundTighteningOptions {
+  // The number of solver clones solving bound problems concurrently.
+  int num_threads = 1;
+
+  // If true, the bound problems are the LP relaxation of the model, solved
+  // with GLOP. Otherwise, they are solved with the problem type of the model,
+  // and the best bound of the solver is used when a solve stops early.
+  bool relax_integrality = true;
+
+  // Each solver clone starts from the state of its previous solve: the LP
+  // basis is kept by incremental solves, and the previous solution is given
+  // as a hint to MIP solvers.
+  bool warm_start = true;
+
+  // Once this much time has passed, the remaining neurons keep their bounds.
+  absl::Duration time_limit = absl::InfiniteDuration();
+
+  // Every computed bound is loosened by this much, to absorb the feasibility
+  // tolerances of the solver.
+  double tolerance = 1e-6;
+};
+
+struct BoundTighteningResult {
+  // The tightened bounds, indexed like the layers given to TightenBounds().
+  std::vector<std::vector<Bounds>> bounds;
+
+  int64_t num_solves = 0;
+
+  // True if the time limit stopped the tightening before all neurons were
+  // processed.
+  bool time_limit_reached = false;
+};
+
+// Optimization-based bound tightening (OBBT). For each neuron, a variable of
+// the model in solver (typically the pre-activation of a ReLU), solves
+//   min / max neuron  subject to the model
+// and returns the resulting bounds, intersected with the bounds of the
+// variable. The model in solver is not modified.
+//
+// The layers are processed in order, and the tightened bounds of a layer are
+// set on the variables before the next layer is processed, so that later
+// layers benefit from them. Within a layer, the solves run in parallel on
+// options.num_threads clones of the model, and the unstable neurons (whose
+// bounds contain zero in their interior) come first, most unstable first,
+// since they are the ones whose binary variables tighter bounds can remove.
+//
+// Like ComputeInequalityGap(), the clones are made by exporting the model to
+// an MPModelProto, once per thread.
+BoundTighteningResult TightenBounds(
+    const operations_research::MPSolver& solver,
+    const std::vector<std::vector<const operations_research::MPVariable*>>&
+        layers,
+    const BoundTighteningOptions& options);
+
+}  // namespace tf_opt
+
+#endif  // TF_OPT_OPTIMIZE_MIP_BOUND_TIGHTENER_H_
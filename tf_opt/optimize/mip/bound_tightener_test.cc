@@ -0,0 +1,128 @@
+// Copyright 2026 The tf.opt Authors.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "tf_opt/optimize/mip/bound_tightener.h"
+
+#include "gtest/gtest.h"
+#include "absl/time/time.h"
+#include "ortools/linear_solver/linear_expr.h"
+#include "ortools/linear_solver/linear_solver.h"
+#include "tf_opt/bounds/bounds.h"
+
+namespace tf_opt {
+namespace {
+
+using operations_research::LinearExpr;
+using operations_research::MPSolver;
+using operations_research::MPVariable;
+
+constexpr double kTolerance = 1e-5;
+
+// Creates a model of the form:
+//   x1 + x2 <= 2.5
+//   z = x1 - x2
+//   w = 2 z - 1
+//   0 <= x1 <= 3, 0 <= x2 <= 5, -10 <= z <= 10, -100 <= w <= 100
+//   x1, x2 integer
+//
+// The tightest bounds are z in [-2.5, 2.5] and w in [-6, 4] for the LP
+// relaxation, and z in [-2, 2] and w in [-5, 3] for the MIP.
+class BoundTightenerTest : public ::testing::Test {
+ public:
+  BoundTightenerTest()
+      : solver_("bound_tightener_test",
+                MPSolver::SCIP_MIXED_INTEGER_PROGRAMMING),
+        x1_(solver_.MakeIntVar(0, 3, "x1")),
+        x2_(solver_.MakeIntVar(0, 5, "x2")),
+        z_(solver_.MakeNumVar(-10, 10, "z")),
+        w_(solver_.MakeNumVar(-100, 100, "w")) {
+    solver_.MakeRowConstraint(LinearExpr(x1_) + x2_ <= 2.5);
+    solver_.MakeRowConstraint(LinearExpr(z_) == LinearExpr(x1_) - x2_);
+    solver_.MakeRowConstraint(LinearExpr(w_) == 2.0 * LinearExpr(z_) - 1.0);
+  }
+
+ protected:
+  void ExpectBoundsNear(const Bounds actual, const Bounds expected) {
+    EXPECT_NEAR(actual.lb(), expected.lb(), kTolerance);
+    EXPECT_NEAR(actual.ub(), expected.ub(), kTolerance);
+  }
+
+  MPSolver solver_;
+  const MPVariable* const x1_;
+  const MPVariable* const x2_;
+  const MPVariable* const z_;
+  const MPVariable* const w_;
+};
+
+TEST_F(BoundTightenerTest, LpRelaxation) {
+  const BoundTighteningResult result =
+      TightenBounds(solver_, {{z_}, {w_}}, BoundTighteningOptions());
+  ASSERT_EQ(result.bounds.size(), 2);
+  ASSERT_EQ(result.bounds[0].size(), 1);
+  ASSERT_EQ(result.bounds[1].size(), 1);
+  ExpectBoundsNear(result.bounds[0][0], Bounds(-2.5, 2.5));
+  ExpectBoundsNear(result.bounds[1][0], Bounds(-6.0, 4.0));
+  EXPECT_EQ(result.num_solves, 4);
+  EXPECT_FALSE(result.time_limit_reached);
+}
+
+TEST_F(BoundTightenerTest, Mip) {
+  BoundTighteningOptions options;
+  options.relax_integrality = false;
+  const BoundTighteningResult result =
+      TightenBounds(solver_, {{z_}, {w_}}, options);
+  ExpectBoundsNear(result.bounds[0][0], Bounds(-2.0, 2.0));
+  ExpectBoundsNear(result.bounds[1][0], Bounds(-5.0, 3.0));
+}
+
+TEST_F(BoundTightenerTest, DoesNotModifyModel) {
+  TightenBounds(solver_, {{z_}, {w_}}, BoundTighteningOptions());
+  EXPECT_EQ(z_->lb(), -10.0);
+  EXPECT_EQ(w_->ub(), 100.0);
+}
+
+TEST_F(BoundTightenerTest, MultipleThreads) {
+  BoundTighteningOptions options;
+  options.num_threads = 4;
+  options.relax_integrality = false;
+  const BoundTighteningResult result =
+      TightenBounds(solver_, {{z_, x1_, x2_}, {w_}}, options);
+  ExpectBoundsNear(result.bounds[0][0], Bounds(-2.0, 2.0));
+  ExpectBoundsNear(result.bounds[0][1], Bounds(0.0, 2.0));
+  ExpectBoundsNear(result.bounds[0][2], Bounds(0.0, 2.0));
+  ExpectBoundsNear(result.bounds[1][0], Bounds(-5.0, 3.0));
+  EXPECT_EQ(result.num_solves, 8);
+}
+
+TEST_F(BoundTightenerTest, NeverLoosensBounds) {
+  MPVariable* const y = solver_.MakeNumVar(-1.0, 1.0, "y");
+  solver_.MakeRowConstraint(LinearExpr(y) <= LinearExpr(x1_) + 5.0);
+  const BoundTighteningResult result =
+      TightenBounds(solver_, {{y}}, BoundTighteningOptions());
+  EXPECT_EQ(result.bounds[0][0], Bounds(-1.0, 1.0));
+}
+
+TEST_F(BoundTightenerTest, TimeLimit) {
+  BoundTighteningOptions options;
+  options.time_limit = absl::ZeroDuration();
+  const BoundTighteningResult result =
+      TightenBounds(solver_, {{z_}, {w_}}, options);
+  EXPECT_TRUE(result.time_limit_reached);
+  EXPECT_EQ(result.num_solves, 0);
+  EXPECT_EQ(result.bounds[0][0], Bounds(-10.0, 10.0));
+  EXPECT_EQ(result.bounds[1][0], Bounds(-100.0, 100.0));
+}
+
+}  // namespace
+}  // namespace tf_opt
@@ -0,0 +1,369 @@
+// Copyright 2026 The tf.opt Authors.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "tf_opt/optimize/mip/formulation_selector.h"
+
+#include <algorithm>
+#include <cstdint>
+#include <limits>
+#include <optional>
+#include <string>
+#include <vector>
+
+#include "ortools/base/logging.h"
+#include "absl/algorithm/container.h"
+#include "absl/container/flat_hash_map.h"
+#include "absl/strings/str_cat.h"
+#include "absl/strings/str_format.h"
+#include "absl/types/span.h"
+#include "ortools/linear_solver/linear_solver.h"
+#include "tf_opt/bounds/bounds.h"
+#include "tf_opt/neural_net/neural_net_graph.h"
+#include "tf_opt/neural_net/neuron/maximum_impl_type.h"
+#include "tf_opt/neural_net/neuron/relu_impl_type.h"
+#include "tf_opt/neural_net/ops/all_operations.h"
+#include "tf_opt/optimize/mip/mip_encoder.h"
+#include "tf_opt/optimize/mip/neuron_formulations.h"
+
+namespace tf_opt {
+
+using operations_research::MPSolver;
+
+namespace {
+
+constexpr ReluImplementationType kReluFormulations[] = {
+    ReluImplementationType::kBigM,
+    ReluImplementationType::kMultipleChoice,
+    ReluImplementationType::kMultipleChoiceSimplified,
+    ReluImplementationType::kIdealExponential,
+};
+
+constexpr MaximumImplementationType kMaximumFormulations[] = {
+    MaximumImplementationType::kBigM,
+    MaximumImplementationType::kExtended,
+    MaximumImplementationType::kTightenedBigM,
+    MaximumImplementationType::kOptimalBigM,
+    MaximumImplementationType::kLogarithmicBigM,
+};
+
+// The height of the triangle relaxation of a ReLU with input bounds [l, u].
+double TriangleHeight(const Bounds bounds) {
+  return -bounds.lb() * bounds.ub() / (bounds.ub() - bounds.lb());
+}
+
+// The smallest number of bits to index n elements.
+int NumBits(const int64_t n) {
+  int result = 0;
+  while ((int64_t{1} << result) < n) ++result;
+  return result;
+}
+
+// The estimate of the formulation of one maximum of the inputs with the
+// given bounds, see EncodeMaximum().
+FormulationEstimate EstimateMaximum(
+    const std::vector<Bounds>& bounds,
+    const MaximumImplementationType formulation) {
+  const int64_t n = bounds.size();
+  double max_ub = bounds[0].ub();
+  double min_lb = bounds[0].lb();
+  for (const Bounds b : bounds) {
+    max_ub = std::max(max_ub, b.ub());
+    min_lb = std::min(min_lb, b.lb());
+  }
+  // The averages over i of the big-M constants of kOptimalBigM, and of the
+  // coefficients of kTightenedBigM.
+  double mean_optimal_big_m = 0.0;
+  double mean_tightened_big_m = 0.0;
+  for (int64_t i = 0; i < n; ++i) {
+    double max_other_ub = -std::numeric_limits<double>::infinity();
+    double sum_other = 0.0;
+    for (int64_t j = 0; j < n; ++j) {
+      if (j == i) continue;
+      max_other_ub = std::max(max_other_ub, bounds[j].ub());
+      sum_other += std::max(bounds[j].ub() - bounds[i].lb(), 0.0);
+    }
+    mean_optimal_big_m += std::max(max_other_ub - bounds[i].lb(), 0.0) / n;
+    mean_tightened_big_m += sum_other / (n - 1) / n;
+  }
+  const double fraction = static_cast<double>(n - 1) / n;
+  FormulationEstimate result;
+  // y, y >= x_i, and one binary variable per input summing to one.
+  result.num_variables = 1 + n;
+  result.num_constraints = 2 * n + 1;
+  switch (formulation) {
+    case MaximumImplementationType::kBigM:
+      result.relaxation_gap = fraction * (max_ub - min_lb);
+      return result;
+    case MaximumImplementationType::kOptimalBigM:
+      result.relaxation_gap = fraction * mean_optimal_big_m;
+      return result;
+    case MaximumImplementationType::kTightenedBigM:
+      result.relaxation_gap = fraction * mean_tightened_big_m;
+      return result;
+    case MaximumImplementationType::kLogarithmicBigM: {
+      // With every bit at 1/2, half of the bits differ from those of i.
+      const int num_bits = NumBits(n);
+      result.num_variables = 1 + num_bits;
+      result.relaxation_gap =
+          std::min(1.0, num_bits / 2.0) * mean_optimal_big_m;
+      return result;
+    }
+    case MaximumImplementationType::kExtended:
+      // n copies of the n inputs, each with two bound rows, and the rows
+      // copy_kj <= copy_kk, sum_k copy_kj = x_j (instead of the big-M rows)
+      // and y = sum_k copy_kk.
+      result.num_variables += n * n;
+      result.num_constraints += 2 * n * n + n * (n - 1) + 1;
+      result.relaxation_gap = 0.0;
+      return result;
+    case MaximumImplementationType::kEpigraph:
+      break;
+  }
+  LOG(FATAL) << "Unexpected maximum formulation: " << formulation;
+}
+
+void Accumulate(const FormulationEstimate& estimate,
+                FormulationEstimate* total) {
+  total->num_variables += estimate.num_variables;
+  total->num_constraints += estimate.num_constraints;
+  total->relaxation_gap += estimate.relaxation_gap;
+}
+
+const char* KindName(const NonlinearLayer::Kind kind) {
+  return kind == NonlinearLayer::Kind::kRelu ? "relu" : "maximum";
+}
+
+const char* FormulationName(const FormulationChoice& choice) {
+  return choice.kind == NonlinearLayer::Kind::kRelu
+             ? ToString(choice.relu_formulation)
+             : ToString(choice.maximum_formulation);
+}
+
+void SetFormulation(const ReluImplementationType formulation,
+                    FormulationChoice* choice) {
+  choice->relu_formulation = formulation;
+}
+
+void SetFormulation(const MaximumImplementationType formulation,
+                    FormulationChoice* choice) {
+  choice->maximum_formulation = formulation;
+}
+
+// The exact formulations of the layer, with their estimates.
+std::vector<FormulationChoice> Options(const NonlinearLayer& layer) {
+  std::vector<FormulationChoice> result;
+  const auto add = [&result, &layer](const auto formulation) {
+    const std::optional<FormulationEstimate> estimate =
+        EstimateFormulation(layer, formulation);
+    if (!estimate.has_value()) return;
+    FormulationChoice& choice = result.emplace_back();
+    choice.name = layer.name;
+    choice.kind = layer.kind;
+    SetFormulation(formulation, &choice);
+    choice.estimate = *estimate;
+  };
+  if (layer.kind == NonlinearLayer::Kind::kRelu) {
+    for (const ReluImplementationType formulation : kReluFormulations) {
+      add(formulation);
+    }
+  } else {
+    for (const MaximumImplementationType formulation : kMaximumFormulations) {
+      add(formulation);
+    }
+  }
+  CHECK(!result.empty()) << "No exact formulation for layer: " << layer.name;
+  return result;
+}
+
+}  // namespace
+
+std::optional<FormulationEstimate> EstimateFormulation(
+    const NonlinearLayer& layer, const ReluImplementationType formulation) {
+  CHECK(layer.kind == NonlinearLayer::Kind::kRelu) << layer.name;
+  CHECK_EQ(layer.relu_input_bounds.size(), layer.relu_fan_in.size());
+  FormulationEstimate result;
+  for (int i = 0; i < layer.relu_fan_in.size(); ++i) {
+    const int fan_in = layer.relu_fan_in[i];
+    // y and z, and the rows y >= x, y <= x - l (1 - z) and y <= u z.
+    result.num_variables += 2;
+    result.num_constraints += 3;
+    switch (formulation) {
+      case ReluImplementationType::kBigM:
+      case ReluImplementationType::kMultipleChoiceSimplified:
+        break;
+      case ReluImplementationType::kMultipleChoice:
+        // x is split in two copies, instead of y >= x.
+        result.num_variables += 1;
+        break;
+      case ReluImplementationType::kIdealExponential:
+        if (fan_in > kMaxIdealExponentialTerms) return std::nullopt;
+        result.num_constraints += (int64_t{1} << fan_in) - 2;
+        continue;
+      case ReluImplementationType::kBigMRelaxation:
+        return std::nullopt;
+    }
+    if (fan_in > 1) {
+      result.relaxation_gap += TriangleHeight(layer.relu_input_bounds[i]);
+    }
+  }
+  return result;
+}
+
+std::optional<FormulationEstimate> EstimateFormulation(
+    const NonlinearLayer& layer, const MaximumImplementationType formulation) {
+  CHECK(layer.kind == NonlinearLayer::Kind::kMaximum) << layer.name;
+  if (formulation == MaximumImplementationType::kEpigraph) return std::nullopt;
+  FormulationEstimate result;
+  for (const std::vector<Bounds>& bounds : layer.maximum_input_bounds) {
+    Accumulate(EstimateMaximum(bounds, formulation), &result);
+  }
+  return result;
+}
+
+FormulationSelection SelectFormulations(absl::Span<const NonlinearLayer> layers,
+                                        const FormulationBudget& budget) {
+  std::vector<std::vector<FormulationChoice>> options;
+  options.reserve(layers.size());
+  FormulationSelection result;
+  for (const NonlinearLayer& layer : layers) {
+    options.push_back(Options(layer));
+    // The smallest formulation, and the tightest among those.
+    const FormulationChoice& smallest = *absl::c_min_element(
+        options.back(),
+        [](const FormulationChoice& a, const FormulationChoice& b) {
+          if (a.estimate.size() != b.estimate.size()) {
+            return a.estimate.size() < b.estimate.size();
+          }
+          return a.estimate.relaxation_gap < b.estimate.relaxation_gap;
+        });
+    result.choices.push_back(smallest);
+    Accumulate(smallest.estimate, &result.total);
+  }
+  result.within_budget =
+      result.total.num_variables <= budget.max_variables &&
+      result.total.num_constraints <= budget.max_constraints;
+  if (!result.within_budget) return result;
+
+  // Multiple-choice knapsack, greedily: each step takes the tighter
+  // formulation of a layer that fits with the largest reduction of the gap
+  // per unit of size. The gap of a layer decreases at each of its steps, so
+  // this ends after at most as many steps as options.
+  while (true) {
+    int best_layer = -1;
+    const FormulationChoice* best_option = nullptr;
+    double best_ratio = 0.0;
+    for (int k = 0; k < options.size(); ++k) {
+      const FormulationEstimate& current = result.choices[k].estimate;
+      for (const FormulationChoice& option : options[k]) {
+        const double gap_reduction =
+            current.relaxation_gap - option.estimate.relaxation_gap;
+        if (gap_reduction <= 0.0) continue;
+        const int64_t added_variables =
+            option.estimate.num_variables - current.num_variables;
+        const int64_t added_constraints =
+            option.estimate.num_constraints - current.num_constraints;
+        if (added_variables > budget.max_variables -
+                                  result.total.num_variables ||
+            added_constraints > budget.max_constraints -
+                                    result.total.num_constraints) {
+          continue;
+        }
+        const double ratio =
+            gap_reduction /
+            std::max<int64_t>(added_variables + added_constraints, 1);
+        if (ratio > best_ratio) {
+          best_layer = k;
+          best_option = &option;
+          best_ratio = ratio;
+        }
+      }
+    }
+    if (best_option == nullptr) break;
+    FormulationEstimate& total = result.total;
+    const FormulationEstimate& current = result.choices[best_layer].estimate;
+    total.num_variables +=
+        best_option->estimate.num_variables - current.num_variables;
+    total.num_constraints +=
+        best_option->estimate.num_constraints - current.num_constraints;
+    result.choices[best_layer] = *best_option;
+  }
+  // Summed again rather than updated, to avoid rounding errors.
+  result.total.relaxation_gap = 0.0;
+  for (const FormulationChoice& choice : result.choices) {
+    result.total.relaxation_gap += choice.estimate.relaxation_gap;
+  }
+  return result;
+}
+
+std::vector<NonlinearLayer> ProfileNonlinearLayers(
+    const NeuralNetGraph& graph,
+    const absl::flat_hash_map<std::string, BoundsTensor>& variable_bounds,
+    const absl::flat_hash_map<std::string, BoundsTensor>& operation_bounds) {
+  MPSolver solver("profile", MPSolver::GLOP_LINEAR_PROGRAMMING);
+  MipEncoder encoder(&solver, variable_bounds);
+  for (const auto& [name, bounds] : operation_bounds) {
+    encoder.SetOperationBounds(name, bounds);
+  }
+  for (int id = 0; id < graph.num_operations(); ++id) {
+    const Operation& op = graph.operation(id);
+    if (dynamic_cast<const ReluOperation*>(&op) != nullptr) {
+      encoder.SetFormulation(op.name(), ReluImplementationType::kBigM);
+    } else if (dynamic_cast<const MaxpoolOperation*>(&op) != nullptr ||
+               dynamic_cast<const ReduceMaxOperation*>(&op) != nullptr ||
+               dynamic_cast<const ReduceMinOperation*>(&op) != nullptr) {
+      encoder.SetFormulation(op.name(),
+                             MaximumImplementationType::kLogarithmicBigM);
+    }
+  }
+  graph.Evaluate(&encoder);
+  return encoder.nonlinear_layers();
+}
+
+void ApplyFormulations(const FormulationSelection& selection,
+                       MipEncoder* encoder) {
+  CHECK(encoder != nullptr);
+  for (const FormulationChoice& choice : selection.choices) {
+    if (choice.kind == NonlinearLayer::Kind::kRelu) {
+      encoder->SetFormulation(choice.name, choice.relu_formulation);
+    } else {
+      encoder->SetFormulation(choice.name, choice.maximum_formulation);
+    }
+  }
+}
+
+std::string FormulationReport(const FormulationSelection& selection) {
+  constexpr char kRow[] = "%-24s %-8s %-28s %12s %12s %14s\n";
+  std::string result = absl::StrFormat(kRow, "layer", "kind", "formulation",
+                                       "variables", "constraints",
+                                       "relaxation_gap");
+  for (const FormulationChoice& choice : selection.choices) {
+    absl::StrAppendFormat(&result, kRow, choice.name, KindName(choice.kind),
+                          FormulationName(choice),
+                          absl::StrCat(choice.estimate.num_variables),
+                          absl::StrCat(choice.estimate.num_constraints),
+                          absl::StrFormat("%.6g",
+                                          choice.estimate.relaxation_gap));
+  }
+  absl::StrAppendFormat(&result, kRow, "total", "", "",
+                        absl::StrCat(selection.total.num_variables),
+                        absl::StrCat(selection.total.num_constraints),
+                        absl::StrFormat("%.6g",
+                                        selection.total.relaxation_gap));
+  if (!selection.within_budget) {
+    result += "The smallest formulations do not fit in the budget.\n";
+  }
+  return result;
+}
+
+}  // namespace tf_opt
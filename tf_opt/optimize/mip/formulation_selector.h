@@ -0,0 +1,125 @@
+// Copyright 2026 The tf.opt Authors.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef TF_OPT_OPTIMIZE_MIP_FORMULATION_SELECTOR_H_
+#define TF_OPT_OPTIMIZE_MIP_FORMULATION_SELECTOR_H_
+
+#include <cstdint>
+#include <limits>
+#include <optional>
+#include <string>
+#include <vector>
+
+#include "absl/container/flat_hash_map.h"
+#include "absl/types/span.h"
+#include "tf_opt/bounds/bounds.h"
+#include "tf_opt/neural_net/neural_net_graph.h"
+#include "tf_opt/neural_net/neuron/maximum_impl_type.h"
+#include "tf_opt/neural_net/neuron/relu_impl_type.h"
+#include "tf_opt/optimize/mip/mip_encoder.h"
+
+namespace tf_opt {
+
+// The size of the formulation of a layer, and an estimate of the weakness of
+// its LP relaxation.
+struct FormulationEstimate {
+  int64_t num_variables = 0;
+  int64_t num_constraints = 0;
+
+  // The sum over the elements of the layer of an estimate of how far above
+  // the true value the LP relaxation lets the output go, at the worst point
+  // of the box of the inputs. Zero for the ideal formulations. This is a
+  // cheap proxy from the bounds and the fan-in, to rank the formulations of a
+  // layer, not a bound on the LP gap:
+  //  - For a ReLU with input bounds [l, u] and fan-in n, the big-M
+  //    formulations are ideal if n = 1, and otherwise let y reach the top of
+  //    the triangle, -l u / (u - l), at some vertex of the box of the inputs.
+  //  - For a maximum of n inputs with bounds [l_i, u_i], the big-M
+  //    formulations let y reach (n - 1) / n times their big-M constant above
+  //    the maximum when every z_i is 1 / n, averaged over i for the
+  //    formulations with one constant per input.
+  double relaxation_gap = 0.0;
+
+  int64_t size() const { return num_variables + num_constraints; }
+};
+
+// The estimates of the formulations of the layer, for the unstable neurons
+// and undominated inputs recorded by MipEncoder. Returns std::nullopt for the
+// formulations that are not exact (kBigMRelaxation and kEpigraph), and for
+// kIdealExponential when a fan-in is above kMaxIdealExponentialTerms.
+std::optional<FormulationEstimate> EstimateFormulation(
+    const NonlinearLayer& layer, ReluImplementationType formulation);
+std::optional<FormulationEstimate> EstimateFormulation(
+    const NonlinearLayer& layer, MaximumImplementationType formulation);
+
+// A limit on the variables and constraints added by the formulations of the
+// nonlinear layers. The linear parts of the model are not counted.
+struct FormulationBudget {
+  int64_t max_variables = std::numeric_limits<int64_t>::max();
+  int64_t max_constraints = std::numeric_limits<int64_t>::max();
+};
+
+// The formulation chosen for one layer.
+struct FormulationChoice {
+  std::string name;
+  NonlinearLayer::Kind kind = NonlinearLayer::Kind::kRelu;
+
+  // The one matching kind is meaningful.
+  ReluImplementationType relu_formulation = kDefaultRelu;
+  MaximumImplementationType maximum_formulation = kDefaultMaximum;
+
+  FormulationEstimate estimate;
+};
+
+struct FormulationSelection {
+  std::vector<FormulationChoice> choices;
+
+  // The sums of the estimates of the choices.
+  FormulationEstimate total;
+
+  // False if even the smallest formulations do not fit in the budget, in
+  // which case those are chosen.
+  bool within_budget = true;
+};
+
+// Chooses the formulation of each layer that makes the model the tightest,
+// by the sum of the relaxation gaps, within the budget. The layers start
+// with their smallest exact formulation, and are then upgraded greedily, by
+// decreasing reduction of the gap per added variable and constraint, while
+// the budget allows. Layers without unstable elements keep the smallest
+// formulation, which adds nothing.
+FormulationSelection SelectFormulations(absl::Span<const NonlinearLayer> layers,
+                                        const FormulationBudget& budget);
+
+// The nonlinear layers of the network, with the bounds that MipEncoder would
+// use: encodes the network with the smallest formulations in a scratch LP.
+// The operation bounds are as in MipEncoder::SetOperationBounds().
+std::vector<NonlinearLayer> ProfileNonlinearLayers(
+    const NeuralNetGraph& graph,
+    const absl::flat_hash_map<std::string, BoundsTensor>& variable_bounds,
+    const absl::flat_hash_map<std::string, BoundsTensor>& operation_bounds =
+        {});
+
+// Sets the formulations of the selection in encoder, see
+// MipEncoder::SetFormulation().
+void ApplyFormulations(const FormulationSelection& selection,
+                       MipEncoder* encoder);
+
+// A table of the choices, one layer per line, with their estimates and the
+// totals, for logging.
+std::string FormulationReport(const FormulationSelection& selection);
+
+}  // namespace tf_opt
+
+#endif  // TF_OPT_OPTIMIZE_MIP_FORMULATION_SELECTOR_H_
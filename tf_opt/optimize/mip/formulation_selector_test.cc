@@ -0,0 +1,228 @@
+// Copyright 2026 The tf.opt Authors.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "tf_opt/optimize/mip/formulation_selector.h"
+
+#include <cstdint>
+#include <limits>
+#include <memory>
+#include <optional>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "gtest/gtest.h"
+#include "absl/container/flat_hash_map.h"
+#include "absl/status/statusor.h"
+#include "ortools/linear_solver/linear_solver.h"
+#include "tf_opt/bounds/bounds.h"
+#include "tf_opt/neural_net/neural_net_graph.h"
+#include "tf_opt/neural_net/neuron/maximum_impl_type.h"
+#include "tf_opt/neural_net/neuron/relu_impl_type.h"
+#include "tf_opt/neural_net/operation_testing.h"
+#include "tf_opt/neural_net/ops/all_operations.h"
+#include "tf_opt/optimize/mip/mip_encoder.h"
+#include "tf_opt/tensor/shape.h"
+#include "tf_opt/tensor/tensor.h"
+#include "tf_opt/tensor/tensor_testing.h"
+
+namespace tf_opt {
+namespace {
+
+using operations_research::MPSolver;
+
+constexpr double kTolerance = 1e-9;
+
+NonlinearLayer ReluLayer(const std::string& name, std::vector<Bounds> bounds,
+                         std::vector<int> fan_in) {
+  NonlinearLayer result;
+  result.name = name;
+  result.kind = NonlinearLayer::Kind::kRelu;
+  result.relu_input_bounds = std::move(bounds);
+  result.relu_fan_in = std::move(fan_in);
+  return result;
+}
+
+NonlinearLayer MaximumLayer(const std::string& name,
+                            std::vector<std::vector<Bounds>> bounds) {
+  NonlinearLayer result;
+  result.name = name;
+  result.kind = NonlinearLayer::Kind::kMaximum;
+  result.maximum_input_bounds = std::move(bounds);
+  return result;
+}
+
+TEST(EstimateFormulationTest, Relu) {
+  const NonlinearLayer layer =
+      ReluLayer("relu", {Bounds(-1.0, 2.0), Bounds(-2.0, 2.0)}, {3, 1});
+  const std::optional<FormulationEstimate> big_m =
+      EstimateFormulation(layer, ReluImplementationType::kBigM);
+  ASSERT_TRUE(big_m.has_value());
+  EXPECT_EQ(big_m->num_variables, 4);
+  EXPECT_EQ(big_m->num_constraints, 6);
+  // Only the neuron with more than one input term has a gap.
+  EXPECT_NEAR(big_m->relaxation_gap, 2.0 / 3.0, kTolerance);
+
+  const std::optional<FormulationEstimate> multiple_choice =
+      EstimateFormulation(layer, ReluImplementationType::kMultipleChoice);
+  ASSERT_TRUE(multiple_choice.has_value());
+  EXPECT_EQ(multiple_choice->num_variables, 6);
+  EXPECT_EQ(multiple_choice->num_constraints, 6);
+  EXPECT_NEAR(multiple_choice->relaxation_gap, 2.0 / 3.0, kTolerance);
+
+  const std::optional<FormulationEstimate> ideal =
+      EstimateFormulation(layer, ReluImplementationType::kIdealExponential);
+  ASSERT_TRUE(ideal.has_value());
+  EXPECT_EQ(ideal->num_variables, 4);
+  EXPECT_EQ(ideal->num_constraints, 6 + (8 - 2));
+  EXPECT_EQ(ideal->relaxation_gap, 0.0);
+
+  EXPECT_FALSE(
+      EstimateFormulation(layer, ReluImplementationType::kBigMRelaxation)
+          .has_value());
+  EXPECT_FALSE(EstimateFormulation(
+                   ReluLayer("wide", {Bounds(-1.0, 1.0)},
+                             {kMaxIdealExponentialTerms + 1}),
+                   ReluImplementationType::kIdealExponential)
+                   .has_value());
+}
+
+TEST(EstimateFormulationTest, Maximum) {
+  const NonlinearLayer layer =
+      MaximumLayer("max", {{Bounds(0.0, 1.0), Bounds(-1.0, 2.0)}});
+  const std::optional<FormulationEstimate> big_m =
+      EstimateFormulation(layer, MaximumImplementationType::kBigM);
+  ASSERT_TRUE(big_m.has_value());
+  EXPECT_EQ(big_m->num_variables, 3);
+  EXPECT_EQ(big_m->num_constraints, 5);
+  EXPECT_NEAR(big_m->relaxation_gap, 0.5 * 3.0, kTolerance);
+
+  // The big-M constants are 2 - 0 and 1 - (-1).
+  const std::optional<FormulationEstimate> optimal =
+      EstimateFormulation(layer, MaximumImplementationType::kOptimalBigM);
+  ASSERT_TRUE(optimal.has_value());
+  EXPECT_NEAR(optimal->relaxation_gap, 0.5 * 2.0, kTolerance);
+
+  const std::optional<FormulationEstimate> logarithmic =
+      EstimateFormulation(layer, MaximumImplementationType::kLogarithmicBigM);
+  ASSERT_TRUE(logarithmic.has_value());
+  EXPECT_EQ(logarithmic->num_variables, 2);
+  EXPECT_EQ(logarithmic->num_constraints, 5);
+
+  const std::optional<FormulationEstimate> extended =
+      EstimateFormulation(layer, MaximumImplementationType::kExtended);
+  ASSERT_TRUE(extended.has_value());
+  EXPECT_EQ(extended->num_variables, 3 + 4);
+  EXPECT_EQ(extended->num_constraints, 2 + 1 + 8 + 2 + 2 + 1);
+  EXPECT_EQ(extended->relaxation_gap, 0.0);
+
+  EXPECT_FALSE(EstimateFormulation(layer, MaximumImplementationType::kEpigraph)
+                   .has_value());
+}
+
+class SelectFormulationsTest : public ::testing::Test {
+ protected:
+  // Two layers of two neurons, where the ideal formulation of the first
+  // removes a larger gap with fewer rows than that of the second.
+  const std::vector<NonlinearLayer> layers_ = {
+      ReluLayer("relu1", {Bounds(-2.0, 2.0), Bounds(-2.0, 2.0)}, {2, 2}),
+      ReluLayer("relu2", {Bounds(-1.0, 1.0), Bounds(-1.0, 1.0)}, {3, 3})};
+};
+
+TEST_F(SelectFormulationsTest, UnlimitedBudgetIsIdeal) {
+  const FormulationSelection selection =
+      SelectFormulations(layers_, FormulationBudget());
+  EXPECT_TRUE(selection.within_budget);
+  ASSERT_EQ(selection.choices.size(), 2);
+  for (const FormulationChoice& choice : selection.choices) {
+    EXPECT_EQ(choice.relu_formulation,
+              ReluImplementationType::kIdealExponential);
+  }
+  EXPECT_EQ(selection.total.num_variables, 8);
+  EXPECT_EQ(selection.total.num_constraints, 12 + 2 * 2 + 2 * 6);
+  EXPECT_EQ(selection.total.relaxation_gap, 0.0);
+}
+
+TEST_F(SelectFormulationsTest, BudgetGoesToLargestGapReduction) {
+  FormulationBudget budget;
+  budget.max_constraints = 12 + 2 * 2;
+  const FormulationSelection selection = SelectFormulations(layers_, budget);
+  EXPECT_TRUE(selection.within_budget);
+  ASSERT_EQ(selection.choices.size(), 2);
+  EXPECT_EQ(selection.choices[0].relu_formulation,
+            ReluImplementationType::kIdealExponential);
+  EXPECT_EQ(selection.choices[1].relu_formulation,
+            ReluImplementationType::kBigM);
+  EXPECT_EQ(selection.total.num_constraints, 16);
+  EXPECT_NEAR(selection.total.relaxation_gap, 2 * 0.5, kTolerance);
+}
+
+TEST_F(SelectFormulationsTest, SmallestWhenOverBudget) {
+  FormulationBudget budget;
+  budget.max_variables = 7;
+  const FormulationSelection selection = SelectFormulations(layers_, budget);
+  EXPECT_FALSE(selection.within_budget);
+  for (const FormulationChoice& choice : selection.choices) {
+    EXPECT_EQ(choice.relu_formulation, ReluImplementationType::kBigM);
+  }
+  EXPECT_NE(FormulationReport(selection).find("do not fit"),
+            std::string::npos);
+}
+
+TEST(FormulationSelectorTest, EstimatesMatchEncoding) {
+  NeuralNetGraph graph;
+  const int x = AddToGraph(VariableOperation::Create("x", Shape({1, 3})), {},
+                           &graph);
+  const int w = AddToGraph(
+      ConstantOperation::Create("w", MakeWeights(Shape({3, 4}), 1)), {},
+      &graph);
+  const int matmul = AddToGraph(
+      MatmulOperation::Create("matmul", Shape({1, 3}), Shape({3, 4})),
+      {x, w}, &graph);
+  const int relu = AddToGraph(
+      ReluOperation::Create("relu", Shape({1, 4})), {matmul}, &graph);
+  AddToGraph(ReduceMaxOperation::Create("max", Shape({1, 4}), {1}), {relu},
+             &graph);
+  const absl::flat_hash_map<std::string, BoundsTensor> box = {
+      {"x", BoundsTensor(Shape({1, 3}), Bounds(-1.0, 1.0))}};
+  const std::vector<NonlinearLayer> layers =
+      ProfileNonlinearLayers(graph, box);
+  ASSERT_EQ(layers.size(), 2);
+  EXPECT_EQ(layers[0].name, "relu");
+  EXPECT_EQ(layers[1].name, "max");
+  EXPECT_FALSE(layers[0].relu_fan_in.empty());
+  EXPECT_EQ(layers[1].maximum_input_bounds.size(), 1);
+
+  for (const int64_t max_constraints :
+       {int64_t{0}, int64_t{40}, std::numeric_limits<int64_t>::max()}) {
+    FormulationBudget budget;
+    budget.max_constraints = max_constraints;
+    const FormulationSelection selection = SelectFormulations(layers, budget);
+    EXPECT_FALSE(FormulationReport(selection).empty());
+    MPSolver solver("formulation_selector_test",
+                    MPSolver::SCIP_MIXED_INTEGER_PROGRAMMING);
+    MipEncoder encoder(&solver, box);
+    ApplyFormulations(selection, &encoder);
+    graph.Evaluate(&encoder);
+    // The only other variables are those of x.
+    EXPECT_EQ(solver.NumVariables(), 3 + selection.total.num_variables);
+    EXPECT_EQ(solver.NumConstraints(), selection.total.num_constraints);
+    if (selection.within_budget) {
+      EXPECT_LE(selection.total.num_constraints, max_constraints);
+    }
+  }
+}
+
+}  // namespace
+}  // namespace tf_opt
@@ -0,0 +1,62 @@
+// Copyright 2026 The tf.opt Authors.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "tf_opt/optimize/mip/ideal_relu_cuts.h"
+
+#include <limits>
+#include <optional>
+#include <utility>
+#include <vector>
+
+#include "ortools/base/logging.h"
+#include "absl/strings/str_cat.h"
+#include "absl/types/span.h"
+#include "ortools/linear_solver/linear_solver.h"
+#include "tf_opt/optimize/mip/neuron_formulations.h"
+#include "tf_opt/optimize/mip/sparse_linear_expr.h"
+
+namespace tf_opt {
+
+using operations_research::MPSolver;
+
+IdealReluCutResult SolveWithIdealReluCuts(absl::Span<const BigMRelu> neurons,
+                                          const IdealReluCutOptions& options,
+                                          MPSolver* solver) {
+  CHECK(solver != nullptr);
+  CHECK_GE(options.max_rounds, 0);
+  IdealReluCutResult result;
+  while (true) {
+    result.status = solver->Solve();
+    if (result.status != MPSolver::OPTIMAL &&
+        result.status != MPSolver::FEASIBLE) {
+      return result;
+    }
+    if (result.num_rounds == options.max_rounds) return result;
+    // The cuts are separated from the same solution before any is added.
+    std::vector<IdealReluCut> cuts;
+    for (const BigMRelu& neuron : neurons) {
+      std::optional<IdealReluCut> cut =
+          SeparateIdealReluCut(neuron, options.tolerance);
+      if (cut.has_value()) cuts.push_back(*std::move(cut));
+    }
+    if (cuts.empty()) return result;
+    for (const IdealReluCut& cut : cuts) {
+      AddRow(-std::numeric_limits<double>::infinity(), cut.lhs, 0.0, solver,
+             absl::StrCat("ideal_relu_cut_", result.num_cuts++));
+    }
+    ++result.num_rounds;
+  }
+}
+
+}  // namespace tf_opt
@@ -0,0 +1,70 @@
+// Copyright 2026 The tf.opt Authors.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef TF_OPT_OPTIMIZE_MIP_IDEAL_RELU_CUTS_H_
+#define TF_OPT_OPTIMIZE_MIP_IDEAL_RELU_CUTS_H_
+
+#include "absl/types/span.h"
+#include "ortools/linear_solver/linear_solver.h"
+#include "tf_opt/optimize/mip/neuron_formulations.h"
+
+namespace tf_opt {
+
+struct IdealReluCutOptions {
+  // The largest number of rounds of cuts. Each round solves the model, and
+  // adds at most one cut per neuron.
+  int max_rounds = 10;
+
+  // Only the inequalities violated by more than this are added.
+  double tolerance = 1e-6;
+};
+
+struct IdealReluCutResult {
+  // The status of the last solve.
+  operations_research::MPSolver::ResultStatus status =
+      operations_research::MPSolver::NOT_SOLVED;
+
+  // The number of rounds that added cuts, and the total number of cuts.
+  int num_rounds = 0;
+  int num_cuts = 0;
+};
+
+// Solves the model in solver, tightened by the inequalities of the ideal
+// formulation of the big-M ReLUs "neurons" (see kIdealExponential in
+// EncodeRelu()) that it violates, instead of adding the 2^n inequalities of
+// each neuron upfront. The model is solved, the most violated inequality of
+// each neuron is added (see SeparateIdealReluCut()), and so on until no
+// inequality is violated or after options.max_rounds rounds. The solution of
+// the solver is that of the last solve, with all the cuts.
+//
+// This is meant for LP relaxations: the cuts are added as rows, so with a
+// MIP solver, each round solves the MIP to optimality. With GLOP, the next
+// round starts from the previous basis when incrementality is on, which is
+// the default.
+//
+// Example use, for the LP bound of a network with the ideal formulation:
+//   MPSolver solver("lp", MPSolver::GLOP_LINEAR_PROGRAMMING);
+//   MipEncoder encoder(&solver, variable_bounds);
+//   encoder.set_lazy_ideal_relus(true);
+//   std::vector<MipTensor> values = graph.Evaluate(&encoder);
+//   ... set the objective ...
+//   IdealReluCutResult result = SolveWithIdealReluCuts(
+//       encoder.lazy_ideal_relus(), IdealReluCutOptions(), &solver);
+IdealReluCutResult SolveWithIdealReluCuts(
+    absl::Span<const BigMRelu> neurons, const IdealReluCutOptions& options,
+    operations_research::MPSolver* solver);
+
+}  // namespace tf_opt
+
+#endif  // TF_OPT_OPTIMIZE_MIP_IDEAL_RELU_CUTS_H_
@@ -0,0 +1,158 @@
+// Copyright 2026 The tf.opt Authors.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "tf_opt/optimize/mip/ideal_relu_cuts.h"
+
+#include <memory>
+#include <optional>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "gtest/gtest.h"
+#include "absl/status/statusor.h"
+#include "ortools/base/logging.h"
+#include "ortools/linear_solver/linear_solver.h"
+#include "tf_opt/bounds/bounds.h"
+#include "tf_opt/neural_net/neural_net_graph.h"
+#include "tf_opt/neural_net/neuron/relu_impl_type.h"
+#include "tf_opt/neural_net/operation_testing.h"
+#include "tf_opt/neural_net/ops/all_operations.h"
+#include "tf_opt/optimize/mip/mip_encoder.h"
+#include "tf_opt/optimize/mip/neuron_formulations.h"
+#include "tf_opt/optimize/mip/sparse_linear_expr.h"
+#include "tf_opt/tensor/shape.h"
+#include "tf_opt/tensor/tensor.h"
+#include "tf_opt/tensor/tensor_testing.h"
+
+namespace tf_opt {
+namespace {
+
+using operations_research::MPSolver;
+
+constexpr double kTolerance = 1e-6;
+
+void Maximize(const SparseLinearExpr& expr, MPSolver* solver) {
+  SparseLinearExpr canonical = expr;
+  canonical.Canonicalize();
+  solver->MutableObjective()->Clear();
+  for (const auto& [variable, coefficient] : canonical.terms()) {
+    solver->MutableObjective()->SetCoefficient(variable, coefficient);
+  }
+  solver->MutableObjective()->SetMaximization();
+}
+
+// y = relu(x1 + x2) on [-1, 1]^2, with x1 = 1 and x2 = -1. The big-M
+// relaxation allows y = 1 with z = 1/2, and the ideal formulation only y = 0.
+class SingleReluTest : public ::testing::Test {
+ public:
+  SingleReluTest() : solver_("ideal_relu_cuts_test",
+                             MPSolver::GLOP_LINEAR_PROGRAMMING) {
+    const SparseLinearExpr x1(solver_.MakeNumVar(-1.0, 1.0, "x1"));
+    const SparseLinearExpr x2(solver_.MakeNumVar(-1.0, 1.0, "x2"));
+    AddRow(1.0, x1, 1.0, &solver_);
+    AddRow(-1.0, x2, -1.0, &solver_);
+    neuron_ = EncodeBigMRelu(x1 + x2, Bounds(-2.0, 2.0), /*relax=*/true, "y",
+                             &solver_);
+    Maximize(neuron_.y, &solver_);
+  }
+
+ protected:
+  MPSolver solver_;
+  BigMRelu neuron_;
+};
+
+TEST_F(SingleReluTest, SeparatesMostViolatedCut) {
+  ASSERT_EQ(solver_.Solve(), MPSolver::OPTIMAL);
+  ASSERT_NEAR(neuron_.y.SolutionValue(), 1.0, kTolerance);
+  const std::optional<IdealReluCut> cut =
+      SeparateIdealReluCut(neuron_, kTolerance);
+  ASSERT_TRUE(cut.has_value());
+  EXPECT_NEAR(cut->violation, 1.0, kTolerance);
+  EXPECT_NEAR(cut->lhs.SolutionValue(), cut->violation, kTolerance);
+}
+
+TEST_F(SingleReluTest, SolveWithCuts) {
+  const IdealReluCutResult result =
+      SolveWithIdealReluCuts({neuron_}, IdealReluCutOptions(), &solver_);
+  EXPECT_EQ(result.status, MPSolver::OPTIMAL);
+  EXPECT_EQ(result.num_rounds, 1);
+  EXPECT_EQ(result.num_cuts, 1);
+  EXPECT_NEAR(neuron_.y.SolutionValue(), 0.0, kTolerance);
+  EXPECT_FALSE(SeparateIdealReluCut(neuron_, kTolerance).has_value());
+}
+
+TEST_F(SingleReluTest, NoRounds) {
+  IdealReluCutOptions options;
+  options.max_rounds = 0;
+  const IdealReluCutResult result =
+      SolveWithIdealReluCuts({neuron_}, options, &solver_);
+  EXPECT_EQ(result.status, MPSolver::OPTIMAL);
+  EXPECT_EQ(result.num_rounds, 0);
+  EXPECT_EQ(result.num_cuts, 0);
+  EXPECT_NEAR(neuron_.y.SolutionValue(), 1.0, kTolerance);
+}
+
+// The LP bound on the output of a network with one hidden layer of ReLUs with
+// the given formulation, with lazy cuts if "lazy".
+double LpBound(const ReluImplementationType formulation, const bool lazy) {
+  NeuralNetGraph graph;
+  const int x = AddToGraph(VariableOperation::Create("x", Shape({1, 3})), {},
+                           &graph);
+  const int w1 = AddToGraph(
+      ConstantOperation::Create("w1", MakeWeights(Shape({3, 4}), 1)), {},
+      &graph);
+  const int matmul1 = AddToGraph(
+      MatmulOperation::Create("matmul1", Shape({1, 3}), Shape({3, 4})),
+      {x, w1}, &graph);
+  const int relu = AddToGraph(
+      ReluOperation::Create("relu", Shape({1, 4}), formulation), {matmul1},
+      &graph);
+  const int w2 = AddToGraph(
+      ConstantOperation::Create("w2", MakeWeights(Shape({4, 1}), 2)), {},
+      &graph);
+  const int output = AddToGraph(
+      MatmulOperation::Create("output", Shape({1, 4}), Shape({4, 1})),
+      {relu, w2}, &graph);
+  MPSolver solver("ideal_relu_cuts_test", MPSolver::GLOP_LINEAR_PROGRAMMING);
+  MipEncoder encoder(&solver,
+                     {{"x", BoundsTensor(Shape({1, 3}), Bounds(-1.0, 1.0))}});
+  encoder.set_lazy_ideal_relus(lazy);
+  const std::vector<MipTensor> values = graph.Evaluate(&encoder);
+  Maximize(values[output].expressions.flat_value(0), &solver);
+  if (!lazy) {
+    CHECK_EQ(solver.Solve(), MPSolver::OPTIMAL);
+    return solver.Objective().Value();
+  }
+  IdealReluCutOptions options;
+  options.max_rounds = 100;
+  const IdealReluCutResult result =
+      SolveWithIdealReluCuts(encoder.lazy_ideal_relus(), options, &solver);
+  CHECK_EQ(result.status, MPSolver::OPTIMAL);
+  CHECK_LT(result.num_rounds, options.max_rounds);
+  return solver.Objective().Value();
+}
+
+TEST(SolveWithIdealReluCutsTest, MatchesExponentialFormulation) {
+  const double big_m = LpBound(ReluImplementationType::kBigM, /*lazy=*/false);
+  const double ideal = LpBound(ReluImplementationType::kIdealExponential,
+                               /*lazy=*/false);
+  const double lazy = LpBound(ReluImplementationType::kIdealExponential,
+                              /*lazy=*/true);
+  EXPECT_LT(ideal, big_m - kTolerance);
+  EXPECT_NEAR(lazy, ideal, kTolerance);
+}
+
+}  // namespace
+}  // namespace tf_opt
@@ -14,19 +14,37 @@
 
 #include "tf_opt/optimize/mip/inequality_checker.h"
 
+#include <algorithm>
+#include <atomic>
+#include <memory>
+#include <string>
+#include <vector>
+
 #include "ortools/base/logging.h"
+#include "absl/types/span.h"
 #include "ortools/linear_solver/linear_expr.h"
 #include "ortools/linear_solver/linear_solver.h"
 #include "ortools/linear_solver/linear_solver.pb.h"
+#include "tf_opt/util/work_stealing_thread_pool.h"
 
 namespace tf_opt {
 
 using operations_research::LinearExpr;
 using operations_research::LinearRange;
 using operations_research::MPSolver;
+using operations_research::MPVariable;
 
-double ComputeInequalityGap(const MPSolver& solver,
-                            const LinearRange inequality) {
+InequalityChecker::InequalityChecker(const MPSolver& solver)
+    : solver_copy_("inequality_gap_solver", solver.ProblemType()) {
+  // Copy given model via proto.
+  operations_research::MPModelProto model_proto;
+  solver.ExportModelToProto(&model_proto);
+  std::string error_msg;
+  const auto status = solver_copy_.LoadModelFromProto(model_proto, &error_msg);
+  CHECK_EQ(status, operations_research::MPSOLVER_MODEL_IS_VALID) << error_msg;
+}
+
+double InequalityChecker::ComputeGap(const LinearRange& inequality) {
   CHECK(inequality.lower_bound() != -MPSolver::infinity() ||
         inequality.upper_bound() != +MPSolver::infinity());
   CHECK(inequality.lower_bound() == -MPSolver::infinity() ||
@@ -35,34 +53,52 @@ double ComputeInequalityGap(const MPSolver& solver,
   const bool less_or_equal =
       (inequality.upper_bound() != +MPSolver::infinity());
 
-  // Copy given model via proto.
-  MPSolver solver_copy("inequality_gap_solver", solver.ProblemType());
-  operations_research::MPModelProto model_proto;
-  solver.ExportModelToProto(&model_proto);
-  std::string error_msg;
-  const auto status = solver_copy.LoadModelFromProto(model_proto, &error_msg);
-  CHECK_EQ(status, operations_research::MPSOLVER_MODEL_IS_VALID) << error_msg;
-
-  const LinearExpr inequality_expr = inequality.linear_expr();
-
   // Map variables into copied variables.
   LinearExpr inequality_copy(inequality.linear_expr().offset());
   for (const auto& term : inequality.linear_expr().terms()) {
     inequality_copy +=
-        term.second * LinearExpr(solver_copy.variables()[term.first->index()]);
+        term.second * LinearExpr(solver_copy_.variables()[term.first->index()]);
   }
 
-  solver_copy.MutableObjective()->OptimizeLinearExpr(inequality_copy,
-                                                     less_or_equal);
-  const MPSolver::ResultStatus solver_status = solver_copy.Solve();
+  // Only the objective changes between checks, so the solver can start from
+  // its previous basis.
+  solver_copy_.MutableObjective()->OptimizeLinearExpr(inequality_copy,
+                                                      less_or_equal);
+  if (!hint_.empty()) {
+    solver_copy_.SetHint(hint_);
+  }
+  const MPSolver::ResultStatus solver_status = solver_copy_.Solve();
 
   CHECK_EQ(solver_status, MPSolver::ResultStatus::OPTIMAL);
 
+  if (solver_copy_.IsMIP()) {
+    hint_.clear();
+    for (const MPVariable* variable : solver_copy_.variables()) {
+      hint_.emplace_back(variable, variable->solution_value());
+    }
+  }
+
   if (less_or_equal) {
-    return inequality.upper_bound() - solver_copy.Objective().Value();
+    return inequality.upper_bound() - solver_copy_.Objective().Value();
   } else {
-    return solver_copy.Objective().Value() - inequality.lower_bound();
+    return solver_copy_.Objective().Value() - inequality.lower_bound();
+  }
+}
+
+std::vector<double> InequalityChecker::ComputeGaps(
+    absl::Span<const LinearRange> inequalities) {
+  std::vector<double> gaps;
+  gaps.reserve(inequalities.size());
+  for (const LinearRange& inequality : inequalities) {
+    gaps.push_back(ComputeGap(inequality));
   }
+  return gaps;
+}
+
+double ComputeInequalityGap(const MPSolver& solver,
+                            const LinearRange inequality) {
+  InequalityChecker checker(solver);
+  return checker.ComputeGap(inequality);
 }
 
 bool CheckValidInequality(const operations_research::MPSolver& solver,
@@ -70,4 +106,51 @@ bool CheckValidInequality(const operations_research::MPSolver& solver,
   return ComputeInequalityGap(solver, inequality) >= 0.0;
 }
 
+CheckValidInequalitiesResult CheckValidInequalities(
+    const MPSolver& solver, absl::Span<const LinearRange> inequalities,
+    const CheckValidInequalitiesOptions& options) {
+  CHECK_GT(options.num_threads, 0);
+  const int num_inequalities = inequalities.size();
+  const int num_threads = std::min(options.num_threads, num_inequalities);
+  CheckValidInequalitiesResult result;
+  result.gaps.resize(num_inequalities);
+  if (num_inequalities == 0) return result;
+
+  WorkStealingThreadPool pool(num_threads);
+  std::vector<std::unique_ptr<InequalityChecker>> checkers(num_threads);
+  ParallelFor(num_threads, &pool, [&](const int i) {
+    checkers[i] = std::make_unique<InequalityChecker>(solver);
+  });
+
+  // Inequalities are claimed in increasing order, and none is claimed after
+  // first_invalid. Hence, when all tasks are done, every inequality before
+  // first_invalid has been checked, and first_invalid is the first invalid
+  // inequality whatever the scheduling.
+  std::atomic<int> next = 0;
+  std::atomic<int> first_invalid = num_inequalities;
+  ParallelFor(num_threads, &pool, [&](int) {
+    // A worker runs one task at a time, so it owns its checker.
+    InequalityChecker& checker = *checkers[pool.CurrentWorkerIndex()];
+    for (int i = next++; i < num_inequalities; i = next++) {
+      if (options.stop_at_first_invalid && i > first_invalid) return;
+      const double gap = checker.ComputeGap(inequalities[i]);
+      result.gaps[i] = gap;
+      if (gap < 0.0) {
+        int current = first_invalid;
+        while (i < current &&
+               !first_invalid.compare_exchange_weak(current, i)) {
+        }
+      }
+    }
+  });
+
+  if (first_invalid < num_inequalities) {
+    result.first_invalid = first_invalid;
+    if (options.stop_at_first_invalid) {
+      result.gaps.resize(result.first_invalid + 1);
+    }
+  }
+  return result;
+}
+
 }  // namespace tf_opt
@@ -15,15 +15,61 @@
 #ifndef TF_OPT_OPTIMIZE_MIP_INEQUALITY_CHECKER_H_
 #define TF_OPT_OPTIMIZE_MIP_INEQUALITY_CHECKER_H_
 
+#include <utility>
+#include <vector>
+
+#include "absl/types/span.h"
 #include "ortools/linear_solver/linear_expr.h"
 #include "ortools/linear_solver/linear_solver.h"
 
 namespace tf_opt {
 
+// Checks many inequalities against the model of a solver. The model is copied
+// once, at construction, and each check only replaces the objective of the
+// copy, so that the solver starts from the state of its previous solve: LP
+// solvers keep their basis, and MIP solvers are given the previous solution
+// as a hint.
+//
+// The inequalities are expressed in the variables of the original solver,
+// which must outlive this class and whose model must not change after the
+// construction.
+//
+// Example use:
+//   InequalityChecker checker(solver);
+//   for (const LinearRange& cut : cuts) {
+//     if (!checker.IsValid(cut)) ...
+//   }
+class InequalityChecker {
+ public:
+  explicit InequalityChecker(const operations_research::MPSolver& solver);
+
+  InequalityChecker(const InequalityChecker&) = delete;
+  InequalityChecker& operator=(const InequalityChecker&) = delete;
+
+  // See ComputeInequalityGap() below.
+  double ComputeGap(const operations_research::LinearRange& inequality);
+
+  // Returns ComputeGap() for each inequality, in order.
+  std::vector<double> ComputeGaps(
+      absl::Span<const operations_research::LinearRange> inequalities);
+
+  // See CheckValidInequality() below.
+  bool IsValid(const operations_research::LinearRange& inequality) {
+    return ComputeGap(inequality) >= 0.0;
+  }
+
+ private:
+  operations_research::MPSolver solver_copy_;
+  // The last solution found, as a hint for the next MIP solve.
+  std::vector<std::pair<const operations_research::MPVariable*, double>>
+      hint_;
+};
+
 // Returns the gap between a (one-sided) inequality and the tightest inequality
 // modeled by solver with the same coefficients. If negative, this implies that
 // the inequality is not valid. This solves a (copy of the) full model and may
-// be slow, and it is intended to be used mainly for analysis and debugging.
+// be slow, and it is intended to be used mainly for analysis and debugging. To
+// check several inequalities, use an InequalityChecker instead.
 double ComputeInequalityGap(const operations_research::MPSolver& solver,
                             const operations_research::LinearRange inequality);
 
@@ -32,6 +78,37 @@ double ComputeInequalityGap(const operations_research::MPSolver& solver,
 bool CheckValidInequality(const operations_research::MPSolver& solver,
                           const operations_research::LinearRange inequality);
 
+struct CheckValidInequalitiesOptions {
+  // The number of threads, each checking inequalities on its own
+  // InequalityChecker.
+  int num_threads = 1;
+
+  // If true, the inequalities after the first invalid one are not checked,
+  // except for those already being checked.
+  bool stop_at_first_invalid = false;
+};
+
+struct CheckValidInequalitiesResult {
+  // The gap of each inequality, see ComputeInequalityGap(). With
+  // stop_at_first_invalid, only the gaps up to first_invalid are returned.
+  std::vector<double> gaps;
+
+  // The index of the first invalid inequality, or -1 if all are valid.
+  int first_invalid = -1;
+};
+
+// Like CheckValidInequality() on each inequality, in parallel. The inequalities
+// are claimed in order, so all the inequalities before an invalid one are
+// always checked, and the verdicts (which gaps are negative, and
+// first_invalid) do not depend on the number of threads or on the scheduling,
+// as long as no gap is within the tolerances of the solver from 0. The gaps
+// themselves may differ by up to those tolerances between runs, since each
+// worker starts from the solution of the inequality it checked before.
+CheckValidInequalitiesResult CheckValidInequalities(
+    const operations_research::MPSolver& solver,
+    absl::Span<const operations_research::LinearRange> inequalities,
+    const CheckValidInequalitiesOptions& options);
+
 }  // namespace tf_opt
 
 #endif  // TF_OPT_OPTIMIZE_MIP_INEQUALITY_CHECKER_H_
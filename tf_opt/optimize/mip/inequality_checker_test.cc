@@ -14,6 +14,9 @@
 
 #include "tf_opt/optimize/mip/inequality_checker.h"
 
+#include <vector>
+
+#include "gmock/gmock.h"
 #include "gtest/gtest.h"
 #include "ortools/linear_solver/linear_expr.h"
 #include "ortools/linear_solver/linear_solver.h"
@@ -22,6 +25,9 @@ namespace tf_opt {
 namespace {
 
 using operations_research::LinearExpr;
+using operations_research::LinearRange;
+using ::testing::ElementsAre;
+using ::testing::IsEmpty;
 using operations_research::MPSolver;
 
 // Creates a feasibility model of the form:
@@ -62,5 +68,70 @@ TEST_F(InequalityCheckerTest, CheckValidInequality) {
   EXPECT_FALSE(CheckValidInequality(solver_, x1_ + x2_ >= 1.0));
 }
 
+TEST_F(InequalityCheckerTest, CheckerReusesCopy) {
+  InequalityChecker checker(solver_);
+  EXPECT_EQ(checker.ComputeGap(x1_ + x2_ <= 3.0), 1.0);
+  EXPECT_EQ(checker.ComputeGap(x1_ + x2_ >= 1.0), -1.0);
+  EXPECT_EQ(checker.ComputeGap(x1_ - x2_ <= 2.0), 0.0);
+  EXPECT_EQ(checker.ComputeGap(x1_ + 2.0 * x2_ >= -1.0), 1.0);
+  EXPECT_TRUE(checker.IsValid(x1_ + x2_ <= 2.0));
+  EXPECT_FALSE(checker.IsValid(x1_ + x2_ <= 1.5));
+}
+
+TEST_F(InequalityCheckerTest, ComputeGaps) {
+  InequalityChecker checker(solver_);
+  EXPECT_THAT(checker.ComputeGaps({x1_ + x2_ <= 3.0, x1_ + x2_ >= 1.0,
+                                   x1_ - x2_ <= 2.0}),
+              ElementsAre(1.0, -1.0, 0.0));
+  EXPECT_THAT(checker.ComputeGaps({}), IsEmpty());
+}
+
+TEST_F(InequalityCheckerTest, CheckValidInequalities) {
+  // Valid inequalities x1 + x2 <= k for k >= 2, and an invalid one.
+  std::vector<LinearRange> inequalities;
+  for (int k = 2; k < 12; ++k) {
+    inequalities.push_back(x1_ + x2_ <= k);
+  }
+  inequalities.push_back(x1_ + x2_ >= 1.0);
+  inequalities.push_back(x1_ - x2_ <= 2.0);
+  for (const int num_threads : {1, 4, 32}) {
+    CheckValidInequalitiesOptions options;
+    options.num_threads = num_threads;
+    const CheckValidInequalitiesResult result =
+        CheckValidInequalities(solver_, inequalities, options);
+    EXPECT_EQ(result.first_invalid, 10);
+    ASSERT_EQ(result.gaps.size(), 12);
+    for (int k = 2; k < 12; ++k) {
+      EXPECT_EQ(result.gaps[k - 2], k - 2.0);
+    }
+    EXPECT_EQ(result.gaps[10], -1.0);
+    EXPECT_EQ(result.gaps[11], 0.0);
+  }
+}
+
+TEST_F(InequalityCheckerTest, CheckValidInequalitiesStopsAtFirstInvalid) {
+  const std::vector<LinearRange> inequalities = {
+      x1_ + x2_ <= 3.0, x1_ + x2_ >= 1.0, x1_ + x2_ <= 4.0, x1_ + x2_ <= 1.0};
+  CheckValidInequalitiesOptions options;
+  options.num_threads = 2;
+  options.stop_at_first_invalid = true;
+  const CheckValidInequalitiesResult result =
+      CheckValidInequalities(solver_, inequalities, options);
+  EXPECT_EQ(result.first_invalid, 1);
+  EXPECT_THAT(result.gaps, ElementsAre(1.0, -1.0));
+}
+
+TEST_F(InequalityCheckerTest, CheckValidInequalitiesAllValid) {
+  const CheckValidInequalitiesResult result = CheckValidInequalities(
+      solver_, {x1_ + x2_ <= 3.0, x1_ + x2_ >= -1.0},
+      CheckValidInequalitiesOptions());
+  EXPECT_EQ(result.first_invalid, -1);
+  EXPECT_THAT(result.gaps, ElementsAre(1.0, 1.0));
+  EXPECT_THAT(CheckValidInequalities(solver_, {},
+                                     CheckValidInequalitiesOptions())
+                  .gaps,
+              IsEmpty());
+}
+
 }  // namespace
 }  // namespace tf_opt
@@ -0,0 +1,516 @@
+// Copyright 2026 The tf.opt Authors.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "tf_opt/optimize/mip/mip_encoder.h"
+
+#include <cstdint>
+#include <limits>
+#include <optional>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "ortools/base/logging.h"
+#include "absl/algorithm/container.h"
+#include "absl/strings/str_cat.h"
+#include "ortools/linear_solver/linear_solver.h"
+#include "tf_opt/neural_net/neuron/clipped_relu_impl_type.h"
+#include "tf_opt/neural_net/neuron/relu_impl_type.h"
+#include "tf_opt/optimize/mip/neuron_formulations.h"
+#include "tf_opt/tensor/concat.h"
+#include "tf_opt/tensor/convolve.h"
+#include "tf_opt/tensor/embedding_lookup.h"
+#include "tf_opt/tensor/math.h"
+#include "tf_opt/tensor/pooling.h"
+#include "tf_opt/tensor/reduce.h"
+
+namespace tf_opt {
+
+using operations_research::MPSolver;
+
+namespace {
+
+// The value of "tensor" if all its expressions are constant, e.g. for
+// constants and weights.
+std::optional<DoubleTensor> PointValue(const MipTensor& tensor) {
+  DoubleTensor result(tensor.expressions.dimension());
+  for (int64_t i = 0; i < tensor.expressions.size(); ++i) {
+    const SparseLinearExpr& expr = tensor.expressions.flat_value(i);
+    if (!expr.is_constant()) return std::nullopt;
+    (*result.mutable_flat_values())[i] = expr.offset();
+  }
+  return result;
+}
+
+DoubleTensor PointValueOrDie(const MipTensor& tensor,
+                             const Operation& op) {
+  std::optional<DoubleTensor> result = PointValue(tensor);
+  CHECK(result.has_value())
+      << "Product of two non-constant tensors in operation: " << op.name();
+  return *std::move(result);
+}
+
+// A tensor of the shape of "tensor" with value i + 1 at flat index i, so that
+// the padding zeros of the pooling functions stand out.
+DoubleTensor ShiftedFlatIndices(const Shape& shape) {
+  DoubleTensor result(shape);
+  for (int64_t i = 0; i < result.size(); ++i) {
+    (*result.mutable_flat_values())[i] = i + 1;
+  }
+  return result;
+}
+
+std::vector<int64_t> UnshiftIndices(absl::Span<const double> shifted) {
+  std::vector<int64_t> result;
+  result.reserve(shifted.size());
+  for (const double index : shifted) {
+    result.push_back(static_cast<int64_t>(index) - 1);
+  }
+  return result;
+}
+
+std::string ElementName(const Operation& op, const int64_t index) {
+  return absl::StrCat(op.name(), "_", index);
+}
+
+// The formulation of the single ReLU of a clipped ReLU with only one kink in
+// the range of its input.
+ReluImplementationType SingleKinkFormulation(
+    const ClippedReluImplementationType formulation) {
+  return formulation == ClippedReluImplementationType::kCompositeExtended
+             ? ReluImplementationType::kMultipleChoice
+             : ReluImplementationType::kBigM;
+}
+
+}  // namespace
+
+MipEncoder::MipEncoder(
+    MPSolver* solver,
+    absl::flat_hash_map<std::string, BoundsTensor> variable_bounds)
+    : solver_(solver), variable_bounds_(std::move(variable_bounds)) {
+  CHECK(solver != nullptr);
+}
+
+void MipEncoder::SetOperationBounds(const std::string& name,
+                                    BoundsTensor bounds) {
+  operation_bounds_[name] = std::move(bounds);
+}
+
+void MipEncoder::SetFormulation(const std::string& name,
+                                const ReluImplementationType formulation) {
+  relu_formulations_[name] = formulation;
+}
+
+void MipEncoder::SetFormulation(const std::string& name,
+                                const MaximumImplementationType formulation) {
+  maximum_formulations_[name] = formulation;
+}
+
+ReluImplementationType MipEncoder::Formulation(const ReluOperation& op) const {
+  const auto it = relu_formulations_.find(op.name());
+  return it == relu_formulations_.end() ? op.formulation() : it->second;
+}
+
+template <typename OperationType>
+MaximumImplementationType MipEncoder::MaximumFormulation(
+    const OperationType& op) const {
+  const auto it = maximum_formulations_.find(op.name());
+  return it == maximum_formulations_.end() ? op.formulation() : it->second;
+}
+
+MipTensor MipEncoder::MakeResult(const Operation& op,
+                                 SparseExprTensor expressions) const {
+  MipTensor result{std::move(expressions),
+                   BoundsTensor(op.output_shape())};
+  CHECK(result.expressions.dimension() == op.output_shape());
+  const auto it = operation_bounds_.find(op.name());
+  const BoundsTensor* operation_bounds =
+      it == operation_bounds_.end() ? nullptr : &it->second;
+  if (operation_bounds != nullptr) {
+    CHECK(operation_bounds->dimension() == op.output_shape())
+        << "Bounds for operation: " << op.name() << " have shape "
+        << operation_bounds->dimension().ToString() << ", expected "
+        << op.output_shape().ToString();
+  }
+  std::vector<Bounds>& bounds = *result.bounds.mutable_flat_values();
+  for (int64_t i = 0; i < result.expressions.size(); ++i) {
+    bounds[i] = result.expressions.flat_value(i).ComputeBounds();
+    if (operation_bounds != nullptr) {
+      bounds[i] = Intersect(bounds[i], operation_bounds->flat_value(i));
+    }
+  }
+  return result;
+}
+
+SparseExprTensor MipEncoder::Materialize(const std::string& name,
+                                         const MipTensor& tensor) {
+  SparseExprTensor result = tensor.expressions;
+  for (int64_t i = 0; i < result.size(); ++i) {
+    SparseLinearExpr& expr = (*result.mutable_flat_values())[i];
+    if (expr.terms().size() <= 1) continue;
+    const Bounds bounds = tensor.bounds.flat_value(i);
+    const SparseLinearExpr variable(solver_->MakeNumVar(
+        bounds.lb(), bounds.ub(), absl::StrCat(name, "_", i)));
+    AddRow(0.0, variable - expr, 0.0, solver_);
+    expr = variable;
+  }
+  return result;
+}
+
+int64_t MipEncoder::NumBinaryVariablesFrom(const int first_variable) const {
+  int64_t result = 0;
+  for (int i = first_variable; i < solver_->NumVariables(); ++i) {
+    if (solver_->variable(i)->integer()) ++result;
+  }
+  return result;
+}
+
+SparseLinearExpr MipEncoder::MaxOfElements(
+    const MipTensor& input, const std::vector<int64_t>& indices,
+    const bool minimize, const MaximumImplementationType formulation,
+    const std::string& name) {
+  // The min is the opposite of the max of the opposites.
+  const double sign = minimize ? -1.0 : 1.0;
+  std::vector<SparseLinearExpr> xs;
+  std::vector<Bounds> x_bounds;
+  xs.reserve(indices.size());
+  x_bounds.reserve(indices.size());
+  for (const int64_t index : indices) {
+    if (index < 0) {
+      xs.emplace_back(0.0);
+      x_bounds.emplace_back(0.0);
+    } else {
+      xs.push_back(sign * input.expressions.flat_value(index));
+      const Bounds bounds = input.bounds.flat_value(index);
+      x_bounds.push_back(minimize ? -bounds : bounds);
+    }
+  }
+  const std::vector<int> candidates = UndominatedIndices(x_bounds);
+  stats_.num_dominated_max_inputs += xs.size() - candidates.size();
+  if (candidates.size() > 1) {
+    std::vector<Bounds>& candidate_bounds =
+        nonlinear_layers_.back().maximum_input_bounds.emplace_back();
+    for (const int i : candidates) {
+      candidate_bounds.push_back(x_bounds[i]);
+    }
+  }
+  const int first_variable = solver_->NumVariables();
+  SparseLinearExpr result =
+      sign * EncodeMaximum(xs, x_bounds, formulation, name, solver_);
+  stats_.num_binary_variables += NumBinaryVariablesFrom(first_variable);
+  return result;
+}
+
+MipTensor MipEncoder::EvaluateAdd(const AddOperation& op,
+                                  const MipTensor& left,
+                                  const MipTensor& right) {
+  return MakeResult(op, Add(left.expressions, right.expressions));
+}
+
+MipTensor MipEncoder::EvaluateClippedRelu(const ClippedReluOperation& op,
+                                          const MipTensor& input) {
+  const double cap = op.cap();
+  const int num_binary_variables = NumBinaryVariables(op.formulation());
+  const ReluImplementationType relu_formulation =
+      SingleKinkFormulation(op.formulation());
+  const int first_variable = solver_->NumVariables();
+  SparseExprTensor result(input.expressions.dimension());
+  for (int64_t i = 0; i < result.size(); ++i) {
+    const SparseLinearExpr& x = input.expressions.flat_value(i);
+    const Bounds bounds = input.bounds.flat_value(i);
+    SparseLinearExpr& y = (*result.mutable_flat_values())[i];
+    ++stats_.num_neurons;
+    const bool stable = bounds.ub() <= 0.0 || bounds.lb() >= cap ||
+                        (bounds.lb() >= 0.0 && bounds.ub() <= cap);
+    if (stable) {
+      ++stats_.num_stable_neurons;
+      stats_.num_eliminated_binary_variables += num_binary_variables;
+    }
+    if (bounds.ub() <= 0.0) {
+      y = SparseLinearExpr(0.0);
+    } else if (bounds.lb() >= cap) {
+      y = SparseLinearExpr(cap);
+    } else if (stable) {
+      y = x;
+    } else if (bounds.lb() >= 0.0) {
+      // min(x, cap) = x - max(0, x - cap).
+      y = x - EncodeRelu(x - cap, bounds - cap, relu_formulation,
+                         ElementName(op, i), solver_);
+      stats_.num_eliminated_binary_variables +=
+          num_binary_variables - NumBinaryVariables(relu_formulation);
+    } else if (bounds.ub() <= cap) {
+      y = EncodeRelu(x, bounds, relu_formulation, ElementName(op, i),
+                     solver_);
+      stats_.num_eliminated_binary_variables +=
+          num_binary_variables - NumBinaryVariables(relu_formulation);
+    } else {
+      y = EncodeClippedRelu(x, bounds, cap, op.formulation(),
+                            ElementName(op, i), solver_);
+    }
+  }
+  stats_.num_binary_variables += NumBinaryVariablesFrom(first_variable);
+  return MakeResult(op, std::move(result));
+}
+
+MipTensor MipEncoder::EvaluateConcat(
+    const ConcatOperation& op, const std::vector<const MipTensor*>& inputs) {
+  std::vector<const SparseExprTensor*> expressions;
+  std::vector<const BoundsTensor*> bounds;
+  for (const MipTensor* input : inputs) {
+    expressions.push_back(&input->expressions);
+    bounds.push_back(&input->bounds);
+  }
+  return {Concat(expressions, op.axis()), Concat(bounds, op.axis())};
+}
+
+MipTensor MipEncoder::EvaluateConstant(const ConstantOperation& op) {
+  SparseExprTensor result(op.output_shape());
+  for (int64_t i = 0; i < result.size(); ++i) {
+    (*result.mutable_flat_values())[i] =
+        SparseLinearExpr(op.value().flat_value(i));
+  }
+  return {std::move(result), DoubleTensorToBoundsTensor(op.value())};
+}
+
+MipTensor MipEncoder::EvaluateConv1d(const Conv1dOperation& op,
+                                     const MipTensor& value,
+                                     const MipTensor& filters) {
+  if (const std::optional<DoubleTensor> point = PointValue(filters)) {
+    return MakeResult(
+        op, Conv1d<SparseLinearExpr>(Materialize(op.name(), value), *point,
+                                     op.stride(), op.padding())
+                .value());
+  }
+  return MakeResult(
+      op, Conv1d<SparseLinearExpr>(PointValueOrDie(value, op),
+                                   Materialize(op.name(), filters),
+                                   op.stride(), op.padding())
+              .value());
+}
+
+MipTensor MipEncoder::EvaluateConv2d(const Conv2dOperation& op,
+                                     const MipTensor& value,
+                                     const MipTensor& filters) {
+  if (const std::optional<DoubleTensor> point = PointValue(filters)) {
+    return MakeResult(
+        op, Conv2d<SparseLinearExpr>(Materialize(op.name(), value), *point,
+                                     op.stride(), op.padding())
+                .value());
+  }
+  return MakeResult(
+      op, Conv2d<SparseLinearExpr>(PointValueOrDie(value, op),
+                                   Materialize(op.name(), filters),
+                                   op.stride(), op.padding())
+              .value());
+}
+
+MipTensor MipEncoder::EvaluateDivide(const DivideOperation& op,
+                                     const MipTensor& left,
+                                     const MipTensor& right) {
+  const DoubleTensor divisor = PointValueOrDie(right, op);
+  CHECK(!absl::c_linear_search(divisor.flat_values(), 0.0))
+      << "Division by zero in operation: " << op.name();
+  return MakeResult(
+      op, internal::Divide<SparseLinearExpr, SparseLinearExpr, double>(
+              left.expressions, divisor));
+}
+
+MipTensor MipEncoder::EvaluateEmbeddingLookup(
+    const EmbeddingLookupOperation& op, const MipTensor& params,
+    const MipTensor& ids) {
+  if (const std::optional<DoubleTensor> point = PointValue(params)) {
+    return MakeResult(op, EmbeddingLookup<SparseLinearExpr>(
+                              *point, Materialize(op.name(), ids)));
+  }
+  return MakeResult(op, EmbeddingLookup<SparseLinearExpr>(
+                            Materialize(op.name(), params),
+                            PointValueOrDie(ids, op)));
+}
+
+MipTensor MipEncoder::EvaluateExpandDims(const ExpandDimsOperation& op,
+                                         const MipTensor& input) {
+  return {input.expressions.ExpandDims(op.axis()),
+          input.bounds.ExpandDims(op.axis())};
+}
+
+MipTensor MipEncoder::EvaluateMatmul(const MatmulOperation& op,
+                                     const MipTensor& left,
+                                     const MipTensor& right) {
+  if (const std::optional<DoubleTensor> point = PointValue(right)) {
+    return MakeResult(
+        op, internal::MatMul<SparseLinearExpr, SparseLinearExpr, double>(
+                Materialize(op.name(), left), *point));
+  }
+  return MakeResult(
+      op, internal::MatMul<SparseLinearExpr, double, SparseLinearExpr>(
+              PointValueOrDie(left, op), Materialize(op.name(), right)));
+}
+
+MipTensor MipEncoder::EvaluateMaxpool(const MaxpoolOperation& op,
+                                      const MipTensor& input) {
+  const MaximumImplementationType formulation = MaximumFormulation(op);
+  nonlinear_layers_.push_back(
+      {op.name(), NonlinearLayer::Kind::kMaximum, {}, {}, {}});
+  SparseExprTensor result = internal::Pool<SparseLinearExpr, double>(
+      ShiftedFlatIndices(input.bounds.dimension()), op.ksize(), op.stride(),
+      op.padding(),
+      [this, &op, &input, formulation](const std::vector<double>& window,
+                                       const int64_t output_index) {
+        return MaxOfElements(input, UnshiftIndices(window),
+                             /*minimize=*/false, formulation,
+                             ElementName(op, output_index));
+      });
+  return MakeResult(op, std::move(result));
+}
+
+MipTensor MipEncoder::EvaluateMultiply(const MultiplyOperation& op,
+                                       const MipTensor& left,
+                                       const MipTensor& right) {
+  if (const std::optional<DoubleTensor> point = PointValue(right)) {
+    return MakeResult(
+        op, internal::Multiply<SparseLinearExpr, SparseLinearExpr, double>(
+                left.expressions, *point));
+  }
+  return MakeResult(
+      op, internal::Multiply<SparseLinearExpr, double, SparseLinearExpr>(
+              PointValueOrDie(left, op), right.expressions));
+}
+
+MipTensor MipEncoder::EvaluateReduceMax(const ReduceMaxOperation& op,
+                                        const MipTensor& input) {
+  const MaximumImplementationType formulation = MaximumFormulation(op);
+  nonlinear_layers_.push_back(
+      {op.name(), NonlinearLayer::Kind::kMaximum, {}, {}, {}});
+  SparseExprTensor result = internal::Reduce<SparseLinearExpr>(
+      ShiftedFlatIndices(input.bounds.dimension()), op.axes(),
+      [this, &op, &input, formulation](absl::Span<const double> elements,
+                                       const int64_t output_index) {
+        return MaxOfElements(input, UnshiftIndices(elements),
+                             /*minimize=*/false, formulation,
+                             ElementName(op, output_index));
+      });
+  return MakeResult(op, std::move(result));
+}
+
+MipTensor MipEncoder::EvaluateReduceMean(const ReduceMeanOperation& op,
+                                         const MipTensor& input) {
+  return MakeResult(op,
+                    ReduceMean(Materialize(op.name(), input), op.axes()));
+}
+
+MipTensor MipEncoder::EvaluateReduceMin(const ReduceMinOperation& op,
+                                        const MipTensor& input) {
+  const MaximumImplementationType formulation = MaximumFormulation(op);
+  nonlinear_layers_.push_back(
+      {op.name(), NonlinearLayer::Kind::kMaximum, {}, {}, {}});
+  SparseExprTensor result = internal::Reduce<SparseLinearExpr>(
+      ShiftedFlatIndices(input.bounds.dimension()), op.axes(),
+      [this, &op, &input, formulation](absl::Span<const double> elements,
+                                       const int64_t output_index) {
+        return MaxOfElements(input, UnshiftIndices(elements),
+                             /*minimize=*/true, formulation,
+                             ElementName(op, output_index));
+      });
+  return MakeResult(op, std::move(result));
+}
+
+MipTensor MipEncoder::EvaluateReduceSum(const ReduceSumOperation& op,
+                                        const MipTensor& input) {
+  return MakeResult(op, ReduceSum(Materialize(op.name(), input), op.axes()));
+}
+
+MipTensor MipEncoder::EvaluateRelu(const ReluOperation& op,
+                                   const MipTensor& input) {
+  const ReluImplementationType formulation = Formulation(op);
+  const int num_binary_variables = NumBinaryVariables(formulation);
+  const int first_variable = solver_->NumVariables();
+  NonlinearLayer& layer = nonlinear_layers_.emplace_back();
+  layer.name = op.name();
+  layer.kind = NonlinearLayer::Kind::kRelu;
+  SparseExprTensor result(input.expressions.dimension());
+  for (int64_t i = 0; i < result.size(); ++i) {
+    const SparseLinearExpr& x = input.expressions.flat_value(i);
+    const Bounds bounds = input.bounds.flat_value(i);
+    SparseLinearExpr& y = (*result.mutable_flat_values())[i];
+    ++stats_.num_neurons;
+    if (bounds.ub() <= 0.0 || bounds.lb() >= 0.0) {
+      y = bounds.ub() <= 0.0 ? SparseLinearExpr(0.0) : x;
+      ++stats_.num_stable_neurons;
+      stats_.num_eliminated_binary_variables += num_binary_variables;
+      continue;
+    }
+    SparseLinearExpr canonical_x = x;
+    canonical_x.Canonicalize();
+    layer.relu_input_bounds.push_back(bounds);
+    layer.relu_fan_in.push_back(canonical_x.terms().size());
+    if (use_lazy_ideal_relus_ &&
+        formulation == ReluImplementationType::kIdealExponential) {
+      lazy_ideal_relus_.push_back(EncodeBigMRelu(
+          canonical_x, bounds, /*relax=*/false, ElementName(op, i), solver_));
+      y = lazy_ideal_relus_.back().y;
+    } else {
+      y = EncodeRelu(canonical_x, bounds, formulation, ElementName(op, i),
+                     solver_);
+    }
+  }
+  stats_.num_binary_variables += NumBinaryVariablesFrom(first_variable);
+  return MakeResult(op, std::move(result));
+}
+
+MipTensor MipEncoder::EvaluateReshape(const ReshapeOperation& op,
+                                      const MipTensor& input) {
+  return {input.expressions.Reshape(op.output_shape()),
+          input.bounds.Reshape(op.output_shape())};
+}
+
+MipTensor MipEncoder::EvaluateSlice(const SliceOperation& op,
+                                    const MipTensor& input) {
+  return {input.expressions.Slice(op.begin(), op.sizes()),
+          input.bounds.Slice(op.begin(), op.sizes())};
+}
+
+MipTensor MipEncoder::EvaluateSqueeze(const SqueezeOperation& op,
+                                      const MipTensor& input) {
+  if (op.axes().empty()) {
+    return {input.expressions.Squeeze(), input.bounds.Squeeze()};
+  }
+  return {input.expressions.Squeeze(op.axes()),
+          input.bounds.Squeeze(op.axes())};
+}
+
+MipTensor MipEncoder::EvaluateSubtract(const SubtractOperation& op,
+                                       const MipTensor& left,
+                                       const MipTensor& right) {
+  return MakeResult(op, Subtract(left.expressions, right.expressions));
+}
+
+MipTensor MipEncoder::EvaluateVariable(const VariableOperation& op) {
+  const auto it = variable_bounds_.find(op.name());
+  CHECK(it != variable_bounds_.end()) << "No bounds for variable: "
+                                      << op.name();
+  const BoundsTensor& bounds = it->second;
+  CHECK(bounds.dimension() == op.output_shape())
+      << "Bounds for variable: " << op.name() << " have shape "
+      << bounds.dimension().ToString() << ", expected "
+      << op.output_shape().ToString();
+  SparseExprTensor result(bounds.dimension());
+  for (int64_t i = 0; i < result.size(); ++i) {
+    const Bounds element = bounds.flat_value(i);
+    (*result.mutable_flat_values())[i] = SparseLinearExpr(
+        solver_->MakeNumVar(element.lb(), element.ub(), ElementName(op, i)));
+  }
+  return {std::move(result), bounds};
+}
+
+}  // namespace tf_opt
@@ -0,0 +1,271 @@
+// Copyright 2026 The tf.opt Authors.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef TF_OPT_OPTIMIZE_MIP_MIP_ENCODER_H_
+#define TF_OPT_OPTIMIZE_MIP_MIP_ENCODER_H_
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+#include "absl/container/flat_hash_map.h"
+#include "ortools/linear_solver/linear_solver.h"
+#include "tf_opt/bounds/bounds.h"
+#include "tf_opt/neural_net/operation_evaluator.h"
+#include "tf_opt/neural_net/neuron/maximum_impl_type.h"
+#include "tf_opt/neural_net/neuron/relu_impl_type.h"
+#include "tf_opt/neural_net/ops/all_operations.h"
+#include "tf_opt/optimize/mip/neuron_formulations.h"
+#include "tf_opt/optimize/mip/sparse_linear_expr.h"
+#include "tf_opt/tensor/shape.h"
+#include "tf_opt/tensor/tensor.h"
+
+namespace tf_opt {
+
+// The MIP encoding of the output of one operation.
+struct MipTensor {
+  // Each element as an affine expression of the variables of the solver.
+  SparseExprTensor expressions;
+
+  // Bounds on each element, valid for every feasible solution of the model.
+  BoundsTensor bounds;
+};
+
+// Counts of the binary variables of a model built by MipEncoder.
+struct MipEncodingStats {
+  // The number of ReLUs and clipped ReLUs.
+  int64_t num_neurons = 0;
+
+  // The neurons that are linear over the bounds of their input (always
+  // active, always inactive, or always capped), which are modeled without
+  // binary variables.
+  int64_t num_stable_neurons = 0;
+
+  // The binary variables of the model.
+  int64_t num_binary_variables = 0;
+
+  // The binary variables that the formulations of the operations would have
+  // added for the stable neurons, and for the clipped ReLUs with only one
+  // kink in the range of their input, which are modeled as a ReLU.
+  int64_t num_eliminated_binary_variables = 0;
+
+  // The inputs of the windows of MaxpoolOperations, and of the reductions of
+  // ReduceMaxOperations and ReduceMinOperations, that can never be the
+  // maximum (or minimum) given the bounds, and that are left out of their
+  // formulations.
+  int64_t num_dominated_max_inputs = 0;
+};
+
+// The elements of one operation that need a formulation with binary
+// variables, with what the size and strength of the formulations depend on,
+// see formulation_selector.h.
+struct NonlinearLayer {
+  enum class Kind { kRelu, kMaximum };
+
+  // The name of the operation.
+  std::string name;
+
+  // kRelu for a ReluOperation, kMaximum for a MaxpoolOperation,
+  // ReduceMaxOperation or ReduceMinOperation.
+  Kind kind = Kind::kRelu;
+
+  // For kRelu, the bounds of the input of each unstable neuron, and the
+  // number of terms of that input.
+  std::vector<Bounds> relu_input_bounds;
+  std::vector<int> relu_fan_in;
+
+  // For kMaximum, the bounds of the undominated inputs of each maximum that
+  // has at least two of them (of the opposites for a min).
+  std::vector<std::vector<Bounds>> maximum_input_bounds;
+};
+
+// Builds a MIP model of a neural network in an MPSolver: the feasible
+// solutions of the model are exactly the evaluations of the network on the
+// box given by the bounds of its VariableOperations, as long as every
+// formulation is exact. The kBigMRelaxation ReLU formulation and the
+// kEpigraph maximum formulation are relaxations, which admit more solutions.
+//
+// Linear operations (Add, MatMul, convolutions, ...) add no variables: their
+// results are SparseLinearExprs of their inputs. When an operation mixes many
+// elements (MatMul, convolutions, EmbeddingLookup, ReduceSum and ReduceMean),
+// the elements of its inputs with more than one term are first replaced by a
+// new variable and an equality row, so that the size of the model stays
+// proportional to the number of weights. Products of two non-constant tensors
+// are not linear and CHECK fail.
+//
+// Nonlinear operations use the formulation of the operation, see
+// neuron_formulations.h: ReluOperation::formulation(),
+// ClippedReluOperation::formulation(), MaxpoolOperation::formulation(), ...
+// unless SetFormulation() gives another one.
+// The big-M constants come from interval arithmetic over the bounds of the
+// variables, intersected with the bounds given by SetOperationBounds(), if
+// any. All bounds must be finite.
+//
+// The same bounds detect the stable neurons, which are modeled without
+// binary variables: a ReLU with a nonnegative input is the identity, and one
+// with a nonpositive input is zero; a clipped ReLU is moreover the constant
+// cap when its input is above the cap, and a single ReLU when its input
+// range contains only one of its two kinks. Likewise, the inputs of a max
+// pooling window or of a max or min reduction that can never win are
+// dropped, and a window with a single candidate is that candidate. See
+// stats() for the counts.
+//
+// Example use:
+//   MPSolver solver("verify", MPSolver::SCIP_MIXED_INTEGER_PROGRAMMING);
+//   MipEncoder encoder(&solver,
+//                      {{"x", BoundsTensor(Shape({1, 784}), Bounds(0, 1))}});
+//   std::vector<MipTensor> values = graph.Evaluate(&encoder);
+//   const SparseLinearExpr& logit =
+//       values[graph.OperationIdOrDie("logits")].expressions.flat_value(3);
+//   solver.MutableObjective()->SetMaximization();
+//   ... set the objective to logit, and solve ...
+class MipEncoder : public OperationEvaluator<MipTensor> {
+ public:
+  // The bounds on each VariableOperation, by name. Evaluating a variable
+  // without bounds, or with bounds of a different shape, CHECK fails. The
+  // solver must outlive the encoder.
+  MipEncoder(operations_research::MPSolver* solver,
+             absl::flat_hash_map<std::string, BoundsTensor> variable_bounds);
+
+  // Bounds on the output of the operation called "name", e.g. from a bound
+  // propagation or from TightenBounds(). They are intersected with the bounds
+  // from interval arithmetic, and must be valid for the network.
+  // ConstantOperations and the operations that only move elements (Reshape,
+  // Concat, Slice, Squeeze and ExpandDims) keep the bounds of their inputs and
+  // ignore these; set the bounds on the operations that produce the elements.
+  void SetOperationBounds(const std::string& name, BoundsTensor bounds);
+
+  // Replaces the formulation of the ReluOperation called "name", or of the
+  // MaxpoolOperation, ReduceMaxOperation or ReduceMinOperation called "name",
+  // e.g. with the choices of SelectFormulations().
+  void SetFormulation(const std::string& name,
+                      ReluImplementationType formulation);
+  void SetFormulation(const std::string& name,
+                      MaximumImplementationType formulation);
+
+  // When true, the unstable ReLUs with the kIdealExponential formulation are
+  // modeled with the big-M formulation only, and their inequalities of the
+  // ideal formulation are left to SolveWithIdealReluCuts(), which adds the
+  // violated ones lazily. This also lifts the limit on the number of terms of
+  // their input. Must be set before evaluating the ReLUs.
+  void set_lazy_ideal_relus(const bool lazy) { use_lazy_ideal_relus_ = lazy; }
+
+  // The ReLUs left to SolveWithIdealReluCuts(), see set_lazy_ideal_relus().
+  const std::vector<BigMRelu>& lazy_ideal_relus() const {
+    return lazy_ideal_relus_;
+  }
+
+  // The counts for the operations evaluated so far.
+  const MipEncodingStats& stats() const { return stats_; }
+
+  // The ReLU and maximum operations evaluated so far, in order.
+  const std::vector<NonlinearLayer>& nonlinear_layers() const {
+    return nonlinear_layers_;
+  }
+
+ protected:
+  Shape GetShape(const MipTensor& tensor) const override {
+    return tensor.bounds.dimension();
+  }
+
+  MipTensor EvaluateAdd(const AddOperation& op, const MipTensor& left,
+                        const MipTensor& right) override;
+  MipTensor EvaluateClippedRelu(const ClippedReluOperation& op,
+                                const MipTensor& input) override;
+  MipTensor EvaluateConcat(
+      const ConcatOperation& op,
+      const std::vector<const MipTensor*>& inputs) override;
+  MipTensor EvaluateConstant(const ConstantOperation& op) override;
+  MipTensor EvaluateConv1d(const Conv1dOperation& op, const MipTensor& value,
+                           const MipTensor& filters) override;
+  MipTensor EvaluateConv2d(const Conv2dOperation& op, const MipTensor& value,
+                           const MipTensor& filters) override;
+  MipTensor EvaluateDivide(const DivideOperation& op, const MipTensor& left,
+                           const MipTensor& right) override;
+  MipTensor EvaluateEmbeddingLookup(const EmbeddingLookupOperation& op,
+                                    const MipTensor& params,
+                                    const MipTensor& ids) override;
+  MipTensor EvaluateExpandDims(const ExpandDimsOperation& op,
+                               const MipTensor& input) override;
+  MipTensor EvaluateMatmul(const MatmulOperation& op, const MipTensor& left,
+                           const MipTensor& right) override;
+  MipTensor EvaluateMaxpool(const MaxpoolOperation& op,
+                            const MipTensor& input) override;
+  MipTensor EvaluateMultiply(const MultiplyOperation& op,
+                             const MipTensor& left,
+                             const MipTensor& right) override;
+  MipTensor EvaluateReduceMax(const ReduceMaxOperation& op,
+                              const MipTensor& input) override;
+  MipTensor EvaluateReduceMean(const ReduceMeanOperation& op,
+                               const MipTensor& input) override;
+  MipTensor EvaluateReduceMin(const ReduceMinOperation& op,
+                              const MipTensor& input) override;
+  MipTensor EvaluateReduceSum(const ReduceSumOperation& op,
+                              const MipTensor& input) override;
+  MipTensor EvaluateRelu(const ReluOperation& op,
+                         const MipTensor& input) override;
+  MipTensor EvaluateReshape(const ReshapeOperation& op,
+                            const MipTensor& input) override;
+  MipTensor EvaluateSlice(const SliceOperation& op,
+                          const MipTensor& input) override;
+  MipTensor EvaluateSqueeze(const SqueezeOperation& op,
+                            const MipTensor& input) override;
+  MipTensor EvaluateSubtract(const SubtractOperation& op,
+                             const MipTensor& left,
+                             const MipTensor& right) override;
+  MipTensor EvaluateVariable(const VariableOperation& op) override;
+
+ private:
+  // The result of operation "op" with the given expressions: computes their
+  // bounds, intersected with the bounds of the operation, if any.
+  MipTensor MakeResult(const Operation& op, SparseExprTensor expressions) const;
+
+  // The expressions of "tensor", where each expression with more than one
+  // term is replaced by a new variable, defined by an equality row.
+  SparseExprTensor Materialize(const std::string& name,
+                               const MipTensor& tensor);
+
+  // The number of binary variables of the solver from the variable of index
+  // "first_variable" on.
+  int64_t NumBinaryVariablesFrom(int first_variable) const;
+
+  // The formulation of "op", from SetFormulation() if any.
+  ReluImplementationType Formulation(const ReluOperation& op) const;
+  template <typename OperationType>
+  MaximumImplementationType MaximumFormulation(const OperationType& op) const;
+
+  // The max (or min if "minimize") of some elements of "input", given by
+  // their flat indices, where a negative index stands for a padding zero.
+  // Records the undominated inputs in the last of nonlinear_layers_.
+  SparseLinearExpr MaxOfElements(const MipTensor& input,
+                                 const std::vector<int64_t>& indices,
+                                 bool minimize,
+                                 MaximumImplementationType formulation,
+                                 const std::string& name);
+
+  operations_research::MPSolver* solver_;
+  absl::flat_hash_map<std::string, BoundsTensor> variable_bounds_;
+  absl::flat_hash_map<std::string, BoundsTensor> operation_bounds_;
+  MipEncodingStats stats_;
+  bool use_lazy_ideal_relus_ = false;
+  std::vector<BigMRelu> lazy_ideal_relus_;
+  absl::flat_hash_map<std::string, ReluImplementationType> relu_formulations_;
+  absl::flat_hash_map<std::string, MaximumImplementationType>
+      maximum_formulations_;
+  std::vector<NonlinearLayer> nonlinear_layers_;
+};
+
+}  // namespace tf_opt
+
+#endif  // TF_OPT_OPTIMIZE_MIP_MIP_ENCODER_H_
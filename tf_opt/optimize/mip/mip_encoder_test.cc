@@ -0,0 +1,550 @@
+// Copyright 2026 The tf.opt Authors.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "tf_opt/optimize/mip/mip_encoder.h"
+
+#include <algorithm>
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "gtest/gtest.h"
+#include "absl/container/flat_hash_map.h"
+#include "absl/strings/str_cat.h"
+#include "ortools/linear_solver/linear_solver.h"
+#include "tf_opt/bounds/bounds.h"
+#include "tf_opt/neural_net/double_evaluator.h"
+#include "tf_opt/neural_net/neural_net_graph.h"
+#include "tf_opt/neural_net/neuron/clipped_relu_impl_type.h"
+#include "tf_opt/neural_net/neuron/maximum_impl_type.h"
+#include "tf_opt/neural_net/neuron/relu_impl_type.h"
+#include "tf_opt/neural_net/operation_testing.h"
+#include "tf_opt/neural_net/ops/all_operations.h"
+#include "tf_opt/optimize/mip/sparse_linear_expr.h"
+#include "tf_opt/tensor/shape.h"
+#include "tf_opt/tensor/tensor.h"
+#include "tf_opt/tensor/tensor_testing.h"
+#include "tf_opt/tensor/window.h"
+
+namespace tf_opt {
+namespace {
+
+using operations_research::MPSolver;
+
+constexpr double kTolerance = 1e-6;
+
+Shape OutputShape(const NeuralNetGraph& graph, const int id) {
+  return graph.operation(id).output_shape();
+}
+
+// Encodes the graph over the box variable_bounds, fixes each variable to its
+// value in "point" with equality rows, and checks that the solution of the
+// model is the evaluation of the network at "point".
+void ExpectExactAtPoint(
+    const NeuralNetGraph& graph,
+    const absl::flat_hash_map<std::string, BoundsTensor>& variable_bounds,
+    const absl::flat_hash_map<std::string, DoubleTensor>& point) {
+  MPSolver solver("mip_encoder_test", MPSolver::SCIP_MIXED_INTEGER_PROGRAMMING);
+  MipEncoder encoder(&solver, variable_bounds);
+  const std::vector<MipTensor> encoding = graph.Evaluate(&encoder);
+  DoubleEvaluator evaluator;
+  for (const int id : graph.variables()) {
+    const std::string& name = graph.operation(id).name();
+    const DoubleTensor& value = point.at(name);
+    for (int64_t i = 0; i < value.size(); ++i) {
+      AddRow(value.flat_value(i), encoding[id].expressions.flat_value(i),
+             value.flat_value(i), &solver);
+    }
+    evaluator.set_variable_value(name, value);
+  }
+  ASSERT_EQ(solver.Solve(), MPSolver::OPTIMAL);
+  const std::vector<DoubleTensor> values = graph.Evaluate(&evaluator);
+  for (int id = 0; id < graph.num_operations(); ++id) {
+    ASSERT_EQ(encoding[id].expressions.dimension(), values[id].dimension());
+    for (int64_t i = 0; i < values[id].size(); ++i) {
+      const double value = values[id].flat_value(i);
+      EXPECT_NEAR(encoding[id].expressions.flat_value(i).SolutionValue(),
+                  value, kTolerance)
+          << graph.operation(id).name() << " at " << i;
+      const Bounds bounds = encoding[id].bounds.flat_value(i);
+      EXPECT_GE(value, bounds.lb() - kTolerance)
+          << graph.operation(id).name() << " at " << i;
+      EXPECT_LE(value, bounds.ub() + kTolerance)
+          << graph.operation(id).name() << " at " << i;
+    }
+  }
+}
+
+TEST(MipEncoderTest, LinearOperationsAddNoVariables) {
+  NeuralNetGraph graph;
+  const int x = AddToGraph(VariableOperation::Create("x", Shape({1, 3})), {},
+                           &graph);
+  const int w = AddToGraph(
+      ConstantOperation::Create("w", MakeWeights(Shape({3, 2}), 1)), {},
+      &graph);
+  const int matmul = AddToGraph(
+      MatmulOperation::Create("matmul", Shape({1, 3}), Shape({3, 2})),
+      {x, w}, &graph);
+  const int b = AddToGraph(
+      ConstantOperation::Create("b", MakeWeights(Shape({2}), 2)), {}, &graph);
+  const int add = AddToGraph(
+      AddOperation::Create("add", Shape({1, 2}), Shape({2})), {matmul, b},
+      &graph);
+  AddToGraph(SubtractOperation::Create("subtract", Shape({1, 2}),
+                                       Shape({1, 2})),
+             {add, matmul}, &graph);
+  MPSolver solver("mip_encoder_test", MPSolver::SCIP_MIXED_INTEGER_PROGRAMMING);
+  MipEncoder encoder(&solver,
+                     {{"x", BoundsTensor(Shape({1, 3}), Bounds(-1.0, 1.0))}});
+  const std::vector<MipTensor> encoding = graph.Evaluate(&encoder);
+  EXPECT_EQ(solver.NumVariables(), 3);
+  EXPECT_EQ(solver.NumConstraints(), 0);
+  const MipTensor& result = encoding.back();
+  for (int64_t i = 0; i < result.expressions.size(); ++i) {
+    // (x w + b) - x w is the constant b.
+    SparseLinearExpr expr = result.expressions.flat_value(i);
+    expr.Canonicalize();
+    EXPECT_TRUE(expr.is_constant());
+    EXPECT_NEAR(expr.offset(), MakeWeights(Shape({2}), 2).flat_value(i),
+                kTolerance);
+  }
+}
+
+TEST(MipEncoderTest, ExactOnDenseNetwork) {
+  NeuralNetGraph graph;
+  const int x = AddToGraph(VariableOperation::Create("x", Shape({1, 2})), {},
+                           &graph);
+  const int w1 = AddToGraph(
+      ConstantOperation::Create("w1", MakeWeights(Shape({2, 3}), 1)), {},
+      &graph);
+  const int matmul1 = AddToGraph(
+      MatmulOperation::Create("matmul1", Shape({1, 2}), Shape({2, 3})),
+      {x, w1}, &graph);
+  const int b1 = AddToGraph(
+      ConstantOperation::Create("b1", MakeWeights(Shape({3}), 2)), {}, &graph);
+  const int add = AddToGraph(
+      AddOperation::Create("add", Shape({1, 3}), Shape({3})), {matmul1, b1},
+      &graph);
+  const int relu = AddToGraph(
+      ReluOperation::Create("relu", Shape({1, 3}),
+                            ReluImplementationType::kMultipleChoice),
+      {add}, &graph);
+  const int w2 = AddToGraph(
+      ConstantOperation::Create("w2", MakeWeights(Shape({3, 2}), 3)), {},
+      &graph);
+  const int matmul2 = AddToGraph(
+      MatmulOperation::Create("matmul2", Shape({1, 3}), Shape({3, 2})),
+      {relu, w2}, &graph);
+  const int clipped = AddToGraph(
+      ClippedReluOperation::Create(
+          "clipped", Shape({1, 2}), 0.5,
+          ClippedReluImplementationType::kIncrementalBigM),
+      {matmul2}, &graph);
+  const int half = AddToGraph(
+      ConstantOperation::Create("half", DoubleTensor(Shape({1}), 0.5)), {},
+      &graph);
+  const int scaled = AddToGraph(
+      DivideOperation::Create("scaled", Shape({1, 2}), Shape({1})),
+      {clipped, half}, &graph);
+  AddToGraph(ReduceMaxOperation::Create(
+                 "max", Shape({1, 2}), {1},
+                 MaximumImplementationType::kLogarithmicBigM),
+             {scaled}, &graph);
+  AddToGraph(ReduceMinOperation::Create("min", Shape({1, 2}), {1}),
+             {matmul2}, &graph);
+  AddToGraph(ReduceMeanOperation::Create("mean", Shape({1, 2}), {1}),
+             {matmul2}, &graph);
+  const absl::flat_hash_map<std::string, BoundsTensor> box = {
+      {"x", BoundsTensor(Shape({1, 2}), Bounds(-1.0, 1.0))}};
+  for (const double u : {-1.0, -0.3, 0.4, 1.0}) {
+    ExpectExactAtPoint(
+        graph, box,
+        {{"x", DoubleTensor(std::vector<std::vector<double>>{{u, 0.5}})}});
+  }
+}
+
+TEST(MipEncoderTest, FusedLinearIsEncodedUnfused) {
+  // x -> (MatMul, Add, Relu) -> (MatMul, Add, ClippedRelu), unfused and
+  // fused.
+  NeuralNetGraph unfused;
+  NeuralNetGraph fused;
+  for (NeuralNetGraph* graph : {&unfused, &fused}) {
+    const int x = AddToGraph(VariableOperation::Create("x", Shape({1, 2})),
+                             {}, graph);
+    const int w1 = AddToGraph(
+        ConstantOperation::Create("w1", MakeWeights(Shape({2, 3}), 1)), {},
+        graph);
+    const int b1 = AddToGraph(
+        ConstantOperation::Create("b1", MakeWeights(Shape({3}), 2)), {},
+        graph);
+    const int w2 = AddToGraph(
+        ConstantOperation::Create("w2", MakeWeights(Shape({3, 2}), 3)), {},
+        graph);
+    const int b2 = AddToGraph(
+        ConstantOperation::Create("b2", MakeWeights(Shape({2}), 4)), {},
+        graph);
+    if (graph == &fused) {
+      const int hidden = AddToGraph(
+          FusedLinearOperation::CreateMatmul("hidden", Shape({1, 2}),
+                                             Shape({2, 3}), Shape({3}),
+                                             Activation::kRelu),
+          {x, w1, b1}, graph);
+      AddToGraph(FusedLinearOperation::CreateMatmul(
+                     "out", Shape({1, 3}), Shape({3, 2}), Shape({2}),
+                     Activation::kClippedRelu, 0.5),
+                 {hidden, w2, b2}, graph);
+      continue;
+    }
+    const int matmul1 = AddToGraph(
+        MatmulOperation::Create("matmul1", Shape({1, 2}), Shape({2, 3})),
+        {x, w1}, graph);
+    const int add1 = AddToGraph(
+        AddOperation::Create("add1", Shape({1, 3}), Shape({3})),
+        {matmul1, b1}, graph);
+    const int hidden = AddToGraph(
+        ReluOperation::Create("hidden", Shape({1, 3})), {add1}, graph);
+    const int matmul2 = AddToGraph(
+        MatmulOperation::Create("matmul2", Shape({1, 3}), Shape({3, 2})),
+        {hidden, w2}, graph);
+    const int add2 = AddToGraph(
+        AddOperation::Create("add2", Shape({1, 2}), Shape({2})),
+        {matmul2, b2}, graph);
+    AddToGraph(ClippedReluOperation::Create("out", Shape({1, 2}), 0.5),
+               {add2}, graph);
+  }
+  const absl::flat_hash_map<std::string, BoundsTensor> box = {
+      {"x", BoundsTensor(Shape({1, 2}), Bounds(-1.0, 1.0))}};
+  MPSolver unfused_solver("unfused", MPSolver::SCIP_MIXED_INTEGER_PROGRAMMING);
+  MipEncoder unfused_encoder(&unfused_solver, box);
+  const std::vector<MipTensor> unfused_encoding =
+      unfused.Evaluate(&unfused_encoder);
+  MPSolver fused_solver("fused", MPSolver::SCIP_MIXED_INTEGER_PROGRAMMING);
+  MipEncoder fused_encoder(&fused_solver, box);
+  const std::vector<MipTensor> encoding = fused.Evaluate(&fused_encoder);
+  // The ReLUs are encoded on the pre-activations, as in the unfused graph.
+  EXPECT_EQ(fused_solver.NumVariables(), unfused_solver.NumVariables());
+  EXPECT_EQ(fused_solver.NumConstraints(), unfused_solver.NumConstraints());
+  EXPECT_EQ(
+      encoding[fused.OperationIdOrDie("out")].bounds.flat_values(),
+      unfused_encoding[unfused.OperationIdOrDie("out")].bounds.flat_values());
+  for (const double u : {-1.0, -0.3, 0.4, 1.0}) {
+    ExpectExactAtPoint(
+        fused, box,
+        {{"x", DoubleTensor(std::vector<std::vector<double>>{{u, 0.5}})}});
+  }
+}
+
+TEST(MipEncoderTest, ExactOnConvolutionalNetwork) {
+  NeuralNetGraph graph;
+  const int x = AddToGraph(VariableOperation::Create("x", Shape({1, 2, 2, 1})),
+                           {}, &graph);
+  const int filter = AddToGraph(
+      ConstantOperation::Create("filter", MakeWeights(Shape({2, 2, 1, 1}), 4)),
+      {}, &graph);
+  const int conv2d = AddToGraph(
+      Conv2dOperation::Create("conv2d", Shape({1, 2, 2, 1}),
+                              Shape({2, 2, 1, 1}), Position2D(1, 1),
+                              PaddingType::SAME),
+      {x, filter}, &graph);
+  const int relu = AddToGraph(
+      ReluOperation::Create("relu", OutputShape(graph, conv2d)), {conv2d},
+      &graph);
+  const int maxpool = AddToGraph(
+      MaxpoolOperation::Create("maxpool", OutputShape(graph, relu),
+                               Position2D(2, 2), Position2D(1, 1),
+                               PaddingType::VALID,
+                               MaximumImplementationType::kTightenedBigM),
+      {relu}, &graph);
+  const int flat = AddToGraph(
+      ReshapeOperation::Create("flat", OutputShape(graph, maxpool),
+                               Shape({1, 1})),
+      {maxpool}, &graph);
+  const int expanded = AddToGraph(
+      ExpandDimsOperation::Create("expanded", OutputShape(graph, flat), 0),
+      {flat}, &graph);
+  AddToGraph(
+      SqueezeOperation::Create("squeezed", OutputShape(graph, expanded), {0}),
+      {expanded}, &graph);
+  AddToGraph(
+      SqueezeOperation::Create("squeezed_all", OutputShape(graph, expanded),
+                               {}),
+      {expanded}, &graph);
+  const int sequence = AddToGraph(
+      ReshapeOperation::Create("sequence", Shape({1, 2, 2, 1}),
+                               Shape({1, 4, 1})),
+      {x}, &graph);
+  const int filter1d = AddToGraph(
+      ConstantOperation::Create("filter1d", MakeWeights(Shape({2, 1, 1}), 5)),
+      {}, &graph);
+  const int conv1d = AddToGraph(
+      Conv1dOperation::Create("conv1d", Shape({1, 4, 1}), Shape({2, 1, 1}), 2,
+                              PaddingType::VALID),
+      {sequence, filter1d}, &graph);
+  const int slice = AddToGraph(
+      SliceOperation::Create("slice", OutputShape(graph, conv1d), {0, 1, 0},
+                             {1, 1, 1}),
+      {conv1d}, &graph);
+  AddToGraph(ConcatOperation::Create(
+                 "concat",
+                 {OutputShape(graph, slice), OutputShape(graph, expanded)}, 1),
+             {slice, expanded}, &graph);
+  AddToGraph(ReduceSumOperation::Create("sum", OutputShape(graph, conv1d),
+                                        {1}),
+             {conv1d}, &graph);
+  const absl::flat_hash_map<std::string, BoundsTensor> box = {
+      {"x", BoundsTensor(Shape({1, 2, 2, 1}), Bounds(-1.0, 2.0))}};
+  for (const double u : {-1.0, 0.5, 2.0}) {
+    DoubleTensor point = MakeWeights(Shape({1, 2, 2, 1}), 7);
+    (*point.mutable_flat_values())[0] = u;
+    ExpectExactAtPoint(graph, box, {{"x", point}});
+  }
+}
+
+TEST(MipEncoderTest, ExactOnEmbeddingLookup) {
+  NeuralNetGraph graph;
+  const int ids = AddToGraph(VariableOperation::Create("ids", Shape({1, 3})),
+                             {}, &graph);
+  const int params = AddToGraph(
+      ConstantOperation::Create("params", MakeWeights(Shape({3, 2}), 6)), {},
+      &graph);
+  const int lookup = AddToGraph(
+      EmbeddingLookupOperation::Create("lookup", Shape({3, 2}), Shape({1, 3})),
+      {params, ids}, &graph);
+  AddToGraph(ReluOperation::Create("relu", OutputShape(graph, lookup),
+                                   ReluImplementationType::kIdealExponential),
+             {lookup}, &graph);
+  const absl::flat_hash_map<std::string, BoundsTensor> box = {
+      {"ids", BoundsTensor(Shape({1, 3}), Bounds(0.0, 1.0))}};
+  ExpectExactAtPoint(
+      graph, box,
+      {{"ids", DoubleTensor(std::vector<std::vector<double>>{{0, 1, 0}})}});
+  ExpectExactAtPoint(
+      graph, box,
+      {{"ids",
+        DoubleTensor(std::vector<std::vector<double>>{{0.2, 0.3, 0.5}})}});
+}
+
+TEST(MipEncoderTest, OperationBoundsTightenVariables) {
+  NeuralNetGraph graph;
+  const int x = AddToGraph(VariableOperation::Create("x", Shape({2})), {},
+                           &graph);
+  AddToGraph(ReluOperation::Create("relu", Shape({2})), {x}, &graph);
+  MPSolver solver("mip_encoder_test", MPSolver::SCIP_MIXED_INTEGER_PROGRAMMING);
+  MipEncoder encoder(&solver,
+                     {{"x", BoundsTensor(Shape({2}), Bounds(-2.0, 2.0))}});
+  encoder.SetOperationBounds("relu",
+                             BoundsTensor(Shape({2}), Bounds(0.0, 1.0)));
+  const std::vector<MipTensor> encoding = graph.Evaluate(&encoder);
+  EXPECT_EQ(encoding[1].bounds.flat_value(0), Bounds(0.0, 1.0));
+  EXPECT_EQ(encoding[1].bounds.flat_value(1), Bounds(0.0, 1.0));
+}
+
+BoundsTensor MakeBox(const std::vector<Bounds>& bounds) {
+  BoundsTensor result(Shape({static_cast<int64_t>(bounds.size())}));
+  *result.mutable_flat_values() = bounds;
+  return result;
+}
+
+TEST(MipEncoderTest, StableRelusHaveNoBinaries) {
+  NeuralNetGraph graph;
+  const int x = AddToGraph(VariableOperation::Create("x", Shape({4})), {},
+                           &graph);
+  AddToGraph(ReluOperation::Create("relu", Shape({4})), {x}, &graph);
+  const absl::flat_hash_map<std::string, BoundsTensor> box = {
+      {"x", MakeBox({Bounds(-2.0, -1.0), Bounds(1.0, 2.0), Bounds(-1.0, 1.0),
+                     Bounds(0.0, 3.0)})}};
+  MPSolver solver("mip_encoder_test", MPSolver::SCIP_MIXED_INTEGER_PROGRAMMING);
+  MipEncoder encoder(&solver, box);
+  const std::vector<MipTensor> encoding = graph.Evaluate(&encoder);
+  const SparseExprTensor& relu = encoding[1].expressions;
+  EXPECT_TRUE(relu.flat_value(0).is_constant());
+  EXPECT_EQ(relu.flat_value(0).offset(), 0.0);
+  EXPECT_EQ(relu.flat_value(1).AsVariable(),
+            encoding[0].expressions.flat_value(1).AsVariable());
+  EXPECT_EQ(relu.flat_value(3).AsVariable(),
+            encoding[0].expressions.flat_value(3).AsVariable());
+  EXPECT_EQ(encoder.stats().num_neurons, 4);
+  EXPECT_EQ(encoder.stats().num_stable_neurons, 3);
+  EXPECT_EQ(encoder.stats().num_binary_variables, 1);
+  EXPECT_EQ(encoder.stats().num_eliminated_binary_variables, 3);
+  EXPECT_EQ(solver.NumVariables(), 4 + 2);
+  ExpectExactAtPoint(
+      graph, box,
+      {{"x", DoubleTensor(std::vector<double>{-1.5, 1.5, 0.5, 0.0})}});
+  ExpectExactAtPoint(
+      graph, box,
+      {{"x", DoubleTensor(std::vector<double>{-1.0, 1.0, -0.5, 3.0})}});
+}
+
+TEST(MipEncoderTest, StableClippedRelus) {
+  NeuralNetGraph graph;
+  const int x = AddToGraph(VariableOperation::Create("x", Shape({6})), {},
+                           &graph);
+  AddToGraph(ClippedReluOperation::Create(
+                 "clipped", Shape({6}), 1.0,
+                 ClippedReluImplementationType::kUnaryBigM),
+             {x}, &graph);
+  // Zero, the cap, the identity, min(x, cap), max(0, x), and unstable.
+  const absl::flat_hash_map<std::string, BoundsTensor> box = {
+      {"x", MakeBox({Bounds(-2.0, -1.0), Bounds(2.0, 3.0), Bounds(0.2, 0.8),
+                     Bounds(0.5, 2.0), Bounds(-1.0, 0.5),
+                     Bounds(-1.0, 2.0)})}};
+  MPSolver solver("mip_encoder_test", MPSolver::SCIP_MIXED_INTEGER_PROGRAMMING);
+  MipEncoder encoder(&solver, box);
+  const std::vector<MipTensor> encoding = graph.Evaluate(&encoder);
+  const SparseExprTensor& clipped = encoding[1].expressions;
+  EXPECT_EQ(clipped.flat_value(0).ToString(), "0");
+  EXPECT_EQ(clipped.flat_value(1).ToString(), "1");
+  EXPECT_EQ(clipped.flat_value(2).AsVariable(),
+            encoding[0].expressions.flat_value(2).AsVariable());
+  EXPECT_EQ(encoder.stats().num_neurons, 6);
+  EXPECT_EQ(encoder.stats().num_stable_neurons, 3);
+  EXPECT_EQ(encoder.stats().num_binary_variables, 1 + 1 + 3);
+  EXPECT_EQ(encoder.stats().num_eliminated_binary_variables, 3 * 3 + 2 + 2);
+  for (const double u : {-1.0, 0.0, 0.5, 1.0, 2.0}) {
+    const DoubleTensor point(std::vector<double>{
+        -1.5, 2.5, 0.5, std::max(u, 0.5), std::min(u, 0.5), u});
+    ExpectExactAtPoint(graph, box, {{"x", point}});
+  }
+}
+
+TEST(MipEncoderTest, DominatedMaxInputsArePruned) {
+  NeuralNetGraph graph;
+  const int x = AddToGraph(VariableOperation::Create("x", Shape({3})), {},
+                           &graph);
+  AddToGraph(ReduceMaxOperation::Create("max", Shape({3}), {0}), {x}, &graph);
+  AddToGraph(ReduceMinOperation::Create("min", Shape({3}), {0}), {x}, &graph);
+  const absl::flat_hash_map<std::string, BoundsTensor> box = {
+      {"x", MakeBox({Bounds(0.0, 1.0), Bounds(2.0, 3.0), Bounds(1.5, 2.5)})}};
+  MPSolver solver("mip_encoder_test", MPSolver::SCIP_MIXED_INTEGER_PROGRAMMING);
+  MipEncoder encoder(&solver, box);
+  const std::vector<MipTensor> encoding = graph.Evaluate(&encoder);
+  // The max is x[1] or x[2], and the min is x[0].
+  EXPECT_EQ(encoding[2].expressions.flat_value(0).AsVariable(),
+            encoding[0].expressions.flat_value(0).AsVariable());
+  EXPECT_EQ(encoder.stats().num_dominated_max_inputs, 1 + 2);
+  EXPECT_EQ(encoder.stats().num_binary_variables, 2);
+  ExpectExactAtPoint(graph, box,
+                     {{"x", DoubleTensor(std::vector<double>{0.5, 2.0, 2.5})}});
+  ExpectExactAtPoint(graph, box,
+                     {{"x", DoubleTensor(std::vector<double>{1.0, 3.0, 1.5})}});
+}
+
+TEST(MipEncoderTest, MaxpoolWindowsKeepOnlyCandidates) {
+  NeuralNetGraph graph;
+  const int x = AddToGraph(VariableOperation::Create("x", Shape({1, 3, 3, 1})),
+                           {}, &graph);
+  AddToGraph(MaxpoolOperation::Create("maxpool", Shape({1, 3, 3, 1}),
+                                      Position2D(3, 3), Position2D(1, 1),
+                                      PaddingType::VALID),
+             {x}, &graph);
+  // Only the center and one corner can be the max of the 3x3 window.
+  BoundsTensor bounds(Shape({1, 3, 3, 1}), Bounds(0.0, 1.0));
+  (*bounds.mutable_flat_values())[0] = Bounds(0.5, 3.0);
+  (*bounds.mutable_flat_values())[4] = Bounds(1.0, 2.0);
+  MPSolver solver("mip_encoder_test", MPSolver::SCIP_MIXED_INTEGER_PROGRAMMING);
+  MipEncoder encoder(&solver, {{"x", bounds}});
+  graph.Evaluate(&encoder);
+  EXPECT_EQ(encoder.stats().num_dominated_max_inputs, 7);
+  EXPECT_EQ(encoder.stats().num_binary_variables, 2);
+}
+
+// The model of a network with n ReLUs has O(n) variables and rows, and no
+// variables for the linear layers.
+TEST(MipEncoderTest, LazyIdealRelusOnlyAddBigMRows) {
+  NeuralNetGraph graph;
+  const int x = AddToGraph(VariableOperation::Create("x", Shape({3})), {},
+                           &graph);
+  AddToGraph(ReluOperation::Create("relu", Shape({3}),
+                                   ReluImplementationType::kIdealExponential),
+             {x}, &graph);
+  const absl::flat_hash_map<std::string, BoundsTensor> box = {
+      {"x", MakeBox({Bounds(-2.0, -1.0), Bounds(-1.0, 1.0),
+                     Bounds(-1.0, 2.0)})}};
+  MPSolver solver("mip_encoder_test", MPSolver::SCIP_MIXED_INTEGER_PROGRAMMING);
+  MipEncoder encoder(&solver, box);
+  encoder.set_lazy_ideal_relus(true);
+  const std::vector<MipTensor> encoding = graph.Evaluate(&encoder);
+  // The stable neuron is eliminated, and the two others only get the big-M
+  // rows: y >= x, y <= x - lb (1 - z) and y <= ub z.
+  ASSERT_EQ(encoder.lazy_ideal_relus().size(), 2);
+  EXPECT_EQ(encoder.lazy_ideal_relus()[0].y.AsVariable(),
+            encoding[1].expressions.flat_value(1).AsVariable());
+  EXPECT_EQ(encoder.lazy_ideal_relus()[1].y.AsVariable(),
+            encoding[1].expressions.flat_value(2).AsVariable());
+  EXPECT_EQ(solver.NumVariables(), 3 + 2 * 2);
+  EXPECT_EQ(solver.NumConstraints(), 2 * 3);
+}
+
+TEST(MipEncoderTest, ScalesLinearlyWithNetwork) {
+  constexpr int kInputs = 20;
+  constexpr int kWidth = 500;
+  constexpr int kLayers = 4;
+  NeuralNetGraph graph;
+  int layer = AddToGraph(
+      VariableOperation::Create("x", Shape({1, kInputs})), {}, &graph);
+  int width = kInputs;
+  for (int i = 0; i < kLayers; ++i) {
+    const int w = AddToGraph(
+        ConstantOperation::Create(absl::StrCat("w", i),
+                                  MakeWeights(Shape({width, kWidth}), i)),
+        {}, &graph);
+    const int matmul = AddToGraph(
+        MatmulOperation::Create(absl::StrCat("matmul", i), Shape({1, width}),
+                                Shape({width, kWidth})),
+        {layer, w}, &graph);
+    layer = AddToGraph(
+        ReluOperation::Create(absl::StrCat("relu", i), Shape({1, kWidth})),
+        {matmul}, &graph);
+    width = kWidth;
+  }
+  MPSolver solver("mip_encoder_test", MPSolver::SCIP_MIXED_INTEGER_PROGRAMMING);
+  MipEncoder encoder(
+      &solver, {{"x", BoundsTensor(Shape({1, kInputs}), Bounds(0.0, 1.0))}});
+  graph.Evaluate(&encoder);
+  // At most a continuous and a binary variable, and three rows, per ReLU.
+  EXPECT_LE(solver.NumVariables(), kInputs + 2 * kLayers * kWidth);
+  EXPECT_LE(solver.NumConstraints(), 3 * kLayers * kWidth);
+  EXPECT_EQ(encoder.stats().num_neurons, kLayers * kWidth);
+  EXPECT_EQ(encoder.stats().num_binary_variables +
+                encoder.stats().num_eliminated_binary_variables,
+            kLayers * kWidth);
+}
+
+TEST(MipEncoderDeathTest, ProductOfVariables) {
+  NeuralNetGraph graph;
+  const int x = AddToGraph(VariableOperation::Create("x", Shape({2})), {},
+                           &graph);
+  AddToGraph(MultiplyOperation::Create("square", Shape({2}), Shape({2})),
+             {x, x}, &graph);
+  MPSolver solver("mip_encoder_test", MPSolver::SCIP_MIXED_INTEGER_PROGRAMMING);
+  MipEncoder encoder(&solver,
+                     {{"x", BoundsTensor(Shape({2}), Bounds(0.0, 1.0))}});
+  EXPECT_DEATH(graph.Evaluate(&encoder),
+               "Product of two non-constant tensors in operation: square");
+}
+
+TEST(MipEncoderDeathTest, MissingVariable) {
+  MPSolver solver("mip_encoder_test", MPSolver::SCIP_MIXED_INTEGER_PROGRAMMING);
+  MipEncoder encoder(&solver,
+                     {{"y", BoundsTensor(Shape({2}), Bounds(0.0, 1.0))}});
+  const VariableOperation x =
+      VariableOperation::Create("x", Shape({2})).value();
+  EXPECT_DEATH(encoder.Evaluate(&x, {}), "No bounds for variable: x");
+}
+
+}  // namespace
+}  // namespace tf_opt
@@ -0,0 +1,475 @@
+// Copyright 2026 The tf.opt Authors.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "tf_opt/optimize/mip/neuron_formulations.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <limits>
+#include <optional>
+#include <string>
+#include <vector>
+
+#include "ortools/base/logging.h"
+#include "absl/strings/str_cat.h"
+#include "ortools/linear_solver/linear_solver.h"
+#include "tf_opt/bounds/bounds.h"
+#include "tf_opt/neural_net/neuron/clipped_relu_impl_type.h"
+#include "tf_opt/neural_net/neuron/maximum_impl_type.h"
+#include "tf_opt/neural_net/neuron/relu_impl_type.h"
+#include "tf_opt/optimize/mip/sparse_linear_expr.h"
+
+namespace tf_opt {
+
+using operations_research::MPSolver;
+
+namespace {
+
+constexpr double kInf = std::numeric_limits<double>::infinity();
+
+void CheckFinite(const Bounds bounds, const std::string& name) {
+  CHECK(std::isfinite(bounds.lb()) && std::isfinite(bounds.ub()))
+      << "Unbounded input for neuron: " << name << ", bounds: " << bounds;
+}
+
+SparseLinearExpr NewContinuous(const double lb, const double ub,
+                               const std::string& name, MPSolver* solver) {
+  return SparseLinearExpr(solver->MakeNumVar(lb, ub, name));
+}
+
+SparseLinearExpr NewBinary(const std::string& name, MPSolver* solver) {
+  return SparseLinearExpr(solver->MakeBoolVar(name));
+}
+
+// y >= x, y <= x - lb (1 - z), y <= ub z, and y >= 0 from its bounds.
+void AddReluBigMRows(const SparseLinearExpr& x, const SparseLinearExpr& y,
+                     const SparseLinearExpr& z, const double lb,
+                     const double ub, MPSolver* solver) {
+  AddRow(0.0, y - x, kInf, solver);
+  AddRow(-kInf, y - x - lb * z, -lb, solver);
+  AddRow(-kInf, y - ub * z, 0.0, solver);
+}
+
+// The smallest and largest values of each term w_i v_i of neuron.x.
+void ComputeTermBounds(const BigMRelu& neuron, const std::string& name,
+                       std::vector<double>* term_lb,
+                       std::vector<double>* term_ub) {
+  const std::vector<SparseLinearExpr::Term>& terms = neuron.x.terms();
+  term_lb->resize(terms.size());
+  term_ub->resize(terms.size());
+  for (int i = 0; i < terms.size(); ++i) {
+    const Bounds bounds =
+        terms[i].second * Bounds(terms[i].first->lb(), terms[i].first->ub());
+    CheckFinite(bounds, name);
+    (*term_lb)[i] = bounds.lb();
+    (*term_ub)[i] = bounds.ub();
+  }
+}
+
+// The inequality of the ideal formulation for the subset I of the terms of
+// neuron.x, as lhs <= 0:
+//   y <= sum_{i in I} (w_i v_i - term_lb_i (1 - z))
+//        + (b + sum_{i not in I} term_ub_i) z
+SparseLinearExpr IdealReluRow(const BigMRelu& neuron,
+                              const std::vector<double>& term_lb,
+                              const std::vector<double>& term_ub,
+                              const std::vector<bool>& in_subset) {
+  const std::vector<SparseLinearExpr::Term>& terms = neuron.x.terms();
+  SparseLinearExpr result = neuron.y;
+  double z_coefficient = neuron.x.offset();
+  for (int i = 0; i < terms.size(); ++i) {
+    if (in_subset[i]) {
+      result -= terms[i].second * SparseLinearExpr(terms[i].first);
+      result += term_lb[i];
+      z_coefficient += term_lb[i];
+    } else {
+      z_coefficient += term_ub[i];
+    }
+  }
+  result -= z_coefficient * neuron.z;
+  return result;
+}
+
+// The inequalities of the ideal formulation for the subsets I of the terms of
+// x other than the empty set and the full set, which are the big-M
+// inequalities.
+void AddIdealReluRows(const BigMRelu& neuron, const std::string& name,
+                      MPSolver* solver) {
+  const int num_terms = neuron.x.terms().size();
+  CHECK_LE(num_terms, kMaxIdealExponentialTerms)
+      << "Too many terms for the ideal formulation of ReLU: " << name;
+  std::vector<double> term_lb;
+  std::vector<double> term_ub;
+  ComputeTermBounds(neuron, name, &term_lb, &term_ub);
+  std::vector<bool> in_subset(num_terms);
+  for (uint32_t subset = 1; subset + 1 < (uint32_t{1} << num_terms);
+       ++subset) {
+    for (int i = 0; i < num_terms; ++i) {
+      in_subset[i] = subset & (uint32_t{1} << i);
+    }
+    AddRow(-kInf, IdealReluRow(neuron, term_lb, term_ub, in_subset), 0.0,
+           solver);
+  }
+}
+
+double Clip(const double value, const double cap) {
+  return std::min(std::max(value, 0.0), cap);
+}
+
+}  // namespace
+
+int NumBinaryVariables(const ReluImplementationType formulation) {
+  switch (formulation) {
+    case ReluImplementationType::kBigM:
+    case ReluImplementationType::kMultipleChoice:
+    case ReluImplementationType::kMultipleChoiceSimplified:
+    case ReluImplementationType::kIdealExponential:
+      return 1;
+    case ReluImplementationType::kBigMRelaxation:
+      return 0;
+  }
+  LOG(FATAL) << "Unknown ReLU formulation: " << formulation;
+}
+
+int NumBinaryVariables(const ClippedReluImplementationType formulation) {
+  switch (formulation) {
+    case ClippedReluImplementationType::kCompositeDirect:
+    case ClippedReluImplementationType::kCompositeExtended:
+    case ClippedReluImplementationType::kIncrementalBigM:
+      return 2;
+    case ClippedReluImplementationType::kExtendedXExclusion:
+    case ClippedReluImplementationType::kExtendedYExclusion:
+    case ClippedReluImplementationType::kUnaryBigM:
+      return 3;
+  }
+  LOG(FATAL) << "Unknown clipped ReLU formulation: " << formulation;
+}
+
+BigMRelu EncodeBigMRelu(const SparseLinearExpr& x, const Bounds x_bounds,
+                        const bool relax, const std::string& name,
+                        MPSolver* solver) {
+  CheckFinite(x_bounds, name);
+  const double lb = x_bounds.lb();
+  const double ub = x_bounds.ub();
+  BigMRelu result;
+  result.x = x;
+  result.x.Canonicalize();
+  result.y =
+      NewContinuous(std::max(lb, 0.0), std::max(ub, 0.0), name, solver);
+  result.z = relax
+                 ? NewContinuous(0.0, 1.0, absl::StrCat(name, "_z"), solver)
+                 : NewBinary(absl::StrCat(name, "_z"), solver);
+  AddReluBigMRows(result.x, result.y, result.z, lb, ub, solver);
+  return result;
+}
+
+std::optional<IdealReluCut> SeparateIdealReluCut(const BigMRelu& neuron,
+                                                 const double tolerance) {
+  std::vector<double> term_lb;
+  std::vector<double> term_ub;
+  ComputeTermBounds(neuron, neuron.y.AsVariable()->name(), &term_lb,
+                    &term_ub);
+  // Each term contributes w_i v_i - term_lb_i (1 - z) to the right-hand side
+  // if it is in I, and term_ub_i z otherwise: the most violated inequality
+  // takes the smallest of the two.
+  const std::vector<SparseLinearExpr::Term>& terms = neuron.x.terms();
+  const double z = neuron.z.SolutionValue();
+  std::vector<bool> in_subset(terms.size());
+  for (int i = 0; i < terms.size(); ++i) {
+    const double term = terms[i].second * terms[i].first->solution_value();
+    in_subset[i] = term - term_lb[i] * (1.0 - z) < term_ub[i] * z;
+  }
+  IdealReluCut cut;
+  cut.lhs = IdealReluRow(neuron, term_lb, term_ub, in_subset);
+  cut.violation = cut.lhs.SolutionValue();
+  if (cut.violation <= tolerance) return std::nullopt;
+  return cut;
+}
+
+SparseLinearExpr EncodeRelu(const SparseLinearExpr& x, const Bounds x_bounds,
+                            const ReluImplementationType formulation,
+                            const std::string& name, MPSolver* solver) {
+  CheckFinite(x_bounds, name);
+  const double lb = x_bounds.lb();
+  const double ub = x_bounds.ub();
+  switch (formulation) {
+    case ReluImplementationType::kBigM:
+    case ReluImplementationType::kMultipleChoiceSimplified:
+    case ReluImplementationType::kBigMRelaxation:
+    case ReluImplementationType::kIdealExponential: {
+      const BigMRelu neuron = EncodeBigMRelu(
+          x, x_bounds,
+          /*relax=*/formulation == ReluImplementationType::kBigMRelaxation,
+          name, solver);
+      if (formulation == ReluImplementationType::kIdealExponential) {
+        AddIdealReluRows(neuron, name, solver);
+      }
+      return neuron.y;
+    }
+    case ReluImplementationType::kMultipleChoice: {
+      const SparseLinearExpr x0 = NewContinuous(
+          std::min(lb, 0.0), 0.0, absl::StrCat(name, "_x0"), solver);
+      const SparseLinearExpr x1 =
+          NewContinuous(0.0, std::max(ub, 0.0), name, solver);
+      const SparseLinearExpr z = NewBinary(absl::StrCat(name, "_z"), solver);
+      AddRow(0.0, x0 + x1 - x, 0.0, solver);
+      AddRow(lb, x0 + lb * z, kInf, solver);
+      AddRow(-kInf, x1 - ub * z, 0.0, solver);
+      return x1;
+    }
+  }
+  LOG(FATAL) << "Unknown ReLU formulation: " << formulation;
+}
+
+SparseLinearExpr EncodeClippedRelu(
+    const SparseLinearExpr& x, const Bounds x_bounds, const double cap,
+    const ClippedReluImplementationType formulation, const std::string& name,
+    MPSolver* solver) {
+  CheckFinite(x_bounds, name);
+  CHECK_GT(cap, 0.0);
+  const double lb = x_bounds.lb();
+  const double ub = x_bounds.ub();
+  switch (formulation) {
+    case ClippedReluImplementationType::kCompositeDirect:
+    case ClippedReluImplementationType::kCompositeExtended: {
+      const ReluImplementationType relu_formulation =
+          formulation == ClippedReluImplementationType::kCompositeDirect
+              ? ReluImplementationType::kBigM
+              : ReluImplementationType::kMultipleChoice;
+      return EncodeRelu(x, x_bounds, relu_formulation,
+                        absl::StrCat(name, "_relu"), solver) -
+             EncodeRelu(x - cap, x_bounds - cap, relu_formulation,
+                        absl::StrCat(name, "_cap"), solver);
+    }
+    case ClippedReluImplementationType::kExtendedXExclusion:
+    case ClippedReluImplementationType::kExtendedYExclusion: {
+      const SparseLinearExpr y =
+          NewContinuous(Clip(lb, cap), Clip(ub, cap), name, solver);
+      const SparseLinearExpr z0 = NewBinary(absl::StrCat(name, "_z0"), solver);
+      const SparseLinearExpr z1 = NewBinary(absl::StrCat(name, "_z1"), solver);
+      const SparseLinearExpr z2 = NewBinary(absl::StrCat(name, "_z2"), solver);
+      AddRow(1.0, z0 + z1 + z2, 1.0, solver);
+      // The copies of x on the middle piece, where y = x, and on the top
+      // piece, where y = cap.
+      const SparseLinearExpr x1 =
+          NewContinuous(0.0, cap, absl::StrCat(name, "_x1"), solver);
+      const SparseLinearExpr x2 = NewContinuous(
+          0.0, std::max(ub, 0.0), absl::StrCat(name, "_x2"), solver);
+      AddRow(0.0, x1 - std::max(lb, 0.0) * z1, kInf, solver);
+      AddRow(-kInf, x1 - std::min(ub, cap) * z1, 0.0, solver);
+      AddRow(0.0, x2 - std::max(lb, cap) * z2, kInf, solver);
+      AddRow(-kInf, x2 - ub * z2, 0.0, solver);
+      AddRow(0.0, y - x1 - cap * z2, 0.0, solver);
+      // The copy of x on the bottom piece, where y = 0, is x0 = x - x1 - x2.
+      SparseLinearExpr x0 = x - x1 - x2;
+      if (formulation == ClippedReluImplementationType::kExtendedYExclusion) {
+        x0 = NewContinuous(std::min(lb, 0.0), 0.0, absl::StrCat(name, "_x0"),
+                           solver);
+        AddRow(0.0, x0 + x1 + x2 - x, 0.0, solver);
+      }
+      AddRow(0.0, x0 - lb * z0, kInf, solver);
+      AddRow(-kInf, x0 - std::min(ub, 0.0) * z0, 0.0, solver);
+      return y;
+    }
+    case ClippedReluImplementationType::kUnaryBigM: {
+      const SparseLinearExpr y =
+          NewContinuous(Clip(lb, cap), Clip(ub, cap), name, solver);
+      const SparseLinearExpr z0 = NewBinary(absl::StrCat(name, "_z0"), solver);
+      const SparseLinearExpr z1 = NewBinary(absl::StrCat(name, "_z1"), solver);
+      const SparseLinearExpr z2 = NewBinary(absl::StrCat(name, "_z2"), solver);
+      AddRow(1.0, z0 + z1 + z2, 1.0, solver);
+      // z0: x <= 0 and y = 0.
+      AddRow(-kInf, x + ub * z0, ub, solver);
+      AddRow(-kInf, y + cap * z0, cap, solver);
+      // z1: 0 <= x <= cap and y = x.
+      AddRow(lb, x + lb * z1, kInf, solver);
+      AddRow(-kInf, x + (ub - cap) * z1, ub, solver);
+      AddRow(-kInf, y - x + (cap - lb) * z1, cap - lb, solver);
+      AddRow(-ub, y - x - ub * z1, kInf, solver);
+      // z2: x >= cap and y = cap.
+      AddRow(lb, x - (cap - lb) * z2, kInf, solver);
+      AddRow(0.0, y - cap * z2, kInf, solver);
+      return y;
+    }
+    case ClippedReluImplementationType::kIncrementalBigM: {
+      const SparseLinearExpr y =
+          NewContinuous(Clip(lb, cap), Clip(ub, cap), name, solver);
+      // z1: x >= 0, z2: x >= cap.
+      const SparseLinearExpr z1 = NewBinary(absl::StrCat(name, "_z1"), solver);
+      const SparseLinearExpr z2 = NewBinary(absl::StrCat(name, "_z2"), solver);
+      AddRow(-kInf, z2 - z1, 0.0, solver);
+      AddRow(-kInf, x - ub * z1, 0.0, solver);
+      AddRow(lb, x + lb * z1, kInf, solver);
+      AddRow(-kInf, x - (ub - cap) * z2, cap, solver);
+      AddRow(lb, x - (cap - lb) * z2, kInf, solver);
+      AddRow(-kInf, y - cap * z1, 0.0, solver);
+      AddRow(0.0, y - cap * z2, kInf, solver);
+      AddRow(-kInf, y - x - lb * z1, -lb, solver);
+      AddRow(0.0, y - x + (ub - cap) * z2, kInf, solver);
+      return y;
+    }
+  }
+  LOG(FATAL) << "Unknown clipped ReLU formulation: " << formulation;
+}
+
+std::vector<int> UndominatedIndices(const std::vector<Bounds>& bounds) {
+  if (bounds.empty()) return {};
+  int best = 0;
+  for (int i = 1; i < bounds.size(); ++i) {
+    if (bounds[i].lb() > bounds[best].lb()) best = i;
+  }
+  std::vector<int> result;
+  for (int i = 0; i < bounds.size(); ++i) {
+    if (i == best || bounds[i].ub() > bounds[best].lb()) result.push_back(i);
+  }
+  return result;
+}
+
+SparseLinearExpr EncodeMaximum(const std::vector<SparseLinearExpr>& xs,
+                               const std::vector<Bounds>& x_bounds,
+                               const MaximumImplementationType formulation,
+                               const std::string& name, MPSolver* solver) {
+  CHECK(!xs.empty());
+  CHECK_EQ(xs.size(), x_bounds.size());
+  const std::vector<int> candidates = UndominatedIndices(x_bounds);
+  if (candidates.size() == 1) return xs[candidates[0]];
+  if (candidates.size() < xs.size()) {
+    std::vector<SparseLinearExpr> candidate_xs;
+    std::vector<Bounds> candidate_bounds;
+    for (const int i : candidates) {
+      candidate_xs.push_back(xs[i]);
+      candidate_bounds.push_back(x_bounds[i]);
+    }
+    return EncodeMaximum(candidate_xs, candidate_bounds, formulation, name,
+                         solver);
+  }
+  const int n = xs.size();
+  const std::vector<Bounds>& bounds = x_bounds;
+  const Bounds y_bounds = Max(bounds);
+  const SparseLinearExpr y =
+      NewContinuous(y_bounds.lb(), y_bounds.ub(), name, solver);
+  for (const SparseLinearExpr& x : xs) {
+    AddRow(0.0, y - x, kInf, solver);
+  }
+  if (formulation == MaximumImplementationType::kEpigraph) return y;
+  for (const Bounds b : bounds) {
+    CheckFinite(b, name);
+  }
+  // The smallest M_i such that y <= x_i + M_i whatever the maximum.
+  const auto optimal_big_m = [&bounds, n](const int i) {
+    double max_other_ub = -kInf;
+    for (int j = 0; j < n; ++j) {
+      if (j != i) max_other_ub = std::max(max_other_ub, bounds[j].ub());
+    }
+    return max_other_ub - bounds[i].lb();
+  };
+
+  if (formulation == MaximumImplementationType::kLogarithmicBigM) {
+    int num_bits = 0;
+    while ((int64_t{1} << num_bits) < n) ++num_bits;
+    std::vector<SparseLinearExpr> bits;
+    SparseLinearExpr index;
+    for (int b = 0; b < num_bits; ++b) {
+      bits.push_back(NewBinary(absl::StrCat(name, "_w", b), solver));
+      index += static_cast<double>(int64_t{1} << b) * bits.back();
+    }
+    AddRow(0.0, index, n - 1, solver);
+    for (int i = 0; i < n; ++i) {
+      // y <= x_i + M_i * (number of bits of the selected index that differ
+      // from those of i).
+      const double big_m = std::max(optimal_big_m(i), 0.0);
+      SparseLinearExpr num_different_bits;
+      for (int b = 0; b < num_bits; ++b) {
+        if (i & (1 << b)) {
+          num_different_bits += 1.0;
+          num_different_bits -= bits[b];
+        } else {
+          num_different_bits += bits[b];
+        }
+      }
+      AddRow(-kInf, y - xs[i] - big_m * num_different_bits, 0.0, solver);
+    }
+    return y;
+  }
+
+  std::vector<SparseLinearExpr> z;
+  SparseLinearExpr sum_z;
+  for (int i = 0; i < n; ++i) {
+    z.push_back(NewBinary(absl::StrCat(name, "_z", i), solver));
+    sum_z += z.back();
+  }
+  AddRow(1.0, sum_z, 1.0, solver);
+  switch (formulation) {
+    case MaximumImplementationType::kBigM: {
+      double min_lb = kInf;
+      for (const Bounds b : bounds) {
+        min_lb = std::min(min_lb, b.lb());
+      }
+      const double big_m = y_bounds.ub() - min_lb;
+      for (int i = 0; i < n; ++i) {
+        AddRow(-kInf, y - xs[i] + big_m * z[i], big_m, solver);
+      }
+      return y;
+    }
+    case MaximumImplementationType::kOptimalBigM: {
+      for (int i = 0; i < n; ++i) {
+        const double big_m = optimal_big_m(i);
+        AddRow(-kInf, y - xs[i] + big_m * z[i], big_m, solver);
+      }
+      return y;
+    }
+    case MaximumImplementationType::kTightenedBigM: {
+      for (int i = 0; i < n; ++i) {
+        SparseLinearExpr row = y - xs[i];
+        for (int j = 0; j < n; ++j) {
+          if (j != i) row -= (bounds[j].ub() - bounds[i].lb()) * z[j];
+        }
+        AddRow(-kInf, row, 0.0, solver);
+      }
+      return y;
+    }
+    case MaximumImplementationType::kExtended: {
+      // copies[k][j] is the copy of x_j when x_k is the maximum.
+      std::vector<std::vector<SparseLinearExpr>> copies(n);
+      std::vector<SparseLinearExpr> sum_copies(n);
+      SparseLinearExpr y_copies;
+      for (int k = 0; k < n; ++k) {
+        for (int j = 0; j < n; ++j) {
+          copies[k].push_back(NewContinuous(
+              std::min(bounds[j].lb(), 0.0), std::max(bounds[j].ub(), 0.0),
+              absl::StrCat(name, "_x", j, "_", k), solver));
+          AddRow(0.0, copies[k][j] - bounds[j].lb() * z[k], kInf, solver);
+          AddRow(-kInf, copies[k][j] - bounds[j].ub() * z[k], 0.0, solver);
+          sum_copies[j] += copies[k][j];
+        }
+        for (int j = 0; j < n; ++j) {
+          if (j != k) AddRow(-kInf, copies[k][j] - copies[k][k], 0.0, solver);
+        }
+        y_copies += copies[k][k];
+      }
+      for (int j = 0; j < n; ++j) {
+        AddRow(0.0, sum_copies[j] - xs[j], 0.0, solver);
+      }
+      AddRow(0.0, y - y_copies, 0.0, solver);
+      return y;
+    }
+    case MaximumImplementationType::kLogarithmicBigM:
+    case MaximumImplementationType::kEpigraph:
+      break;
+  }
+  LOG(FATAL) << "Unknown maximum formulation: " << formulation;
+}
+
+}  // namespace tf_opt
@@ -0,0 +1,152 @@
+// Copyright 2026 The tf.opt Authors.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+// MIP formulations of the nonlinear neurons of a network, for the
+// formulations listed by ReluImplementationType, ClippedReluImplementationType
+// and MaximumImplementationType.
+//
+// Each function adds variables and constraints to solver to model y = f(x),
+// and returns y. The bounds of the inputs are given by the caller, e.g. from
+// SparseLinearExpr::ComputeBounds() or from a bound propagation, and must be
+// finite unless stated otherwise. The tighter the bounds, the tighter the
+// formulation.
+#ifndef TF_OPT_OPTIMIZE_MIP_NEURON_FORMULATIONS_H_
+#define TF_OPT_OPTIMIZE_MIP_NEURON_FORMULATIONS_H_
+
+#include <optional>
+#include <string>
+#include <vector>
+
+#include "ortools/linear_solver/linear_solver.h"
+#include "tf_opt/bounds/bounds.h"
+#include "tf_opt/neural_net/neuron/clipped_relu_impl_type.h"
+#include "tf_opt/neural_net/neuron/maximum_impl_type.h"
+#include "tf_opt/neural_net/neuron/relu_impl_type.h"
+#include "tf_opt/optimize/mip/sparse_linear_expr.h"
+
+namespace tf_opt {
+
+// The largest number of terms of the input of a ReLU with the
+// kIdealExponential formulation, which has 2^n - 2 constraints for n terms.
+constexpr int kMaxIdealExponentialTerms = 16;
+
+// The number of binary variables of one neuron with the given formulation.
+int NumBinaryVariables(ReluImplementationType formulation);
+int NumBinaryVariables(ClippedReluImplementationType formulation);
+
+// The variables of a ReLU y = max(0, x) with the big-M formulation.
+struct BigMRelu {
+  // The input, with canonical terms (see SparseLinearExpr::Canonicalize()).
+  SparseLinearExpr x;
+
+  // The output variable.
+  SparseLinearExpr y;
+
+  // The indicator of x >= 0: binary, or in [0, 1] for the relaxation.
+  SparseLinearExpr z;
+};
+
+// An inequality lhs <= 0 of the ideal formulation of a ReLU.
+struct IdealReluCut {
+  SparseLinearExpr lhs;
+
+  // The value of lhs in the last solution of the solver.
+  double violation = 0.0;
+};
+
+// Models y = max(0, x) with the rows of kBigM below, where z is continuous if
+// "relax", and returns the variables.
+BigMRelu EncodeBigMRelu(const SparseLinearExpr& x, Bounds x_bounds,
+                        bool relax, const std::string& name,
+                        operations_research::MPSolver* solver);
+
+// Returns the inequality of the ideal formulation of neuron (see
+// kIdealExponential below) that is the most violated by the last solution of
+// the solver, or nullopt if none is violated by more than tolerance. Each
+// term of x is in the subset I when it gives the smallest right-hand side,
+// so that the separation takes time linear in the number of terms, instead
+// of trying all 2^n subsets. The bounds of the variables of x must be
+// finite.
+std::optional<IdealReluCut> SeparateIdealReluCut(const BigMRelu& neuron,
+                                                 double tolerance);
+
+// Models y = max(0, x), where the bounds of x are x_bounds, which may be
+// tighter than the bounds computed from its variables.
+//
+//   * kBigM:  y >= x, y <= x - lb (1 - z), y <= ub z, with z binary.
+//   * kBigMRelaxation: the same, with z in [0, 1] (the triangle relaxation).
+//   * kMultipleChoice: x = x0 + x1, y = x1, lb (1 - z) <= x0 <= 0 and
+//       0 <= x1 <= ub z, with z binary.
+//   * kMultipleChoiceSimplified: kMultipleChoice with x0 substituted, which
+//       for a single input expression gives the rows of kBigM.
+//   * kIdealExponential: the ideal formulation of y = max(0, w.v + b) over
+//       the box of the variables v of x (Anderson et al., "Strong
+//       mixed-integer programming formulations for trained neural networks",
+//       2020): kBigM plus, for each subset I of the terms,
+//         y <= sum_{i in I} w_i (v_i - L_i (1 - z))
+//              + (b + sum_{i not in I} w_i U_i) z,
+//       where [L_i, U_i] are the bounds of v_i, swapped if w_i < 0. Requires
+//       at most kMaxIdealExponentialTerms terms.
+SparseLinearExpr EncodeRelu(const SparseLinearExpr& x, Bounds x_bounds,
+                            ReluImplementationType formulation,
+                            const std::string& name,
+                            operations_research::MPSolver* solver);
+
+// Models y = min(max(0, x), cap), where the bounds of x are x_bounds.
+//
+//   * kCompositeDirect: y = max(0, x) - max(0, x - cap), with two kBigM
+//       ReLUs.
+//   * kCompositeExtended: the same with two kMultipleChoice ReLUs.
+//   * kExtendedXExclusion, kExtendedYExclusion: the disjunctive formulation
+//       of the three pieces (x <= 0, 0 <= x <= cap and x >= cap), with one
+//       binary per piece, where either the copies of x or the copies of y are
+//       projected out.
+//   * kUnaryBigM: one binary per piece, with big-M constraints for each.
+//   * kIncrementalBigM: binaries z1 >= z2 for x >= 0 and x >= cap.
+SparseLinearExpr EncodeClippedRelu(const SparseLinearExpr& x, Bounds x_bounds,
+                                   double cap,
+                                   ClippedReluImplementationType formulation,
+                                   const std::string& name,
+                                   operations_research::MPSolver* solver);
+
+// The indices of the inputs of a maximum, with the given bounds, that can be
+// larger than all others: an input whose upper bound is at most the largest
+// lower bound is dominated by the input with that lower bound, and is never
+// needed to compute the maximum. The result is sorted and not empty when
+// bounds is not empty.
+std::vector<int> UndominatedIndices(const std::vector<Bounds>& bounds);
+
+// Models y = max(xs), where xs is not empty and the bounds of xs[i] are
+// x_bounds[i]. The dominated inputs are dropped first (see
+// UndominatedIndices()), and when a single input remains, it is returned
+// as is. Otherwise, with one binary z_i per input selecting the maximum
+// (sum_i z_i = 1), and y >= x_i for all i:
+//   * kBigM: y <= x_i + M (1 - z_i), with M = max_j ub_j - min_j lb_j.
+//   * kOptimalBigM: y <= x_i + M_i (1 - z_i), with M_i = max_{j != i} ub_j -
+//       lb_i, the smallest valid constant.
+//   * kTightenedBigM: y <= x_i + sum_{j != i} (ub_j - lb_i) z_j.
+//   * kLogarithmicBigM: the binary encoding of the selected index, with
+//       ceil(log2(n)) binaries instead of n.
+//   * kExtended: the disjunctive formulation, with a copy of every input for
+//       each choice of the maximum (n^2 continuous variables).
+//   * kEpigraph: only y >= x_i, a relaxation, for use when y is minimized.
+SparseLinearExpr EncodeMaximum(const std::vector<SparseLinearExpr>& xs,
+                               const std::vector<Bounds>& x_bounds,
+                               MaximumImplementationType formulation,
+                               const std::string& name,
+                               operations_research::MPSolver* solver);
+
+}  // namespace tf_opt
+
+#endif  // TF_OPT_OPTIMIZE_MIP_NEURON_FORMULATIONS_H_
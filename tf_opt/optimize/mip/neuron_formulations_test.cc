@@ -0,0 +1,240 @@
+// Copyright 2026 The tf.opt Authors.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "tf_opt/optimize/mip/neuron_formulations.h"
+
+#include <algorithm>
+#include <string>
+#include <vector>
+
+#include "gmock/gmock.h"
+#include "gtest/gtest.h"
+#include "ortools/base/logging.h"
+#include "ortools/linear_solver/linear_solver.h"
+#include "tf_opt/bounds/bounds.h"
+#include "tf_opt/neural_net/neuron/clipped_relu_impl_type.h"
+#include "tf_opt/neural_net/neuron/maximum_impl_type.h"
+#include "tf_opt/neural_net/neuron/relu_impl_type.h"
+#include "tf_opt/optimize/mip/sparse_linear_expr.h"
+
+namespace tf_opt {
+namespace {
+
+using operations_research::MPSolver;
+using ::testing::ElementsAre;
+using ::testing::IsEmpty;
+
+constexpr double kTolerance = 1e-6;
+
+// Solves the model for y with x fixed, maximizing y if "maximize", and
+// minimizing it otherwise. A formulation is exact at x when both agree with
+// f(x).
+double SolveFor(const SparseLinearExpr& y, const bool maximize,
+                MPSolver* solver) {
+  solver->MutableObjective()->Clear();
+  for (const auto& [variable, coefficient] : y.terms()) {
+    solver->MutableObjective()->SetCoefficient(
+        variable,
+        solver->MutableObjective()->GetCoefficient(variable) + coefficient);
+  }
+  solver->MutableObjective()->SetOptimizationDirection(maximize);
+  CHECK_EQ(solver->Solve(), MPSolver::OPTIMAL);
+  return y.SolutionValue();
+}
+
+int NumIntegerVariables(const MPSolver& solver) {
+  int result = 0;
+  for (int i = 0; i < solver.NumVariables(); ++i) {
+    if (solver.variable(i)->integer()) ++result;
+  }
+  return result;
+}
+
+const std::vector<double>& TestPoints() {
+  static const auto* const kPoints =
+      new std::vector<double>({-2.0, -0.5, 0.0, 0.25, 1.0, 1.5, 3.0});
+  return *kPoints;
+}
+
+class ReluFormulationTest
+    : public ::testing::TestWithParam<ReluImplementationType> {};
+
+TEST_P(ReluFormulationTest, ExactAtFixedInput) {
+  for (const double value : TestPoints()) {
+    MPSolver solver("relu", MPSolver::SCIP_MIXED_INTEGER_PROGRAMMING);
+    // x = 2 u - v + 0.5, with v = 0.75 and u fixed so that x = value.
+    const double u = (value - 0.5 + 0.75) / 2.0;
+    const SparseLinearExpr x =
+        2.0 * SparseLinearExpr(solver.MakeNumVar(u, u, "u")) -
+        SparseLinearExpr(solver.MakeNumVar(0.75, 0.75, "v")) + 0.5;
+    const SparseLinearExpr y =
+        EncodeRelu(x, Bounds(-3.0, 3.5), GetParam(), "y", &solver);
+    EXPECT_EQ(NumIntegerVariables(solver), NumBinaryVariables(GetParam()));
+    const double expected = std::max(value, 0.0);
+    if (GetParam() == ReluImplementationType::kBigMRelaxation) {
+      // Only the lower bound is exact.
+      EXPECT_NEAR(SolveFor(y, /*maximize=*/false, &solver), expected,
+                  kTolerance);
+      continue;
+    }
+    EXPECT_NEAR(SolveFor(y, /*maximize=*/false, &solver), expected,
+                kTolerance)
+        << value;
+    EXPECT_NEAR(SolveFor(y, /*maximize=*/true, &solver), expected,
+                kTolerance)
+        << value;
+  }
+}
+
+TEST(ReluFormulationTest, IdealIsTighterThanBigM) {
+  // y = relu(x1 + x2) on [-1, 1]^2. At the LP point x1 = 1, x2 = -1, the
+  // big-M relaxation allows y = 1, and the ideal formulation y = 0.
+  for (const bool ideal : {false, true}) {
+    MPSolver solver("relu", MPSolver::GLOP_LINEAR_PROGRAMMING);
+    const SparseLinearExpr x1(solver.MakeNumVar(-1.0, 1.0, "x1"));
+    const SparseLinearExpr x2(solver.MakeNumVar(-1.0, 1.0, "x2"));
+    AddRow(1.0, x1, 1.0, &solver);
+    AddRow(-1.0, x2, -1.0, &solver);
+    const SparseLinearExpr x = x1 + x2;
+    const SparseLinearExpr y = EncodeRelu(
+        x, Bounds(-2.0, 2.0),
+        ideal ? ReluImplementationType::kIdealExponential
+              : ReluImplementationType::kBigM,
+        "y", &solver);
+    EXPECT_NEAR(SolveFor(y, /*maximize=*/true, &solver), ideal ? 0.0 : 1.0,
+                kTolerance);
+  }
+}
+
+INSTANTIATE_TEST_SUITE_P(
+    AllFormulations, ReluFormulationTest,
+    ::testing::Values(ReluImplementationType::kBigM,
+                      ReluImplementationType::kMultipleChoice,
+                      ReluImplementationType::kMultipleChoiceSimplified,
+                      ReluImplementationType::kIdealExponential,
+                      ReluImplementationType::kBigMRelaxation));
+
+class ClippedReluFormulationTest
+    : public ::testing::TestWithParam<ClippedReluImplementationType> {};
+
+TEST_P(ClippedReluFormulationTest, ExactAtFixedInput) {
+  constexpr double kCap = 1.0;
+  for (const double value : TestPoints()) {
+    MPSolver solver("clipped_relu", MPSolver::SCIP_MIXED_INTEGER_PROGRAMMING);
+    const SparseLinearExpr x(solver.MakeNumVar(value, value, "x"));
+    const SparseLinearExpr y = EncodeClippedRelu(x, Bounds(-2.0, 3.0), kCap,
+                                                 GetParam(), "y", &solver);
+    EXPECT_EQ(NumIntegerVariables(solver), NumBinaryVariables(GetParam()));
+    const double expected = std::min(std::max(value, 0.0), kCap);
+    EXPECT_NEAR(SolveFor(y, /*maximize=*/false, &solver), expected,
+                kTolerance)
+        << value;
+    EXPECT_NEAR(SolveFor(y, /*maximize=*/true, &solver), expected,
+                kTolerance)
+        << value;
+  }
+}
+
+INSTANTIATE_TEST_SUITE_P(
+    AllFormulations, ClippedReluFormulationTest,
+    ::testing::Values(ClippedReluImplementationType::kCompositeDirect,
+                      ClippedReluImplementationType::kCompositeExtended,
+                      ClippedReluImplementationType::kExtendedXExclusion,
+                      ClippedReluImplementationType::kExtendedYExclusion,
+                      ClippedReluImplementationType::kUnaryBigM,
+                      ClippedReluImplementationType::kIncrementalBigM));
+
+class MaximumFormulationTest
+    : public ::testing::TestWithParam<MaximumImplementationType> {};
+
+TEST_P(MaximumFormulationTest, ExactAtFixedInputs) {
+  const std::vector<Bounds> bounds = {Bounds(-1.0, 2.0), Bounds(0.0, 1.0),
+                                      Bounds(-3.0, 0.5)};
+  const std::vector<std::vector<double>> points = {
+      {1.5, 0.5, -2.0}, {-1.0, 0.5, 0.0}, {0.0, 0.0, 0.5}, {-1.0, 0.0, -3.0}};
+  for (const std::vector<double>& point : points) {
+    MPSolver solver("maximum", MPSolver::SCIP_MIXED_INTEGER_PROGRAMMING);
+    std::vector<SparseLinearExpr> xs;
+    for (int i = 0; i < point.size(); ++i) {
+      xs.emplace_back(solver.MakeNumVar(point[i], point[i], "x"));
+    }
+    const SparseLinearExpr y =
+        EncodeMaximum(xs, bounds, GetParam(), "y", &solver);
+    const double expected = *std::max_element(point.begin(), point.end());
+    EXPECT_NEAR(SolveFor(y, /*maximize=*/false, &solver), expected,
+                kTolerance);
+    if (GetParam() != MaximumImplementationType::kEpigraph) {
+      EXPECT_NEAR(SolveFor(y, /*maximize=*/true, &solver), expected,
+                  kTolerance);
+    }
+  }
+}
+
+TEST(MaximumFormulationTest, SingleInputAddsNothing) {
+  MPSolver solver("maximum", MPSolver::SCIP_MIXED_INTEGER_PROGRAMMING);
+  const SparseLinearExpr x(solver.MakeNumVar(0.0, 1.0, "x"));
+  const SparseLinearExpr y = EncodeMaximum(
+      {x}, {Bounds(0.0, 1.0)}, MaximumImplementationType::kBigM, "y",
+      &solver);
+  EXPECT_EQ(y.AsVariable(), x.AsVariable());
+  EXPECT_EQ(solver.NumVariables(), 1);
+  EXPECT_EQ(solver.NumConstraints(), 0);
+}
+
+TEST(MaximumFormulationTest, UndominatedIndices) {
+  EXPECT_THAT(UndominatedIndices({}), IsEmpty());
+  EXPECT_THAT(UndominatedIndices({Bounds(-1.0, 0.5), Bounds(1.0, 2.0),
+                                  Bounds(0.0, 3.0), Bounds(-2.0, 1.0)}),
+              ElementsAre(1, 2));
+  // Equal constants: only one is kept.
+  EXPECT_THAT(UndominatedIndices({Bounds(1.0), Bounds(1.0), Bounds(0.0)}),
+              ElementsAre(0));
+}
+
+TEST(MaximumFormulationTest, DominatedInputsArePruned) {
+  MPSolver solver("maximum", MPSolver::SCIP_MIXED_INTEGER_PROGRAMMING);
+  std::vector<SparseLinearExpr> xs;
+  for (int i = 0; i < 4; ++i) {
+    xs.emplace_back(solver.MakeNumVar(0.0, 0.0, "x"));
+  }
+  EncodeMaximum(xs,
+                {Bounds(-1.0, 0.5), Bounds(1.0, 2.0), Bounds(0.0, 3.0),
+                 Bounds(-2.0, 1.0)},
+                MaximumImplementationType::kBigM, "y", &solver);
+  EXPECT_EQ(NumIntegerVariables(solver), 2);
+}
+
+TEST(MaximumFormulationTest, SingleSurvivorIsReturned) {
+  MPSolver solver("maximum", MPSolver::SCIP_MIXED_INTEGER_PROGRAMMING);
+  const SparseLinearExpr x0(solver.MakeNumVar(2.0, 3.0, "x0"));
+  const SparseLinearExpr x1(solver.MakeNumVar(0.0, 2.0, "x1"));
+  const SparseLinearExpr y =
+      EncodeMaximum({x0, x1}, {Bounds(2.0, 3.0), Bounds(0.0, 2.0)},
+                    MaximumImplementationType::kExtended, "y", &solver);
+  EXPECT_EQ(y.AsVariable(), x0.AsVariable());
+  EXPECT_EQ(solver.NumVariables(), 2);
+  EXPECT_EQ(solver.NumConstraints(), 0);
+}
+
+INSTANTIATE_TEST_SUITE_P(
+    AllFormulations, MaximumFormulationTest,
+    ::testing::Values(MaximumImplementationType::kBigM,
+                      MaximumImplementationType::kExtended,
+                      MaximumImplementationType::kTightenedBigM,
+                      MaximumImplementationType::kOptimalBigM,
+                      MaximumImplementationType::kLogarithmicBigM,
+                      MaximumImplementationType::kEpigraph));
+
+}  // namespace
+}  // namespace tf_opt
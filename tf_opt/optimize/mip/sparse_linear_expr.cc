@@ -0,0 +1,143 @@
+// Copyright 2026 The tf.opt Authors.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "tf_opt/optimize/mip/sparse_linear_expr.h"
+
+#include <algorithm>
+#include <string>
+#include <vector>
+
+#include "ortools/base/logging.h"
+#include "absl/strings/str_cat.h"
+#include "ortools/linear_solver/linear_solver.h"
+#include "tf_opt/bounds/bounds.h"
+
+namespace tf_opt {
+
+using operations_research::MPConstraint;
+using operations_research::MPSolver;
+using operations_research::MPVariable;
+
+const MPVariable* SparseLinearExpr::AsVariable() const {
+  if (terms_.size() != 1 || terms_[0].second != 1.0 || offset_ != 0.0) {
+    return nullptr;
+  }
+  return terms_[0].first;
+}
+
+void SparseLinearExpr::Canonicalize() {
+  std::sort(terms_.begin(), terms_.end(),
+            [](const Term& a, const Term& b) {
+              return a.first->index() < b.first->index();
+            });
+  int size = 0;
+  for (int i = 0; i < terms_.size(); ++i) {
+    if (size > 0 && terms_[size - 1].first == terms_[i].first) {
+      terms_[size - 1].second += terms_[i].second;
+    } else {
+      terms_[size++] = terms_[i];
+    }
+  }
+  terms_.resize(size);
+  terms_.erase(std::remove_if(terms_.begin(), terms_.end(),
+                              [](const Term& term) {
+                                return term.second == 0.0;
+                              }),
+               terms_.end());
+}
+
+Bounds SparseLinearExpr::ComputeBounds() const {
+  Bounds result(offset_);
+  for (const auto& [variable, coefficient] : terms_) {
+    // Skips zeros, which could otherwise multiply infinite bounds.
+    if (coefficient == 0.0) continue;
+    result += coefficient * Bounds(variable->lb(), variable->ub());
+  }
+  return result;
+}
+
+double SparseLinearExpr::SolutionValue() const {
+  double result = offset_;
+  for (const auto& [variable, coefficient] : terms_) {
+    result += coefficient * variable->solution_value();
+  }
+  return result;
+}
+
+SparseLinearExpr& SparseLinearExpr::operator+=(const SparseLinearExpr& rhs) {
+  terms_.insert(terms_.end(), rhs.terms_.begin(), rhs.terms_.end());
+  offset_ += rhs.offset_;
+  return *this;
+}
+
+SparseLinearExpr& SparseLinearExpr::operator-=(const SparseLinearExpr& rhs) {
+  terms_.reserve(terms_.size() + rhs.terms_.size());
+  for (const auto& [variable, coefficient] : rhs.terms_) {
+    terms_.emplace_back(variable, -coefficient);
+  }
+  offset_ -= rhs.offset_;
+  return *this;
+}
+
+SparseLinearExpr& SparseLinearExpr::operator*=(const double rhs) {
+  if (rhs == 0.0) {
+    terms_.clear();
+    offset_ = 0.0;
+    return *this;
+  }
+  for (Term& term : terms_) {
+    term.second *= rhs;
+  }
+  offset_ *= rhs;
+  return *this;
+}
+
+SparseLinearExpr& SparseLinearExpr::operator/=(const double rhs) {
+  CHECK_NE(rhs, 0.0);
+  for (Term& term : terms_) {
+    term.second /= rhs;
+  }
+  offset_ /= rhs;
+  return *this;
+}
+
+SparseLinearExpr SparseLinearExpr::operator-() const {
+  SparseLinearExpr result = *this;
+  result *= -1.0;
+  return result;
+}
+
+std::string SparseLinearExpr::ToString() const {
+  std::string result;
+  for (const auto& [variable, coefficient] : terms_) {
+    absl::StrAppend(&result, coefficient, " * ", variable->name(), " + ");
+  }
+  absl::StrAppend(&result, offset_);
+  return result;
+}
+
+MPConstraint* AddRow(const double lb, const SparseLinearExpr& expr,
+                     const double ub, MPSolver* solver,
+                     const std::string& name) {
+  SparseLinearExpr canonical = expr;
+  canonical.Canonicalize();
+  MPConstraint* const row = solver->MakeRowConstraint(
+      lb - canonical.offset(), ub - canonical.offset(), name);
+  for (const auto& [variable, coefficient] : canonical.terms()) {
+    row->SetCoefficient(variable, coefficient);
+  }
+  return row;
+}
+
+}  // namespace tf_opt
@@ -0,0 +1,136 @@
+// Copyright 2026 The tf.opt Authors.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef TF_OPT_OPTIMIZE_MIP_SPARSE_LINEAR_EXPR_H_
+#define TF_OPT_OPTIMIZE_MIP_SPARSE_LINEAR_EXPR_H_
+
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "ortools/linear_solver/linear_solver.h"
+#include "tf_opt/bounds/bounds.h"
+#include "tf_opt/tensor/tensor.h"
+
+namespace tf_opt {
+
+// An affine expression
+//   sum_i coefficient_i * variable_i + offset
+// over the variables of an MPSolver, stored as a vector of terms. Unlike
+// operations_research::LinearExpr, which holds a hash map, it is cheap to
+// build and copy for the handful of terms of a neuron, which makes it the
+// element type of the tensors built by MipEncoder.
+//
+// A variable may appear in several terms, see Canonicalize(). The arithmetic
+// operators are those needed by the tensor functions (MatMul, Conv2d, ...),
+// so that a linear layer with constant weights can be applied to a
+// Tensor<SparseLinearExpr> directly.
+class SparseLinearExpr {
+ public:
+  using Term = std::pair<const operations_research::MPVariable*, double>;
+
+  // The constant 0.
+  SparseLinearExpr() : offset_(0.0) {}
+
+  explicit SparseLinearExpr(const double constant) : offset_(constant) {}
+
+  explicit SparseLinearExpr(const operations_research::MPVariable* variable)
+      : terms_({{variable, 1.0}}), offset_(0.0) {}
+
+  const std::vector<Term>& terms() const { return terms_; }
+  double offset() const { return offset_; }
+
+  bool is_constant() const { return terms_.empty(); }
+
+  // The variable if this expression is 1 * variable + 0, and nullptr
+  // otherwise.
+  const operations_research::MPVariable* AsVariable() const;
+
+  // Merges the terms of the same variable, drops the zero coefficients, and
+  // sorts the terms by variable index.
+  void Canonicalize();
+
+  // The bounds of the expression given the bounds of its variables.
+  Bounds ComputeBounds() const;
+
+  // The value of the expression in the last solution of the solver.
+  double SolutionValue() const;
+
+  SparseLinearExpr& operator+=(const SparseLinearExpr& rhs);
+  SparseLinearExpr& operator-=(const SparseLinearExpr& rhs);
+  SparseLinearExpr& operator*=(double rhs);
+  SparseLinearExpr& operator/=(double rhs);
+
+  SparseLinearExpr& operator+=(const double rhs) {
+    offset_ += rhs;
+    return *this;
+  }
+
+  SparseLinearExpr operator-() const;
+
+  std::string ToString() const;
+
+ private:
+  std::vector<Term> terms_;
+  double offset_;
+};
+
+using SparseExprTensor = Tensor<SparseLinearExpr>;
+
+inline SparseLinearExpr operator+(SparseLinearExpr lhs,
+                                  const SparseLinearExpr& rhs) {
+  lhs += rhs;
+  return lhs;
+}
+
+inline SparseLinearExpr operator+(SparseLinearExpr lhs, const double rhs) {
+  lhs += rhs;
+  return lhs;
+}
+
+inline SparseLinearExpr operator-(SparseLinearExpr lhs,
+                                  const SparseLinearExpr& rhs) {
+  lhs -= rhs;
+  return lhs;
+}
+
+inline SparseLinearExpr operator-(SparseLinearExpr lhs, const double rhs) {
+  lhs += -rhs;
+  return lhs;
+}
+
+inline SparseLinearExpr operator*(SparseLinearExpr lhs, const double rhs) {
+  lhs *= rhs;
+  return lhs;
+}
+
+inline SparseLinearExpr operator*(const double lhs, SparseLinearExpr rhs) {
+  rhs *= lhs;
+  return rhs;
+}
+
+inline SparseLinearExpr operator/(SparseLinearExpr lhs, const double rhs) {
+  lhs /= rhs;
+  return lhs;
+}
+
+// Adds the row lb <= expr <= ub to solver, with one coefficient per distinct
+// variable of expr, and returns it.
+operations_research::MPConstraint* AddRow(
+    double lb, const SparseLinearExpr& expr, double ub,
+    operations_research::MPSolver* solver, const std::string& name = "");
+
+}  // namespace tf_opt
+
+#endif  // TF_OPT_OPTIMIZE_MIP_SPARSE_LINEAR_EXPR_H_
@@ -0,0 +1,116 @@
+// Copyright 2026 The tf.opt Authors.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "tf_opt/optimize/mip/sparse_linear_expr.h"
+
+#include <limits>
+
+#include "gmock/gmock.h"
+#include "gtest/gtest.h"
+#include "ortools/linear_solver/linear_solver.h"
+#include "tf_opt/bounds/bounds.h"
+#include "tf_opt/tensor/math.h"
+#include "tf_opt/tensor/tensor.h"
+
+namespace tf_opt {
+namespace {
+
+using operations_research::MPConstraint;
+using operations_research::MPSolver;
+using operations_research::MPVariable;
+using ::testing::ElementsAre;
+using ::testing::Pair;
+
+class SparseLinearExprTest : public ::testing::Test {
+ public:
+  SparseLinearExprTest()
+      : solver_("sparse_linear_expr_test",
+                MPSolver::GLOP_LINEAR_PROGRAMMING),
+        x_(solver_.MakeNumVar(-1.0, 2.0, "x")),
+        y_(solver_.MakeNumVar(0.0, 3.0, "y")) {}
+
+ protected:
+  MPSolver solver_;
+  const MPVariable* const x_;
+  const MPVariable* const y_;
+};
+
+TEST_F(SparseLinearExprTest, Arithmetic) {
+  const SparseLinearExpr x(x_);
+  const SparseLinearExpr y(y_);
+  SparseLinearExpr expr = 2.0 * (y + 1.0) - x * 3.0 + x / 2.0;
+  EXPECT_EQ(expr.offset(), 2.0);
+  EXPECT_THAT(expr.terms(), ElementsAre(Pair(y_, 2.0), Pair(x_, -3.0),
+                                        Pair(x_, 0.5)));
+  expr.Canonicalize();
+  EXPECT_THAT(expr.terms(), ElementsAre(Pair(x_, -2.5), Pair(y_, 2.0)));
+  EXPECT_FALSE(expr.is_constant());
+  EXPECT_EQ(expr.AsVariable(), nullptr);
+  EXPECT_EQ(x.AsVariable(), x_);
+  EXPECT_EQ((-x).AsVariable(), nullptr);
+}
+
+TEST_F(SparseLinearExprTest, CanonicalizeDropsZeros) {
+  SparseLinearExpr expr = SparseLinearExpr(x_) - SparseLinearExpr(x_) + 4.0;
+  expr.Canonicalize();
+  EXPECT_TRUE(expr.is_constant());
+  EXPECT_EQ(expr.offset(), 4.0);
+}
+
+TEST_F(SparseLinearExprTest, ComputeBounds) {
+  const SparseLinearExpr expr =
+      SparseLinearExpr(x_) - 2.0 * SparseLinearExpr(y_) + 1.0;
+  EXPECT_EQ(expr.ComputeBounds(), Bounds(-6.0, 3.0));
+  EXPECT_EQ(SparseLinearExpr(5.0).ComputeBounds(), Bounds(5.0));
+}
+
+TEST_F(SparseLinearExprTest, TensorOperations) {
+  SparseExprTensor input(Shape({1, 2}));
+  (*input.mutable_flat_values())[0] = SparseLinearExpr(x_);
+  (*input.mutable_flat_values())[1] = SparseLinearExpr(y_);
+  const SparseExprTensor result =
+      internal::MatMul<SparseLinearExpr, SparseLinearExpr, double>(
+          input, DoubleTensor(std::vector<std::vector<double>>{{1.0, 0.0},
+                                                               {2.0, -1.0}}));
+  ASSERT_EQ(result.dimension(), Shape({1, 2}));
+  EXPECT_THAT(result.flat_value(0).terms(),
+              ElementsAre(Pair(x_, 1.0), Pair(y_, 2.0)));
+  EXPECT_THAT(result.flat_value(1).terms(), ElementsAre(Pair(y_, -1.0)));
+}
+
+TEST_F(SparseLinearExprTest, AddRowMovesOffset) {
+  const SparseLinearExpr expr =
+      SparseLinearExpr(x_) + SparseLinearExpr(y_) + SparseLinearExpr(x_) -
+      3.0;
+  const MPConstraint* row = AddRow(
+      -1.0, expr, std::numeric_limits<double>::infinity(), &solver_, "row");
+  EXPECT_EQ(row->lb(), 2.0);
+  EXPECT_EQ(row->ub(), std::numeric_limits<double>::infinity());
+  EXPECT_EQ(row->GetCoefficient(x_), 2.0);
+  EXPECT_EQ(row->GetCoefficient(y_), 1.0);
+  EXPECT_EQ(row->name(), "row");
+}
+
+TEST_F(SparseLinearExprTest, SolutionValue) {
+  solver_.MutableObjective()->SetCoefficient(x_, 1.0);
+  solver_.MutableObjective()->SetCoefficient(y_, -1.0);
+  solver_.MutableObjective()->SetMaximization();
+  ASSERT_EQ(solver_.Solve(), MPSolver::OPTIMAL);
+  const SparseLinearExpr expr =
+      3.0 * SparseLinearExpr(x_) + SparseLinearExpr(y_) + 1.0;
+  EXPECT_NEAR(expr.SolutionValue(), 7.0, 1e-9);
+}
+
+}  // namespace
+}  // namespace tf_opt
@@ -17,9 +17,11 @@
 #include <algorithm>
 #include <cmath>
 #include <cstdint>
+#include <vector>
 
 #include "absl/status/statusor.h"
 #include "absl/strings/str_cat.h"
+#include "tf_opt/tensor/gemm.h"
 
 namespace tf_opt {
 
@@ -109,6 +111,78 @@ Status Conv2dValidateShapes(const Shape& input_shape,
   return OkStatus();
 }
 
+namespace {
+
+// Upper bound on the number of doubles in the im2col buffer, so that large
+// images are processed a few output pixels at a time.
+constexpr int64_t kMaxIm2colBufferSize = int64_t{1} << 22;
+
+}  // namespace
+
+DoubleTensor Conv2dIm2col(const DoubleTensor& input, const DoubleTensor& filter,
+                          const WindowExtractor2D& window_extractor) {
+  const Conv2dInputShape input_shape(&input.dimension());
+  const Conv2dFilterShape filter_shape(&filter.dimension());
+  const int64_t output_height = window_extractor.output_size().row;
+  const int64_t output_width = window_extractor.output_size().col;
+  const int64_t in_channels = input_shape.channels();
+  const int64_t out_channels = filter_shape.out_channels();
+  DoubleTensor result(Shape(
+      {input_shape.batch(), output_height, output_width, out_channels}));
+
+  // The filter, in its [height, width, in_channel, out_channel] row major
+  // layout, already is a (height * width * in_channel) x out_channel matrix.
+  const int64_t patch_size =
+      filter_shape.height() * filter_shape.width() * in_channels;
+  const int64_t num_pixels = output_height * output_width;
+  if (num_pixels == 0 || out_channels == 0) {
+    return result;
+  }
+  const int64_t pixels_per_block = std::clamp<int64_t>(
+      kMaxIm2colBufferSize / std::max<int64_t>(patch_size, 1), 1, num_pixels);
+  std::vector<double> patches(pixels_per_block * patch_size);
+
+  const int64_t input_row_size = input_shape.width() * in_channels;
+  const int64_t input_image_size = input_shape.height() * input_row_size;
+  const double* const filter_data = filter.flat_values().data();
+  for (int64_t b = 0; b < input_shape.batch(); ++b) {
+    const double* const image =
+        input.flat_values().data() + b * input_image_size;
+    double* const output = result.mutable_flat_values()->data() +
+                           b * num_pixels * out_channels;
+    for (int64_t block_start = 0; block_start < num_pixels;
+         block_start += pixels_per_block) {
+      const int64_t block_size =
+          std::min(pixels_per_block, num_pixels - block_start);
+      // Fill one row of patches per output pixel, with zeros for padding.
+      for (int64_t p = 0; p < block_size; ++p) {
+        const int64_t pixel = block_start + p;
+        const Rectangle window = window_extractor.GetWindow(
+            Position2D(pixel / output_width, pixel % output_width));
+        double* patch = patches.data() + p * patch_size;
+        for (int64_t ky = 0; ky < window.size.row; ++ky) {
+          const int64_t iy = window.start.row + ky;
+          for (int64_t kx = 0; kx < window.size.col; ++kx) {
+            const int64_t ix = window.start.col + kx;
+            if (window_extractor.IsPadding(Position2D(iy, ix))) {
+              std::fill(patch, patch + in_channels, 0.0);
+            } else {
+              const double* pixel_values =
+                  image + iy * input_row_size + ix * in_channels;
+              std::copy(pixel_values, pixel_values + in_channels, patch);
+            }
+            patch += in_channels;
+          }
+        }
+      }
+      Gemm(block_size, out_channels, patch_size, patches.data(), patch_size,
+           filter_data, out_channels, output + block_start * out_channels,
+           out_channels);
+    }
+  }
+  return result;
+}
+
 }  // namespace internal
 
 }  // namespace tf_opt
@@ -55,6 +55,7 @@
 #include <cstdint>
 #include <ostream>
 #include <string>
+#include <type_traits>
 
 #include "ortools/base/logging.h"
 #include "absl/log/die_if_null.h"
@@ -76,6 +77,13 @@ absl::Status Conv1dValidateShapes(const Shape& input_shape,
 absl::Status Conv2dValidateShapes(const Shape& input_shape,
                                   const Shape& filter_shape);
 
+// Conv2d for doubles, computed by lowering each image to a matrix with one row
+// per output pixel and one column per filter coefficient ("im2col"), and
+// multiplying it by the filter with Gemm() (see gemm.h). Shapes must already
+// be validated, and window_extractor initialized from them.
+DoubleTensor Conv2dIm2col(const DoubleTensor& input, const DoubleTensor& filter,
+                          const WindowExtractor2D& window_extractor);
+
 }  // namespace internal
 
 // These shape structs wrap a pointer to Shape. They were created for
@@ -171,6 +179,9 @@ struct Conv1dFilterShape {
 //
 // For a visualization of how strides and padding work, see
 // https://github.com/vdumoulin/conv_arithmetic.
+//
+// When all types are double, the convolution is computed as a matrix product
+// (see internal::Conv2dIm2col()).
 template <typename ResultType, typename InputType, typename FilterType>
 absl::StatusOr<Tensor<ResultType>> Conv2d(const Tensor<InputType>& input,
                                           const Tensor<FilterType>& filter,
@@ -186,6 +197,12 @@ absl::StatusOr<Tensor<ResultType>> Conv2d(const Tensor<InputType>& input,
       input_shape.RegionSize(), filter_shape.RegionSize(),
       Position2D(strides.row, strides.col), padding_type));
 
+  if constexpr (std::is_same_v<ResultType, double> &&
+                std::is_same_v<InputType, double> &&
+                std::is_same_v<FilterType, double>) {
+    return internal::Conv2dIm2col(input, filter, window_extractor);
+  }
+
   const int64_t output_batch = input_shape.batch();
   const int64_t output_height = window_extractor.output_size().row;
   const int64_t output_width = window_extractor.output_size().col;
@@ -242,6 +259,9 @@ absl::StatusOr<Tensor<ResultType>> Conv2d(const Tensor<InputType>& input,
 //   result: Will be rank 3, format: [batch, width, out_channel].
 //
 // Returns error if shapes are invalid.
+//
+// Implemented as a Conv2d with height one, so doubles also take the im2col
+// path.
 template <typename ResultType, typename InputType, typename FilterType>
 absl::StatusOr<Tensor<ResultType>> Conv1d(const Tensor<InputType>& input,
                                           const Tensor<FilterType>& filter,
@@ -20,6 +20,7 @@
 #include "gmock/gmock.h"
 #include "gtest/gtest.h"
 #include "absl/status/statusor.h"
+#include "tf_opt/bounds/bounds.h"
 #include "tf_opt/open_source/status_matchers.h"
 #include "tf_opt/tensor/shape.h"
 #include "tf_opt/tensor/tensor.h"
@@ -212,6 +213,46 @@ TEST(Conv2dTest, ValidStrideYTest_ConvOpTestForkTranspose) {
               IsOkAndHolds(DoubleTensorNear(expected_result)));
 }
 
+// Compares the im2col implementation used for doubles against the generic
+// implementation (used for all other types), on point Bounds.
+void ExpectIm2colMatchesGeneric(const Shape& input_shape,
+                                const Shape& filter_shape,
+                                const Position2D strides,
+                                const PaddingType padding) {
+  DoubleTensor input(input_shape);
+  for (int64_t i = 0; i < input.size(); ++i) {
+    input.set_flat_value(i, (i * 7 % 11) - 5.0);
+  }
+  DoubleTensor filter(filter_shape);
+  for (int64_t i = 0; i < filter.size(); ++i) {
+    filter.set_flat_value(i, (i * 5 % 13) / 4.0 - 1.5);
+  }
+  TFOPT_ASSERT_OK_AND_ASSIGN(
+      const DoubleTensor double_result,
+      (Conv2d<double, double, double>(input, filter, strides, padding)));
+  TFOPT_ASSERT_OK_AND_ASSIGN(
+      const BoundsTensor bounds_result,
+      (Conv2d<Bounds, Bounds, double>(DoubleTensorToBoundsTensor(input),
+                                      filter, strides, padding)));
+  EXPECT_THAT(DoubleTensorToBoundsTensor(double_result),
+              BoundsTensorNear(bounds_result, kTolerance));
+}
+
+TEST(Conv2dTest, Im2colMatchesGenericSamePadding) {
+  ExpectIm2colMatchesGeneric(Shape({2, 7, 5, 3}), Shape({3, 2, 3, 4}),
+                             Position2D(2, 1), PaddingType::SAME);
+}
+
+TEST(Conv2dTest, Im2colMatchesGenericValidPadding) {
+  ExpectIm2colMatchesGeneric(Shape({3, 6, 9, 2}), Shape({4, 3, 2, 5}),
+                             Position2D(1, 2), PaddingType::VALID);
+}
+
+TEST(Conv2dTest, Im2colMatchesGenericLargeFilter) {
+  ExpectIm2colMatchesGeneric(Shape({1, 12, 40, 16}), Shape({5, 5, 16, 24}),
+                             Position2D(1, 1), PaddingType::SAME);
+}
+
 // For setting up error tests.
 struct SimpleConv2dBuilder {
   DoubleTensor input;
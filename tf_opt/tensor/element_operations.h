@@ -71,6 +71,10 @@ T TfOptHighest() {
 
 // Unary element operations.
 
+// The elementwise functions that can follow a linear operation and its bias,
+// see BiasActivationInPlace() in math.h.
+enum class Activation { kIdentity, kRelu, kClippedRelu };
+
 template <typename T>
 struct ReluElement {
  public:
@@ -0,0 +1,667 @@
+// Copyright 2026 The tf.opt Authors.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "tf_opt/tensor/elementwise_kernels.h"
+
+#include <algorithm>
+#include <atomic>
+#include <cstdint>
+#include <limits>
+
+#include "ortools/base/logging.h"
+#include "tf_opt/bounds/bounds.h"
+
+#if defined(__x86_64__) && (defined(__GNUC__) || defined(__clang__))
+#define TFOPT_X86_SIMD 1
+#include <immintrin.h>
+#define TFOPT_TARGET_AVX2 __attribute__((target("avx2")))
+#define TFOPT_TARGET_AVX512 __attribute__((target("avx512f")))
+#endif
+
+namespace tf_opt {
+namespace internal {
+namespace {
+
+#ifdef TFOPT_X86_SIMD
+
+// _mm512_max_pd() and _mm512_min_pd() pass _mm512_undefined_pd() as their
+// masked-off source, which GCC reports as maybe uninitialized. With a full
+// mask, these compile to the same unmasked instructions.
+TFOPT_TARGET_AVX512 __m512d Max512(const __m512d a, const __m512d b) {
+  return _mm512_mask_max_pd(_mm512_setzero_pd(), 0xFF, a, b);
+}
+TFOPT_TARGET_AVX512 __m512d Min512(const __m512d a, const __m512d b) {
+  return _mm512_mask_min_pd(_mm512_setzero_pd(), 0xFF, a, b);
+}
+
+#endif  // TFOPT_X86_SIMD
+
+// Each op computes the same value with Scalar() and, on x86-64, with Avx2()
+// and Avx512() on 4 and 8 lanes. Scalar() matches element_operations.h, which
+// uses std::max and std::min. Note that std::max(a, b) is (a < b) ? b : a,
+// while the max_pd instructions compute (a > b) ? a : b: the operands are
+// swapped so that NaNs and signed zeros give the same result.
+
+struct AddOp {
+  static double Scalar(const double l, const double r) { return l + r; }
+#ifdef TFOPT_X86_SIMD
+  TFOPT_TARGET_AVX2 static __m256d Avx2(const __m256d l, const __m256d r) {
+    return _mm256_add_pd(l, r);
+  }
+  TFOPT_TARGET_AVX512 static __m512d Avx512(const __m512d l,
+                                            const __m512d r) {
+    return _mm512_add_pd(l, r);
+  }
+#endif
+};
+
+struct SubtractOp {
+  static double Scalar(const double l, const double r) { return l - r; }
+#ifdef TFOPT_X86_SIMD
+  TFOPT_TARGET_AVX2 static __m256d Avx2(const __m256d l, const __m256d r) {
+    return _mm256_sub_pd(l, r);
+  }
+  TFOPT_TARGET_AVX512 static __m512d Avx512(const __m512d l,
+                                            const __m512d r) {
+    return _mm512_sub_pd(l, r);
+  }
+#endif
+};
+
+struct MultiplyOp {
+  static double Scalar(const double l, const double r) { return l * r; }
+#ifdef TFOPT_X86_SIMD
+  TFOPT_TARGET_AVX2 static __m256d Avx2(const __m256d l, const __m256d r) {
+    return _mm256_mul_pd(l, r);
+  }
+  TFOPT_TARGET_AVX512 static __m512d Avx512(const __m512d l,
+                                            const __m512d r) {
+    return _mm512_mul_pd(l, r);
+  }
+#endif
+};
+
+struct DivideOp {
+  static double Scalar(const double l, const double r) { return l / r; }
+#ifdef TFOPT_X86_SIMD
+  TFOPT_TARGET_AVX2 static __m256d Avx2(const __m256d l, const __m256d r) {
+    return _mm256_div_pd(l, r);
+  }
+  TFOPT_TARGET_AVX512 static __m512d Avx512(const __m512d l,
+                                            const __m512d r) {
+    return _mm512_div_pd(l, r);
+  }
+#endif
+};
+
+struct MaxOp {
+  static double Scalar(const double l, const double r) {
+    return std::max(l, r);
+  }
+#ifdef TFOPT_X86_SIMD
+  TFOPT_TARGET_AVX2 static __m256d Avx2(const __m256d l, const __m256d r) {
+    return _mm256_max_pd(r, l);
+  }
+  TFOPT_TARGET_AVX512 static __m512d Avx512(const __m512d l,
+                                            const __m512d r) {
+    return Max512(r, l);
+  }
+#endif
+};
+
+struct MinOp {
+  static double Scalar(const double l, const double r) {
+    return std::min(l, r);
+  }
+#ifdef TFOPT_X86_SIMD
+  TFOPT_TARGET_AVX2 static __m256d Avx2(const __m256d l, const __m256d r) {
+    return _mm256_min_pd(r, l);
+  }
+  TFOPT_TARGET_AVX512 static __m512d Avx512(const __m512d l,
+                                            const __m512d r) {
+    return Min512(r, l);
+  }
+#endif
+};
+
+// std::max(0.0, x).
+struct ReluOp {
+  double Scalar(const double x) const { return std::max(0.0, x); }
+#ifdef TFOPT_X86_SIMD
+  TFOPT_TARGET_AVX2 __m256d Avx2(const __m256d x) const {
+    return _mm256_max_pd(x, _mm256_setzero_pd());
+  }
+  TFOPT_TARGET_AVX512 __m512d Avx512(const __m512d x) const {
+    return Max512(x, _mm512_setzero_pd());
+  }
+#endif
+};
+
+// std::min(cap, std::max(0.0, x)).
+struct ClippedReluOp {
+  double Scalar(const double x) const {
+    return std::min(cap, std::max(0.0, x));
+  }
+#ifdef TFOPT_X86_SIMD
+  TFOPT_TARGET_AVX2 __m256d Avx2(const __m256d x) const {
+    return _mm256_min_pd(_mm256_max_pd(x, _mm256_setzero_pd()),
+                         _mm256_set1_pd(cap));
+  }
+  TFOPT_TARGET_AVX512 __m512d Avx512(const __m512d x) const {
+    return Min512(Max512(x, _mm512_setzero_pd()), _mm512_set1_pd(cap));
+  }
+#endif
+
+  double cap;
+};
+
+template <typename Op, bool kBroadcastLeft, bool kBroadcastRight>
+void BinaryScalar(const double* left, const double* right, double* result,
+                  const int64_t size) {
+  for (int64_t i = 0; i < size; ++i) {
+    result[i] = Op::Scalar(left[kBroadcastLeft ? 0 : i],
+                           right[kBroadcastRight ? 0 : i]);
+  }
+}
+
+template <typename Op>
+void UnaryScalar(const Op& op, const double* input, double* result,
+                 const int64_t size) {
+  for (int64_t i = 0; i < size; ++i) {
+    result[i] = op.Scalar(input[i]);
+  }
+}
+
+#ifdef TFOPT_X86_SIMD
+
+template <typename Op, bool kBroadcastLeft, bool kBroadcastRight>
+TFOPT_TARGET_AVX2 void BinaryAvx2(const double* left, const double* right,
+                                  double* result, const int64_t size) {
+  const __m256d left_broadcast = _mm256_set1_pd(left[0]);
+  const __m256d right_broadcast = _mm256_set1_pd(right[0]);
+  int64_t i = 0;
+  for (; i + 4 <= size; i += 4) {
+    const __m256d l =
+        kBroadcastLeft ? left_broadcast : _mm256_loadu_pd(left + i);
+    const __m256d r =
+        kBroadcastRight ? right_broadcast : _mm256_loadu_pd(right + i);
+    _mm256_storeu_pd(result + i, Op::Avx2(l, r));
+  }
+  BinaryScalar<Op, kBroadcastLeft, kBroadcastRight>(
+      kBroadcastLeft ? left : left + i, kBroadcastRight ? right : right + i,
+      result + i, size - i);
+}
+
+// The last partial vector is handled with masked loads and stores.
+template <typename Op, bool kBroadcastLeft, bool kBroadcastRight>
+TFOPT_TARGET_AVX512 void BinaryAvx512(const double* left, const double* right,
+                                      double* result, const int64_t size) {
+  const __m512d left_broadcast = _mm512_set1_pd(left[0]);
+  const __m512d right_broadcast = _mm512_set1_pd(right[0]);
+  int64_t i = 0;
+  for (; i + 8 <= size; i += 8) {
+    const __m512d l =
+        kBroadcastLeft ? left_broadcast : _mm512_loadu_pd(left + i);
+    const __m512d r =
+        kBroadcastRight ? right_broadcast : _mm512_loadu_pd(right + i);
+    _mm512_storeu_pd(result + i, Op::Avx512(l, r));
+  }
+  if (i < size) {
+    const __mmask8 mask = (1u << (size - i)) - 1;
+    const __m512d l = kBroadcastLeft ? left_broadcast
+                                     : _mm512_maskz_loadu_pd(mask, left + i);
+    const __m512d r = kBroadcastRight
+                          ? right_broadcast
+                          : _mm512_maskz_loadu_pd(mask, right + i);
+    _mm512_mask_storeu_pd(result + i, mask, Op::Avx512(l, r));
+  }
+}
+
+template <typename Op>
+TFOPT_TARGET_AVX2 void UnaryAvx2(const Op& op, const double* input,
+                                 double* result, const int64_t size) {
+  int64_t i = 0;
+  for (; i + 4 <= size; i += 4) {
+    _mm256_storeu_pd(result + i, op.Avx2(_mm256_loadu_pd(input + i)));
+  }
+  UnaryScalar(op, input + i, result + i, size - i);
+}
+
+template <typename Op>
+TFOPT_TARGET_AVX512 void UnaryAvx512(const Op& op, const double* input,
+                                     double* result, const int64_t size) {
+  int64_t i = 0;
+  for (; i + 8 <= size; i += 8) {
+    _mm512_storeu_pd(result + i, op.Avx512(_mm512_loadu_pd(input + i)));
+  }
+  if (i < size) {
+    const __mmask8 mask = (1u << (size - i)) - 1;
+    _mm512_mask_storeu_pd(result + i, mask,
+                          op.Avx512(_mm512_maskz_loadu_pd(mask, input + i)));
+  }
+}
+
+#endif  // TFOPT_X86_SIMD
+
+SimdLevel DetectSimdLevel() {
+#ifdef TFOPT_X86_SIMD
+  __builtin_cpu_init();
+  if (__builtin_cpu_supports("avx512f")) {
+    return SimdLevel::kAvx512;
+  }
+  if (__builtin_cpu_supports("avx2")) {
+    return SimdLevel::kAvx2;
+  }
+#endif
+  return SimdLevel::kScalar;
+}
+
+std::atomic<SimdLevel>& ActiveSimdLevelStorage() {
+  static std::atomic<SimdLevel> level(SupportedSimdLevel());
+  return level;
+}
+
+template <typename Op, bool kBroadcastLeft, bool kBroadcastRight>
+void RunBinary(const double* left, const double* right, double* result,
+               const int64_t size) {
+  switch (ActiveSimdLevel()) {
+#ifdef TFOPT_X86_SIMD
+    case SimdLevel::kAvx512:
+      BinaryAvx512<Op, kBroadcastLeft, kBroadcastRight>(left, right, result,
+                                                        size);
+      return;
+    case SimdLevel::kAvx2:
+      BinaryAvx2<Op, kBroadcastLeft, kBroadcastRight>(left, right, result,
+                                                      size);
+      return;
+#endif
+    default:
+      BinaryScalar<Op, kBroadcastLeft, kBroadcastRight>(left, right, result,
+                                                        size);
+  }
+}
+
+template <typename Op>
+void RunBinary(const double* left, const bool broadcast_left,
+               const double* right, const bool broadcast_right,
+               double* result, const int64_t size) {
+  if (broadcast_left && broadcast_right) {
+    std::fill(result, result + size, Op::Scalar(left[0], right[0]));
+  } else if (broadcast_left) {
+    RunBinary<Op, true, false>(left, right, result, size);
+  } else if (broadcast_right) {
+    RunBinary<Op, false, true>(left, right, result, size);
+  } else {
+    RunBinary<Op, false, false>(left, right, result, size);
+  }
+}
+
+template <typename Op>
+void RunUnary(const Op& op, const double* input, double* result,
+              const int64_t size) {
+  switch (ActiveSimdLevel()) {
+#ifdef TFOPT_X86_SIMD
+    case SimdLevel::kAvx512:
+      UnaryAvx512(op, input, result, size);
+      return;
+    case SimdLevel::kAvx2:
+      UnaryAvx2(op, input, result, size);
+      return;
+#endif
+    default:
+      UnaryScalar(op, input, result, size);
+  }
+}
+
+// The operands and results of an interval kernel.
+struct IntervalArrays {
+  const double* left_lb;
+  const double* left_ub;
+  const double* right_lb;
+  const double* right_ub;
+  double* result_lb;
+  double* result_ub;
+};
+
+// Moves the arrays that are not broadcast forward by offset elements.
+template <bool kBroadcastLeft, bool kBroadcastRight>
+IntervalArrays Advance(IntervalArrays arrays, const int64_t offset) {
+  if (!kBroadcastLeft) {
+    arrays.left_lb += offset;
+    arrays.left_ub += offset;
+  }
+  if (!kBroadcastRight) {
+    arrays.right_lb += offset;
+    arrays.right_ub += offset;
+  }
+  arrays.result_lb += offset;
+  arrays.result_ub += offset;
+  return arrays;
+}
+
+// Interval ops compute the same values as the Bounds operators, which
+// Scalar() calls. The vectorized versions take the min and max of the four
+// products (or quotients) in the same order as std::min and std::max over an
+// initializer list, so that NaNs propagate the same way.
+struct IntervalMultiplyOp {
+  static Bounds Scalar(const Bounds left, const Bounds right) {
+    return left * right;
+  }
+#ifdef TFOPT_X86_SIMD
+  TFOPT_TARGET_AVX2 static void Avx2(const __m256d a, const __m256d b,
+                                     const __m256d c, const __m256d d,
+                                     __m256d* lb, __m256d* ub) {
+    const __m256d ll = _mm256_mul_pd(a, c);
+    const __m256d lu = _mm256_mul_pd(a, d);
+    const __m256d ul = _mm256_mul_pd(b, c);
+    const __m256d uu = _mm256_mul_pd(b, d);
+    *lb = _mm256_min_pd(uu, _mm256_min_pd(ul, _mm256_min_pd(lu, ll)));
+    *ub = _mm256_max_pd(uu, _mm256_max_pd(ul, _mm256_max_pd(lu, ll)));
+  }
+  TFOPT_TARGET_AVX512 static void Avx512(const __m512d a, const __m512d b,
+                                         const __m512d c, const __m512d d,
+                                         __m512d* lb, __m512d* ub) {
+    const __m512d ll = _mm512_mul_pd(a, c);
+    const __m512d lu = _mm512_mul_pd(a, d);
+    const __m512d ul = _mm512_mul_pd(b, c);
+    const __m512d uu = _mm512_mul_pd(b, d);
+    *lb = Min512(uu, Min512(ul, Min512(lu, ll)));
+    *ub = Max512(uu, Max512(ul, Max512(lu, ll)));
+  }
+#endif
+};
+
+// The special cases of Bounds::operator/=() are applied in reverse order of
+// precedence, each overriding the previous ones.
+struct IntervalDivideOp {
+  static Bounds Scalar(const Bounds left, const Bounds right) {
+    return left / right;
+  }
+#ifdef TFOPT_X86_SIMD
+  TFOPT_TARGET_AVX2 static void Avx2(const __m256d a, const __m256d b,
+                                     const __m256d c, const __m256d d,
+                                     __m256d* lb, __m256d* ub) {
+    const __m256d ll = _mm256_div_pd(a, c);
+    const __m256d lu = _mm256_div_pd(a, d);
+    const __m256d ul = _mm256_div_pd(b, c);
+    const __m256d uu = _mm256_div_pd(b, d);
+    __m256d result_lb =
+        _mm256_min_pd(uu, _mm256_min_pd(ul, _mm256_min_pd(lu, ll)));
+    __m256d result_ub =
+        _mm256_max_pd(uu, _mm256_max_pd(ul, _mm256_max_pd(lu, ll)));
+    const __m256d zero = _mm256_setzero_pd();
+    const __m256d infinity =
+        _mm256_set1_pd(std::numeric_limits<double>::infinity());
+    const __m256d minus_infinity =
+        _mm256_set1_pd(-std::numeric_limits<double>::infinity());
+    // The divisor strictly contains zero.
+    const __m256d divisor_straddles_zero =
+        _mm256_and_pd(_mm256_cmp_pd(c, zero, _CMP_LT_OQ),
+                      _mm256_cmp_pd(d, zero, _CMP_GT_OQ));
+    result_lb =
+        _mm256_blendv_pd(result_lb, minus_infinity, divisor_straddles_zero);
+    result_ub = _mm256_blendv_pd(result_ub, infinity, divisor_straddles_zero);
+    // The dividend is [0, 0].
+    const __m256d dividend_is_zero =
+        _mm256_and_pd(_mm256_cmp_pd(a, zero, _CMP_EQ_OQ),
+                      _mm256_cmp_pd(b, zero, _CMP_EQ_OQ));
+    result_lb = _mm256_blendv_pd(result_lb, zero, dividend_is_zero);
+    result_ub = _mm256_blendv_pd(result_ub, zero, dividend_is_zero);
+    // The divisor is [0, 0].
+    const __m256d divisor_is_zero =
+        _mm256_and_pd(_mm256_cmp_pd(c, zero, _CMP_EQ_OQ),
+                      _mm256_cmp_pd(d, zero, _CMP_EQ_OQ));
+    *lb = _mm256_blendv_pd(result_lb, minus_infinity, divisor_is_zero);
+    *ub = _mm256_blendv_pd(result_ub, infinity, divisor_is_zero);
+  }
+  TFOPT_TARGET_AVX512 static void Avx512(const __m512d a, const __m512d b,
+                                         const __m512d c, const __m512d d,
+                                         __m512d* lb, __m512d* ub) {
+    const __m512d ll = _mm512_div_pd(a, c);
+    const __m512d lu = _mm512_div_pd(a, d);
+    const __m512d ul = _mm512_div_pd(b, c);
+    const __m512d uu = _mm512_div_pd(b, d);
+    __m512d result_lb = Min512(uu, Min512(ul, Min512(lu, ll)));
+    __m512d result_ub = Max512(uu, Max512(ul, Max512(lu, ll)));
+    const __m512d zero = _mm512_setzero_pd();
+    const __m512d infinity =
+        _mm512_set1_pd(std::numeric_limits<double>::infinity());
+    const __m512d minus_infinity =
+        _mm512_set1_pd(-std::numeric_limits<double>::infinity());
+    const __mmask8 divisor_straddles_zero =
+        _mm512_cmp_pd_mask(c, zero, _CMP_LT_OQ) &
+        _mm512_cmp_pd_mask(d, zero, _CMP_GT_OQ);
+    result_lb =
+        _mm512_mask_blend_pd(divisor_straddles_zero, result_lb, minus_infinity);
+    result_ub =
+        _mm512_mask_blend_pd(divisor_straddles_zero, result_ub, infinity);
+    const __mmask8 dividend_is_zero = _mm512_cmp_pd_mask(a, zero, _CMP_EQ_OQ) &
+                                      _mm512_cmp_pd_mask(b, zero, _CMP_EQ_OQ);
+    result_lb = _mm512_mask_blend_pd(dividend_is_zero, result_lb, zero);
+    result_ub = _mm512_mask_blend_pd(dividend_is_zero, result_ub, zero);
+    const __mmask8 divisor_is_zero = _mm512_cmp_pd_mask(c, zero, _CMP_EQ_OQ) &
+                                     _mm512_cmp_pd_mask(d, zero, _CMP_EQ_OQ);
+    *lb = _mm512_mask_blend_pd(divisor_is_zero, result_lb, minus_infinity);
+    *ub = _mm512_mask_blend_pd(divisor_is_zero, result_ub, infinity);
+  }
+#endif
+};
+
+template <typename Op, bool kBroadcastLeft, bool kBroadcastRight>
+void IntervalScalar(const IntervalArrays& arrays, const int64_t size) {
+  for (int64_t i = 0; i < size; ++i) {
+    const int64_t l = kBroadcastLeft ? 0 : i;
+    const int64_t r = kBroadcastRight ? 0 : i;
+    const Bounds result =
+        Op::Scalar(Bounds(arrays.left_lb[l], arrays.left_ub[l]),
+                   Bounds(arrays.right_lb[r], arrays.right_ub[r]));
+    arrays.result_lb[i] = result.lb();
+    arrays.result_ub[i] = result.ub();
+  }
+}
+
+#ifdef TFOPT_X86_SIMD
+
+template <typename Op, bool kBroadcastLeft, bool kBroadcastRight>
+TFOPT_TARGET_AVX2 void IntervalAvx2(const IntervalArrays& arrays,
+                                    const int64_t size) {
+  const __m256d left_lb = _mm256_set1_pd(arrays.left_lb[0]);
+  const __m256d left_ub = _mm256_set1_pd(arrays.left_ub[0]);
+  const __m256d right_lb = _mm256_set1_pd(arrays.right_lb[0]);
+  const __m256d right_ub = _mm256_set1_pd(arrays.right_ub[0]);
+  int64_t i = 0;
+  for (; i + 4 <= size; i += 4) {
+    __m256d lb;
+    __m256d ub;
+    Op::Avx2(kBroadcastLeft ? left_lb : _mm256_loadu_pd(arrays.left_lb + i),
+             kBroadcastLeft ? left_ub : _mm256_loadu_pd(arrays.left_ub + i),
+             kBroadcastRight ? right_lb : _mm256_loadu_pd(arrays.right_lb + i),
+             kBroadcastRight ? right_ub : _mm256_loadu_pd(arrays.right_ub + i),
+             &lb, &ub);
+    _mm256_storeu_pd(arrays.result_lb + i, lb);
+    _mm256_storeu_pd(arrays.result_ub + i, ub);
+  }
+  IntervalScalar<Op, kBroadcastLeft, kBroadcastRight>(
+      Advance<kBroadcastLeft, kBroadcastRight>(arrays, i), size - i);
+}
+
+template <typename Op, bool kBroadcastLeft, bool kBroadcastRight>
+TFOPT_TARGET_AVX512 void IntervalAvx512(const IntervalArrays& arrays,
+                                        const int64_t size) {
+  const __m512d left_lb = _mm512_set1_pd(arrays.left_lb[0]);
+  const __m512d left_ub = _mm512_set1_pd(arrays.left_ub[0]);
+  const __m512d right_lb = _mm512_set1_pd(arrays.right_lb[0]);
+  const __m512d right_ub = _mm512_set1_pd(arrays.right_ub[0]);
+  int64_t i = 0;
+  for (; i + 8 <= size; i += 8) {
+    __m512d lb;
+    __m512d ub;
+    Op::Avx512(
+        kBroadcastLeft ? left_lb : _mm512_loadu_pd(arrays.left_lb + i),
+        kBroadcastLeft ? left_ub : _mm512_loadu_pd(arrays.left_ub + i),
+        kBroadcastRight ? right_lb : _mm512_loadu_pd(arrays.right_lb + i),
+        kBroadcastRight ? right_ub : _mm512_loadu_pd(arrays.right_ub + i),
+        &lb, &ub);
+    _mm512_storeu_pd(arrays.result_lb + i, lb);
+    _mm512_storeu_pd(arrays.result_ub + i, ub);
+  }
+  if (i < size) {
+    const __mmask8 mask = (1u << (size - i)) - 1;
+    __m512d lb;
+    __m512d ub;
+    Op::Avx512(
+        kBroadcastLeft ? left_lb
+                       : _mm512_maskz_loadu_pd(mask, arrays.left_lb + i),
+        kBroadcastLeft ? left_ub
+                       : _mm512_maskz_loadu_pd(mask, arrays.left_ub + i),
+        kBroadcastRight ? right_lb
+                        : _mm512_maskz_loadu_pd(mask, arrays.right_lb + i),
+        kBroadcastRight ? right_ub
+                        : _mm512_maskz_loadu_pd(mask, arrays.right_ub + i),
+        &lb, &ub);
+    _mm512_mask_storeu_pd(arrays.result_lb + i, mask, lb);
+    _mm512_mask_storeu_pd(arrays.result_ub + i, mask, ub);
+  }
+}
+
+#endif  // TFOPT_X86_SIMD
+
+template <typename Op, bool kBroadcastLeft, bool kBroadcastRight>
+void RunInterval(const IntervalArrays& arrays, const int64_t size) {
+  switch (ActiveSimdLevel()) {
+#ifdef TFOPT_X86_SIMD
+    case SimdLevel::kAvx512:
+      IntervalAvx512<Op, kBroadcastLeft, kBroadcastRight>(arrays, size);
+      return;
+    case SimdLevel::kAvx2:
+      IntervalAvx2<Op, kBroadcastLeft, kBroadcastRight>(arrays, size);
+      return;
+#endif
+    default:
+      IntervalScalar<Op, kBroadcastLeft, kBroadcastRight>(arrays, size);
+  }
+}
+
+template <typename Op>
+void RunInterval(const IntervalArrays& arrays, const bool broadcast_left,
+                 const bool broadcast_right, const int64_t size) {
+  if (broadcast_left && broadcast_right) {
+    RunInterval<Op, true, true>(arrays, size);
+  } else if (broadcast_left) {
+    RunInterval<Op, true, false>(arrays, size);
+  } else if (broadcast_right) {
+    RunInterval<Op, false, true>(arrays, size);
+  } else {
+    RunInterval<Op, false, false>(arrays, size);
+  }
+}
+
+}  // namespace
+
+const char* ToString(const SimdLevel level) {
+  switch (level) {
+    case SimdLevel::kScalar:
+      return "scalar";
+    case SimdLevel::kAvx2:
+      return "avx2";
+    case SimdLevel::kAvx512:
+      return "avx512";
+  }
+  return "unknown";
+}
+
+SimdLevel SupportedSimdLevel() {
+  static const SimdLevel level = DetectSimdLevel();
+  return level;
+}
+
+SimdLevel ActiveSimdLevel() {
+  return ActiveSimdLevelStorage().load(std::memory_order_relaxed);
+}
+
+void SetSimdLevelForTesting(const SimdLevel level) {
+  ActiveSimdLevelStorage().store(std::min(level, SupportedSimdLevel()),
+                                 std::memory_order_relaxed);
+}
+
+void BinaryKernel(const BinaryKernelOp op, const double* left,
+                  const bool broadcast_left, const double* right,
+                  const bool broadcast_right, double* result,
+                  const int64_t size) {
+  if (size <= 0) {
+    return;
+  }
+  switch (op) {
+    case BinaryKernelOp::kAdd:
+      RunBinary<AddOp>(left, broadcast_left, right, broadcast_right, result,
+                       size);
+      return;
+    case BinaryKernelOp::kSubtract:
+      RunBinary<SubtractOp>(left, broadcast_left, right, broadcast_right,
+                            result, size);
+      return;
+    case BinaryKernelOp::kMultiply:
+      RunBinary<MultiplyOp>(left, broadcast_left, right, broadcast_right,
+                            result, size);
+      return;
+    case BinaryKernelOp::kDivide:
+      RunBinary<DivideOp>(left, broadcast_left, right, broadcast_right,
+                          result, size);
+      return;
+    case BinaryKernelOp::kMax:
+      RunBinary<MaxOp>(left, broadcast_left, right, broadcast_right, result,
+                       size);
+      return;
+    case BinaryKernelOp::kMin:
+      RunBinary<MinOp>(left, broadcast_left, right, broadcast_right, result,
+                       size);
+      return;
+  }
+  LOG(FATAL) << "Unknown BinaryKernelOp: " << static_cast<int>(op);
+}
+
+void ReluKernel(const double* input, double* result, const int64_t size) {
+  RunUnary(ReluOp(), input, result, size);
+}
+
+void ClippedReluKernel(const double* input, const double cap, double* result,
+                       const int64_t size) {
+  RunUnary(ClippedReluOp{cap}, input, result, size);
+}
+
+void IntervalBinaryKernel(const IntervalKernelOp op, const double* left_lb,
+                          const double* left_ub, const bool broadcast_left,
+                          const double* right_lb, const double* right_ub,
+                          const bool broadcast_right, double* result_lb,
+                          double* result_ub, const int64_t size) {
+  if (size <= 0) {
+    return;
+  }
+  const IntervalArrays arrays = {left_lb,  left_ub,   right_lb,
+                                 right_ub, result_lb, result_ub};
+  switch (op) {
+    case IntervalKernelOp::kMultiply:
+      RunInterval<IntervalMultiplyOp>(arrays, broadcast_left, broadcast_right,
+                                      size);
+      return;
+    case IntervalKernelOp::kDivide:
+      RunInterval<IntervalDivideOp>(arrays, broadcast_left, broadcast_right,
+                                    size);
+      return;
+  }
+  LOG(FATAL) << "Unknown IntervalKernelOp: " << static_cast<int>(op);
+}
+
+}  // namespace internal
+}  // namespace tf_opt
@@ -0,0 +1,83 @@
+// Copyright 2026 The tf.opt Authors.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+// Vectorized elementwise kernels for contiguous arrays of doubles. These are
+// the backend of the elementwise functions of math.h (Add, Multiply,
+// ElementwiseRelu, ...) when all operands are double tensors, and of
+// soa_bounds_tensor.h; you should not need to call them directly.
+//
+// Each kernel has a portable scalar version and, on x86-64, AVX2 and AVX-512
+// versions. The best version supported by the CPU is picked at runtime, so
+// the library needs no special compiler flags. All versions compute exactly
+// the same values as the scalar functors of element_operations.h, including
+// for NaNs and signed zeros.
+
+#ifndef TF_OPT_TENSOR_ELEMENTWISE_KERNELS_H_
+#define TF_OPT_TENSOR_ELEMENTWISE_KERNELS_H_
+
+#include <cstdint>
+
+namespace tf_opt {
+namespace internal {
+
+enum class BinaryKernelOp { kAdd, kSubtract, kMultiply, kDivide, kMax, kMin };
+
+// Interval products and quotients, as defined by Bounds (bounds.h).
+enum class IntervalKernelOp { kMultiply, kDivide };
+
+enum class SimdLevel { kScalar, kAvx2, kAvx512 };
+
+const char* ToString(SimdLevel level);
+
+// The best level supported by the CPU.
+SimdLevel SupportedSimdLevel();
+
+// The level used by the kernels: SupportedSimdLevel(), unless overridden by
+// SetSimdLevelForTesting().
+SimdLevel ActiveSimdLevel();
+
+// Uses min(level, SupportedSimdLevel()) from now on. Not thread-safe with
+// respect to running kernels, only meant for tests and benchmarks.
+void SetSimdLevelForTesting(SimdLevel level);
+
+// Computes result[i] = left[i] op right[i] for i in [0, size). When
+// broadcast_left is true, left[0] is used for every i instead, and likewise
+// for right. The result may alias left or right.
+void BinaryKernel(BinaryKernelOp op, const double* left, bool broadcast_left,
+                  const double* right, bool broadcast_right, double* result,
+                  int64_t size);
+
+// Computes result[i] = max(0, input[i]) for i in [0, size).
+void ReluKernel(const double* input, double* result, int64_t size);
+
+// Computes result[i] = min(cap, max(0, input[i])) for i in [0, size).
+void ClippedReluKernel(const double* input, double cap, double* result,
+                       int64_t size);
+
+// Computes [result_lb[i], result_ub[i]] =
+//   [left_lb[i], left_ub[i]] op [right_lb[i], right_ub[i]]
+// for i in [0, size), with the same values as the Bounds operators (including
+// the special cases of division by intervals containing zero). When
+// broadcast_left is true, the interval at index 0 of left is used for every i
+// instead, and likewise for right. The results may alias the inputs.
+void IntervalBinaryKernel(IntervalKernelOp op, const double* left_lb,
+                          const double* left_ub, bool broadcast_left,
+                          const double* right_lb, const double* right_ub,
+                          bool broadcast_right, double* result_lb,
+                          double* result_ub, int64_t size);
+
+}  // namespace internal
+}  // namespace tf_opt
+
+#endif  // TF_OPT_TENSOR_ELEMENTWISE_KERNELS_H_
@@ -0,0 +1,250 @@
+// Copyright 2026 The tf.opt Authors.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "tf_opt/tensor/elementwise_kernels.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <cstring>
+#include <limits>
+#include <string>
+#include <vector>
+
+#include "gmock/gmock.h"
+#include "gtest/gtest.h"
+#include "tf_opt/bounds/bounds.h"
+
+namespace tf_opt {
+namespace internal {
+namespace {
+
+constexpr double kInf = std::numeric_limits<double>::infinity();
+constexpr double kNaN = std::numeric_limits<double>::quiet_NaN();
+
+// Compares the bits, so that NaNs are equal and 0.0 differs from -0.0.
+MATCHER_P(BitwiseEq, expected, "") {
+  return std::memcmp(&arg, &expected, sizeof(double)) == 0;
+}
+
+// Values with NaNs, infinities and signed zeros, repeated with a period that
+// does not divide the vector widths.
+std::vector<double> MakeValues(const int64_t size, const int seed) {
+  const std::vector<double> special = {1.5,  -2.0,  0.0, -0.0, kNaN, 3.25,
+                                       kInf, -kInf, 7.0, -0.5, 2.0};
+  std::vector<double> result(size);
+  for (int64_t i = 0; i < size; ++i) {
+    result[i] = special[(i * 7 + seed) % special.size()];
+  }
+  return result;
+}
+
+double ScalarBinary(const BinaryKernelOp op, const double l, const double r) {
+  switch (op) {
+    case BinaryKernelOp::kAdd:
+      return l + r;
+    case BinaryKernelOp::kSubtract:
+      return l - r;
+    case BinaryKernelOp::kMultiply:
+      return l * r;
+    case BinaryKernelOp::kDivide:
+      return l / r;
+    case BinaryKernelOp::kMax:
+      return std::max(l, r);
+    case BinaryKernelOp::kMin:
+      return std::min(l, r);
+  }
+  return 0.0;
+}
+
+// Runs each test at every SIMD level supported by the CPU.
+class ElementwiseKernelsTest : public ::testing::TestWithParam<SimdLevel> {
+ protected:
+  void SetUp() override {
+    if (GetParam() > SupportedSimdLevel()) {
+      GTEST_SKIP() << ToString(GetParam()) << " is not supported.";
+    }
+    SetSimdLevelForTesting(GetParam());
+    ASSERT_EQ(ActiveSimdLevel(), GetParam());
+  }
+
+  void TearDown() override { SetSimdLevelForTesting(SupportedSimdLevel()); }
+};
+
+TEST_P(ElementwiseKernelsTest, Binary) {
+  for (const BinaryKernelOp op :
+       {BinaryKernelOp::kAdd, BinaryKernelOp::kSubtract,
+        BinaryKernelOp::kMultiply, BinaryKernelOp::kDivide,
+        BinaryKernelOp::kMax, BinaryKernelOp::kMin}) {
+    for (int64_t size = 0; size <= 37; ++size) {
+      for (const bool broadcast_left : {false, true}) {
+        for (const bool broadcast_right : {false, true}) {
+          // At least one element, which broadcast operands read.
+          const int64_t num_values = std::max<int64_t>(size, 1);
+          const std::vector<double> left = MakeValues(num_values, 0);
+          const std::vector<double> right = MakeValues(num_values, 3);
+          std::vector<double> result(size + 1, 42.0);
+          BinaryKernel(op, left.data(), broadcast_left, right.data(),
+                       broadcast_right, result.data(), size);
+          for (int64_t i = 0; i < size; ++i) {
+            const double expected =
+                ScalarBinary(op, left[broadcast_left ? 0 : i],
+                             right[broadcast_right ? 0 : i]);
+            ASSERT_THAT(result[i], BitwiseEq(expected))
+                << "op " << static_cast<int>(op) << ", size " << size
+                << ", index " << i;
+          }
+          // Nothing is written past the end.
+          EXPECT_EQ(result[size], 42.0);
+        }
+      }
+    }
+  }
+}
+
+TEST_P(ElementwiseKernelsTest, BinaryInPlace) {
+  std::vector<double> left = MakeValues(19, 0);
+  const std::vector<double> right = MakeValues(19, 5);
+  std::vector<double> expected(19);
+  for (int i = 0; i < 19; ++i) {
+    expected[i] = left[i] * right[i];
+  }
+  BinaryKernel(BinaryKernelOp::kMultiply, left.data(), false, right.data(),
+               false, left.data(), 19);
+  for (int i = 0; i < 19; ++i) {
+    EXPECT_THAT(left[i], BitwiseEq(expected[i]));
+  }
+}
+
+TEST_P(ElementwiseKernelsTest, Relu) {
+  for (int64_t size = 0; size <= 37; ++size) {
+    const std::vector<double> input = MakeValues(size, 1);
+    std::vector<double> result(size + 1, 42.0);
+    ReluKernel(input.data(), result.data(), size);
+    for (int64_t i = 0; i < size; ++i) {
+      ASSERT_THAT(result[i], BitwiseEq(std::max(0.0, input[i])))
+          << "size " << size << ", index " << i;
+    }
+    EXPECT_EQ(result[size], 42.0);
+  }
+}
+
+TEST_P(ElementwiseKernelsTest, ClippedRelu) {
+  constexpr double kCap = 2.0;
+  for (int64_t size = 0; size <= 37; ++size) {
+    const std::vector<double> input = MakeValues(size, 2);
+    std::vector<double> result(size + 1, 42.0);
+    ClippedReluKernel(input.data(), kCap, result.data(), size);
+    for (int64_t i = 0; i < size; ++i) {
+      ASSERT_THAT(result[i],
+                  BitwiseEq(std::min(kCap, std::max(0.0, input[i]))))
+          << "size " << size << ", index " << i;
+    }
+    EXPECT_EQ(result[size], 42.0);
+  }
+}
+
+// Intervals with infinite, zero and zero-containing bounds, so that every
+// special case of Bounds::operator/=() is hit. NaNs are not valid bounds.
+void MakeIntervals(const int64_t size, const int seed,
+                   std::vector<double>* lower, std::vector<double>* upper) {
+  const std::vector<Bounds> special = {
+      {1.5, 2.0},  {-2.0, 3.0}, {0.0, 0.0},   {-0.0, 1.0}, {-3.0, 0.0},
+      {-kInf, 2.0}, {1.0, kInf}, {-kInf, kInf}, {7.0, 7.0}, {-0.5, -0.25},
+      {2.0, 4.0}};
+  lower->resize(size);
+  upper->resize(size);
+  for (int64_t i = 0; i < size; ++i) {
+    const Bounds& bounds = special[(i * 7 + seed) % special.size()];
+    (*lower)[i] = bounds.lb();
+    (*upper)[i] = bounds.ub();
+  }
+}
+
+TEST_P(ElementwiseKernelsTest, IntervalBinary) {
+  for (const IntervalKernelOp op :
+       {IntervalKernelOp::kMultiply, IntervalKernelOp::kDivide}) {
+    for (int64_t size = 0; size <= 37; ++size) {
+      for (const bool broadcast_left : {false, true}) {
+        for (const bool broadcast_right : {false, true}) {
+          const int64_t num_values = std::max<int64_t>(size, 1);
+          std::vector<double> left_lb, left_ub, right_lb, right_ub;
+          MakeIntervals(num_values, 0, &left_lb, &left_ub);
+          MakeIntervals(num_values, 4, &right_lb, &right_ub);
+          std::vector<double> result_lb(size + 1, 42.0);
+          std::vector<double> result_ub(size + 1, 42.0);
+          IntervalBinaryKernel(op, left_lb.data(), left_ub.data(),
+                               broadcast_left, right_lb.data(),
+                               right_ub.data(), broadcast_right,
+                               result_lb.data(), result_ub.data(), size);
+          for (int64_t i = 0; i < size; ++i) {
+            const int64_t l = broadcast_left ? 0 : i;
+            const int64_t r = broadcast_right ? 0 : i;
+            const Bounds left(left_lb[l], left_ub[l]);
+            const Bounds right(right_lb[r], right_ub[r]);
+            const Bounds expected = op == IntervalKernelOp::kMultiply
+                                        ? left * right
+                                        : left / right;
+            ASSERT_THAT(result_lb[i], BitwiseEq(expected.lb()))
+                << "op " << static_cast<int>(op) << ", size " << size
+                << ", index " << i;
+            ASSERT_THAT(result_ub[i], BitwiseEq(expected.ub()))
+                << "op " << static_cast<int>(op) << ", size " << size
+                << ", index " << i;
+          }
+          EXPECT_EQ(result_lb[size], 42.0);
+          EXPECT_EQ(result_ub[size], 42.0);
+        }
+      }
+    }
+  }
+}
+
+TEST_P(ElementwiseKernelsTest, IntervalBinaryInPlace) {
+  std::vector<double> left_lb, left_ub, right_lb, right_ub;
+  MakeIntervals(19, 1, &left_lb, &left_ub);
+  MakeIntervals(19, 6, &right_lb, &right_ub);
+  std::vector<Bounds> expected;
+  for (int i = 0; i < 19; ++i) {
+    expected.push_back(Bounds(left_lb[i], left_ub[i]) /
+                       Bounds(right_lb[i], right_ub[i]));
+  }
+  IntervalBinaryKernel(IntervalKernelOp::kDivide, left_lb.data(),
+                       left_ub.data(), false, right_lb.data(), right_ub.data(),
+                       false, left_lb.data(), left_ub.data(), 19);
+  for (int i = 0; i < 19; ++i) {
+    EXPECT_THAT(left_lb[i], BitwiseEq(expected[i].lb()));
+    EXPECT_THAT(left_ub[i], BitwiseEq(expected[i].ub()));
+  }
+}
+
+INSTANTIATE_TEST_SUITE_P(AllLevels, ElementwiseKernelsTest,
+                         ::testing::Values(SimdLevel::kScalar,
+                                           SimdLevel::kAvx2,
+                                           SimdLevel::kAvx512),
+                         [](const ::testing::TestParamInfo<SimdLevel>& info) {
+                           return std::string(ToString(info.param));
+                         });
+
+TEST(SimdLevelTest, ForcedLevelIsCappedBySupport) {
+  SetSimdLevelForTesting(SimdLevel::kAvx512);
+  EXPECT_EQ(ActiveSimdLevel(), SupportedSimdLevel());
+  SetSimdLevelForTesting(SimdLevel::kScalar);
+  EXPECT_EQ(ActiveSimdLevel(), SimdLevel::kScalar);
+  SetSimdLevelForTesting(SupportedSimdLevel());
+}
+
+}  // namespace
+}  // namespace internal
+}  // namespace tf_opt
@@ -0,0 +1,170 @@
+// Copyright 2026 The tf.opt Authors.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "tf_opt/tensor/gemm.h"
+
+#include <algorithm>
+#include <cstdint>
+#include <vector>
+
+#include "ortools/base/logging.h"
+
+namespace tf_opt {
+namespace internal {
+namespace {
+
+// Size of the register block computed by the micro-kernel: kMr rows of a times
+// kNr columns of b. The kMr x kNr accumulators should fit in the vector
+// registers (e.g. 8 AVX2 registers of 4 doubles).
+constexpr int64_t kMr = 4;
+constexpr int64_t kNr = 8;
+
+// Cache blocking. A packed kMc x kKc block of a should fit in L2, and a packed
+// kKc x kNc panel of b in L3. kKc x kNr doubles of b (one micro-panel) should
+// fit in L1.
+constexpr int64_t kMc = 128;
+constexpr int64_t kKc = 256;
+constexpr int64_t kNc = 2048;
+
+// Below this many multiply-adds, packing does not pay off and we use a plain
+// loop instead.
+constexpr int64_t kMinPackedWork = 32 * 32 * 32;
+
+// Copies the block a[0:num_rows, 0:depth] into packed, as consecutive panels of
+// kMr rows stored column by column. The last panel is padded with zeros.
+void PackA(const double* a, const int64_t lda, const int64_t num_rows,
+           const int64_t depth, double* packed) {
+  for (int64_t panel_start = 0; panel_start < num_rows; panel_start += kMr) {
+    const int64_t panel_rows = std::min(kMr, num_rows - panel_start);
+    const double* panel = a + panel_start * lda;
+    for (int64_t k = 0; k < depth; ++k) {
+      for (int64_t i = 0; i < panel_rows; ++i) {
+        packed[i] = panel[i * lda + k];
+      }
+      for (int64_t i = panel_rows; i < kMr; ++i) {
+        packed[i] = 0.0;
+      }
+      packed += kMr;
+    }
+  }
+}
+
+// Copies the block b[0:depth, 0:num_cols] into packed, as consecutive panels
+// of kNr columns stored row by row. The last panel is padded with zeros.
+void PackB(const double* b, const int64_t ldb, const int64_t depth,
+           const int64_t num_cols, double* packed) {
+  for (int64_t panel_start = 0; panel_start < num_cols; panel_start += kNr) {
+    const int64_t panel_cols = std::min(kNr, num_cols - panel_start);
+    const double* panel = b + panel_start;
+    for (int64_t k = 0; k < depth; ++k) {
+      const double* row = panel + k * ldb;
+      for (int64_t j = 0; j < panel_cols; ++j) {
+        packed[j] = row[j];
+      }
+      for (int64_t j = panel_cols; j < kNr; ++j) {
+        packed[j] = 0.0;
+      }
+      packed += kNr;
+    }
+  }
+}
+
+// Computes c[0:num_rows, 0:num_cols] += a_panel * b_panel, where a_panel and
+// b_panel are a packed kMr x depth and depth x kNr panel respectively, and
+// num_rows <= kMr, num_cols <= kNr. The fixed-size loops over the accumulators
+// are unrolled and vectorized by the compiler.
+void MicroKernel(const int64_t depth, const double* a_panel,
+                 const double* b_panel, double* c, const int64_t ldc,
+                 const int64_t num_rows, const int64_t num_cols) {
+  double accumulators[kMr][kNr] = {};
+  for (int64_t k = 0; k < depth; ++k) {
+    for (int64_t i = 0; i < kMr; ++i) {
+      const double a_value = a_panel[i];
+      for (int64_t j = 0; j < kNr; ++j) {
+        accumulators[i][j] += a_value * b_panel[j];
+      }
+    }
+    a_panel += kMr;
+    b_panel += kNr;
+  }
+  for (int64_t i = 0; i < num_rows; ++i) {
+    for (int64_t j = 0; j < num_cols; ++j) {
+      c[i * ldc + j] += accumulators[i][j];
+    }
+  }
+}
+
+// Reference implementation for small products, in i-k-j order so that the
+// innermost loop is contiguous in both b and c.
+void SmallGemm(const int64_t rows, const int64_t cols, const int64_t inner,
+               const double* a, const int64_t lda, const double* b,
+               const int64_t ldb, double* c, const int64_t ldc) {
+  for (int64_t i = 0; i < rows; ++i) {
+    double* c_row = c + i * ldc;
+    for (int64_t k = 0; k < inner; ++k) {
+      const double a_value = a[i * lda + k];
+      const double* b_row = b + k * ldb;
+      for (int64_t j = 0; j < cols; ++j) {
+        c_row[j] += a_value * b_row[j];
+      }
+    }
+  }
+}
+
+int64_t RoundUp(const int64_t value, const int64_t multiple) {
+  return (value + multiple - 1) / multiple * multiple;
+}
+
+}  // namespace
+
+void Gemm(const int64_t rows, const int64_t cols, const int64_t inner,
+          const double* a, const int64_t lda, const double* b,
+          const int64_t ldb, double* c, const int64_t ldc) {
+  CHECK_GE(rows, 0);
+  CHECK_GE(cols, 0);
+  CHECK_GE(inner, 0);
+  if (rows == 0 || cols == 0 || inner == 0) {
+    return;
+  }
+  if (rows * cols * inner < kMinPackedWork) {
+    SmallGemm(rows, cols, inner, a, lda, b, ldb, c, ldc);
+    return;
+  }
+  std::vector<double> packed_a(RoundUp(std::min(rows, kMc), kMr) *
+                               std::min(inner, kKc));
+  std::vector<double> packed_b(std::min(inner, kKc) *
+                               RoundUp(std::min(cols, kNc), kNr));
+  for (int64_t jc = 0; jc < cols; jc += kNc) {
+    const int64_t nc = std::min(kNc, cols - jc);
+    for (int64_t pc = 0; pc < inner; pc += kKc) {
+      const int64_t kc = std::min(kKc, inner - pc);
+      PackB(b + pc * ldb + jc, ldb, kc, nc, packed_b.data());
+      for (int64_t ic = 0; ic < rows; ic += kMc) {
+        const int64_t mc = std::min(kMc, rows - ic);
+        PackA(a + ic * lda + pc, lda, mc, kc, packed_a.data());
+        for (int64_t jr = 0; jr < nc; jr += kNr) {
+          const double* b_panel = packed_b.data() + jr * kc;
+          for (int64_t ir = 0; ir < mc; ir += kMr) {
+            MicroKernel(kc, packed_a.data() + ir * kc, b_panel,
+                        c + (ic + ir) * ldc + jc + jr, ldc,
+                        std::min(kMr, mc - ir), std::min(kNr, nc - jr));
+          }
+        }
+      }
+    }
+  }
+}
+
+}  // namespace internal
+}  // namespace tf_opt
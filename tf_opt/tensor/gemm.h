@@ -0,0 +1,44 @@
+// Copyright 2026 The tf.opt Authors.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+// A dense matrix multiplication kernel for double precision, row-major
+// matrices. This is the backend of MatMul (see math.h) when both operands are
+// double tensors; you should not need to call it directly.
+//
+// The implementation follows the usual structure of BLAS-like libraries (see
+// e.g. Goto and van de Geijn, "Anatomy of High-Performance Matrix
+// Multiplication", 2008): the operands are split in blocks that fit in the
+// caches, each block is packed into a contiguous buffer, and a small
+// register-blocked micro-kernel computes the product of the packed blocks.
+
+#ifndef TF_OPT_TENSOR_GEMM_H_
+#define TF_OPT_TENSOR_GEMM_H_
+
+#include <cstdint>
+
+namespace tf_opt {
+namespace internal {
+
+// Computes c += a * b, where a is a rows x inner matrix, b is a inner x cols
+// matrix and c is a rows x cols matrix. All matrices are row-major, and the
+// distance between the start of two consecutive rows is given by lda, ldb and
+// ldc respectively (the "leading dimension", as in BLAS). The output c must
+// not alias a or b.
+void Gemm(int64_t rows, int64_t cols, int64_t inner, const double* a,
+          int64_t lda, const double* b, int64_t ldb, double* c, int64_t ldc);
+
+}  // namespace internal
+}  // namespace tf_opt
+
+#endif  // TF_OPT_TENSOR_GEMM_H_
@@ -0,0 +1,103 @@
+// Copyright 2026 The tf.opt Authors.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "tf_opt/tensor/gemm.h"
+
+#include <cstdint>
+#include <random>
+#include <tuple>
+#include <vector>
+
+#include "gmock/gmock.h"
+#include "gtest/gtest.h"
+
+namespace tf_opt {
+namespace internal {
+namespace {
+
+using ::testing::DoubleNear;
+using ::testing::ElementsAre;
+using ::testing::Pointwise;
+
+std::vector<double> RandomMatrix(const int64_t size, std::mt19937* generator) {
+  std::uniform_real_distribution<double> distribution(-1.0, 1.0);
+  std::vector<double> result(size);
+  for (double& value : result) {
+    value = distribution(*generator);
+  }
+  return result;
+}
+
+// Computes c += a * b with the textbook triple loop.
+void ReferenceGemm(const int64_t rows, const int64_t cols, const int64_t inner,
+                   const double* a, const int64_t lda, const double* b,
+                   const int64_t ldb, double* c, const int64_t ldc) {
+  for (int64_t i = 0; i < rows; ++i) {
+    for (int64_t j = 0; j < cols; ++j) {
+      for (int64_t k = 0; k < inner; ++k) {
+        c[i * ldc + j] += a[i * lda + k] * b[k * ldb + j];
+      }
+    }
+  }
+}
+
+TEST(GemmTest, SmallMatrices) {
+  const std::vector<double> a = {1.0, 2.0, 3.0, 4.0, 5.0, 6.0};
+  const std::vector<double> b = {10.0, 20.0, 30.0, 40.0, 50.0, 60.0};
+  std::vector<double> c = {1.0, 1.0, 1.0, 1.0};
+  Gemm(2, 2, 3, a.data(), 3, b.data(), 2, c.data(), 2);
+  EXPECT_THAT(c, ElementsAre(221.0, 281.0, 491.0, 641.0));
+}
+
+TEST(GemmTest, EmptyInnerDimensionIsNoOp) {
+  std::vector<double> c = {1.0, 2.0};
+  Gemm(1, 2, 0, nullptr, 0, nullptr, 2, c.data(), 2);
+  EXPECT_THAT(c, ElementsAre(1.0, 2.0));
+}
+
+class GemmRandomTest
+    : public ::testing::TestWithParam<std::tuple<int64_t, int64_t, int64_t>> {
+};
+
+// Compares against the reference implementation on sizes that are not
+// multiples of the register and cache blocks, on sub-matrices of larger
+// buffers (leading dimensions larger than the number of columns), and with a
+// nonzero initial output.
+TEST_P(GemmRandomTest, MatchesReference) {
+  const auto [rows, cols, inner] = GetParam();
+  const int64_t lda = inner + 3;
+  const int64_t ldb = cols + 1;
+  const int64_t ldc = cols + 2;
+  std::mt19937 generator(rows * 10007 + cols * 101 + inner);
+  const std::vector<double> a = RandomMatrix(rows * lda, &generator);
+  const std::vector<double> b = RandomMatrix(inner * ldb, &generator);
+  std::vector<double> c = RandomMatrix(rows * ldc, &generator);
+  std::vector<double> expected = c;
+  ReferenceGemm(rows, cols, inner, a.data(), lda, b.data(), ldb,
+                expected.data(), ldc);
+  Gemm(rows, cols, inner, a.data(), lda, b.data(), ldb, c.data(), ldc);
+  EXPECT_THAT(c, Pointwise(DoubleNear(1e-9), expected));
+}
+
+INSTANTIATE_TEST_SUITE_P(
+    Sizes, GemmRandomTest,
+    ::testing::Values(std::make_tuple(1, 1, 1), std::make_tuple(3, 5, 7),
+                      std::make_tuple(4, 8, 64), std::make_tuple(37, 41, 43),
+                      std::make_tuple(130, 19, 300),
+                      std::make_tuple(9, 2100, 40),
+                      std::make_tuple(257, 3, 513)));
+
+}  // namespace
+}  // namespace internal
+}  // namespace tf_opt
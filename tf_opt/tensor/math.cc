@@ -14,8 +14,14 @@
 
 #include "tf_opt/tensor/math.h"
 
+#include <algorithm>
+#include <cstdint>
+#include <vector>
+
 #include "ortools/base/logging.h"
 #include "absl/status/statusor.h"
+#include "tf_opt/bounds/bounds.h"
+#include "tf_opt/tensor/tensor.h"
 
 namespace tf_opt {
 
@@ -36,4 +42,33 @@ absl::StatusOr<Shape> MatMulOutputShape(const Shape& left, const Shape& right) {
   return internal::MatMulResultShape(pad_left, pad_right);
 }
 
+bool IsTrailingBiasShape(const Shape& input, const Shape& bias) {
+  const std::vector<int64_t>& input_sizes = input.dimension_sizes();
+  const std::vector<int64_t>& bias_sizes = bias.dimension_sizes();
+  if (bias_sizes.size() > input_sizes.size()) {
+    return false;
+  }
+  int num_leading_ones = 0;
+  while (num_leading_ones < bias_sizes.size() &&
+         bias_sizes[num_leading_ones] == 1) {
+    ++num_leading_ones;
+  }
+  const int num_trailing = bias_sizes.size() - num_leading_ones;
+  return std::equal(bias_sizes.begin() + num_leading_ones, bias_sizes.end(),
+                    input_sizes.end() - num_trailing);
+}
+
+BoundsTensor MatMul(const DoubleTensor& left, const BoundsTensor& right) {
+  return internal::MatMul<Bounds, double, Bounds>(left, right);
+}
+
+BoundsTensor MatMul(const BoundsTensor& left, const DoubleTensor& right) {
+  return internal::MatMul<Bounds, Bounds, double>(left, right);
+}
+
+BoundsTensor MidpointRadiusMatMul(const BoundsTensor& left,
+                                  const BoundsTensor& right) {
+  return internal::MidpointRadiusMatMul(left, right);
+}
+
 }  // namespace tf_opt
@@ -42,7 +42,9 @@
 // for type T, (e.g. multiplication is not defined for a pair of LinearExprs,
 // and thus it is not possible to multiply or divide two MPTensors), then the
 // function will not compile.  For ElementwiseMaximum, std::max is the binary
-// operator (and std::min for ElementwiseMinimum).
+// operator (and std::min for ElementwiseMinimum). For double tensors, these
+// functions and the elementwise ReLUs run vectorized kernels picked at runtime
+// for the CPU (see elementwise_kernels.h), with the same results.
 //
 // Example use:
 //   DoubleTensor st1({{1.0, 2.0, 3.0}, {10.0, 20.0, 30.0}});
@@ -67,6 +69,7 @@
 #include <cstdint>
 #include <vector>
 
+#include "ortools/base/logging.h"
 #include "absl/status/statusor.h"
 #include "tf_opt/tensor/element_operations.h"
 #include "tf_opt/tensor/math_impl.h"
@@ -100,8 +103,12 @@ Tensor<T> ElementwiseNegate(const Tensor<T>& input) {
 // T requirement: TfOptMax(T, T) is defined.
 template <typename T>
 Tensor<T> ElementwiseRelu(const Tensor<T>& input) {
-  ReluElement<T> element;
-  return internal::UnaryElementwiseOp<T>(input, element);
+  if constexpr (internal::kAllDouble<T>) {
+    return internal::DoubleElementwiseRelu(input);
+  } else {
+    ReluElement<T> element;
+    return internal::UnaryElementwiseOp<T>(input, element);
+  }
 }
 
 // Returns tensor with shape of input and
@@ -111,8 +118,55 @@ Tensor<T> ElementwiseRelu(const Tensor<T>& input) {
 // T requirement: TfOptMax(T, T) and TfOptMin(T, T) is defined.
 template <typename T>
 Tensor<T> ElementwiseClippedRelu(const Tensor<T>& input, double cap) {
-  ClippedReluElement<T> element(cap);
-  return internal::UnaryElementwiseOp<T>(input, element);
+  if constexpr (internal::kAllDouble<T>) {
+    return internal::DoubleElementwiseClippedRelu(input, cap);
+  } else {
+    ClippedReluElement<T> element(cap);
+    return internal::UnaryElementwiseOp<T>(input, element);
+  }
+}
+
+// Returns true if a bias of shape "bias" can be added to a tensor of shape
+// "input" by BiasActivationInPlace(): bias must not have more dimensions than
+// input, and its dimensions without its leading ones must be the trailing
+// dimensions of input. E.g. biases of shape [3] and [1, 3] fit an input of
+// shape [2, 3], but [2, 1] and [1, 1, 3] do not.
+bool IsTrailingBiasShape(const Shape& input, const Shape& bias);
+
+// Replaces each element x of *input by activation(x + b), where b is the
+// element of bias broadcast to x (see IsTrailingBiasShape(), which must
+// hold), and activation is the identity, ReLU, or ClippedRelu(., cap).
+// The result is the same as e.g. ElementwiseRelu(Add(*input, bias)), but the
+// bias and the activation are applied in a single pass over *input, one bias
+// sized slice at a time, without allocating any intermediate tensor. This is
+// the epilogue of a fused dense or convolution layer.
+//
+// T requirement: operator+(T, T), TfOptMax(T, T) and TfOptMin(T, T) are
+// defined.
+template <typename T>
+void BiasActivationInPlace(const Tensor<T>& bias, Activation activation,
+                           double cap, Tensor<T>* input) {
+  CHECK(IsTrailingBiasShape(input->dimension(), bias.dimension()))
+      << "Bias of shape " << bias.dimension().ToString()
+      << " does not fit input of shape " << input->dimension().ToString();
+  if constexpr (internal::kAllDouble<T>) {
+    internal::DoubleBiasActivationInPlace(bias, activation, cap, input);
+  } else {
+    const std::vector<T>& bias_values = bias.flat_values();
+    std::vector<T>& values = *input->mutable_flat_values();
+    const int64_t bias_size = bias.size();
+    for (int64_t start = 0; start < input->size(); start += bias_size) {
+      for (int64_t j = 0; j < bias_size; ++j) {
+        T& value = values[start + j];
+        value = value + bias_values[j];
+        if (activation == Activation::kRelu) {
+          value = TfOptMax(T(0.0), value);
+        } else if (activation == Activation::kClippedRelu) {
+          value = TfOptMin(T(cap), TfOptMax(T(0.0), value));
+        }
+      }
+    }
+  }
 }
 
 // Returns left + right, CHECK fails on shape error.
@@ -155,13 +209,37 @@ Tensor<T> MatMul(const Tensor<T>& left, const Tensor<T>& right) {
   return internal::MatMul<T, T, T>(left, right);
 }
 
+// Returns left * right (matrix multiplication) for a double and a Bounds
+// operand, e.g. constant weights and the bounds of the input of a dense layer.
+// CHECK fails on shape error. With finite values, this runs four double GEMMs
+// instead of the elementwise interval products (see
+// internal::SplitIntervalMatMul()); so does MatMul() of two BoundsTensors when
+// one of them is point-valued.
+BoundsTensor MatMul(const DoubleTensor& left, const BoundsTensor& right);
+BoundsTensor MatMul(const BoundsTensor& left, const DoubleTensor& right);
+
+// Returns bounds containing MatMul(left, right), computed in midpoint-radius
+// form with three double GEMMs:
+//   mid(L R) = mid(L) mid(R),
+//   rad(L R) = |mid(L)| rad(R) + rad(L) (|mid(R)| + rad(R)).
+// The radius can be up to 1.5 times that of MatMul(), so prefer MatMul() when
+// tightness matters more than speed. Falls back to MatMul() when a bound is
+// infinite. CHECK fails on shape error.
+BoundsTensor MidpointRadiusMatMul(const BoundsTensor& left,
+                                  const BoundsTensor& right);
+
 // Returns max(left, right) (componentwise), CHECK fails on shape error.
 //
 // T requirement: TfOptMax(T, T) is defined.
 template <typename T>
 Tensor<T> ElementwiseMaximum(const Tensor<T>& left, const Tensor<T>& right) {
-  MaxElements<T> element;
-  return internal::BinaryElementwiseOp<T, T, T>(left, right, element);
+  if constexpr (internal::kAllDouble<T>) {
+    return internal::DoubleBinaryElementwiseOp(left, right,
+                                               internal::BinaryKernelOp::kMax);
+  } else {
+    MaxElements<T> element;
+    return internal::BinaryElementwiseOp<T, T, T>(left, right, element);
+  }
 }
 
 // Returns min(left, right) (componentwise), CHECK fails on shape error.
@@ -169,8 +247,13 @@ Tensor<T> ElementwiseMaximum(const Tensor<T>& left, const Tensor<T>& right) {
 // T requirement: TfOptMin(T, T) is defined.
 template <typename T>
 Tensor<T> ElementwiseMinimum(const Tensor<T>& left, const Tensor<T>& right) {
-  MinElements<T> element;
-  return internal::BinaryElementwiseOp<T, T, T>(left, right, element);
+  if constexpr (internal::kAllDouble<T>) {
+    return internal::DoubleBinaryElementwiseOp(left, right,
+                                               internal::BinaryKernelOp::kMin);
+  } else {
+    MinElements<T> element;
+    return internal::BinaryElementwiseOp<T, T, T>(left, right, element);
+  }
 }
 
 }  // namespace tf_opt
@@ -15,54 +15,20 @@
 #include "tf_opt/tensor/math_impl.h"
 
 #include <algorithm>
+#include <cmath>
 #include <cstdint>
+#include <optional>
+#include <utility>
+#include <vector>
 
 #include "absl/status/statusor.h"
+#include "tf_opt/bounds/bounds.h"
+#include "tf_opt/tensor/elementwise_kernels.h"
+#include "tf_opt/tensor/gemm.h"
 
 namespace tf_opt {
 namespace internal {
 
-std::vector<int64_t> Broadcaster::PaddedMultiIndex(
-    const int64_t broadcast_index) const {
-  std::vector<int64_t> multi_index =
-      broadcast_shape_.ExpandIndex(broadcast_index);
-
-  for (int i = 0; i < multi_index.size(); i++) {
-    if (padded_shape_.dimension_size(i) == 1) {
-      multi_index[i] = 0;
-    }
-  }
-  return multi_index;
-}
-
-int64_t Broadcaster::BroadcastIndexToTrueIndex(
-    const int64_t broadcast_index) const {
-  return padded_shape_.FlattenIndex(PaddedMultiIndex(broadcast_index));
-}
-
-std::vector<int64_t> Broadcaster::BroadcastIndexToMatmulSliceArg(
-    const int64_t broadcast_index, MultiplicationPosition mult_pos) const {
-  std::vector<int64_t> multi_index = PaddedMultiIndex(broadcast_index);
-  switch (mult_pos) {
-    case MultiplicationPosition::kLeft:
-      multi_index[multi_index.size() - 1] = -1;
-      break;
-    case MultiplicationPosition::kRight:
-      multi_index[multi_index.size() - 2] = -1;
-      break;
-    default:
-      LOG(FATAL);
-  }
-  const int64_t amount_padding =
-      padded_shape_.num_dimensions() - true_shape_.num_dimensions();
-  if (amount_padding > 0) {
-    CHECK_LT(amount_padding, multi_index.size());
-    multi_index.erase(multi_index.begin(),
-                      multi_index.begin() + amount_padding);
-  }
-  return multi_index;
-}
-
 Shape BroadcastPadIfNeeded(const Shape& shape,
                            const int64_t target_num_dimensions) {
   if (target_num_dimensions > shape.num_dimensions()) {
@@ -99,6 +65,121 @@ absl::StatusOr<Shape> ResultShape(const Shape& padded_left,
   return Shape(output_size);
 }
 
+DoubleTensor DoubleBinaryElementwiseOp(const DoubleTensor& left,
+                                       const DoubleTensor& right,
+                                       const BinaryKernelOp op) {
+  const Shape& left_shape = left.dimension();
+  const Shape& right_shape = right.dimension();
+  const double* left_values = left.flat_values().data();
+  const double* right_values = right.flat_values().data();
+  if (left_shape == right_shape) {
+    DoubleTensor result(left_shape);
+    BinaryKernel(op, left_values, false, right_values, false,
+                 result.mutable_flat_values()->data(), result.size());
+    return result;
+  }
+  const int64_t num_dim = MaxNumDimensions(left_shape, right_shape);
+  const Shape result_shape =
+      ResultShape(BroadcastPadIfNeeded(left_shape, num_dim),
+                  BroadcastPadIfNeeded(right_shape, num_dim))
+          .value();
+  DoubleTensor result(result_shape);
+  double* result_values = result.mutable_flat_values()->data();
+  const int64_t size = result.size();
+  if (size == 0) {
+    return result;
+  }
+  if (left.size() == 1 || right.size() == 1) {
+    BinaryKernel(op, left_values, left.size() == 1, right_values,
+                 right.size() == 1, result_values, size);
+    return result;
+  }
+  if (IsTrailingAxisBroadcast(left_shape, right_shape)) {
+    const int64_t bias_size = right.size();
+    for (int64_t start = 0; start < size; start += bias_size) {
+      BinaryKernel(op, left_values + start, false, right_values, false,
+                   result_values + start, bias_size);
+    }
+    return result;
+  }
+  if (IsTrailingAxisBroadcast(right_shape, left_shape)) {
+    const int64_t bias_size = left.size();
+    for (int64_t start = 0; start < size; start += bias_size) {
+      BinaryKernel(op, left_values, false, right_values + start, false,
+                   result_values + start, bias_size);
+    }
+    return result;
+  }
+  // General broadcasting, with the scalar element operations.
+  switch (op) {
+    case BinaryKernelOp::kAdd:
+      return BinaryElementwiseOp<double, double, double>(
+          left, right, [](const double l, const double r, const int64_t) {
+            return l + r;
+          });
+    case BinaryKernelOp::kSubtract:
+      return BinaryElementwiseOp<double, double, double>(
+          left, right, [](const double l, const double r, const int64_t) {
+            return l - r;
+          });
+    case BinaryKernelOp::kMultiply:
+      return BinaryElementwiseOp<double, double, double>(
+          left, right, [](const double l, const double r, const int64_t) {
+            return l * r;
+          });
+    case BinaryKernelOp::kDivide:
+      return BinaryElementwiseOp<double, double, double>(
+          left, right, [](const double l, const double r, const int64_t) {
+            return l / r;
+          });
+    case BinaryKernelOp::kMax:
+      return BinaryElementwiseOp<double, double, double>(
+          left, right, MaxElements<double>());
+    case BinaryKernelOp::kMin:
+      return BinaryElementwiseOp<double, double, double>(
+          left, right, MinElements<double>());
+  }
+  LOG(FATAL) << "Unknown BinaryKernelOp: " << static_cast<int>(op);
+}
+
+DoubleTensor DoubleElementwiseRelu(const DoubleTensor& input) {
+  DoubleTensor result(input.dimension());
+  ReluKernel(input.flat_values().data(), result.mutable_flat_values()->data(),
+             result.size());
+  return result;
+}
+
+DoubleTensor DoubleElementwiseClippedRelu(const DoubleTensor& input,
+                                          const double cap) {
+  DoubleTensor result(input.dimension());
+  ClippedReluKernel(input.flat_values().data(), cap,
+                    result.mutable_flat_values()->data(), result.size());
+  return result;
+}
+
+void DoubleBiasActivationInPlace(const DoubleTensor& bias,
+                                 const Activation activation, const double cap,
+                                 DoubleTensor* input) {
+  const double* const bias_values = bias.flat_values().data();
+  double* const values = input->mutable_flat_values()->data();
+  const int64_t bias_size = bias.size();
+  for (int64_t start = 0; start < input->size(); start += bias_size) {
+    double* const slice = values + start;
+    BinaryKernel(BinaryKernelOp::kAdd, slice, /*broadcast_left=*/false,
+                 bias_values, /*broadcast_right=*/false, slice, bias_size);
+    switch (activation) {
+      case Activation::kIdentity:
+        break;
+      case Activation::kRelu:
+        ReluKernel(slice, slice, bias_size);
+        break;
+      case Activation::kClippedRelu:
+        ClippedReluKernel(slice, cap, slice, bias_size);
+        break;
+    }
+  }
+}
+
 absl::StatusOr<Shape> MatMulResultShape(const Shape& padded_left,
                                         const Shape& padded_right) {
   const int num_dimensions = padded_left.num_dimensions();
@@ -131,5 +212,268 @@ absl::StatusOr<Shape> MatMulResultShape(const Shape& padded_left,
   return Shape(output_size);
 }
 
+std::vector<int64_t> BroadcastStrides(const Shape& operand_shape,
+                                      const Shape& broadcast_shape,
+                                      const int64_t block_size) {
+  const int64_t num_dimensions = broadcast_shape.num_dimensions();
+  const int64_t padding = num_dimensions - operand_shape.num_dimensions();
+  CHECK_GE(padding, 0) << "Cannot broadcast " << operand_shape.ToString()
+                       << " to " << broadcast_shape.ToString();
+  std::vector<int64_t> strides(num_dimensions, 0);
+  int64_t stride = block_size;
+  for (int64_t i = operand_shape.num_dimensions() - 1; i >= 0; --i) {
+    const int64_t size = operand_shape.dimension_size(i);
+    if (size != 1) {
+      CHECK_EQ(size, broadcast_shape.dimension_size(i + padding))
+          << "Cannot broadcast " << operand_shape.ToString() << " to "
+          << broadcast_shape.ToString();
+      strides[i + padding] = stride;
+    }
+    stride *= size;
+  }
+  return strides;
+}
+
+BroadcastIterator::BroadcastIterator(std::vector<int64_t> dimension_sizes,
+                                     std::vector<int64_t> left_strides,
+                                     std::vector<int64_t> right_strides)
+    : dimension_sizes_(std::move(dimension_sizes)),
+      left_strides_(std::move(left_strides)),
+      right_strides_(std::move(right_strides)),
+      counter_(dimension_sizes_.size(), 0) {
+  CHECK_EQ(left_strides_.size(), dimension_sizes_.size());
+  CHECK_EQ(right_strides_.size(), dimension_sizes_.size());
+}
+
+bool IsTrailingAxisBroadcast(const Shape& input, const Shape& bias) {
+  if (input.num_dimensions() == 0 || bias.num_dimensions() == 0) {
+    return false;
+  }
+  const int64_t bias_size = bias.dimension_sizes().back();
+  return bias_size > 0 && bias.size() == bias_size &&
+         input.dimension_sizes().back() == bias_size &&
+         input.num_dimensions() >= bias.num_dimensions();
+}
+
+Shape MatMulBatchShape(const Shape& shape) {
+  CHECK_GE(shape.num_dimensions(), 2);
+  const std::vector<int64_t>& sizes = shape.dimension_sizes();
+  return Shape(std::vector<int64_t>(sizes.begin(), sizes.end() - 2));
+}
+
+namespace {
+
+// The matrix products of a batched MatMul, see MatMul() in math_impl.h.
+struct MatMulLayout {
+  Shape result_shape;
+  int64_t rows = 0;
+  int64_t cols = 0;
+  int64_t inner = 0;
+  // For each matrix of the result, the flat offsets of the operand matrices.
+  std::vector<int64_t> left_offsets;
+  std::vector<int64_t> right_offsets;
+};
+
+MatMulLayout GetMatMulLayout(const Shape& left, const Shape& right) {
+  CHECK_GE(left.num_dimensions(), 2);
+  CHECK_GE(right.num_dimensions(), 2);
+  const int64_t num_dim = MaxNumDimensions(left, right);
+  MatMulLayout layout;
+  layout.result_shape =
+      MatMulResultShape(BroadcastPadIfNeeded(left, num_dim),
+                        BroadcastPadIfNeeded(right, num_dim))
+          .value();
+  layout.rows = layout.result_shape.dimension_size(num_dim - 2);
+  layout.cols = layout.result_shape.dimension_size(num_dim - 1);
+  layout.inner = left.dimension_size(left.num_dimensions() - 1);
+  const Shape batch_shape = MatMulBatchShape(layout.result_shape);
+  BroadcastIterator batch(
+      batch_shape.dimension_sizes(),
+      BroadcastStrides(MatMulBatchShape(left), batch_shape,
+                       layout.rows * layout.inner),
+      BroadcastStrides(MatMulBatchShape(right), batch_shape,
+                       layout.inner * layout.cols));
+  for (int64_t b = 0; b < batch_shape.size(); ++b, batch.Next()) {
+    layout.left_offsets.push_back(batch.left_index());
+    layout.right_offsets.push_back(batch.right_index());
+  }
+  return layout;
+}
+
+// result += left * right for each matrix product of the layout.
+void BatchedGemm(const MatMulLayout& layout, const std::vector<double>& left,
+                 const std::vector<double>& right,
+                 std::vector<double>* result) {
+  const int64_t result_matrix_size = layout.rows * layout.cols;
+  for (int64_t m = 0; m < layout.left_offsets.size(); ++m) {
+    Gemm(layout.rows, layout.cols, layout.inner,
+         left.data() + layout.left_offsets[m], layout.inner,
+         right.data() + layout.right_offsets[m], layout.cols,
+         result->data() + m * result_matrix_size, layout.cols);
+  }
+}
+
+bool AllFinite(const DoubleTensor& tensor) {
+  return std::all_of(tensor.flat_values().begin(), tensor.flat_values().end(),
+                     [](const double value) { return std::isfinite(value); });
+}
+
+bool AllFinite(const BoundsTensor& tensor) {
+  return std::all_of(tensor.flat_values().begin(), tensor.flat_values().end(),
+                     [](const Bounds& bounds) {
+                       return std::isfinite(bounds.lb()) &&
+                              std::isfinite(bounds.ub());
+                     });
+}
+
+bool IsPointValued(const BoundsTensor& tensor) {
+  return std::all_of(
+      tensor.flat_values().begin(), tensor.flat_values().end(),
+      [](const Bounds& bounds) { return bounds.lb() == bounds.ub(); });
+}
+
+// The lower (or upper) bounds of tensor, as flat values.
+std::vector<double> LowerBounds(const BoundsTensor& tensor) {
+  std::vector<double> result;
+  result.reserve(tensor.size());
+  for (const Bounds& bounds : tensor.flat_values()) {
+    result.push_back(bounds.lb());
+  }
+  return result;
+}
+
+std::vector<double> UpperBounds(const BoundsTensor& tensor) {
+  std::vector<double> result;
+  result.reserve(tensor.size());
+  for (const Bounds& bounds : tensor.flat_values()) {
+    result.push_back(bounds.ub());
+  }
+  return result;
+}
+
+BoundsTensor ToBoundsTensor(const Shape& shape,
+                            const std::vector<double>& lower,
+                            const std::vector<double>& upper) {
+  BoundsTensor result(shape);
+  std::vector<Bounds>& values = *result.mutable_flat_values();
+  for (int64_t i = 0; i < result.size(); ++i) {
+    values[i] = Bounds(lower[i], upper[i]);
+  }
+  return result;
+}
+
+// The product of a point-valued matrix and an interval matrix, on the left if
+// point_on_left and on the right otherwise. See SplitIntervalMatMul().
+BoundsTensor PointIntervalMatMul(const DoubleTensor& point,
+                                 const BoundsTensor& interval,
+                                 const bool point_on_left) {
+  const MatMulLayout layout =
+      point_on_left ? GetMatMulLayout(point.dimension(), interval.dimension())
+                    : GetMatMulLayout(interval.dimension(), point.dimension());
+  std::vector<double> positive(point.size());
+  std::vector<double> negative(point.size());
+  for (int64_t i = 0; i < point.size(); ++i) {
+    const double value = point.flat_values()[i];
+    positive[i] = std::max(value, 0.0);
+    negative[i] = std::min(value, 0.0);
+  }
+  const std::vector<double> lower = LowerBounds(interval);
+  const std::vector<double> upper = UpperBounds(interval);
+  // Multiplies in the order of the operands of the MatMul.
+  const auto gemm = [&layout, point_on_left](const std::vector<double>& weights,
+                                             const std::vector<double>& bounds,
+                                             std::vector<double>* result) {
+    if (point_on_left) {
+      BatchedGemm(layout, weights, bounds, result);
+    } else {
+      BatchedGemm(layout, bounds, weights, result);
+    }
+  };
+  std::vector<double> result_lower(layout.result_shape.size(), 0.0);
+  std::vector<double> result_upper(layout.result_shape.size(), 0.0);
+  gemm(positive, lower, &result_lower);
+  gemm(negative, upper, &result_lower);
+  gemm(positive, upper, &result_upper);
+  gemm(negative, lower, &result_upper);
+  return ToBoundsTensor(layout.result_shape, result_lower, result_upper);
+}
+
+}  // namespace
+
+std::optional<BoundsTensor> SplitIntervalMatMul(const DoubleTensor& left,
+                                                const BoundsTensor& right) {
+  if (!AllFinite(left) || !AllFinite(right)) {
+    return std::nullopt;
+  }
+  return PointIntervalMatMul(left, right, /*point_on_left=*/true);
+}
+
+std::optional<BoundsTensor> SplitIntervalMatMul(const BoundsTensor& left,
+                                                const DoubleTensor& right) {
+  if (!AllFinite(left) || !AllFinite(right)) {
+    return std::nullopt;
+  }
+  return PointIntervalMatMul(right, left, /*point_on_left=*/false);
+}
+
+std::optional<BoundsTensor> SplitIntervalMatMul(const BoundsTensor& left,
+                                                const BoundsTensor& right) {
+  if (IsPointValued(left)) {
+    return SplitIntervalMatMul(
+        DoubleTensor::FromFlatData(left.dimension(), LowerBounds(left)),
+        right);
+  }
+  if (IsPointValued(right)) {
+    return SplitIntervalMatMul(
+        left,
+        DoubleTensor::FromFlatData(right.dimension(), LowerBounds(right)));
+  }
+  return std::nullopt;
+}
+
+BoundsTensor MidpointRadiusMatMul(const BoundsTensor& left,
+                                  const BoundsTensor& right) {
+  if (!AllFinite(left) || !AllFinite(right)) {
+    return MatMul<Bounds, Bounds, Bounds>(left, right);
+  }
+  const MatMulLayout layout =
+      GetMatMulLayout(left.dimension(), right.dimension());
+  // Midpoints, radii and absolute values of the midpoints of an operand.
+  struct MidpointRadius {
+    std::vector<double> midpoint;
+    std::vector<double> radius;
+    std::vector<double> abs_midpoint;
+  };
+  const auto to_midpoint_radius = [](const BoundsTensor& tensor) {
+    MidpointRadius result;
+    for (const Bounds& bounds : tensor.flat_values()) {
+      const double midpoint = 0.5 * (bounds.lb() + bounds.ub());
+      result.midpoint.push_back(midpoint);
+      result.radius.push_back(0.5 * (bounds.ub() - bounds.lb()));
+      result.abs_midpoint.push_back(std::abs(midpoint));
+    }
+    return result;
+  };
+  const MidpointRadius left_mr = to_midpoint_radius(left);
+  MidpointRadius right_mr = to_midpoint_radius(right);
+  // |mid(L)| rad(R) + rad(L) (|mid(R)| + rad(R)), reusing
+  // right_mr.abs_midpoint.
+  std::vector<double> radius(layout.result_shape.size(), 0.0);
+  BatchedGemm(layout, left_mr.abs_midpoint, right_mr.radius, &radius);
+  for (int64_t i = 0; i < right.size(); ++i) {
+    right_mr.abs_midpoint[i] += right_mr.radius[i];
+  }
+  BatchedGemm(layout, left_mr.radius, right_mr.abs_midpoint, &radius);
+  std::vector<double> midpoint(layout.result_shape.size(), 0.0);
+  BatchedGemm(layout, left_mr.midpoint, right_mr.midpoint, &midpoint);
+  std::vector<double> lower(midpoint.size());
+  std::vector<double> upper(midpoint.size());
+  for (int64_t i = 0; i < midpoint.size(); ++i) {
+    lower[i] = midpoint[i] - radius[i];
+    upper[i] = midpoint[i] + radius[i];
+  }
+  return ToBoundsTensor(layout.result_shape, lower, upper);
+}
+
 }  // namespace internal
 }  // namespace tf_opt
@@ -20,11 +20,17 @@
 
 #include <algorithm>
 #include <cstdint>
+#include <optional>
+#include <type_traits>
+#include <utility>
 #include <vector>
 
 #include "ortools/base/logging.h"
 #include "absl/status/statusor.h"
+#include "tf_opt/bounds/bounds.h"
 #include "tf_opt/tensor/element_operations.h"
+#include "tf_opt/tensor/elementwise_kernels.h"
+#include "tf_opt/tensor/gemm.h"
 #include "tf_opt/tensor/shape.h"
 #include "tf_opt/tensor/tensor.h"
 
@@ -54,33 +60,77 @@ int64_t MaxNumDimensions(const Shape& shape_left, const Shape& shape_right);
 absl::StatusOr<Shape> ResultShape(const Shape& padded_left,
                                   const Shape& padded_right);
 
-enum class MultiplicationPosition { kLeft, kRight };
+// Returns the strides of an operand of shape "operand_shape" once broadcast to
+// "broadcast_shape", following the NumPy rules described in math.h. The result
+// has one entry per dimension of "broadcast_shape": the distance in the flat
+// storage of the operand between consecutive elements along that dimension.
+// The stride is zero on every dimension the operand is broadcast along,
+// including the leading dimensions added by BroadcastPadIfNeeded().
+//
+// E.g. for an operand of shape [3, 1] broadcast to [2, 3, 4], returns
+// [0, 1, 0].
+//
+// When each element of the operand is a contiguous block of "block_size"
+// values (e.g. the matrices of a batched MatMul), the strides are scaled by
+// "block_size".
+std::vector<int64_t> BroadcastStrides(const Shape& operand_shape,
+                                      const Shape& broadcast_shape,
+                                      int64_t block_size = 1);
 
-// Relates the elements of r to the elements of t1 used to produce r.
-class Broadcaster {
+// Walks every multi-index of a shape in row-major order, like an odometer,
+// while keeping track of the corresponding flat index in two broadcast
+// operands (see BroadcastStrides()). Advancing is O(1) amortized and does not
+// allocate, unlike Shape::ExpandIndex() followed by Shape::FlattenIndex().
+//
+// Example use:
+//   BroadcastIterator it(result_shape.dimension_sizes(),
+//                        BroadcastStrides(left_shape, result_shape),
+//                        BroadcastStrides(right_shape, result_shape));
+//   for (int64_t i = 0; i < result_shape.size(); ++i, it.Next()) {
+//     result[i] = left[it.left_index()] + right[it.right_index()];
+//   }
+class BroadcastIterator {
  public:
-  // broadcast_shape: the shape of "r".
-  // padded_true_shape: the shape of "t1" after padding with 1s at the
-  //   start to match length of r.  See BroadcastPadIfNeeded.
-  Broadcaster(const Shape& true_shape, const Shape& padded_true_shape,
-              const Shape& broadcast_shape)
-      : true_shape_(true_shape),
-        padded_shape_(padded_true_shape),
-        broadcast_shape_(broadcast_shape) {}
-
-  // Given a flat index into the result "r", compute the flat index in "t1".
-  int64_t BroadcastIndexToTrueIndex(int64_t broadcast_index) const;
-  std::vector<int64_t> BroadcastIndexToMatmulSliceArg(
-      int64_t broadcast_index, MultiplicationPosition mult_pos) const;
+  // The three vectors must have the same length.
+  BroadcastIterator(std::vector<int64_t> dimension_sizes,
+                    std::vector<int64_t> left_strides,
+                    std::vector<int64_t> right_strides);
 
- private:
-  std::vector<int64_t> PaddedMultiIndex(int64_t broadcast_index) const;
+  int64_t left_index() const { return left_index_; }
+  int64_t right_index() const { return right_index_; }
+
+  // Moves to the next multi-index. Wraps around to the first multi-index after
+  // the last one.
+  void Next();
 
-  const Shape true_shape_;
-  const Shape padded_shape_;
-  const Shape broadcast_shape_;
+ private:
+  const std::vector<int64_t> dimension_sizes_;
+  const std::vector<int64_t> left_strides_;
+  const std::vector<int64_t> right_strides_;
+  std::vector<int64_t> counter_;
+  int64_t left_index_ = 0;
+  int64_t right_index_ = 0;
 };
 
+inline void BroadcastIterator::Next() {
+  for (int64_t i = static_cast<int64_t>(counter_.size()) - 1; i >= 0; --i) {
+    left_index_ += left_strides_[i];
+    right_index_ += right_strides_[i];
+    if (++counter_[i] < dimension_sizes_[i]) {
+      return;
+    }
+    counter_[i] = 0;
+    left_index_ -= left_strides_[i] * dimension_sizes_[i];
+    right_index_ -= right_strides_[i] * dimension_sizes_[i];
+  }
+}
+
+// Returns true when "bias" broadcasts against "input" only along the leading
+// dimensions, i.e. bias has shape [1, ..., 1, n] (or [n]) and input has shape
+// [..., n]. In that case, the broadcast result has the flat layout of input
+// and element i of the result uses element i % n of bias.
+bool IsTrailingAxisBroadcast(const Shape& input, const Shape& bias);
+
 // Given input tensors left and right of broadcast compatible shapes, computes
 // a new tensor that is in spirit:
 //   [f(left[i], right[i]) for i in ResultDimension(left, right)].
@@ -89,83 +139,221 @@ class Broadcaster {
 // BinaryElementOperator should take a LeftOperandType, a RightOperandType, and
 // the OutputIndex to produce the ResultType. See element_operations.h for
 // examples, e.g. AddElements<ResultType, LeftOperandType, RightOperandType>..
+//
+// Implementation note: identical shapes, single element operands and bias-like
+// operands (see IsTrailingAxisBroadcast()) are handled by dedicated loops over
+// the flat data. All other cases walk the result with a BroadcastIterator.
 template <typename ResultType, typename LeftOperandType,
           typename RightOperandType, typename BinaryElementOperator>
 Tensor<ResultType> BinaryElementwiseOp(const Tensor<LeftOperandType>& left,
                                        const Tensor<RightOperandType>& right,
                                        const BinaryElementOperator& f) {
-  const int64_t num_dim = MaxNumDimensions(left.dimension(), right.dimension());
-  const Shape padded_left_dim = BroadcastPadIfNeeded(left.dimension(), num_dim);
-  const Shape padded_right_dim =
-      BroadcastPadIfNeeded(right.dimension(), num_dim);
+  const Shape& left_shape = left.dimension();
+  const Shape& right_shape = right.dimension();
+  const std::vector<LeftOperandType>& left_values = left.flat_values();
+  const std::vector<RightOperandType>& right_values = right.flat_values();
+  if (left_shape == right_shape) {
+    Tensor<ResultType> result(left_shape);
+    std::vector<ResultType>& result_values = *result.mutable_flat_values();
+    for (int64_t i = 0; i < result.size(); ++i) {
+      result_values[i] = f(left_values[i], right_values[i], i);
+    }
+    return result;
+  }
+  const int64_t num_dim = MaxNumDimensions(left_shape, right_shape);
   const Shape result_shape =
-      ResultShape(padded_left_dim, padded_right_dim).value();
+      ResultShape(BroadcastPadIfNeeded(left_shape, num_dim),
+                  BroadcastPadIfNeeded(right_shape, num_dim))
+          .value();
   Tensor<ResultType> result(result_shape);
-  const Broadcaster broadcast_left(left.dimension(), padded_left_dim,
-                                   result_shape);
-  const Broadcaster broadcast_right(right.dimension(), padded_right_dim,
-                                    result_shape);
-  for (int64_t i = 0; i < result.size(); i++) {
-    const LeftOperandType& left_value =
-        left.flat_values()[broadcast_left.BroadcastIndexToTrueIndex(i)];
-    const RightOperandType& right_value =
-        right.flat_values()[broadcast_right.BroadcastIndexToTrueIndex(i)];
-    (*result.mutable_flat_values())[i] = f(left_value, right_value, i);
+  std::vector<ResultType>& result_values = *result.mutable_flat_values();
+  const int64_t size = result.size();
+  if (size == 0) {
+    return result;
+  }
+  // Broadcasting a single element (e.g. a scalar) or padding with leading ones
+  // does not change the flat layout of the other operand.
+  if (right.size() == 1) {
+    for (int64_t i = 0; i < size; ++i) {
+      result_values[i] = f(left_values[i], right_values[0], i);
+    }
+    return result;
+  }
+  if (left.size() == 1) {
+    for (int64_t i = 0; i < size; ++i) {
+      result_values[i] = f(left_values[0], right_values[i], i);
+    }
+    return result;
+  }
+  if (IsTrailingAxisBroadcast(left_shape, right_shape)) {
+    const int64_t bias_size = right.size();
+    for (int64_t start = 0; start < size; start += bias_size) {
+      for (int64_t j = 0; j < bias_size; ++j) {
+        result_values[start + j] =
+            f(left_values[start + j], right_values[j], start + j);
+      }
+    }
+    return result;
+  }
+  if (IsTrailingAxisBroadcast(right_shape, left_shape)) {
+    const int64_t bias_size = left.size();
+    for (int64_t start = 0; start < size; start += bias_size) {
+      for (int64_t j = 0; j < bias_size; ++j) {
+        result_values[start + j] =
+            f(left_values[j], right_values[start + j], start + j);
+      }
+    }
+    return result;
+  }
+  // General case: the last dimension is walked with a plain loop, and the
+  // remaining dimensions with a BroadcastIterator.
+  std::vector<int64_t> outer_sizes = result_shape.dimension_sizes();
+  std::vector<int64_t> left_strides =
+      BroadcastStrides(left_shape, result_shape);
+  std::vector<int64_t> right_strides =
+      BroadcastStrides(right_shape, result_shape);
+  const int64_t inner_size = outer_sizes.back();
+  const int64_t left_inner_stride = left_strides.back();
+  const int64_t right_inner_stride = right_strides.back();
+  outer_sizes.pop_back();
+  left_strides.pop_back();
+  right_strides.pop_back();
+  BroadcastIterator outer(std::move(outer_sizes), std::move(left_strides),
+                          std::move(right_strides));
+  for (int64_t start = 0; start < size; start += inner_size, outer.Next()) {
+    int64_t left_index = outer.left_index();
+    int64_t right_index = outer.right_index();
+    for (int64_t j = 0; j < inner_size; ++j) {
+      result_values[start + j] =
+          f(left_values[left_index], right_values[right_index], start + j);
+      left_index += left_inner_stride;
+      right_index += right_inner_stride;
+    }
   }
   return result;
 }
 
+// True when all of Ts are double, i.e. when the kernels of gemm.h and
+// elementwise_kernels.h apply.
+template <typename... Ts>
+constexpr bool kAllDouble = (std::is_same_v<Ts, double> && ...);
+
+// BinaryElementwiseOp() for double tensors and one of the operations of
+// elementwise_kernels.h. The cases with dedicated loops in
+// BinaryElementwiseOp() run the vectorized kernels instead.
+DoubleTensor DoubleBinaryElementwiseOp(const DoubleTensor& left,
+                                       const DoubleTensor& right,
+                                       BinaryKernelOp op);
+
+// ElementwiseRelu() and ElementwiseClippedRelu() (see math.h) for double
+// tensors, with the vectorized kernels.
+DoubleTensor DoubleElementwiseRelu(const DoubleTensor& input);
+DoubleTensor DoubleElementwiseClippedRelu(const DoubleTensor& input,
+                                          double cap);
+
 template <typename ResultType, typename LeftOperandType,
           typename RightOperandType>
 Tensor<ResultType> Add(const Tensor<LeftOperandType>& left,
                        const Tensor<RightOperandType>& right) {
-  return internal::BinaryElementwiseOp<ResultType, LeftOperandType,
-                                       RightOperandType>(
-      left, right,
-      [](const LeftOperandType& left_element,
-         const RightOperandType& right_element,
-         const int64_t) { return left_element + right_element; });
+  if constexpr (kAllDouble<ResultType, LeftOperandType, RightOperandType>) {
+    return DoubleBinaryElementwiseOp(left, right, BinaryKernelOp::kAdd);
+  } else {
+    return internal::BinaryElementwiseOp<ResultType, LeftOperandType,
+                                         RightOperandType>(
+        left, right,
+        [](const LeftOperandType& left_element,
+           const RightOperandType& right_element,
+           const int64_t) { return left_element + right_element; });
+  }
 }
 
 template <typename ResultType, typename LeftOperandType,
           typename RightOperandType>
 Tensor<ResultType> Subtract(const Tensor<LeftOperandType>& left,
                             const Tensor<RightOperandType>& right) {
-  return internal::BinaryElementwiseOp<ResultType, LeftOperandType,
-                                       RightOperandType>(
-      left, right,
-      [](const LeftOperandType& left_element,
-         const RightOperandType& right_element,
-         const int64_t) { return left_element - right_element; });
+  if constexpr (kAllDouble<ResultType, LeftOperandType, RightOperandType>) {
+    return DoubleBinaryElementwiseOp(left, right, BinaryKernelOp::kSubtract);
+  } else {
+    return internal::BinaryElementwiseOp<ResultType, LeftOperandType,
+                                         RightOperandType>(
+        left, right,
+        [](const LeftOperandType& left_element,
+           const RightOperandType& right_element,
+           const int64_t) { return left_element - right_element; });
+  }
 }
 
 template <typename ResultType, typename LeftOperandType,
           typename RightOperandType>
 Tensor<ResultType> Multiply(const Tensor<LeftOperandType>& left,
                             const Tensor<RightOperandType>& right) {
-  return internal::BinaryElementwiseOp<ResultType, LeftOperandType,
-                                       RightOperandType>(
-      left, right,
-      [](const LeftOperandType& left_element,
-         const RightOperandType& right_element,
-         const int64_t) { return left_element * right_element; });
+  if constexpr (kAllDouble<ResultType, LeftOperandType, RightOperandType>) {
+    return DoubleBinaryElementwiseOp(left, right, BinaryKernelOp::kMultiply);
+  } else {
+    return internal::BinaryElementwiseOp<ResultType, LeftOperandType,
+                                         RightOperandType>(
+        left, right,
+        [](const LeftOperandType& left_element,
+           const RightOperandType& right_element,
+           const int64_t) { return left_element * right_element; });
+  }
 }
 
 template <typename ResultType, typename LeftOperandType,
           typename RightOperandType>
 Tensor<ResultType> Divide(const Tensor<LeftOperandType>& left,
                           const Tensor<RightOperandType>& right) {
-  return internal::BinaryElementwiseOp<ResultType, LeftOperandType,
-                                       RightOperandType>(
-      left, right,
-      [](const LeftOperandType& left_element,
-         const RightOperandType& right_element,
-         const int64_t) { return left_element / right_element; });
+  if constexpr (kAllDouble<ResultType, LeftOperandType, RightOperandType>) {
+    return DoubleBinaryElementwiseOp(left, right, BinaryKernelOp::kDivide);
+  } else {
+    return internal::BinaryElementwiseOp<ResultType, LeftOperandType,
+                                         RightOperandType>(
+        left, right,
+        [](const LeftOperandType& left_element,
+           const RightOperandType& right_element,
+           const int64_t) { return left_element / right_element; });
+  }
 }
 
+// BiasActivationInPlace() (see math.h) for double tensors, with the
+// vectorized kernels applied to each bias sized slice while it is in cache.
+void DoubleBiasActivationInPlace(const DoubleTensor& bias,
+                                 Activation activation, double cap,
+                                 DoubleTensor* input);
+
 absl::StatusOr<Shape> MatMulResultShape(const Shape& padded_left,
                                         const Shape& padded_right);
 
+// The shape of the leading (batch) dimensions of a MatMul operand or result,
+// i.e. the shape without its last two dimensions.
+Shape MatMulBatchShape(const Shape& shape);
+
+// MatMul() of Bounds with double GEMMs, when one operand is point-valued: a
+// double tensor, or Bounds with lb == ub everywhere (e.g. constant weights
+// converted to Bounds). Splitting the point-valued matrix W into its positive
+// and negative parts W+ and W- gives
+//   W X = [W+ lb(X) + W- ub(X), W+ ub(X) + W- lb(X)],
+// which are the same bounds as the elementwise interval products, up to
+// rounding, with four GEMMs (and symmetrically when W is on the right).
+//
+// Returns nullopt if neither operand is point-valued, or if a value is
+// infinite, since 0 * inf is NaN in a GEMM whereas the Bounds products may
+// still be finite.
+std::optional<BoundsTensor> SplitIntervalMatMul(const DoubleTensor& left,
+                                                const BoundsTensor& right);
+std::optional<BoundsTensor> SplitIntervalMatMul(const BoundsTensor& left,
+                                                const DoubleTensor& right);
+std::optional<BoundsTensor> SplitIntervalMatMul(const BoundsTensor& left,
+                                                const BoundsTensor& right);
+
+// See MidpointRadiusMatMul() in math.h.
+BoundsTensor MidpointRadiusMatMul(const BoundsTensor& left,
+                                  const BoundsTensor& right);
+
+// Matrix multiplication over the last two dimensions, with the leading (batch)
+// dimensions following the broadcasting rules of BinaryElementwiseOp(). When
+// all types are double, each matrix product is computed by Gemm() (gemm.h).
+// Bounds results use SplitIntervalMatMul() when it applies.
 template <typename ResultType, typename LeftOperandType,
           typename RightOperandType>
 Tensor<ResultType> MatMul(const Tensor<LeftOperandType>& left,
@@ -174,6 +362,12 @@ Tensor<ResultType> MatMul(const Tensor<LeftOperandType>& left,
   const int64_t right_dimensions = right.dimension().num_dimensions();
   CHECK_GE(left_dimensions, 2);
   CHECK_GE(right_dimensions, 2);
+  if constexpr (std::is_same_v<ResultType, Bounds>) {
+    std::optional<BoundsTensor> split = SplitIntervalMatMul(left, right);
+    if (split.has_value()) {
+      return *std::move(split);
+    }
+  }
 
   const int64_t num_dim = MaxNumDimensions(left.dimension(), right.dimension());
   const Shape padded_left_dim = BroadcastPadIfNeeded(left.dimension(), num_dim);
@@ -182,22 +376,45 @@ Tensor<ResultType> MatMul(const Tensor<LeftOperandType>& left,
   const Shape result_shape =
       MatMulResultShape(padded_left_dim, padded_right_dim).value();
   Tensor<ResultType> result(result_shape);
-  Broadcaster broadcast_left(left.dimension(), padded_left_dim, result_shape);
-  Broadcaster broadcast_right(right.dimension(), padded_right_dim,
-                              result_shape);
-  for (int64_t i = 0; i < result.size(); i++) {
-    const std::vector<LeftOperandType> left_row =
-        left.VectorSlice(broadcast_left.BroadcastIndexToMatmulSliceArg(
-            i, MultiplicationPosition::kLeft));
-    const std::vector<RightOperandType> right_col =
-        right.VectorSlice(broadcast_right.BroadcastIndexToMatmulSliceArg(
-            i, MultiplicationPosition::kRight));
-    CHECK_EQ(left_row.size(), right_col.size());
-    ResultType inner_prod = result.flat_values()[i];  // zero.
-    for (int j = 0; j < left_row.size(); j++) {
-      inner_prod += left_row[j] * right_col[j];
+
+  const int64_t rows = result_shape.dimension_size(num_dim - 2);
+  const int64_t cols = result_shape.dimension_size(num_dim - 1);
+  const int64_t inner = left.dimension().dimension_size(left_dimensions - 1);
+  const int64_t left_matrix_size = rows * inner;
+  const int64_t right_matrix_size = inner * cols;
+  const int64_t result_matrix_size = rows * cols;
+
+  const Shape batch_shape = MatMulBatchShape(result_shape);
+  BroadcastIterator batch(
+      batch_shape.dimension_sizes(),
+      BroadcastStrides(MatMulBatchShape(left.dimension()), batch_shape,
+                       left_matrix_size),
+      BroadcastStrides(MatMulBatchShape(right.dimension()), batch_shape,
+                       right_matrix_size));
+  const std::vector<LeftOperandType>& left_values = left.flat_values();
+  const std::vector<RightOperandType>& right_values = right.flat_values();
+  std::vector<ResultType>& result_values = *result.mutable_flat_values();
+  for (int64_t b = 0; b < batch_shape.size(); ++b, batch.Next()) {
+    const int64_t left_offset = batch.left_index();
+    const int64_t right_offset = batch.right_index();
+    const int64_t result_offset = b * result_matrix_size;
+    if constexpr (kAllDouble<ResultType, LeftOperandType, RightOperandType>) {
+      Gemm(rows, cols, inner, left_values.data() + left_offset, inner,
+           right_values.data() + right_offset, cols,
+           result_values.data() + result_offset, cols);
+      continue;
+    }
+    for (int64_t i = 0; i < rows; ++i) {
+      for (int64_t j = 0; j < cols; ++j) {
+        const int64_t out = result_offset + i * cols + j;
+        ResultType inner_prod = result_values[out];  // zero.
+        for (int64_t k = 0; k < inner; ++k) {
+          inner_prod += left_values[left_offset + i * inner + k] *
+                        right_values[right_offset + k * cols + j];
+        }
+        result_values[out] = inner_prod;
+      }
     }
-    (*result.mutable_flat_values())[i] = inner_prod;
   }
   return result;
 }
@@ -14,10 +14,13 @@
 
 #include "tf_opt/tensor/math.h"
 
+#include <cstdint>
+#include <limits>
 #include <vector>
 
 #include "gmock/gmock.h"
 #include "gtest/gtest.h"
+#include "tf_opt/bounds/bounds.h"
 #include "tf_opt/open_source/status_matchers.h"
 #include "tf_opt/tensor/shape.h"
 #include "tf_opt/tensor/tensor.h"
@@ -30,6 +33,8 @@ using ::testing::HasSubstr;
 using ::tf_opt::testing::IsOkAndHolds;
 using ::tf_opt::testing::StatusIs;
 
+using Matrix = std::vector<std::vector<double>>;
+
 constexpr absl::StatusCode kInvalidArgument =
     absl::StatusCode::kInvalidArgument;
 
@@ -107,6 +112,42 @@ TEST(TensorMathTest, ElementwiseClippedRelu) {
   EXPECT_THAT(ElementwiseClippedRelu(t, 4.5), DoubleTensorNear(expected));
 }
 
+TEST(TensorMathTest, IsTrailingBiasShape) {
+  const Shape input({2, 4, 3});
+  EXPECT_TRUE(IsTrailingBiasShape(input, Shape({3})));
+  EXPECT_TRUE(IsTrailingBiasShape(input, Shape({1, 1, 3})));
+  EXPECT_TRUE(IsTrailingBiasShape(input, Shape({4, 3})));
+  EXPECT_FALSE(IsTrailingBiasShape(input, Shape({4, 1})));
+  EXPECT_FALSE(IsTrailingBiasShape(input, Shape({2, 1, 3})));
+  EXPECT_FALSE(IsTrailingBiasShape(input, Shape({3, 2, 4, 3})));
+  // A bias of higher rank would change the shape of the result.
+  EXPECT_FALSE(IsTrailingBiasShape(input, Shape({1, 2, 4, 3})));
+}
+
+TEST(TensorMathTest, BiasActivationInPlace) {
+  const DoubleTensor input({{1.0, -2.0, 3.0}, {-4.0, 5.0, -6.0}});
+  const DoubleTensor bias(std::vector<double>{0.5, 1.0, 2.0});
+  for (const Activation activation :
+       {Activation::kIdentity, Activation::kRelu, Activation::kClippedRelu}) {
+    DoubleTensor result = input;
+    BiasActivationInPlace(bias, activation, 4.5, &result);
+    DoubleTensor expected = Add(input, bias);
+    if (activation == Activation::kRelu) {
+      expected = ElementwiseRelu(expected);
+    } else if (activation == Activation::kClippedRelu) {
+      expected = ElementwiseClippedRelu(expected, 4.5);
+    }
+    EXPECT_THAT(result, DoubleTensorNear(expected));
+  }
+}
+
+TEST(TensorMathDeathTest, BiasActivationInPlaceWrongShape) {
+  DoubleTensor input({{1.0, -2.0, 3.0}, {-4.0, 5.0, -6.0}});
+  const DoubleTensor bias(Matrix{{1.0}, {2.0}});
+  EXPECT_DEATH(BiasActivationInPlace(bias, Activation::kRelu, 0.0, &input),
+               "does not fit");
+}
+
 void ExpectSum(const DoubleTensor& t1, const DoubleTensor& t2,
                const DoubleTensor& expected_sum) {
   EXPECT_THAT(Add(t1, t2), DoubleTensorNear(expected_sum)) << "Testing t1 + t2";
@@ -241,6 +282,53 @@ TEST(TensorMathTest, BroadcastBothWithRankLift) {
   ExpectSum(t1, t2, expected_sum);
 }
 
+TEST(TensorMathTest, BroadcastBiasAdd) {
+  const DoubleTensor t1({{{1.0, 2.0, 3.0}, {4.0, 5.0, 6.0}},
+                         {{7.0, 8.0, 9.0}, {10.0, 11.0, 12.0}}});
+  const DoubleTensor t2(std::vector<std::vector<std::vector<double>>>(
+      {{{10.0, 20.0, 30.0}}}));
+  const DoubleTensor expected_sum({{{11.0, 22.0, 33.0}, {14.0, 25.0, 36.0}},
+                                   {{17.0, 28.0, 39.0}, {20.0, 31.0, 42.0}}});
+  ExpectSum(t1, t2, expected_sum);
+}
+
+TEST(TensorMathTest, BroadcastMiddleAxisAdd) {
+  const DoubleTensor t1({{{1.0, 2.0, 3.0}, {4.0, 5.0, 6.0}},
+                         {{7.0, 8.0, 9.0}, {10.0, 11.0, 12.0}}});
+  const DoubleTensor t2(std::vector<std::vector<std::vector<double>>>(
+      {{{100.0, 200.0, 300.0}}, {{400.0, 500.0, 600.0}}}));
+  const DoubleTensor expected_sum(
+      {{{101.0, 202.0, 303.0}, {104.0, 205.0, 306.0}},
+       {{407.0, 508.0, 609.0}, {410.0, 511.0, 612.0}}});
+  ExpectSum(t1, t2, expected_sum);
+}
+
+TEST(TensorMathTest, BroadcastBothAlongDifferentAxesAdd) {
+  const DoubleTensor t1(std::vector<std::vector<std::vector<double>>>(
+      {{{1.0, 2.0}}, {{3.0, 4.0}}}));
+  const DoubleTensor t2({std::vector<double>({10.0}),
+                         std::vector<double>({20.0}),
+                         std::vector<double>({30.0})});
+  const DoubleTensor expected_sum(
+      {{{11.0, 12.0}, {21.0, 22.0}, {31.0, 32.0}},
+       {{13.0, 14.0}, {23.0, 24.0}, {33.0, 34.0}}});
+  ExpectSum(t1, t2, expected_sum);
+}
+
+TEST(TensorMathTest, BroadcastNonCommutative) {
+  const DoubleTensor t1(std::vector<std::vector<std::vector<double>>>(
+      {{{1.0, 2.0}}, {{3.0, 4.0}}}));
+  const DoubleTensor t2({std::vector<double>({10.0}),
+                         std::vector<double>({20.0})});
+  const DoubleTensor expected_difference(
+      {{{-9.0, -8.0}, {-19.0, -18.0}}, {{-7.0, -6.0}, {-17.0, -16.0}}});
+  EXPECT_THAT(Subtract(t1, t2), DoubleTensorNear(expected_difference));
+  const DoubleTensor bias({1.0, 2.0});
+  const DoubleTensor expected_quotient({{2.0, 1.0}, {4.0, 2.5}});
+  EXPECT_THAT(Divide(bias, DoubleTensor({{0.5, 2.0}, {0.25, 0.8}})),
+              DoubleTensorNear(expected_quotient));
+}
+
 TEST(TensorMathDeathTest, WrongRowsNoBroadcasting) {
   const DoubleTensor t1({{1.0, 2.0, 3.0}, {4.0, 5.0, 6.0}});
   const DoubleTensor t2({{10.0, 20.0}, {40.0, 50.0}});
@@ -333,6 +421,142 @@ TEST(TensorMathTest, MatMul3dPadBroadcast) {
   EXPECT_THAT(MatMul(t1, t2), DoubleTensorNear(expected_mat_mul));
 }
 
+TEST(TensorMathTest, MatMul4dBroadcastBothSides) {
+  const DoubleTensor t1 = DoubleTensor::FromFlatData(Shape({2, 1, 1, 2}),
+                                                     {1.0, 2.0, 3.0, 4.0});
+  const DoubleTensor t2 = DoubleTensor::FromFlatData(
+      Shape({3, 2, 1}), {1.0, 0.0, 0.0, 1.0, 1.0, 1.0});
+  const DoubleTensor expected_mat_mul = DoubleTensor::FromFlatData(
+      Shape({2, 3, 1, 1}), {1.0, 2.0, 3.0, 3.0, 4.0, 7.0});
+  EXPECT_THAT(MatMul(t1, t2), DoubleTensorNear(expected_mat_mul));
+}
+
+// The elementwise interval products of a 2d MatMul, as a reference.
+BoundsTensor NaiveBoundsMatMul(const BoundsTensor& left,
+                               const BoundsTensor& right) {
+  const int64_t rows = left.dimension().dimension_size(0);
+  const int64_t inner = left.dimension().dimension_size(1);
+  const int64_t cols = right.dimension().dimension_size(1);
+  BoundsTensor result(Shape({rows, cols}));
+  for (int64_t i = 0; i < rows; ++i) {
+    for (int64_t j = 0; j < cols; ++j) {
+      Bounds sum(0.0);
+      for (int64_t k = 0; k < inner; ++k) {
+        sum += left.flat_values()[i * inner + k] *
+               right.flat_values()[k * cols + j];
+      }
+      (*result.mutable_flat_values())[i * cols + j] = sum;
+    }
+  }
+  return result;
+}
+
+BoundsTensor MakeBoundsMatrix(const int64_t rows, const int64_t cols) {
+  BoundsTensor result(Shape({rows, cols}));
+  for (int64_t i = 0; i < result.size(); ++i) {
+    const double lb = (i * 7) % 11 - 5.0;
+    (*result.mutable_flat_values())[i] = Bounds(lb, lb + (i % 4) * 0.5);
+  }
+  return result;
+}
+
+TEST(TensorMathTest, MatMulDoubleBounds) {
+  const DoubleTensor weights(Matrix{{1.0, -2.0, 0.0}, {-0.5, 3.0, 2.0}});
+  const BoundsTensor input = MakeBoundsMatrix(3, 4);
+  EXPECT_THAT(
+      MatMul(weights, input),
+      BoundsTensorNear(NaiveBoundsMatMul(DoubleTensorToBoundsTensor(weights),
+                                         input),
+                       1e-12));
+}
+
+TEST(TensorMathTest, MatMulBoundsDouble) {
+  const BoundsTensor input = MakeBoundsMatrix(5, 3);
+  const DoubleTensor weights(Matrix{{1.0, -2.0}, {0.0, 0.25}, {-4.0, 3.0}});
+  EXPECT_THAT(
+      MatMul(input, weights),
+      BoundsTensorNear(
+          NaiveBoundsMatMul(input, DoubleTensorToBoundsTensor(weights)),
+          1e-12));
+}
+
+TEST(TensorMathTest, MatMulBoundsPointValued) {
+  const BoundsTensor input = MakeBoundsMatrix(2, 3);
+  const BoundsTensor right_weights = DoubleTensorToBoundsTensor(
+      DoubleTensor(Matrix{{1.0, -2.0}, {0.5, 0.25}, {-4.0, 3.0}}));
+  EXPECT_THAT(MatMul(input, right_weights),
+              BoundsTensorNear(NaiveBoundsMatMul(input, right_weights), 1e-12));
+  const BoundsTensor left_weights =
+      DoubleTensorToBoundsTensor(DoubleTensor(Matrix{{1.0, -1.0}, {2.0, 0.0}}));
+  EXPECT_THAT(MatMul(left_weights, input),
+              BoundsTensorNear(NaiveBoundsMatMul(left_weights, input), 1e-12));
+}
+
+TEST(TensorMathTest, MatMulDoubleBoundsBatched) {
+  const DoubleTensor weights(Matrix{{1.0, -2.0, 0.5}, {-1.0, 0.0, 3.0}});
+  BoundsTensor input(Shape({2, 3, 2}));
+  for (int64_t i = 0; i < input.size(); ++i) {
+    (*input.mutable_flat_values())[i] = Bounds(-1.0 * i, 2.0 * i);
+  }
+  const BoundsTensor result = MatMul(weights, input);
+  ASSERT_EQ(result.dimension(), Shape({2, 2, 2}));
+  for (int b = 0; b < 2; ++b) {
+    EXPECT_THAT(result.SubTensor(b),
+                BoundsTensorNear(
+                    NaiveBoundsMatMul(DoubleTensorToBoundsTensor(weights),
+                                      input.SubTensor(b)),
+                    1e-12));
+  }
+}
+
+TEST(TensorMathTest, MatMulDoubleBoundsInfinite) {
+  // The positive and negative parts would give 0 * inf = NaN.
+  constexpr double kInf = std::numeric_limits<double>::infinity();
+  const DoubleTensor weights(Matrix{{2.0, -1.0}});
+  BoundsTensor input(Shape({2, 1}));
+  (*input.mutable_flat_values())[0] = Bounds(1.0, kInf);
+  (*input.mutable_flat_values())[1] = Bounds(0.0, 1.0);
+  const BoundsTensor result = MatMul(weights, input);
+  ASSERT_EQ(result.dimension(), Shape({1, 1}));
+  EXPECT_EQ(result.flat_value(0), Bounds(1.0, kInf));
+}
+
+TEST(TensorMathTest, BiasActivationInPlaceBounds) {
+  BoundsTensor result = MatMul(
+      MakeBoundsMatrix(3, 2), DoubleTensor(Matrix{{1.0, -2.0}, {0.5, 3.0}}));
+  const BoundsTensor bias(std::vector<Bounds>{Bounds(-1.0, 0.5), Bounds(2.0)});
+  const BoundsTensor expected =
+      ElementwiseClippedRelu(Add(result, bias), 3.0);
+  BiasActivationInPlace(bias, Activation::kClippedRelu, 3.0, &result);
+  EXPECT_THAT(result, BoundsTensorNear(expected, 1e-12));
+}
+
+TEST(TensorMathTest, MidpointRadiusMatMul) {
+  // The exact product is [0, 2] * [1, 3] + [-1, 1] * [-2, 2] = [-2, 8].
+  BoundsTensor left(Shape({1, 2}));
+  (*left.mutable_flat_values())[0] = Bounds(0.0, 2.0);
+  (*left.mutable_flat_values())[1] = Bounds(-1.0, 1.0);
+  BoundsTensor right(Shape({2, 1}));
+  (*right.mutable_flat_values())[0] = Bounds(1.0, 3.0);
+  (*right.mutable_flat_values())[1] = Bounds(-2.0, 2.0);
+  const BoundsTensor result = MidpointRadiusMatMul(left, right);
+  ASSERT_EQ(result.dimension(), Shape({1, 1}));
+  EXPECT_EQ(result.flat_value(0), Bounds(-4.0, 8.0));
+  EXPECT_EQ(MatMul(left, right).flat_value(0), Bounds(-2.0, 8.0));
+}
+
+TEST(TensorMathTest, MidpointRadiusMatMulContainsMatMul) {
+  const BoundsTensor left = MakeBoundsMatrix(4, 5);
+  const BoundsTensor right = MakeBoundsMatrix(5, 3);
+  const BoundsTensor exact = MatMul(left, right);
+  const BoundsTensor enclosure = MidpointRadiusMatMul(left, right);
+  ASSERT_EQ(enclosure.dimension(), exact.dimension());
+  for (int64_t i = 0; i < exact.size(); ++i) {
+    EXPECT_LE(enclosure.flat_value(i).lb(), exact.flat_value(i).lb() + 1e-9);
+    EXPECT_GE(enclosure.flat_value(i).ub(), exact.flat_value(i).ub() - 1e-9);
+  }
+}
+
 // TODO: matmul should have death tests as well.
 
 
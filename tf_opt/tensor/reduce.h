@@ -23,6 +23,7 @@
 #include "tf_opt/tensor/element_operations.h"
 #include "tf_opt/tensor/shape.h"
 #include "tf_opt/tensor/tensor.h"
+#include "tf_opt/tensor/tensor_view.h"
 
 namespace tf_opt {
 
@@ -89,7 +90,7 @@ const Tensor<T> GetInputSliceForReduce(const Tensor<T>& input_tensor,
     CHECK_GE(begin, 0);
   }
 
-  return input_tensor.Slice(begins, sizes);
+  return TensorView<T>(input_tensor).Slice(begins, sizes).ToTensor();
 }
 
 // This method assumes that the 'axes' is sorted and doesn't contain duplicates.
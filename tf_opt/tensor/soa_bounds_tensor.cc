@@ -0,0 +1,180 @@
+// Copyright 2026 The tf.opt Authors.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "tf_opt/tensor/soa_bounds_tensor.h"
+
+#include <cstdint>
+#include <utility>
+#include <vector>
+
+#include "ortools/base/logging.h"
+#include "tf_opt/bounds/bounds.h"
+#include "tf_opt/tensor/elementwise_kernels.h"
+#include "tf_opt/tensor/math.h"
+#include "tf_opt/tensor/math_impl.h"
+#include "tf_opt/tensor/shape.h"
+#include "tf_opt/tensor/tensor.h"
+
+namespace tf_opt {
+namespace {
+
+using internal::IntervalKernelOp;
+
+// Multiply() or Divide(), with the same fast paths as
+// internal::DoubleBinaryElementwiseOp(). General broadcasting falls back to
+// the BoundsTensor version.
+SoaBoundsTensor IntervalBinaryOp(const SoaBoundsTensor& left,
+                                 const SoaBoundsTensor& right,
+                                 const IntervalKernelOp op) {
+  const Shape& left_shape = left.dimension();
+  const Shape& right_shape = right.dimension();
+  const double* left_lb = left.lower().flat_values().data();
+  const double* left_ub = left.upper().flat_values().data();
+  const double* right_lb = right.lower().flat_values().data();
+  const double* right_ub = right.upper().flat_values().data();
+  if (left_shape == right_shape) {
+    SoaBoundsTensor result(left_shape);
+    internal::IntervalBinaryKernel(
+        op, left_lb, left_ub, false, right_lb, right_ub, false,
+        result.mutable_lower()->mutable_flat_values()->data(),
+        result.mutable_upper()->mutable_flat_values()->data(), result.size());
+    return result;
+  }
+  const int64_t num_dim = internal::MaxNumDimensions(left_shape, right_shape);
+  const Shape result_shape =
+      internal::ResultShape(
+          internal::BroadcastPadIfNeeded(left_shape, num_dim),
+          internal::BroadcastPadIfNeeded(right_shape, num_dim))
+          .value();
+  SoaBoundsTensor result(result_shape);
+  double* result_lb = result.mutable_lower()->mutable_flat_values()->data();
+  double* result_ub = result.mutable_upper()->mutable_flat_values()->data();
+  const int64_t size = result.size();
+  if (size == 0) {
+    return result;
+  }
+  if (left.size() == 1 || right.size() == 1) {
+    internal::IntervalBinaryKernel(op, left_lb, left_ub, left.size() == 1,
+                                   right_lb, right_ub, right.size() == 1,
+                                   result_lb, result_ub, size);
+    return result;
+  }
+  if (internal::IsTrailingAxisBroadcast(left_shape, right_shape)) {
+    const int64_t bias_size = right.size();
+    for (int64_t start = 0; start < size; start += bias_size) {
+      internal::IntervalBinaryKernel(op, left_lb + start, left_ub + start,
+                                     false, right_lb, right_ub, false,
+                                     result_lb + start, result_ub + start,
+                                     bias_size);
+    }
+    return result;
+  }
+  if (internal::IsTrailingAxisBroadcast(right_shape, left_shape)) {
+    const int64_t bias_size = left.size();
+    for (int64_t start = 0; start < size; start += bias_size) {
+      internal::IntervalBinaryKernel(op, left_lb, left_ub, false,
+                                     right_lb + start, right_ub + start, false,
+                                     result_lb + start, result_ub + start,
+                                     bias_size);
+    }
+    return result;
+  }
+  const BoundsTensor left_bounds = left.ToBoundsTensor();
+  const BoundsTensor right_bounds = right.ToBoundsTensor();
+  switch (op) {
+    case IntervalKernelOp::kMultiply:
+      return SoaBoundsTensor(Multiply(left_bounds, right_bounds));
+    case IntervalKernelOp::kDivide:
+      return SoaBoundsTensor(Divide(left_bounds, right_bounds));
+  }
+  LOG(FATAL) << "Unknown IntervalKernelOp: " << static_cast<int>(op);
+}
+
+}  // namespace
+
+SoaBoundsTensor::SoaBoundsTensor(const Shape& shape)
+    : lower_(shape), upper_(shape) {}
+
+SoaBoundsTensor::SoaBoundsTensor(DoubleTensor lower, DoubleTensor upper)
+    : lower_(std::move(lower)), upper_(std::move(upper)) {
+  CHECK(lower_.dimension() == upper_.dimension())
+      << "Lower bounds of shape: " << lower_.dimension().ToString()
+      << " and upper bounds of shape: " << upper_.dimension().ToString();
+}
+
+SoaBoundsTensor::SoaBoundsTensor(const BoundsTensor& bounds)
+    : lower_(bounds.dimension()), upper_(bounds.dimension()) {
+  const std::vector<Bounds>& values = bounds.flat_values();
+  std::vector<double>& lower_values = *lower_.mutable_flat_values();
+  std::vector<double>& upper_values = *upper_.mutable_flat_values();
+  for (int64_t i = 0; i < bounds.size(); ++i) {
+    lower_values[i] = values[i].lb();
+    upper_values[i] = values[i].ub();
+  }
+}
+
+BoundsTensor SoaBoundsTensor::ToBoundsTensor() const {
+  BoundsTensor result(dimension());
+  std::vector<Bounds>& values = *result.mutable_flat_values();
+  for (int64_t i = 0; i < size(); ++i) {
+    values[i] = flat_value(i);
+  }
+  return result;
+}
+
+SoaBoundsTensor Add(const SoaBoundsTensor& left, const SoaBoundsTensor& right) {
+  return SoaBoundsTensor(Add(left.lower(), right.lower()),
+                         Add(left.upper(), right.upper()));
+}
+
+SoaBoundsTensor Subtract(const SoaBoundsTensor& left,
+                         const SoaBoundsTensor& right) {
+  return SoaBoundsTensor(Subtract(left.lower(), right.upper()),
+                         Subtract(left.upper(), right.lower()));
+}
+
+SoaBoundsTensor Multiply(const SoaBoundsTensor& left,
+                         const SoaBoundsTensor& right) {
+  return IntervalBinaryOp(left, right, IntervalKernelOp::kMultiply);
+}
+
+SoaBoundsTensor Divide(const SoaBoundsTensor& left,
+                       const SoaBoundsTensor& right) {
+  return IntervalBinaryOp(left, right, IntervalKernelOp::kDivide);
+}
+
+SoaBoundsTensor ElementwiseMaximum(const SoaBoundsTensor& left,
+                                   const SoaBoundsTensor& right) {
+  return SoaBoundsTensor(ElementwiseMaximum(left.lower(), right.lower()),
+                         ElementwiseMaximum(left.upper(), right.upper()));
+}
+
+SoaBoundsTensor ElementwiseMinimum(const SoaBoundsTensor& left,
+                                   const SoaBoundsTensor& right) {
+  return SoaBoundsTensor(ElementwiseMinimum(left.lower(), right.lower()),
+                         ElementwiseMinimum(left.upper(), right.upper()));
+}
+
+SoaBoundsTensor ElementwiseRelu(const SoaBoundsTensor& input) {
+  return SoaBoundsTensor(ElementwiseRelu(input.lower()),
+                         ElementwiseRelu(input.upper()));
+}
+
+SoaBoundsTensor ElementwiseClippedRelu(const SoaBoundsTensor& input,
+                                       const double cap) {
+  return SoaBoundsTensor(ElementwiseClippedRelu(input.lower(), cap),
+                         ElementwiseClippedRelu(input.upper(), cap));
+}
+
+}  // namespace tf_opt
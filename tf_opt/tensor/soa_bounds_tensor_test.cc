@@ -0,0 +1,132 @@
+// Copyright 2026 The tf.opt Authors.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "tf_opt/tensor/soa_bounds_tensor.h"
+
+#include <cstdint>
+#include <utility>
+#include <vector>
+
+#include "gmock/gmock.h"
+#include "gtest/gtest.h"
+#include "tf_opt/bounds/bounds.h"
+#include "tf_opt/tensor/math.h"
+#include "tf_opt/tensor/shape.h"
+#include "tf_opt/tensor/tensor.h"
+#include "tf_opt/tensor/tensor_testing.h"
+
+namespace tf_opt {
+namespace {
+
+// Bounds including zero-containing and degenerate intervals.
+BoundsTensor MakeBounds(const Shape& shape, const int seed) {
+  const std::vector<Bounds> special = {
+      {1.5, 2.0}, {-2.0, 3.0},   {0.0, 0.0}, {0.0, 1.0}, {-3.0, 0.0},
+      {7.0, 7.0}, {-0.5, -0.25}, {2.0, 4.0}, {-6.0, -1.0}};
+  BoundsTensor result(shape);
+  for (int64_t i = 0; i < result.size(); ++i) {
+    (*result.mutable_flat_values())[i] =
+        special[(i * 5 + seed) % special.size()];
+  }
+  return result;
+}
+
+TEST(SoaBoundsTensorTest, DefaultIsScalarZero) {
+  const SoaBoundsTensor tensor;
+  EXPECT_EQ(tensor.dimension(), Shape());
+  EXPECT_EQ(tensor.flat_value(0), Bounds(0.0));
+}
+
+TEST(SoaBoundsTensorTest, FromLowerAndUpper) {
+  const SoaBoundsTensor tensor(DoubleTensor({1.0, -2.0}),
+                               DoubleTensor({3.0, 0.5}));
+  EXPECT_EQ(tensor.dimension(), Shape({2}));
+  EXPECT_EQ(tensor.size(), 2);
+  EXPECT_EQ(tensor.flat_value(0), Bounds(1.0, 3.0));
+  EXPECT_EQ(tensor.flat_value(1), Bounds(-2.0, 0.5));
+}
+
+TEST(SoaBoundsTensorTest, BoundsTensorRoundTrip) {
+  const BoundsTensor bounds = MakeBounds(Shape({2, 3, 4}), 0);
+  const SoaBoundsTensor tensor(bounds);
+  EXPECT_EQ(tensor.dimension(), bounds.dimension());
+  EXPECT_EQ(tensor.lower().flat_values()[1], bounds.flat_values()[1].lb());
+  EXPECT_EQ(tensor.upper().flat_values()[1], bounds.flat_values()[1].ub());
+  EXPECT_THAT(tensor.ToBoundsTensor(), BoundsTensorEquals(bounds));
+}
+
+TEST(SoaBoundsTensorDeathTest, DifferentShapes) {
+  EXPECT_DEATH(
+      SoaBoundsTensor(DoubleTensor({1.0, 2.0}), DoubleTensor({3.0})),
+      "shape");
+}
+
+// Each binary operation matches its BoundsTensor version, for each of the
+// broadcasting cases of math_impl.h.
+class SoaBoundsTensorBinaryTest
+    : public ::testing::TestWithParam<std::pair<Shape, Shape>> {};
+
+TEST_P(SoaBoundsTensorBinaryTest, MatchesBoundsTensor) {
+  const BoundsTensor left = MakeBounds(GetParam().first, 0);
+  const BoundsTensor right = MakeBounds(GetParam().second, 3);
+  const SoaBoundsTensor soa_left(left);
+  const SoaBoundsTensor soa_right(right);
+  EXPECT_THAT(Add(soa_left, soa_right).ToBoundsTensor(),
+              BoundsTensorEquals(Add(left, right)));
+  EXPECT_THAT(Subtract(soa_left, soa_right).ToBoundsTensor(),
+              BoundsTensorEquals(Subtract(left, right)));
+  EXPECT_THAT(Multiply(soa_left, soa_right).ToBoundsTensor(),
+              BoundsTensorEquals(Multiply(left, right)));
+  EXPECT_THAT(Divide(soa_left, soa_right).ToBoundsTensor(),
+              BoundsTensorEquals(Divide(left, right)));
+  EXPECT_THAT(ElementwiseMaximum(soa_left, soa_right).ToBoundsTensor(),
+              BoundsTensorEquals(ElementwiseMaximum(left, right)));
+  EXPECT_THAT(ElementwiseMinimum(soa_left, soa_right).ToBoundsTensor(),
+              BoundsTensorEquals(ElementwiseMinimum(left, right)));
+}
+
+INSTANTIATE_TEST_SUITE_P(
+    Broadcasting, SoaBoundsTensorBinaryTest,
+    ::testing::Values(std::make_pair(Shape({3, 7}), Shape({3, 7})),
+                      std::make_pair(Shape({3, 7}), Shape()),
+                      std::make_pair(Shape({1}), Shape({3, 7})),
+                      std::make_pair(Shape({3, 7}), Shape({7})),
+                      std::make_pair(Shape({7}), Shape({2, 3, 7})),
+                      std::make_pair(Shape({2, 1, 3}), Shape({4, 1}))));
+
+TEST(SoaBoundsTensorTest, Relu) {
+  const BoundsTensor bounds = MakeBounds(Shape({3, 11}), 1);
+  EXPECT_THAT(ElementwiseRelu(SoaBoundsTensor(bounds)).ToBoundsTensor(),
+              BoundsTensorEquals(ElementwiseRelu(bounds)));
+}
+
+TEST(SoaBoundsTensorTest, ClippedRelu) {
+  const BoundsTensor bounds = MakeBounds(Shape({3, 11}), 2);
+  EXPECT_THAT(
+      ElementwiseClippedRelu(SoaBoundsTensor(bounds), 1.75).ToBoundsTensor(),
+      BoundsTensorEquals(ElementwiseClippedRelu(bounds, 1.75)));
+}
+
+TEST(SoaBoundsTensorTest, MultiplyWithDoubleWeights) {
+  const SoaBoundsTensor input(DoubleTensor({-1.0, 2.0}),
+                              DoubleTensor({1.0, 3.0}));
+  const DoubleTensor weights({-2.0, 0.5});
+  const SoaBoundsTensor result =
+      Multiply(input, SoaBoundsTensor(weights, weights));
+  EXPECT_EQ(result.flat_value(0), Bounds(-2.0, 2.0));
+  EXPECT_EQ(result.flat_value(1), Bounds(1.0, 1.5));
+}
+
+}  // namespace
+}  // namespace tf_opt
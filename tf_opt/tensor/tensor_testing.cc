@@ -127,4 +127,13 @@ class DoubleTensorIIDRandomNormalMatcher
       new DoubleTensorIIDRandomNormalMatcher(shape, mean, stddev));
 }
 
+DoubleTensor MakeWeights(const Shape& shape, const int seed) {
+  DoubleTensor result(shape);
+  std::vector<double>& values = *result.mutable_flat_values();
+  for (int i = 0; i < values.size(); ++i) {
+    values[i] = ((seed * 31 + i * 17) % 23) / 11.0 - 1.0;
+  }
+  return result;
+}
+
 }  // namespace tf_opt
@@ -141,6 +141,10 @@ void TensorMatcher<T>::DescribeNegationTo(std::ostream* os) const {
 ::testing::Matcher<DoubleTensor> IsIIDRandomNormal(const Shape& shape,
                                                    double mean, double stddev);
 
+// A deterministic tensor of the given shape, with values in [-1, 1]. Different
+// seeds give different values.
+DoubleTensor MakeWeights(const Shape& shape, int seed);
+
 }  // namespace tf_opt
 
 #endif  // TF_OPT_TENSOR_TENSOR_TESTING_H_
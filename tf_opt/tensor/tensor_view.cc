@@ -0,0 +1,34 @@
+// Copyright 2026 The tf.opt Authors.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "tf_opt/tensor/tensor_view.h"
+
+#include <cstdint>
+#include <vector>
+
+namespace tf_opt {
+namespace internal {
+
+std::vector<int64_t> RowMajorStrides(const Shape& shape) {
+  std::vector<int64_t> strides(shape.num_dimensions());
+  int64_t stride = 1;
+  for (int64_t d = shape.num_dimensions() - 1; d >= 0; --d) {
+    strides[d] = stride;
+    stride *= shape.dimension_size(d);
+  }
+  return strides;
+}
+
+}  // namespace internal
+}  // namespace tf_opt
@@ -0,0 +1,287 @@
+// Copyright 2026 The tf.opt Authors.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef TF_OPT_TENSOR_TENSOR_VIEW_H_
+#define TF_OPT_TENSOR_TENSOR_VIEW_H_
+
+#include <cstdint>
+#include <utility>
+#include <vector>
+
+#include "ortools/base/logging.h"
+#include "absl/types/span.h"
+#include "tf_opt/tensor/shape.h"
+#include "tf_opt/tensor/tensor.h"
+
+namespace tf_opt {
+
+// A read-only, non-owning view of the values of a Tensor<T>, possibly with a
+// different shape. The element at multi-index i of the view is
+//   data[offset + sum_d i[d] * strides[d]].
+//
+// Reshape(), Squeeze(), ExpandDims(), Slice(), SubTensor() and BroadcastTo()
+// mirror the Tensor methods of the same name (and follow the same validation
+// rules), but only compute a new shape, strides and offset: they cost
+// O(rank) instead of O(size). Call ToTensor() to materialize the result.
+//
+// A stride of zero repeats the same element along a dimension, which is how
+// BroadcastTo() works without copying.
+//
+// The viewed data must outlive the view, and must not be resized while the
+// view is in use (e.g. through Tensor<T>::mutable_flat_values()).
+//
+// Example use:
+//   const DoubleTensor t = ...;  // shape [1, 4, 6]
+//   const DoubleTensor last_columns =
+//       TensorView<double>(t).Squeeze().Slice({0, 3}, {4, 3}).ToTensor();
+template <typename T>
+class TensorView {
+ public:
+  // A view of all of tensor, with the same shape.
+  explicit TensorView(const Tensor<T>& tensor);
+
+  // A view of "data", which must contain all elements addressed by shape,
+  // strides and offset.
+  TensorView(const T* data, Shape shape, std::vector<int64_t> strides,
+             int64_t offset);
+
+  const Shape& dimension() const { return shape_; }
+  int64_t size() const { return shape_.size(); }
+  const std::vector<int64_t>& strides() const { return strides_; }
+  int64_t offset() const { return offset_; }
+
+  const T& ValueSpan(absl::Span<const int64_t> index) const;
+  const T& value(const std::vector<int64_t>& index) const {
+    return ValueSpan(index);
+  }
+
+  // True if the elements of the view are stored consecutively, in row major
+  // order, as in a Tensor<T>.
+  bool IsContiguous() const;
+
+  // Like Tensor<T>::Reshape(). Requires IsContiguous().
+  TensorView<T> Reshape(const Shape& replacement_shape) const;
+
+  // Like Tensor<T>::Squeeze().
+  TensorView<T> Squeeze() const;
+  TensorView<T> Squeeze(absl::Span<const int> axes) const;
+
+  // Like Tensor<T>::ExpandDims().
+  TensorView<T> ExpandDims(int axis) const;
+
+  // Like Tensor<T>::Slice().
+  TensorView<T> Slice(absl::Span<const int64_t> begin_indices,
+                      absl::Span<const int64_t> sizes) const;
+
+  // Like Tensor<T>::SubTensor().
+  TensorView<T> SubTensor(int start_index, int size) const;
+  TensorView<T> SubTensor(int index, bool keep_dims = false) const;
+
+  // Broadcasts this to "broadcast_shape", following the rules of math.h: the
+  // shape of this is padded with leading ones, and dimensions of size one are
+  // repeated (with stride zero) to match broadcast_shape.
+  TensorView<T> BroadcastTo(const Shape& broadcast_shape) const;
+
+  // Copies the elements of the view into a new tensor with the same shape.
+  Tensor<T> ToTensor() const;
+
+ private:
+  const T* data_;
+  Shape shape_;
+  std::vector<int64_t> strides_;
+  int64_t offset_;
+};
+
+namespace internal {
+
+// The strides of a Tensor of shape "shape", i.e. in row major order.
+std::vector<int64_t> RowMajorStrides(const Shape& shape);
+
+}  // namespace internal
+
+// Template implementations
+
+template <typename T>
+TensorView<T>::TensorView(const Tensor<T>& tensor)
+    : TensorView(tensor.flat_values().data(), tensor.dimension(),
+                 internal::RowMajorStrides(tensor.dimension()), 0) {}
+
+template <typename T>
+TensorView<T>::TensorView(const T* data, Shape shape,
+                          std::vector<int64_t> strides, const int64_t offset)
+    : data_(data),
+      shape_(std::move(shape)),
+      strides_(std::move(strides)),
+      offset_(offset) {
+  CHECK_EQ(strides_.size(), shape_.num_dimensions());
+}
+
+template <typename T>
+const T& TensorView<T>::ValueSpan(absl::Span<const int64_t> index) const {
+  CHECK(shape_.MultiIndexIsValid(index));
+  int64_t flat_index = offset_;
+  for (int d = 0; d < index.size(); ++d) {
+    flat_index += index[d] * strides_[d];
+  }
+  return data_[flat_index];
+}
+
+template <typename T>
+bool TensorView<T>::IsContiguous() const {
+  int64_t expected_stride = 1;
+  for (int64_t d = shape_.num_dimensions() - 1; d >= 0; --d) {
+    // The stride is irrelevant for dimensions of size one.
+    if (shape_.dimension_size(d) != 1 && strides_[d] != expected_stride) {
+      return false;
+    }
+    expected_stride *= shape_.dimension_size(d);
+  }
+  return true;
+}
+
+template <typename T>
+TensorView<T> TensorView<T>::Reshape(const Shape& replacement_shape) const {
+  CHECK(IsContiguous()) << "Cannot reshape a non-contiguous view of shape "
+                        << shape_.ToString() << ", call ToTensor() first.";
+  CHECK_EQ(shape_.size(), replacement_shape.size());
+  return TensorView<T>(data_, replacement_shape,
+                       internal::RowMajorStrides(replacement_shape), offset_);
+}
+
+template <typename T>
+TensorView<T> TensorView<T>::Squeeze() const {
+  std::vector<int64_t> strides;
+  for (int d = 0; d < shape_.num_dimensions(); ++d) {
+    if (shape_.dimension_size(d) != 1) {
+      strides.push_back(strides_[d]);
+    }
+  }
+  return TensorView<T>(data_, internal::SqueezeShape(shape_),
+                       std::move(strides), offset_);
+}
+
+template <typename T>
+TensorView<T> TensorView<T>::Squeeze(absl::Span<const int> axes) const {
+  Shape result_shape = internal::SqueezeShape(shape_, axes).value();
+  std::vector<bool> retained(shape_.num_dimensions(), true);
+  for (const int a : axes) {
+    retained[a] = false;
+  }
+  std::vector<int64_t> strides;
+  for (int d = 0; d < shape_.num_dimensions(); ++d) {
+    if (retained[d]) {
+      strides.push_back(strides_[d]);
+    }
+  }
+  return TensorView<T>(data_, std::move(result_shape), std::move(strides),
+                       offset_);
+}
+
+template <typename T>
+TensorView<T> TensorView<T>::ExpandDims(const int axis) const {
+  Shape result_shape = internal::ExpandDimsShape(shape_, axis).value();
+  std::vector<int64_t> strides = strides_;
+  strides.insert(strides.begin() + axis, 0);
+  return TensorView<T>(data_, std::move(result_shape), std::move(strides),
+                       offset_);
+}
+
+template <typename T>
+TensorView<T> TensorView<T>::Slice(absl::Span<const int64_t> begin_indices,
+                                   absl::Span<const int64_t> sizes) const {
+  Shape result_shape =
+      internal::SliceShape(shape_, begin_indices, sizes).value();
+  int64_t offset = offset_;
+  for (int d = 0; d < shape_.num_dimensions(); ++d) {
+    offset += begin_indices[d] * strides_[d];
+  }
+  return TensorView<T>(data_, std::move(result_shape), strides_, offset);
+}
+
+template <typename T>
+TensorView<T> TensorView<T>::SubTensor(const int start_index,
+                                       const int size) const {
+  Shape result_shape = internal::SubTensorShape(shape_, start_index, size);
+  return TensorView<T>(data_, std::move(result_shape), strides_,
+                       offset_ + start_index * strides_[0]);
+}
+
+template <typename T>
+TensorView<T> TensorView<T>::SubTensor(const int index,
+                                       const bool keep_dims) const {
+  TensorView<T> result = SubTensor(index, 1);
+  if (!keep_dims) {
+    return result.Squeeze({0});
+  }
+  return result;
+}
+
+template <typename T>
+TensorView<T> TensorView<T>::BroadcastTo(const Shape& broadcast_shape) const {
+  const int64_t padding =
+      broadcast_shape.num_dimensions() - shape_.num_dimensions();
+  CHECK_GE(padding, 0) << "Cannot broadcast " << shape_.ToString() << " to "
+                       << broadcast_shape.ToString();
+  std::vector<int64_t> strides(broadcast_shape.num_dimensions(), 0);
+  for (int d = 0; d < shape_.num_dimensions(); ++d) {
+    const int64_t size = shape_.dimension_size(d);
+    if (size != 1) {
+      CHECK_EQ(size, broadcast_shape.dimension_size(d + padding))
+          << "Cannot broadcast " << shape_.ToString() << " to "
+          << broadcast_shape.ToString();
+      strides[d + padding] = strides_[d];
+    }
+  }
+  return TensorView<T>(data_, broadcast_shape, std::move(strides), offset_);
+}
+
+template <typename T>
+Tensor<T> TensorView<T>::ToTensor() const {
+  Tensor<T> result(shape_);
+  const int64_t size = shape_.size();
+  if (size == 0) {
+    return result;
+  }
+  std::vector<T>& result_values = *result.mutable_flat_values();
+  const int64_t num_dimensions = shape_.num_dimensions();
+  if (num_dimensions == 0) {
+    result_values[0] = data_[offset_];
+    return result;
+  }
+  // Copies one row (along the last dimension) at a time, and advances the
+  // multi-index of the other dimensions like an odometer.
+  const int64_t row_size = shape_.dimension_size(num_dimensions - 1);
+  const int64_t row_stride = strides_[num_dimensions - 1];
+  std::vector<int64_t> counter(num_dimensions - 1, 0);
+  int64_t row_start = offset_;
+  for (int64_t out = 0; out < size; out += row_size) {
+    const T* row = data_ + row_start;
+    for (int64_t j = 0; j < row_size; ++j) {
+      result_values[out + j] = row[j * row_stride];
+    }
+    for (int64_t d = num_dimensions - 2; d >= 0; --d) {
+      row_start += strides_[d];
+      if (++counter[d] < shape_.dimension_size(d)) {
+        break;
+      }
+      counter[d] = 0;
+      row_start -= strides_[d] * shape_.dimension_size(d);
+    }
+  }
+  return result;
+}
+
+}  // namespace tf_opt
+
+#endif  // TF_OPT_TENSOR_TENSOR_VIEW_H_
@@ -0,0 +1,146 @@
+// Copyright 2026 The tf.opt Authors.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "tf_opt/tensor/tensor_view.h"
+
+#include <vector>
+
+#include "gmock/gmock.h"
+#include "gtest/gtest.h"
+#include "tf_opt/tensor/shape.h"
+#include "tf_opt/tensor/tensor.h"
+#include "tf_opt/tensor/tensor_testing.h"
+
+namespace tf_opt {
+namespace {
+
+using ::testing::ElementsAre;
+
+// [[[0, 1, 2], [3, 4, 5]], [[6, 7, 8], [9, 10, 11]]]
+DoubleTensor MakeTensor() {
+  return DoubleTensor::FromFlatData(
+      Shape({2, 2, 3}),
+      {0.0, 1.0, 2.0, 3.0, 4.0, 5.0, 6.0, 7.0, 8.0, 9.0, 10.0, 11.0});
+}
+
+TEST(TensorViewTest, ViewOfTensor) {
+  const DoubleTensor t = MakeTensor();
+  const TensorView<double> view(t);
+  EXPECT_EQ(view.dimension(), Shape({2, 2, 3}));
+  EXPECT_EQ(view.size(), 12);
+  EXPECT_THAT(view.strides(), ElementsAre(6, 3, 1));
+  EXPECT_EQ(view.offset(), 0);
+  EXPECT_TRUE(view.IsContiguous());
+  EXPECT_EQ(view.value({1, 0, 2}), 8.0);
+  EXPECT_THAT(view.ToTensor(), DoubleTensorEquals(t));
+}
+
+TEST(TensorViewTest, ReshapeDoesNotCopy) {
+  const DoubleTensor t = MakeTensor();
+  const TensorView<double> view = TensorView<double>(t).Reshape(Shape({4, 3}));
+  EXPECT_EQ(&view.value({3, 2}), &t.flat_value(11));
+  EXPECT_THAT(view.ToTensor(), DoubleTensorEquals(t.Reshape(Shape({4, 3}))));
+}
+
+TEST(TensorViewTest, SqueezeAndExpandDims) {
+  const DoubleTensor t = MakeTensor().Reshape(Shape({1, 2, 1, 6}));
+  const TensorView<double> view(t);
+  EXPECT_THAT(view.Squeeze().ToTensor(), DoubleTensorEquals(t.Squeeze()));
+  EXPECT_THAT(view.Squeeze({2}).ToTensor(),
+              DoubleTensorEquals(t.Squeeze({2})));
+  for (int axis = 0; axis <= 4; ++axis) {
+    EXPECT_THAT(view.ExpandDims(axis).ToTensor(),
+                DoubleTensorEquals(t.ExpandDims(axis)))
+        << "axis: " << axis;
+  }
+}
+
+TEST(TensorViewTest, Slice) {
+  const DoubleTensor t = MakeTensor();
+  const TensorView<double> slice =
+      TensorView<double>(t).Slice({0, 1, 1}, {2, 1, 2});
+  EXPECT_EQ(slice.offset(), 4);
+  EXPECT_FALSE(slice.IsContiguous());
+  const DoubleTensor expected =
+      DoubleTensor::FromFlatData(Shape({2, 1, 2}), {4.0, 5.0, 10.0, 11.0});
+  EXPECT_THAT(slice.ToTensor(), DoubleTensorEquals(expected));
+  EXPECT_THAT(slice.ToTensor(),
+              DoubleTensorEquals(t.Slice({0, 1, 1}, {2, 1, 2})));
+}
+
+TEST(TensorViewTest, SliceOfSlice) {
+  const DoubleTensor t = MakeTensor();
+  const TensorView<double> slice = TensorView<double>(t)
+                                       .Slice({1, 0, 0}, {1, 2, 3})
+                                       .Squeeze({0})
+                                       .Slice({0, 1}, {2, 1});
+  EXPECT_THAT(slice.ToTensor(),
+              DoubleTensorEquals(DoubleTensor({std::vector<double>({7.0}),
+                                               std::vector<double>({10.0})})));
+}
+
+TEST(TensorViewTest, EmptySlice) {
+  const DoubleTensor t = MakeTensor();
+  const TensorView<double> slice =
+      TensorView<double>(t).Slice({0, 0, 0}, {2, 0, 3});
+  EXPECT_EQ(slice.size(), 0);
+  EXPECT_EQ(slice.ToTensor().dimension(), Shape({2, 0, 3}));
+}
+
+TEST(TensorViewTest, SubTensor) {
+  const DoubleTensor t = MakeTensor();
+  const TensorView<double> view(t);
+  EXPECT_THAT(view.SubTensor(1, 1).ToTensor(),
+              DoubleTensorEquals(t.SubTensor(1, 1)));
+  EXPECT_THAT(view.SubTensor(1).ToTensor(),
+              DoubleTensorEquals(t.SubTensor(1)));
+  EXPECT_THAT(view.SubTensor(0, /*keep_dims=*/true).ToTensor(),
+              DoubleTensorEquals(t.SubTensor(0, /*keep_dims=*/true)));
+}
+
+TEST(TensorViewTest, BroadcastTo) {
+  const DoubleTensor t({std::vector<double>({1.0}),
+                        std::vector<double>({2.0})});
+  const TensorView<double> broadcast =
+      TensorView<double>(t).BroadcastTo(Shape({2, 2, 3}));
+  EXPECT_THAT(broadcast.strides(), ElementsAre(0, 1, 0));
+  EXPECT_FALSE(broadcast.IsContiguous());
+  const DoubleTensor expected({{{1.0, 1.0, 1.0}, {2.0, 2.0, 2.0}},
+                               {{1.0, 1.0, 1.0}, {2.0, 2.0, 2.0}}});
+  EXPECT_THAT(broadcast.ToTensor(), DoubleTensorEquals(expected));
+}
+
+TEST(TensorViewTest, ScalarView) {
+  const DoubleTensor t(3.0);
+  const TensorView<double> view(t);
+  EXPECT_TRUE(view.IsContiguous());
+  EXPECT_THAT(view.ToTensor(), DoubleTensorEquals(t));
+  EXPECT_THAT(view.ExpandDims(0).BroadcastTo(Shape({3})).ToTensor(),
+              DoubleTensorEquals(DoubleTensor({3.0, 3.0, 3.0})));
+}
+
+TEST(TensorViewDeathTest, ReshapeNonContiguous) {
+  const DoubleTensor t = MakeTensor();
+  const TensorView<double> slice =
+      TensorView<double>(t).Slice({0, 0, 0}, {2, 2, 2});
+  EXPECT_DEATH(slice.Reshape(Shape({8})), "non-contiguous");
+}
+
+TEST(TensorViewDeathTest, BadSlice) {
+  const DoubleTensor t = MakeTensor();
+  EXPECT_DEATH(TensorView<double>(t).Slice({0, 0, 2}, {1, 1, 2}), "");
+}
+
+}  // namespace
+}  // namespace tf_opt
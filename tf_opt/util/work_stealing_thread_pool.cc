@@ -0,0 +1,138 @@
+// Copyright 2026 The tf.opt Authors.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "tf_opt/util/work_stealing_thread_pool.h"
+
+#include <functional>
+#include <memory>
+#include <utility>
+
+#include "ortools/base/logging.h"
+#include "absl/synchronization/blocking_counter.h"
+#include "absl/synchronization/mutex.h"
+
+namespace tf_opt {
+namespace {
+
+// The pool and worker index of the calling thread, see CurrentWorkerIndex().
+thread_local const WorkStealingThreadPool* current_pool = nullptr;
+thread_local int current_worker_index = -1;
+
+}  // namespace
+
+WorkStealingThreadPool::WorkStealingThreadPool(const int num_threads) {
+  CHECK_GT(num_threads, 0);
+  for (int i = 0; i < num_threads; ++i) {
+    queues_.push_back(std::make_unique<TaskQueue>());
+  }
+  threads_.reserve(num_threads);
+  for (int i = 0; i < num_threads; ++i) {
+    threads_.emplace_back([this, i] { WorkerLoop(i); });
+  }
+}
+
+WorkStealingThreadPool::~WorkStealingThreadPool() {
+  {
+    absl::MutexLock lock(&mutex_);
+    stopping_ = true;
+  }
+  for (std::thread& thread : threads_) {
+    thread.join();
+  }
+}
+
+int WorkStealingThreadPool::CurrentWorkerIndex() const {
+  return current_pool == this ? current_worker_index : -1;
+}
+
+void WorkStealingThreadPool::Schedule(std::function<void()> task) {
+  int index = CurrentWorkerIndex();
+  if (index < 0) {
+    index = next_queue_.fetch_add(1, std::memory_order_relaxed) %
+            queues_.size();
+  }
+  {
+    TaskQueue& queue = *queues_[index];
+    absl::MutexLock lock(&queue.mutex);
+    queue.tasks.push_back(std::move(task));
+  }
+  absl::MutexLock lock(&mutex_);
+  ++num_queued_;
+}
+
+bool WorkStealingThreadPool::PopOrSteal(const int index,
+                                        std::function<void()>* task) {
+  {
+    TaskQueue& own = *queues_[index];
+    absl::MutexLock lock(&own.mutex);
+    if (!own.tasks.empty()) {
+      *task = std::move(own.tasks.back());
+      own.tasks.pop_back();
+      return true;
+    }
+  }
+  const int num_queues = queues_.size();
+  for (int offset = 1; offset < num_queues; ++offset) {
+    TaskQueue& victim = *queues_[(index + offset) % num_queues];
+    absl::MutexLock lock(&victim.mutex);
+    if (!victim.tasks.empty()) {
+      *task = std::move(victim.tasks.front());
+      victim.tasks.pop_front();
+      return true;
+    }
+  }
+  return false;
+}
+
+void WorkStealingThreadPool::WorkerLoop(const int index) {
+  current_pool = this;
+  current_worker_index = index;
+  while (true) {
+    {
+      absl::MutexLock lock(&mutex_);
+      mutex_.Await(
+          absl::Condition(this, &WorkStealingThreadPool::HasTaskOrStopping));
+      if (num_queued_ == 0) {
+        // stopping_ is set and all tasks have been claimed. Tasks still
+        // running on other workers can only schedule onto their own queue,
+        // which they will run themselves.
+        return;
+      }
+      // Claims one of the queued tasks. Every claim matches a push that
+      // happened before, so PopOrSteal() below eventually finds a task.
+      --num_queued_;
+    }
+    std::function<void()> task;
+    while (!PopOrSteal(index, &task)) {
+      std::this_thread::yield();
+    }
+    task();
+  }
+}
+
+void ParallelFor(const int n, WorkStealingThreadPool* pool,
+                 const std::function<void(int)>& task) {
+  CHECK(pool != nullptr);
+  CHECK_EQ(pool->CurrentWorkerIndex(), -1) << "ParallelFor() from a task";
+  absl::BlockingCounter counter(n);
+  for (int i = 0; i < n; ++i) {
+    pool->Schedule([i, &task, &counter] {
+      task(i);
+      counter.DecrementCount();
+    });
+  }
+  counter.Wait();
+}
+
+}  // namespace tf_opt
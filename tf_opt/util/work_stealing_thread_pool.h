@@ -0,0 +1,101 @@
+// Copyright 2026 The tf.opt Authors.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef TF_OPT_UTIL_WORK_STEALING_THREAD_POOL_H_
+#define TF_OPT_UTIL_WORK_STEALING_THREAD_POOL_H_
+
+#include <atomic>
+#include <cstdint>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <thread>  // NOLINT(build/c++11)
+#include <vector>
+
+#include "absl/base/thread_annotations.h"
+#include "absl/synchronization/mutex.h"
+
+namespace tf_opt {
+
+// A fixed set of worker threads, each with its own deque of tasks.
+//
+// A worker runs the tasks of its own deque most recent first, which keeps the
+// data a task just produced in cache for the tasks it schedules. When its
+// deque is empty, a worker steals the oldest task of another worker. Tasks
+// scheduled from outside the pool are spread over the workers round robin.
+//
+// The destructor waits for all scheduled tasks, including the tasks they
+// schedule, to finish.
+//
+// Example use:
+//   WorkStealingThreadPool pool(8);
+//   for (int i = 0; i < n; ++i) {
+//     pool.Schedule([i, &results] { results[i] = Compute(i); });
+//   }
+class WorkStealingThreadPool {
+ public:
+  // Requires num_threads > 0.
+  explicit WorkStealingThreadPool(int num_threads);
+  ~WorkStealingThreadPool();
+
+  WorkStealingThreadPool(const WorkStealingThreadPool&) = delete;
+  WorkStealingThreadPool& operator=(const WorkStealingThreadPool&) = delete;
+
+  int num_threads() const { return threads_.size(); }
+
+  // Runs task on some worker thread. Thread-safe, and may be called from a
+  // task.
+  void Schedule(std::function<void()> task);
+
+  // The index in [0, num_threads()) of the worker running the calling code,
+  // or -1 if the caller is not a worker of this pool. A worker runs one task
+  // at a time, so tasks can use this index to access per-worker state without
+  // locking.
+  int CurrentWorkerIndex() const;
+
+ private:
+  struct TaskQueue {
+    absl::Mutex mutex;
+    std::deque<std::function<void()>> tasks ABSL_GUARDED_BY(mutex);
+  };
+
+  // Pops the newest task of the queue of worker "index", or steals the
+  // oldest task of another queue. Returns false if all queues are empty.
+  bool PopOrSteal(int index, std::function<void()>* task);
+
+  void WorkerLoop(int index);
+
+  bool HasTaskOrStopping() const ABSL_EXCLUSIVE_LOCKS_REQUIRED(mutex_) {
+    return num_queued_ > 0 || stopping_;
+  }
+
+  std::vector<std::unique_ptr<TaskQueue>> queues_;
+  std::vector<std::thread> threads_;
+  std::atomic<uint32_t> next_queue_{0};
+
+  // Idle workers wait on this for num_queued_ > 0.
+  absl::Mutex mutex_;
+  // The number of tasks pushed in a queue and not yet claimed by a worker.
+  int64_t num_queued_ ABSL_GUARDED_BY(mutex_) = 0;
+  bool stopping_ ABSL_GUARDED_BY(mutex_) = false;
+};
+
+// Runs task(i) for every i in [0, n) on pool, and waits for all of them to
+// finish. Must not be called from a task of pool.
+void ParallelFor(int n, WorkStealingThreadPool* pool,
+                 const std::function<void(int)>& task);
+
+}  // namespace tf_opt
+
+#endif  // TF_OPT_UTIL_WORK_STEALING_THREAD_POOL_H_
@@ -0,0 +1,124 @@
+// Copyright 2026 The tf.opt Authors.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "tf_opt/util/work_stealing_thread_pool.h"
+
+#include <atomic>
+#include <functional>
+#include <vector>
+
+#include "gmock/gmock.h"
+#include "gtest/gtest.h"
+#include "absl/synchronization/blocking_counter.h"
+
+namespace tf_opt {
+namespace {
+
+using ::testing::Each;
+
+TEST(WorkStealingThreadPoolTest, RunsAllTasks) {
+  constexpr int kNumTasks = 1000;
+  std::vector<int> results(kNumTasks, 0);
+  {
+    WorkStealingThreadPool pool(4);
+    EXPECT_EQ(pool.num_threads(), 4);
+    for (int i = 0; i < kNumTasks; ++i) {
+      pool.Schedule([i, &results] { results[i] = i + 1; });
+    }
+  }
+  for (int i = 0; i < kNumTasks; ++i) {
+    EXPECT_EQ(results[i], i + 1);
+  }
+}
+
+TEST(WorkStealingThreadPoolTest, ParallelForWaits) {
+  constexpr int kNumTasks = 100;
+  WorkStealingThreadPool pool(4);
+  std::vector<int> results(kNumTasks, 0);
+  ParallelFor(kNumTasks, &pool, [&results](const int i) { results[i] = i; });
+  for (int i = 0; i < kNumTasks; ++i) {
+    EXPECT_EQ(results[i], i);
+  }
+  ParallelFor(0, &pool, [](int) {});
+}
+
+TEST(WorkStealingThreadPoolTest, TasksCanScheduleTasks) {
+  constexpr int kDepth = 10;
+  std::atomic<int> num_run(0);
+  // A binary tree of tasks, all scheduled from worker threads but the root.
+  // Declared before the pool, whose destructor waits for all tasks.
+  std::function<void(int)> spawn;
+  {
+    WorkStealingThreadPool pool(3);
+    spawn = [&](const int depth) {
+      ++num_run;
+      if (depth < kDepth) {
+        pool.Schedule([&spawn, depth] { spawn(depth + 1); });
+        pool.Schedule([&spawn, depth] { spawn(depth + 1); });
+      }
+    };
+    pool.Schedule([&spawn] { spawn(1); });
+  }
+  EXPECT_EQ(num_run, (1 << kDepth) - 1);
+}
+
+TEST(WorkStealingThreadPoolTest, CurrentWorkerIndex) {
+  constexpr int kNumThreads = 4;
+  constexpr int kNumTasks = 100;
+  WorkStealingThreadPool pool(kNumThreads);
+  WorkStealingThreadPool other_pool(1);
+  EXPECT_EQ(pool.CurrentWorkerIndex(), -1);
+  std::vector<int> indices(kNumTasks, -2);
+  std::vector<int> other_indices(kNumTasks, -2);
+  absl::BlockingCounter done(kNumTasks);
+  for (int i = 0; i < kNumTasks; ++i) {
+    pool.Schedule([&, i] {
+      indices[i] = pool.CurrentWorkerIndex();
+      other_indices[i] = other_pool.CurrentWorkerIndex();
+      done.DecrementCount();
+    });
+  }
+  done.Wait();
+  for (const int index : indices) {
+    EXPECT_GE(index, 0);
+    EXPECT_LT(index, kNumThreads);
+  }
+  EXPECT_THAT(other_indices, Each(-1));
+}
+
+// A single task that schedules many others: idle workers must steal them.
+TEST(WorkStealingThreadPoolTest, IdleWorkersSteal) {
+  constexpr int kNumThreads = 4;
+  constexpr int kNumTasks = 64;
+  WorkStealingThreadPool pool(kNumThreads);
+  std::atomic<int> num_waiting(0);
+  absl::BlockingCounter done(kNumTasks);
+  pool.Schedule([&] {
+    for (int i = 0; i < kNumTasks; ++i) {
+      pool.Schedule([&] {
+        // Blocks until a task runs on every worker, which only happens if the
+        // other workers steal from the scheduling worker.
+        if (num_waiting.fetch_add(1) < kNumThreads) {
+          while (num_waiting.load() < kNumThreads) {
+          }
+        }
+        done.DecrementCount();
+      });
+    }
+  });
+  done.Wait();
+}
+
+}  // namespace
+}  // namespace tf_opt